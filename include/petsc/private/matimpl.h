@@ -336,12 +336,14 @@ PETSC_EXTERN PetscErrorCode PetscMatStashSpaceDestroy(PetscMatStashSpace *);
 
 typedef struct {
   PetscInt count;
+  PetscInt nflushed; /* Number of messages flushed to the rank before MatAssemblyBegin() */
 } MatStashHeader;
 
 typedef struct {
-  void    *buffer; /* Of type blocktype, dynamically constructed  */
-  PetscInt count;
-  char     pending;
+  void       *buffer; /* Of type blocktype, dynamically constructed  */
+  PetscInt    count;
+  PetscMPIInt rank; /* Source of a flushed message */
+  char        pending;
 } MatStashFrame;
 
 typedef struct _MatStash MatStash;
@@ -402,6 +404,20 @@ struct _MatStash {
   MPI_Datatype    blocktype;
   size_t          blocktype_size;
   InsertMode     *insertmode; /* Pointer to check mat->insertmode and set upon message arrival in case no local values have been set. */
+
+  /* The following variables are used to flush the BTS stash to the owners while values are still being set */
+  PetscInt       flushsize;          /* Flush once the stash holds this many values, 0 means only at MatAssemblyBegin() */
+  PetscMPIInt    flushtag;
+  PetscInt      *flushowners;        /* Ownership ranges in units of the stash block size */
+  PetscMPIInt   *flushsendcounts;    /* Number of messages flushed to each rank */
+  PetscMPIInt   *flushrecvcounts;    /* Number of flushed messages received from each rank */
+  PetscSegBuffer segflushsendblocks; /* Send buffers, live until MatStashScatterEnd_Private() */
+  PetscSegBuffer segflushreqs;
+  PetscSegBuffer segflushframe;
+  PetscSegBuffer segflushrecvblocks;
+  MatStashFrame *flushframes;
+  PetscCount     nflushframes;
+  PetscCount     flushframe_i; /* Index of the next flushed frame to process */
 };
 
 #if !defined(PETSC_HAVE_MPIUNI)
@@ -417,6 +433,7 @@ PETSC_INTERN PetscErrorCode MatStashValuesCol_Private(MatStash *, PetscInt, Pets
 PETSC_INTERN PetscErrorCode MatStashValuesRowBlocked_Private(MatStash *, PetscInt, PetscInt, const PetscInt[], const PetscScalar[], PetscInt, PetscInt, PetscInt);
 PETSC_INTERN PetscErrorCode MatStashValuesColBlocked_Private(MatStash *, PetscInt, PetscInt, const PetscInt[], const PetscScalar[], PetscInt, PetscInt, PetscInt);
 PETSC_INTERN PetscErrorCode MatStashScatterBegin_Private(Mat, MatStash *, PetscInt *);
+PETSC_INTERN PetscErrorCode MatStashFlush_Private(Mat);
 PETSC_INTERN PetscErrorCode MatStashScatterGetMesg_Private(MatStash *, PetscMPIInt *, PetscInt **, PetscInt **, PetscScalar **, PetscInt *);
 PETSC_INTERN PetscErrorCode MatGetInfo_External(Mat, MatInfoType, MatInfo *);
 
@@ -494,6 +511,7 @@ struct _p_Mat {
   PetscBool        assembly_subset; /* set by MAT_SUBSET_OFF_PROC_ENTRIES */
   PetscBool        submat_singleis; /* for efficient PCSetUp_ASM() */
   PetscBool        structure_only;
+  PetscBool        concurrent_setvalues;
   PetscBool        sortedfull;      /* full, sorted rows are inserted */
   PetscBool        force_diagonals; /* set by MAT_FORCE_DIAGONAL_ENTRIES */
 #if defined(PETSC_HAVE_DEVICE)
@@ -1685,6 +1703,7 @@ PETSC_EXTERN PetscErrorCode MatFDColoringApply_AIJ(Mat, MatFDColoring, Vec, void
 
 PETSC_EXTERN PetscLogEvent MAT_Mult;
 PETSC_EXTERN PetscLogEvent MAT_MultAdd;
+PETSC_EXTERN PetscLogEvent MAT_MultPowers;
 PETSC_EXTERN PetscLogEvent MAT_MultTranspose;
 PETSC_EXTERN PetscLogEvent MAT_MultHermitianTranspose;
 PETSC_EXTERN PetscLogEvent MAT_MultTransposeAdd;
@@ -1770,6 +1789,7 @@ PETSC_EXTERN PetscLogEvent MAT_HIPSPARSECopyFromGPU;
 PETSC_EXTERN PetscLogEvent MAT_HIPSPARSEGenerateTranspose;
 PETSC_EXTERN PetscLogEvent MAT_HIPSPARSESolveAnalysis;
 PETSC_EXTERN PetscLogEvent MAT_SetValuesBatch;
+PETSC_EXTERN PetscLogEvent MAT_StashFlush;
 PETSC_EXTERN PetscLogEvent MAT_CreateGraph;
 PETSC_EXTERN PetscLogEvent MAT_ViennaCLCopyToGPU;
 PETSC_EXTERN PetscLogEvent MAT_DenseCopyToGPU;
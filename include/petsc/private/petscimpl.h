@@ -1596,7 +1596,24 @@ PETSC_INTERN PetscErrorCode PetscKokkosFinalize_Private(void);
 #endif
 
 #if defined(PETSC_HAVE_OPENMP)
-PETSC_EXTERN PetscInt PetscNumOMPThreads;
+PETSC_EXTERN PetscInt  PetscNumOMPThreads;
+PETSC_EXTERN PetscBool PetscOMPFirstTouch;
+#endif
+PETSC_INTERN PetscErrorCode PetscMemzeroFirstTouch_Private(void *, size_t, PetscInt, PetscInt, const PetscInt[]);
+
+PETSC_INTERN PetscErrorCode PetscCPUFeaturesInitialize(void);
+
+/*
+   Hand-vectorized x86 kernels are compiled with PETSC_ATTRIBUTE_TARGET() and installed at run time if PetscCPUFeatureIsEnabled(),
+   without the attribute they are only available when the whole code is compiled for the extensions
+*/
+#if defined(PETSC_HAVE_IMMINTRIN_H) && (defined(__x86_64__) || defined(__i386__)) && !defined(PETSC_SKIP_IMMINTRIN_H_CUDAWORKAROUND)
+  #if defined(PETSC_ATTRIBUTE_TARGET_SUPPORTED) || (defined(__AVX2__) && defined(__FMA__))
+    #define PETSC_X86_AVX2_KERNELS_SUPPORTED 1
+  #endif
+  #if defined(PETSC_ATTRIBUTE_TARGET_SUPPORTED) || defined(__AVX512F__)
+    #define PETSC_X86_AVX512_KERNELS_SUPPORTED 1
+  #endif
 #endif
 
 struct _n_PetscObjectList {
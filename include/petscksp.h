@@ -87,6 +87,12 @@ typedef const char *KSPType;
 #define KSPCGLS       "cgls"
 #define KSPFETIDP     "fetidp"
 #define KSPHPDDM      "hpddm"
+#define KSPSSTEPCG    "sstepcg"
+#define KSPSSTEPGMRES "sstepgmres"
+#define KSPBLOCKCG    "blockcg"
+#define KSPBLOCKGMRES "blockgmres"
+#define KSPGCRODR     "gcrodr"
+#define KSPMPIR       "mpir"
 
 /* Logging support */
 PETSC_EXTERN PetscClassId KSP_CLASSID;
@@ -289,6 +295,11 @@ PETSC_EXTERN PetscErrorCode KSPGMRESClassicalGramSchmidtOrthogonalization(KSP, P
 PETSC_EXTERN PetscErrorCode KSPLGMRESSetAugDim(KSP, PetscInt);
 PETSC_EXTERN PetscErrorCode KSPLGMRESSetConstant(KSP);
 
+PETSC_EXTERN PetscErrorCode KSPGCRODRSetRecycleSize(KSP, PetscInt);
+PETSC_EXTERN PetscErrorCode KSPGCRODRGetRecycleSize(KSP, PetscInt *);
+
+PETSC_EXTERN PetscErrorCode KSPMPIRSetInnerTolerances(KSP, PetscReal, PetscInt);
+
 PETSC_EXTERN PetscErrorCode KSPPIPEFGMRESSetShift(KSP, PetscScalar);
 
 PETSC_EXTERN PetscErrorCode KSPGCRSetRestart(KSP, PetscInt);
@@ -443,6 +454,31 @@ M*/
 PETSC_EXTERN PetscErrorCode KSPGMRESSetCGSRefinementType(KSP, KSPGMRESCGSRefinementType);
 PETSC_EXTERN PetscErrorCode KSPGMRESGetCGSRefinementType(KSP, KSPGMRESCGSRefinementType *);
 
+/*E
+   KSPSStepBasis - The polynomial basis of the vectors generated at each outer iteration of `KSPSSTEPCG` and `KSPSSTEPGMRES`
+
+   Values:
++  `KSP_SSTEP_BASIS_MONOMIAL`  - the powers of the operator, the simplest but ill conditioned for large block sizes
+.  `KSP_SSTEP_BASIS_NEWTON`    - products of the operator shifted by Leja ordered Ritz values
+-  `KSP_SSTEP_BASIS_CHEBYSHEV` - the Chebyshev polynomials of an interval containing the spectrum
+
+   Level: advanced
+
+.seealso: [](ch_ksp), `KSP`, `KSPSSTEPCG`, `KSPSSTEPGMRES`, `KSPSStepSetBasis()`, `KSPSStepSetEigenvalues()`, `MatMultPowers()`
+E*/
+typedef enum {
+  KSP_SSTEP_BASIS_MONOMIAL,
+  KSP_SSTEP_BASIS_NEWTON,
+  KSP_SSTEP_BASIS_CHEBYSHEV
+} KSPSStepBasis;
+PETSC_EXTERN const char *const KSPSStepBases[];
+
+PETSC_EXTERN PetscErrorCode KSPSStepSetSize(KSP, PetscInt);
+PETSC_EXTERN PetscErrorCode KSPSStepGetSize(KSP, PetscInt *);
+PETSC_EXTERN PetscErrorCode KSPSStepSetBasis(KSP, KSPSStepBasis);
+PETSC_EXTERN PetscErrorCode KSPSStepGetBasis(KSP, KSPSStepBasis *);
+PETSC_EXTERN PetscErrorCode KSPSStepSetEigenvalues(KSP, PetscReal, PetscReal);
+
 PETSC_EXTERN PetscErrorCode KSPFGMRESModifyPCNoChange(KSP, PetscInt, PetscInt, PetscReal, void *);
 PETSC_EXTERN PetscErrorCode KSPFGMRESModifyPCKSP(KSP, PetscInt, PetscInt, PetscReal, void *);
 PETSC_EXTERN PetscErrorCode KSPFGMRESSetModifyPC(KSP, PetscErrorCode (*)(KSP, PetscInt, PetscInt, PetscReal, void *), void *, PetscErrorCode (*)(void *));
@@ -358,6 +358,43 @@ M*/
   #define PETSC_ATTRIBUTE_MAY_ALIAS
 #endif
 
+/*MC
+  PETSC_ATTRIBUTE_TARGET - Compile a function for instruction set extensions that the rest of the
+  code is not compiled for
+
+  Synopsis:
+  #include <petscmacros.h>
+  <attribute declaration> PETSC_ATTRIBUTE_TARGET(features)
+
+  Input Parameter:
+. features - string literal listing the extensions, for example `"avx2,fma"`
+
+  Example Usage:
+.vb
+  PETSC_ATTRIBUTE_TARGET("avx2,fma") static void my_kernel_avx2(...);
+
+  PetscCall(PetscCPUFeatureIsEnabled(PETSC_CPU_FEATURE_AVX2, &flg));
+  if (flg) my_kernel_avx2(...);
+.ve
+
+  Level: developer
+
+  Notes:
+  Such a function must only be called once `PetscCPUFeatureIsEnabled()` has reported that the
+  processor supports the extensions, this lets a single build use them where they are available.
+
+  `PETSC_ATTRIBUTE_TARGET_SUPPORTED` is defined when the compiler supports the attribute, otherwise the
+  macro expands to nothing and the function is compiled with the flags of the rest of the code.
+
+.seealso: `PetscHasAttribute()`, `PetscCPUFeatureIsEnabled()`
+M*/
+#if PetscHasAttribute(target) && !defined(__NVCOMPILER) && !defined(__CUDACC__) && !defined(__HIPCC__)
+  #define PETSC_ATTRIBUTE_TARGET_SUPPORTED 1
+  #define PETSC_ATTRIBUTE_TARGET(features) __attribute__((target(features)))
+#else
+  #define PETSC_ATTRIBUTE_TARGET(features)
+#endif
+
 /*MC
   PETSC_NULLPTR - Standard way of indicating a null value or pointer
 
@@ -66,6 +66,10 @@ typedef const char *MatType;
 #define MATAIJSELL                   "aijsell"
 #define MATSEQAIJSELL                "seqaijsell"
 #define MATMPIAIJSELL                "mpiaijsell"
+#define MATAIJVBR                    "aijvbr"
+#define MATSEQAIJVBR                 "seqaijvbr"
+#define MATMPIAIJVBR                 "mpiaijvbr"
+#define MATSEQAIJSINGLE              "seqaijsingle"
 #define MATAIJMKL                    "aijmkl"
 #define MATSEQAIJMKL                 "seqaijmkl"
 #define MATMPIAIJMKL                 "mpiaijmkl"
@@ -275,6 +279,7 @@ typedef const char *MatProductAlgorithm;
 #define MATPRODUCTALGORITHMBHEAP           "btheap"
 #define MATPRODUCTALGORITHMLLCONDENSED     "llcondensed"
 #define MATPRODUCTALGORITHMROWMERGE        "rowmerge"
+#define MATPRODUCTALGORITHMHASHTHREADED    "hash_threaded"
 #define MATPRODUCTALGORITHMOUTERPRODUCT    "outerproduct"
 #define MATPRODUCTALGORITHMATB             "at*b"
 #define MATPRODUCTALGORITHMRAP             "rap"
@@ -646,7 +651,8 @@ typedef enum {
   MAT_FORM_EXPLICIT_TRANSPOSE     = 24,
   MAT_STRUCTURAL_SYMMETRY_ETERNAL = 25,
   MAT_SPD_ETERNAL                 = 26,
-  MAT_OPTION_MAX                  = 27
+  MAT_CONCURRENT_SET_VALUES       = 27,
+  MAT_OPTION_MAX                  = 28
 } MatOption;
 
 PETSC_EXTERN const char *const *MatOptions;
@@ -714,6 +720,7 @@ PETSC_EXTERN PetscErrorCode MatDenseRestoreSubMatrix(Mat, Mat *);
 PETSC_EXTERN PetscErrorCode MatMult(Mat, Vec, Vec);
 PETSC_EXTERN PetscErrorCode MatMultDiagonalBlock(Mat, Vec, Vec);
 PETSC_EXTERN PetscErrorCode MatMultAdd(Mat, Vec, Vec, Vec);
+PETSC_EXTERN PetscErrorCode MatMultPowers(Mat, Vec, PetscInt, const PetscScalar[], const PetscScalar[], const PetscScalar[], Vec[]);
 PETSC_EXTERN PetscErrorCode MatMultTranspose(Mat, Vec, Vec);
 PETSC_EXTERN PetscErrorCode MatMultHermitianTranspose(Mat, Vec, Vec);
 PETSC_EXTERN PetscErrorCode MatIsTranspose(Mat, Mat, PetscReal, PetscBool *);
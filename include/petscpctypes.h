@@ -41,6 +41,7 @@ typedef const char *PCType;
 #define PCGASM               "gasm"
 #define PCKSP                "ksp"
 #define PCBJKOKKOS           "bjkokkos"
+#define PCBJBATCH            "bjbatch"
 #define PCCOMPOSITE          "composite"
 #define PCREDUNDANT          "redundant"
 #define PCSPAI               "spai"
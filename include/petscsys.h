@@ -1295,6 +1295,7 @@ PETSC_EXTERN PetscErrorCode PetscObjectCompareId(PetscObject, PetscObjectId, Pet
 PETSC_EXTERN PetscErrorCode PetscMemoryGetCurrentUsage(PetscLogDouble *);
 PETSC_EXTERN PetscErrorCode PetscMemoryGetMaximumUsage(PetscLogDouble *);
 PETSC_EXTERN PetscErrorCode PetscMemorySetGetMaximumUsage(void);
+PETSC_EXTERN PetscErrorCode PetscMemoryGetNUMAPages(PetscInt, PetscInt *, PetscLogDouble[]);
 PETSC_EXTERN PetscErrorCode PetscMemoryTrace(const char[]);
 
 PETSC_EXTERN PetscErrorCode PetscSleep(PetscReal);
@@ -2432,6 +2433,7 @@ PETSC_EXTERN PetscErrorCode PetscCommBuildTwoSidedSetType(MPI_Comm, PetscBuildTw
 PETSC_EXTERN PetscErrorCode PetscCommBuildTwoSidedGetType(MPI_Comm, PetscBuildTwoSidedType *);
 
 PETSC_EXTERN PetscErrorCode PetscSSEIsEnabled(MPI_Comm, PetscBool *, PetscBool *);
+PETSC_EXTERN PetscErrorCode PetscCPUFeatureIsEnabled(PetscCPUFeature, PetscBool *);
 
 PETSC_EXTERN MPI_Comm PetscObjectComm(PetscObject);
 
@@ -931,6 +931,32 @@ typedef enum {
 } PetscBuildTwoSidedType;
 PETSC_EXTERN const char *const PetscBuildTwoSidedTypes[];
 
+/*E
+   PetscCPUFeature - instruction set extension of the processor that hand-vectorized kernels can use
+
+   Values:
++  `PETSC_CPU_FEATURE_AVX`      - x86 Advanced Vector Extensions
+.  `PETSC_CPU_FEATURE_AVX2`     - x86 AVX2
+.  `PETSC_CPU_FEATURE_FMA`      - x86 fused multiply-add (FMA3)
+.  `PETSC_CPU_FEATURE_AVX512F`  - x86 AVX-512 foundation
+.  `PETSC_CPU_FEATURE_AVX512VL` - x86 AVX-512 vector length extensions
+-  `PETSC_CPU_FEATURE_SVE`      - ARM Scalable Vector Extension
+
+   Level: developer
+
+.seealso: `PetscCPUFeatureIsEnabled()`, `PetscSSEIsEnabled()`
+E*/
+typedef enum {
+  PETSC_CPU_FEATURE_AVX,
+  PETSC_CPU_FEATURE_AVX2,
+  PETSC_CPU_FEATURE_FMA,
+  PETSC_CPU_FEATURE_AVX512F,
+  PETSC_CPU_FEATURE_AVX512VL,
+  PETSC_CPU_FEATURE_SVE
+  /* Updates here must be accompanied by updates in the string array in sseenabled.c */
+} PetscCPUFeature;
+PETSC_EXTERN const char *const PetscCPUFeatures[];
+
 /*E
   InsertMode - How the entries are combined with the current values in the vectors or matrices
 
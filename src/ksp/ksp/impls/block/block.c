@@ -0,0 +1,244 @@
+/*
+    Routines shared by the block Krylov methods KSPBLOCKCG and KSPBLOCKGMRES
+*/
+#include <../src/ksp/ksp/impls/block/blockimpl.h>
+
+PetscErrorCode KSPBlockCreate_Private(KSP ksp)
+{
+  KSP_Block *blk = (KSP_Block *)ksp->data;
+
+  PetscFunctionBegin;
+  blk->tol = PETSC_SMALL;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPBlockReset_Private(KSP ksp)
+{
+  KSP_Block *blk = (KSP_Block *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(MatDestroy(&blk->AP));
+  PetscCall(MatDestroy(&blk->P));
+  PetscCall(PetscFree2(blk->norms, blk->norms0));
+  blk->p = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPBlockSetFromOptions_Private(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_Block *blk = (KSP_Block *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscOptionsReal("-ksp_block_deflation_tol", "Threshold on the eigenvalues of the scaled Gram matrix of a block below which a direction is discarded", "None", blk->tol, &blk->tol, NULL));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPBlockView_Private(KSP ksp, PetscViewer viewer)
+{
+  KSP_Block *blk = (KSP_Block *)ksp->data;
+  PetscBool  iascii;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &iascii));
+  if (iascii) PetscCall(PetscViewerASCIIPrintf(viewer, "  deflation tolerance %g\n", (double)blk->tol));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Makes sure that the n work matrices, the input block of the operator and the norms are allocated for the number of columns of B;
+   realloc is set when they were (re)created, so that the implementation can update its own work data
+*/
+PetscErrorCode KSPBlockSetUpWork_Private(KSP ksp, Mat B, PetscInt n, Mat work[], PetscBool *realloc)
+{
+  KSP_Block *blk = (KSP_Block *)ksp->data;
+  PetscInt   p;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetSize(B, NULL, &p));
+  *realloc = (PetscBool)(p != blk->p);
+  if (*realloc) {
+    for (PetscInt i = 0; i < n; i++) PetscCall(MatDestroy(work + i));
+    PetscCall(KSPBlockReset_Private(ksp));
+    for (PetscInt i = 0; i < n; i++) PetscCall(MatDuplicate(B, MAT_DO_NOT_COPY_VALUES, work + i));
+    PetscCall(MatDuplicate(B, MAT_DO_NOT_COPY_VALUES, &blk->P));
+    PetscCall(PetscMalloc2(p, &blk->norms, p, &blk->norms0));
+    blk->p = p;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* AP <- A P, the symbolic product is reused as long as the operator is the same */
+PetscErrorCode KSPBlockMatMult_Private(KSP ksp)
+{
+  KSP_Block *blk = (KSP_Block *)ksp->data;
+  Mat        A, pA = NULL, pB = NULL;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetOperators(ksp->pc, &A, NULL));
+  if (blk->AP) PetscCall(MatProductGetMats(blk->AP, &pA, &pB, NULL));
+  if (pA != A || pB != blk->P) {
+    PetscCall(MatDestroy(&blk->AP));
+    PetscCall(MatProductCreate(A, blk->P, NULL, &blk->AP));
+    PetscCall(MatProductSetType(blk->AP, MATPRODUCT_AB));
+    PetscCall(MatProductSetFromOptions(blk->AP));
+    PetscCall(MatProductSymbolic(blk->AP));
+  }
+  PetscCall(MatProductNumeric(blk->AP));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* C <- alpha op(A) B + beta C on the local rows, with op(A) = A or A^H according to transa, the caller performs the reduction if any */
+PetscErrorCode KSPBlockGemm_Private(const char *transa, PetscInt m, PetscInt n, PetscInt k, PetscScalar alpha, const PetscScalar A[], PetscInt lda, const PetscScalar B[], PetscInt ldb, PetscScalar beta, PetscScalar C[], PetscInt ldc)
+{
+  PetscBLASInt bm, bn, bk, blda, bldb, bldc;
+
+  PetscFunctionBegin;
+  if (!m || !n) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscBLASIntCast(m, &bm));
+  PetscCall(PetscBLASIntCast(n, &bn));
+  PetscCall(PetscBLASIntCast(k, &bk));
+  PetscCall(PetscBLASIntCast(PetscMax(lda, 1), &blda));
+  PetscCall(PetscBLASIntCast(PetscMax(ldb, 1), &bldb));
+  PetscCall(PetscBLASIntCast(PetscMax(ldc, 1), &bldc));
+  PetscCallBLAS("BLASgemm", BLASgemm_(transa, "N", &bm, &bn, &bk, &alpha, A, &blda, B, &bldb, &beta, C, &bldc));
+  PetscCall(PetscLogFlops(2.0 * m * n * k));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* local part d[j] <- X(:, j)^H Y(:, j) of the inner products of the p columns of X and Y */
+PetscErrorCode KSPBlockColumnDot_Private(PetscInt n, PetscInt p, const PetscScalar X[], PetscInt ldx, const PetscScalar Y[], PetscInt ldy, PetscScalar d[])
+{
+  PetscFunctionBegin;
+  for (PetscInt j = 0; j < p; j++) {
+    PetscScalar sum = 0.0;
+
+    for (PetscInt i = 0; i < n; i++) sum += PetscConj(X[i + j * ldx]) * Y[i + j * ldy];
+    d[j] = sum;
+  }
+  PetscCall(PetscLogFlops(2.0 * n * p));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Given the Gram matrix G = W^H W of a block W of p columns, and d[] the squared norms used to scale its columns, computes the number k of
+   directions kept, T (p x k) such that W T has orthonormal columns and, if S is not NULL, S (k x p) such that W = (W T) S up to the discarded
+   directions. The scaled Gram matrix D G D with D = diag(d)^{-1/2} is diagonalized, and its eigenvalues below the deflation tolerance
+   correspond to directions numerically dependent on the other ones, which are discarded. G is overwritten.
+*/
+PetscErrorCode KSPBlockOrthonormalize_Private(KSP ksp, PetscInt p, PetscScalar G[], const PetscReal d[], PetscInt *k, PetscScalar T[], PetscScalar S[])
+{
+  KSP_Block   *blk = (KSP_Block *)ksp->data;
+  PetscReal   *w, *D;
+  PetscScalar *work;
+  PetscBLASInt bp, lwork, info;
+#if defined(PETSC_USE_COMPLEX)
+  PetscReal *rwork;
+#endif
+
+  PetscFunctionBegin;
+  *k = 0;
+  if (!p) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscBLASIntCast(p, &bp));
+  lwork = 3 * bp;
+  PetscCall(PetscMalloc3(p, &w, p, &D, lwork, &work));
+  for (PetscInt i = 0; i < p; i++) D[i] = d[i] > 0.0 ? 1.0 / PetscSqrtReal(d[i]) : 0.0;
+  for (PetscInt j = 0; j < p; j++)
+    for (PetscInt i = 0; i < p; i++) G[i + j * p] *= D[i] * D[j];
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+#if defined(PETSC_USE_COMPLEX)
+  PetscCall(PetscMalloc1(3 * p, &rwork));
+  PetscCallBLAS("LAPACKsyev", LAPACKsyev_("V", "L", &bp, G, &bp, w, work, &lwork, rwork, &info));
+  PetscCall(PetscFree(rwork));
+#else
+  PetscCallBLAS("LAPACKsyev", LAPACKsyev_("V", "L", &bp, G, &bp, w, work, &lwork, &info));
+#endif
+  PetscCall(PetscFPTrapPop());
+  if (!info) {
+    /* the eigenvalues are in ascending order, keep the largest ones first */
+    for (PetscInt i = p - 1; i >= 0 && w[i] > blk->tol; i--) {
+      const PetscReal sq = PetscSqrtReal(w[i]);
+
+      for (PetscInt j = 0; j < p; j++) T[j + *k * p] = D[j] * G[j + i * p] / sq;
+      if (S)
+        for (PetscInt j = 0; j < p; j++) S[*k + j * p] = D[j] > 0.0 ? sq * PetscConj(G[j + i * p]) / D[j] : 0.0;
+      (*k)++;
+    }
+  } else PetscCall(PetscInfo(ksp, "Eigendecomposition of the Gram matrix of the block failed with info %" PetscBLASInt_FMT ", all its directions are discarded\n", info));
+  PetscCall(PetscFree3(w, D, work));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Updates ksp->rnorm with the largest residual norm of the columns, stored in norms[], calls the monitors and sets ksp->reason: with a single
+   right-hand side from KSPSolve() the convergence test of the KSP is used, otherwise every column must satisfy the relative or absolute tolerance
+*/
+PetscErrorCode KSPBlockMonitorConverged_Private(KSP ksp)
+{
+  KSP_Block *blk = (KSP_Block *)ksp->data;
+  PetscReal  max = 0.0;
+  PetscInt   nrtol = 0, natol = 0;
+
+  PetscFunctionBegin;
+  if (ksp->normtype == KSP_NORM_NONE) {
+    PetscCall(KSPMonitor(ksp, ksp->its, 0.0));
+    if (blk->vecsolve) PetscCall((*ksp->converged)(ksp, ksp->its, 0.0, &ksp->reason, ksp->cnvP));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  for (PetscInt j = 0; j < blk->p; j++) max = PetscMax(max, blk->norms[j]);
+  if (!ksp->its)
+    for (PetscInt j = 0; j < blk->p; j++) blk->norms0[j] = blk->norms[j];
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->rnorm = max;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  PetscCall(KSPLogResidualHistory(ksp, max));
+  PetscCall(KSPMonitor(ksp, ksp->its, max));
+  if (blk->vecsolve) {
+    PetscCall((*ksp->converged)(ksp, ksp->its, max, &ksp->reason, ksp->cnvP));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  if (PetscIsInfOrNanReal(max)) {
+    ksp->reason = KSP_DIVERGED_NANORINF;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  if (ksp->its < ksp->min_it) PetscFunctionReturn(PETSC_SUCCESS);
+  for (PetscInt j = 0; j < blk->p; j++) {
+    if (blk->norms[j] < ksp->abstol) natol++;
+    else if (blk->norms[j] <= ksp->rtol * blk->norms0[j]) nrtol++;
+    else if (ksp->its && blk->norms[j] >= ksp->divtol * blk->norms0[j]) {
+      PetscCall(PetscInfo(ksp, "Column %" PetscInt_FMT " has diverged, residual norm %g, initial residual norm %g at iteration %" PetscInt_FMT "\n", j, (double)blk->norms[j], (double)blk->norms0[j], ksp->its));
+      ksp->reason = KSP_DIVERGED_DTOL;
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+  }
+  if (natol + nrtol == blk->p) {
+    ksp->reason = nrtol ? KSP_CONVERGED_RTOL : KSP_CONVERGED_ATOL;
+    PetscCall(PetscInfo(ksp, "All %" PetscInt_FMT " columns have converged, largest residual norm %g at iteration %" PetscInt_FMT "\n", blk->p, (double)max, ksp->its));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* KSPSolve() with a single right-hand side, wrapped in MATDENSE with one column, through the KSPMatSolve() implementation */
+PetscErrorCode KSPBlockSolveVec_Private(KSP ksp)
+{
+  KSP_Block         *blk = (KSP_Block *)ksp->data;
+  Mat                B, X;
+  const PetscScalar *b;
+  PetscScalar       *x;
+  PetscInt           n, N;
+
+  PetscFunctionBegin;
+  PetscCall(VecGetLocalSize(ksp->vec_rhs, &n));
+  PetscCall(VecGetSize(ksp->vec_rhs, &N));
+  PetscCall(VecGetArrayRead(ksp->vec_rhs, &b));
+  PetscCall(VecGetArray(ksp->vec_sol, &x));
+  PetscCall(MatCreateDense(PetscObjectComm((PetscObject)ksp), n, PETSC_DECIDE, N, 1, (PetscScalar *)b, &B));
+  PetscCall(MatCreateDense(PetscObjectComm((PetscObject)ksp), n, PETSC_DECIDE, N, 1, x, &X));
+  blk->vecsolve = PETSC_TRUE;
+  PetscUseTypeMethod(ksp, matsolve, B, X);
+  blk->vecsolve = PETSC_FALSE;
+  PetscCall(MatDestroy(&X));
+  PetscCall(MatDestroy(&B));
+  PetscCall(VecRestoreArray(ksp->vec_sol, &x));
+  PetscCall(VecRestoreArrayRead(ksp->vec_rhs, &b));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,272 @@
+/*
+    Block conjugate gradient: the columns of the block of residuals are iterated together, with the search directions made A-orthonormal
+    at every iteration by diagonalizing their Gram matrix, which discards the directions that have become numerically dependent
+    when some columns converge or the right-hand sides are not independent
+*/
+#include <../src/ksp/ksp/impls/block/blockimpl.h>
+
+typedef struct {
+  KSP_Block    block;   /* must be first */
+  Mat          work[4]; /* residuals R, preconditioned residuals Z, A-orthonormal search directions and their product with A */
+  PetscScalar *G;       /* Gram matrix of the directions and their inner products with the residuals */
+  PetscScalar *H;       /* inner products of the directions with the preconditioned residuals, followed by the norms */
+  PetscScalar *T;       /* change of basis to the A-orthonormal directions */
+  PetscScalar *alpha;   /* step length */
+} KSP_BlockCG;
+
+static PetscErrorCode KSPSetUp_BlockCG(KSP ksp)
+{
+  PetscFunctionBegin;
+  /* the work data depends on the number of columns of the block and is allocated by the first solve */
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPReset_BlockCG(KSP ksp)
+{
+  KSP_BlockCG *cg = (KSP_BlockCG *)ksp->data;
+
+  PetscFunctionBegin;
+  for (PetscInt i = 0; i < 4; i++) PetscCall(MatDestroy(cg->work + i));
+  PetscCall(PetscFree4(cg->G, cg->H, cg->T, cg->alpha));
+  PetscCall(KSPBlockReset_Private(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* local part of the inner products giving the norms of the p columns of the residuals according to the norm type */
+static PetscErrorCode KSPBlockCGNorms_Private(KSP ksp, PetscInt n, PetscInt p, const PetscScalar r[], const PetscScalar z[], PetscInt ld, PetscScalar d[])
+{
+  PetscFunctionBegin;
+  switch (ksp->normtype) {
+  case KSP_NORM_PRECONDITIONED:
+    PetscCall(KSPBlockColumnDot_Private(n, p, z, ld, z, ld, d));
+    break;
+  case KSP_NORM_UNPRECONDITIONED:
+    PetscCall(KSPBlockColumnDot_Private(n, p, r, ld, r, ld, d));
+    break;
+  case KSP_NORM_NATURAL:
+    PetscCall(KSPBlockColumnDot_Private(n, p, r, ld, z, ld, d));
+    break;
+  default:
+    for (PetscInt j = 0; j < p; j++) d[j] = 0.0;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPMatSolve_BlockCG(KSP ksp, Mat B, Mat X)
+{
+  KSP_BlockCG       *cg  = (KSP_BlockCG *)ksp->data;
+  KSP_Block         *blk = &cg->block;
+  MPI_Comm           comm;
+  Mat                R, Z, P, Q;
+  PetscScalar       *x, *r, *pp, *q, *pr, *G, *F, *H;
+  const PetscScalar *cr, *cz, *cpr, *cap;
+  PetscReal         *d;
+  PetscInt           n, p, k, ld, ldap, ldx;
+  PetscBool          realloc;
+
+  PetscFunctionBegin;
+  PetscCheck(!ksp->transpose_solve, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Transpose solves are not supported by KSPBLOCKCG");
+  PetscCall(PetscObjectGetComm((PetscObject)ksp, &comm));
+  PetscCall(KSPBlockSetUpWork_Private(ksp, B, 4, cg->work, &realloc));
+  p = blk->p;
+  if (realloc) {
+    PetscCall(PetscFree4(cg->G, cg->H, cg->T, cg->alpha));
+    PetscCall(PetscMalloc4(2 * p * p, &cg->G, p * p + p, &cg->H, p * p, &cg->T, p * p, &cg->alpha));
+  }
+  R = cg->work[0];
+  Z = cg->work[1];
+  P = cg->work[2];
+  Q = cg->work[3];
+  G = cg->G;
+  F = cg->G + p * p;
+  H = cg->H;
+  d = blk->norms;
+  PetscCall(MatGetLocalSize(B, &n, NULL));
+  PetscCall(MatDenseGetLDA(R, &ld));
+  PetscCall(MatDenseGetLDA(X, &ldx));
+
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->its    = 0;
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+
+  /* R <- B - A X, Z <- M R */
+  if (!ksp->guess_zero) {
+    PetscCall(MatCopy(X, blk->P, SAME_NONZERO_PATTERN));
+    PetscCall(KSPBlockMatMult_Private(ksp));
+    PetscCall(MatCopy(B, R, SAME_NONZERO_PATTERN));
+    PetscCall(MatAXPY(R, -1.0, blk->AP, SAME_NONZERO_PATTERN));
+  } else {
+    PetscCall(MatZeroEntries(X));
+    PetscCall(MatCopy(B, R, SAME_NONZERO_PATTERN));
+  }
+  PetscCall(KSP_PCMatApply(ksp, R, Z));
+  PetscCall(MatDenseGetArrayRead(R, &cr));
+  PetscCall(MatDenseGetArrayRead(Z, &cz));
+  PetscCall(KSPBlockCGNorms_Private(ksp, n, p, cr, cz, ld, H));
+  PetscCall(MatDenseRestoreArrayRead(Z, &cz));
+  PetscCall(MatDenseRestoreArrayRead(R, &cr));
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, H, p, MPIU_SCALAR, MPIU_SUM, comm));
+  for (PetscInt j = 0; j < p; j++) d[j] = PetscSqrtReal(PetscAbsScalar(H[j]));
+  PetscCall(KSPBlockMonitorConverged_Private(ksp));
+  PetscCall(MatCopy(Z, blk->P, SAME_NONZERO_PATTERN));
+
+  while (!ksp->reason && ksp->its < ksp->max_it) {
+    /* G <- P^H A P and F <- P^H R with a single reduction */
+    PetscCall(KSPBlockMatMult_Private(ksp));
+    PetscCall(MatDenseGetLDA(blk->AP, &ldap));
+    PetscCall(MatDenseGetArrayRead(blk->P, &cpr));
+    PetscCall(MatDenseGetArrayRead(blk->AP, &cap));
+    PetscCall(MatDenseGetArrayRead(R, &cr));
+    PetscCall(KSPBlockGemm_Private("C", p, p, n, 1.0, cpr, ld, cap, ldap, 0.0, G, p));
+    PetscCall(KSPBlockGemm_Private("C", p, p, n, 1.0, cpr, ld, cr, ld, 0.0, F, p));
+    PetscCall(MatDenseRestoreArrayRead(R, &cr));
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, G, 2 * p * p, MPIU_SCALAR, MPIU_SUM, comm));
+    for (PetscInt j = 0; j < p && !ksp->reason; j++) {
+      d[j] = PetscRealPart(G[j * (p + 1)]);
+      if (PetscIsInfOrNanReal(d[j])) ksp->reason = KSP_DIVERGED_NANORINF;
+      else if (d[j] < 0.0) {
+        PetscCall(PetscInfo(ksp, "Negative curvature %g of direction %" PetscInt_FMT "\n", (double)d[j], j));
+        ksp->reason = KSP_DIVERGED_INDEFINITE_MAT;
+      }
+    }
+    k = 0;
+    if (!ksp->reason) PetscCall(KSPBlockOrthonormalize_Private(ksp, p, G, d, &k, cg->T, NULL));
+    if (!ksp->reason && !k) {
+      PetscCall(PetscInfo(ksp, "All the search directions are numerically zero while the residuals have not converged\n"));
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+    }
+    if (ksp->reason) {
+      PetscCall(MatDenseRestoreArrayRead(blk->AP, &cap));
+      PetscCall(MatDenseRestoreArrayRead(blk->P, &cpr));
+      break;
+    }
+    /* P <- P T and Q <- A P T are A-orthonormal, then alpha <- T^H F = P^H R */
+    PetscCall(MatDenseGetArrayWrite(P, &pp));
+    PetscCall(MatDenseGetArrayWrite(Q, &q));
+    PetscCall(KSPBlockGemm_Private("N", n, k, p, 1.0, cpr, ld, cg->T, p, 0.0, pp, ld));
+    PetscCall(KSPBlockGemm_Private("N", n, k, p, 1.0, cap, ldap, cg->T, p, 0.0, q, ld));
+    PetscCall(MatDenseRestoreArrayRead(blk->AP, &cap));
+    PetscCall(MatDenseRestoreArrayRead(blk->P, &cpr));
+    PetscCall(KSPBlockGemm_Private("C", k, p, p, 1.0, cg->T, p, F, p, 0.0, cg->alpha, k));
+
+    /* X <- X + P alpha, R <- R - Q alpha, Z <- M R */
+    PetscCall(MatDenseGetArray(X, &x));
+    PetscCall(KSPBlockGemm_Private("N", n, p, k, 1.0, pp, ld, cg->alpha, k, 1.0, x, ldx));
+    PetscCall(MatDenseRestoreArray(X, &x));
+    PetscCall(MatDenseGetArray(R, &r));
+    PetscCall(KSPBlockGemm_Private("N", n, p, k, -1.0, q, ld, cg->alpha, k, 1.0, r, ld));
+    PetscCall(MatDenseRestoreArray(R, &r));
+    PetscCall(KSP_PCMatApply(ksp, R, Z));
+
+    /* H <- Q^H Z and the norms of the residuals with a single reduction */
+    PetscCall(MatDenseGetArrayRead(R, &cr));
+    PetscCall(MatDenseGetArrayRead(Z, &cz));
+    PetscCall(KSPBlockGemm_Private("C", k, p, n, 1.0, q, ld, cz, ld, 0.0, H, k));
+    PetscCall(KSPBlockCGNorms_Private(ksp, n, p, cr, cz, ld, H + k * p));
+    PetscCall(MatDenseRestoreArrayRead(Z, &cz));
+    PetscCall(MatDenseRestoreArrayRead(R, &cr));
+    PetscCall(MatDenseRestoreArrayWrite(Q, &q));
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, H, k * p + p, MPIU_SCALAR, MPIU_SUM, comm));
+    for (PetscInt j = 0; j < p; j++) d[j] = PetscSqrtReal(PetscAbsScalar(H[k * p + j]));
+    PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+    ksp->its++;
+    PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+    PetscCall(KSPBlockMonitorConverged_Private(ksp));
+
+    /* new directions Z - P H, A-orthogonal to the previous ones */
+    if (!ksp->reason) {
+      PetscCall(MatCopy(Z, blk->P, SAME_NONZERO_PATTERN));
+      PetscCall(MatDenseGetArray(blk->P, &pr));
+      PetscCall(KSPBlockGemm_Private("N", n, p, k, -1.0, pp, ld, H, k, 1.0, pr, ld));
+      PetscCall(MatDenseRestoreArray(blk->P, &pr));
+    }
+    PetscCall(MatDenseRestoreArrayWrite(P, &pp));
+  }
+  if (!ksp->reason) ksp->reason = KSP_DIVERGED_ITS;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSolve_BlockCG(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPBlockSolveVec_Private(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPDestroy_BlockCG(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPReset_BlockCG(ksp));
+  PetscCall(KSPDestroyDefault(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetFromOptions_BlockCG(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  PetscFunctionBegin;
+  PetscOptionsHeadBegin(PetscOptionsObject, "KSP block CG options");
+  PetscCall(KSPBlockSetFromOptions_Private(ksp, PetscOptionsObject));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPView_BlockCG(KSP ksp, PetscViewer viewer)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPBlockView_Private(ksp, viewer));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   KSPBLOCKCG - The block conjugate gradient method {cite}`o1980block`, {cite}`ji2017breakdown`, which solves for all the columns of a block of right-hand sides
+   given to `KSPMatSolve()` at once
+
+   Options Database Key:
+.  -ksp_block_deflation_tol <tol> - threshold on the eigenvalues of the scaled Gram matrix of the search directions below which a direction is discarded
+
+   Level: intermediate
+
+   Notes:
+   The operator is applied to the whole block of search directions with `MatMatMult()`, the preconditioner with `PCMatApply()`, and the inner products
+   are computed with dense matrix-matrix products on the local rows followed by one reduction, two per iteration as for `KSPCG`. The search space grows
+   by as many directions per iteration as there are columns, so fewer iterations than with `KSPCG` are usually needed for each column.
+
+   The search directions are made A-orthonormal at each iteration, and those which are numerically dependent, for example when some columns have
+   converged or when the right-hand sides are linearly dependent, are discarded.
+
+   The operator and the preconditioner must be symmetric (Hermitian in complex) positive definite. Only left preconditioning is supported.
+
+   The residual norm reported to the monitors is the largest norm of the columns. Each column has converged when it satisfies the relative tolerance,
+   with respect to its initial residual norm, or the absolute tolerance, and the solve stops when all the columns have converged; a custom convergence
+   test set with `KSPSetConvergenceTest()` is only used by `KSPSolve()`, which solves with a single column.
+
+   `KSPMatSolveTranspose()` is not supported.
+
+.seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPCG`, `KSPBLOCKGMRES`, `KSPMatSolve()`, `KSPSetMatSolveBatchSize()`, `KSPHPDDM`
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_BlockCG(KSP ksp)
+{
+  KSP_BlockCG *cg;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&cg));
+  ksp->data = (void *)cg;
+
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_PRECONDITIONED, PC_LEFT, 3));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_UNPRECONDITIONED, PC_LEFT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NATURAL, PC_LEFT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_LEFT, 1));
+
+  ksp->ops->setup          = KSPSetUp_BlockCG;
+  ksp->ops->solve          = KSPSolve_BlockCG;
+  ksp->ops->matsolve       = KSPMatSolve_BlockCG;
+  ksp->ops->reset          = KSPReset_BlockCG;
+  ksp->ops->destroy        = KSPDestroy_BlockCG;
+  ksp->ops->view           = KSPView_BlockCG;
+  ksp->ops->setfromoptions = KSPSetFromOptions_BlockCG;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+  PetscCall(KSPBlockCreate_Private(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,423 @@
+/*
+    Block GMRES: the Krylov basis is extended at each iteration by a block of as many vectors as there are columns, the product of the
+    preconditioned operator with the last block of the basis orthogonalized against all the previous ones. The Hessenberg matrix then has
+    a block of subdiagonals, which is triangularized one block column at a time with Householder reflectors, and the least-squares problem
+    is solved for all the columns at once. The directions of a new block that are numerically dependent on the basis are discarded, so the
+    width of the blocks of the basis may decrease within a cycle.
+*/
+#include <../src/ksp/ksp/impls/block/blockimpl.h>
+
+#define BLOCKGMRES_DEFAULT_MAXK 30
+
+#if defined(PETSC_USE_COMPLEX)
+  #define BLOCKGMRES_TRANS "C"
+#else
+  #define BLOCKGMRES_TRANS "T"
+#endif
+
+typedef struct {
+  KSP_Block    block;   /* must be first */
+  PetscInt     max_k;   /* restart, in number of blocks */
+  PetscInt     nv;      /* restart used to allocate the data below */
+  PetscInt     n;       /* local length of the basis vectors */
+  Mat          work[2]; /* residuals and products of the preconditioned operator with a block of the basis */
+  PetscScalar *V;       /* orthonormal basis, its vectors are stored contiguously */
+  PetscInt    *off;     /* offsets of the blocks in the basis */
+  PetscScalar *H;       /* Hessenberg matrix, overwritten by its triangular factor and the Householder reflectors */
+  PetscScalar *g;       /* right-hand sides of the least-squares problems, then their solutions */
+  PetscScalar *tau, *qrwork, *red, *S;
+  PetscReal   *d; /* norms of the columns of a block and diagonal of a Gram matrix */
+  PetscInt     lwork;
+} KSP_BlockGMRES;
+
+static PetscErrorCode KSPSetUp_BlockGMRES(KSP ksp)
+{
+  PetscFunctionBegin;
+  /* the work data depends on the number of columns of the block and is allocated by the first solve */
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPBlockGMRESFree_Private(KSP ksp)
+{
+  KSP_BlockGMRES *gm = (KSP_BlockGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree2(gm->V, gm->off));
+  PetscCall(PetscFree7(gm->H, gm->g, gm->tau, gm->qrwork, gm->red, gm->S, gm->d));
+  gm->nv = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPReset_BlockGMRES(KSP ksp)
+{
+  KSP_BlockGMRES *gm = (KSP_BlockGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  for (PetscInt i = 0; i < 2; i++) PetscCall(MatDestroy(gm->work + i));
+  PetscCall(KSPBlockGMRESFree_Private(ksp));
+  PetscCall(KSPBlockReset_Private(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Orthonormalizes the kin columns of W, of leading dimension ldw, against the first off vectors of the basis, by two passes of block
+   classical Gram-Schmidt, then within themselves by two passes of the eigendecomposition of their Gram matrix. The orthonormal vectors
+   are stored in the basis after the first off ones and their number returned in kout. On output, with W the input block,
+   W = V(:, 0:off-1) C + V(:, off:off+kout-1) S up to the discarded directions, where C and S are stored with leading dimension ldc.
+   The norms of the columns of W are returned in d.
+*/
+static PetscErrorCode KSPBlockGMRESOrthonormalize_Private(KSP ksp, PetscInt off, PetscInt kin, PetscScalar W[], PetscInt ldw, PetscScalar C[], PetscScalar S[], PetscInt ldc, PetscInt *kout)
+{
+  KSP_BlockGMRES *gm = (KSP_BlockGMRES *)ksp->data;
+  MPI_Comm        comm;
+  PetscInt        n = gm->n, ldv = PetscMax(gm->n, 1), p = gm->block.p, k1, k2;
+  PetscScalar    *V = gm->V, *Vk = gm->V + off * ldv, *red = gm->red, *G, *T1 = gm->S, *S1 = gm->S + p * p, *T2 = gm->S + 2 * p * p, *S2 = gm->S + 3 * p * p;
+  PetscReal      *d = gm->d;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogEventBegin(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
+  PetscCall(PetscObjectGetComm((PetscObject)ksp, &comm));
+  G = red + off * kin;
+  if (off) {
+    /* first pass, with the norms of the columns used to scale the Gram matrix below */
+    PetscCall(KSPBlockGemm_Private("C", off, kin, n, 1.0, V, ldv, W, ldw, 0.0, red, off));
+    PetscCall(KSPBlockColumnDot_Private(n, kin, W, ldw, W, ldw, G));
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, red, off * kin + kin, MPIU_SCALAR, MPIU_SUM, comm));
+    for (PetscInt j = 0; j < kin; j++) {
+      d[j] = PetscRealPart(G[j]);
+      PetscCall(PetscArraycpy(C + j * ldc, red + j * off, off));
+    }
+    PetscCall(KSPBlockGemm_Private("N", n, kin, off, -1.0, V, ldv, red, off, 1.0, W, ldw));
+    /* second pass, with the Gram matrix of the projected block from the same reduction */
+    PetscCall(KSPBlockGemm_Private("C", off, kin, n, 1.0, V, ldv, W, ldw, 0.0, red, off));
+    PetscCall(KSPBlockGemm_Private("C", kin, kin, n, 1.0, W, ldw, W, ldw, 0.0, G, kin));
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, red, off * kin + kin * kin, MPIU_SCALAR, MPIU_SUM, comm));
+    PetscCall(KSPBlockGemm_Private("N", n, kin, off, -1.0, V, ldv, red, off, 1.0, W, ldw));
+    PetscCall(KSPBlockGemm_Private("C", kin, kin, off, -1.0, red, off, red, off, 1.0, G, kin));
+    for (PetscInt j = 0; j < kin; j++)
+      for (PetscInt i = 0; i < off; i++) C[i + j * ldc] += red[i + j * off];
+  } else {
+    PetscCall(KSPBlockGemm_Private("C", kin, kin, n, 1.0, W, ldw, W, ldw, 0.0, G, kin));
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, G, kin * kin, MPIU_SCALAR, MPIU_SUM, comm));
+    for (PetscInt j = 0; j < kin; j++) d[j] = PetscRealPart(G[j * (kin + 1)]);
+  }
+
+  /* W T1 has orthonormal columns up to rounding errors, which the second eigendecomposition removes */
+  PetscCall(KSPBlockOrthonormalize_Private(ksp, kin, G, d, &k1, T1, S1));
+  k2 = 0;
+  if (k1) {
+    PetscCall(KSPBlockGemm_Private("N", n, k1, kin, 1.0, W, ldw, T1, kin, 0.0, Vk, ldv));
+    PetscCall(KSPBlockGemm_Private("C", k1, k1, n, 1.0, Vk, ldv, Vk, ldv, 0.0, G, k1));
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, G, k1 * k1, MPIU_SCALAR, MPIU_SUM, comm));
+    for (PetscInt j = 0; j < k1; j++) d[p + j] = PetscRealPart(G[j * (k1 + 1)]);
+    PetscCall(KSPBlockOrthonormalize_Private(ksp, k1, G, d + p, &k2, T2, S2));
+    PetscCall(KSPBlockGemm_Private("N", n, k2, k1, 1.0, Vk, ldv, T2, k1, 0.0, W, ldw));
+    for (PetscInt j = 0; j < k2; j++) PetscCall(PetscArraycpy(Vk + j * ldv, W + j * ldw, n));
+    PetscCall(KSPBlockGemm_Private("N", k2, kin, k1, 1.0, S2, k1, S1, kin, 0.0, S, ldc));
+  }
+  for (PetscInt j = 0; j < kin; j++) d[j] = PetscSqrtReal(PetscMax(d[j], 0.0));
+  *kout = k2;
+  PetscCall(PetscLogEventEnd(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Applies the reflectors of the previous block columns to the block column j of the Hessenberg matrix, then triangularizes it and applies
+   its own reflectors to the right-hand sides of the least-squares problems
+*/
+static PetscErrorCode KSPBlockGMRESUpdateQR_Private(KSP ksp, PetscInt j)
+{
+  KSP_BlockGMRES *gm  = (KSP_BlockGMRES *)ksp->data;
+  PetscInt        ldh = (gm->max_k + 1) * gm->block.p, *off = gm->off;
+  PetscBLASInt    bm, bn, bk, bldh, bp, lwork, info;
+
+  PetscFunctionBegin;
+  PetscCall(PetscBLASIntCast(ldh, &bldh));
+  PetscCall(PetscBLASIntCast(gm->block.p, &bp));
+  PetscCall(PetscBLASIntCast(gm->lwork, &lwork));
+  PetscCall(PetscBLASIntCast(off[j + 1] - off[j], &bn));
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+  for (PetscInt i = 0; i < j; i++) {
+    PetscCall(PetscBLASIntCast(off[i + 2] - off[i], &bm));
+    PetscCall(PetscBLASIntCast(off[i + 1] - off[i], &bk));
+    PetscCallBLAS("LAPACKormqr", LAPACKormqr_("L", BLOCKGMRES_TRANS, &bm, &bn, &bk, gm->H + off[i] + off[i] * ldh, &bldh, gm->tau + off[i], gm->H + off[i] + off[j] * ldh, &bldh, gm->qrwork, &lwork, &info));
+    PetscCheck(!info, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine ormqr %" PetscBLASInt_FMT, info);
+  }
+  PetscCall(PetscBLASIntCast(off[j + 2] - off[j], &bm));
+  PetscCallBLAS("LAPACKgeqrf", LAPACKgeqrf_(&bm, &bn, gm->H + off[j] + off[j] * ldh, &bldh, gm->tau + off[j], gm->qrwork, &lwork, &info));
+  PetscCheck(!info, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine geqrf %" PetscBLASInt_FMT, info);
+  PetscCallBLAS("LAPACKormqr", LAPACKormqr_("L", BLOCKGMRES_TRANS, &bm, &bp, &bn, gm->H + off[j] + off[j] * ldh, &bldh, gm->tau + off[j], gm->g + off[j], &bldh, gm->qrwork, &lwork, &info));
+  PetscCheck(!info, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine ormqr %" PetscBLASInt_FMT, info);
+  PetscCall(PetscFPTrapPop());
+  PetscCall(PetscLogFlops(4.0 * (off[j + 2] - off[j]) * (off[j + 1] - off[j]) * (off[j + 1] - off[j] + gm->block.p)));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* X <- X + V Y, with Y the solution of the least-squares problems of the first m rows and V preconditioned when on the right */
+static PetscErrorCode KSPBlockGMRESUpdateSolution_Private(KSP ksp, PetscInt m, Mat X)
+{
+  KSP_BlockGMRES *gm = (KSP_BlockGMRES *)ksp->data;
+  PetscInt        p = gm->block.p, ldh = (gm->max_k + 1) * p, ldw;
+  PetscScalar    *w, one = 1.0;
+  PetscBLASInt    bm, bp, bldh;
+
+  PetscFunctionBegin;
+  if (!m) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscBLASIntCast(m, &bm));
+  PetscCall(PetscBLASIntCast(p, &bp));
+  PetscCall(PetscBLASIntCast(ldh, &bldh));
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+  PetscCallBLAS("BLAStrsm", BLAStrsm_("L", "U", "N", "N", &bm, &bp, &one, gm->H, &bldh, gm->g, &bldh));
+  PetscCall(PetscFPTrapPop());
+  PetscCall(PetscLogFlops(1.0 * m * m * p));
+  PetscCall(MatDenseGetLDA(gm->work[1], &ldw));
+  PetscCall(MatDenseGetArrayWrite(gm->work[1], &w));
+  PetscCall(KSPBlockGemm_Private("N", gm->n, p, m, 1.0, gm->V, PetscMax(gm->n, 1), gm->g, ldh, 0.0, w, ldw));
+  PetscCall(MatDenseRestoreArrayWrite(gm->work[1], &w));
+  if (ksp->pc_side == PC_RIGHT) {
+    PetscCall(KSP_PCMatApply(ksp, gm->work[1], gm->work[0]));
+    PetscCall(MatAXPY(X, 1.0, gm->work[0], SAME_NONZERO_PATTERN));
+  } else PetscCall(MatAXPY(X, 1.0, gm->work[1], SAME_NONZERO_PATTERN));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPMatSolve_BlockGMRES(KSP ksp, Mat B, Mat X)
+{
+  KSP_BlockGMRES *gm  = (KSP_BlockGMRES *)ksp->data;
+  KSP_Block      *blk = &gm->block;
+  Mat             R, W, Vj;
+  PetscScalar    *r, *w, *pp;
+  PetscInt        n, p, ld, ldh, ldp, *off, j;
+  PetscBool       realloc;
+
+  PetscFunctionBegin;
+  PetscCheck(!ksp->transpose_solve, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Transpose solves are not supported by KSPBLOCKGMRES");
+  PetscCheck(ksp->pc_side != PC_SYMMETRIC, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Symmetric preconditioning is not supported by KSPBLOCKGMRES");
+  PetscCall(KSPBlockSetUpWork_Private(ksp, B, 2, gm->work, &realloc));
+  PetscCall(MatGetLocalSize(B, &n, NULL));
+  p   = blk->p;
+  ldh = (gm->max_k + 1) * p;
+  if (realloc || gm->nv != gm->max_k || gm->n != n) {
+    PetscCall(KSPBlockGMRESFree_Private(ksp));
+    gm->nv    = gm->max_k;
+    gm->n     = n;
+    gm->lwork = 64 * p;
+    PetscCall(PetscMalloc2(PetscMax(n, 1) * (gm->max_k + 1) * p, &gm->V, gm->max_k + 2, &gm->off));
+    PetscCall(PetscMalloc7(ldh * gm->max_k * p, &gm->H, ldh * p, &gm->g, gm->max_k * p, &gm->tau, gm->lwork, &gm->qrwork, ldh * p + p * p, &gm->red, 4 * p * p, &gm->S, 2 * p, &gm->d));
+  }
+  R   = gm->work[0];
+  W   = gm->work[1];
+  off = gm->off;
+  PetscCall(MatDenseGetLDA(R, &ld));
+
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->its    = 0;
+  ksp->reason = KSP_CONVERGED_ITERATING;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  if (ksp->guess_zero) PetscCall(MatZeroEntries(X));
+
+  while (PETSC_TRUE) {
+    /* R <- B - A X, preconditioned when on the left */
+    if (ksp->guess_zero && !ksp->its) PetscCall(MatCopy(B, W, SAME_NONZERO_PATTERN));
+    else {
+      PetscCall(MatCopy(X, blk->P, SAME_NONZERO_PATTERN));
+      PetscCall(KSPBlockMatMult_Private(ksp));
+      PetscCall(MatCopy(B, W, SAME_NONZERO_PATTERN));
+      PetscCall(MatAXPY(W, -1.0, blk->AP, SAME_NONZERO_PATTERN));
+    }
+    if (ksp->pc_side == PC_LEFT) PetscCall(KSP_PCMatApply(ksp, W, R));
+    else PetscCall(MatCopy(W, R, SAME_NONZERO_PATTERN));
+
+    /* first block of the basis and right-hand sides of the least-squares problems */
+    PetscCall(PetscArrayzero(gm->g, ldh * p));
+    PetscCall(MatDenseGetArray(R, &r));
+    off[0] = 0;
+    PetscCall(KSPBlockGMRESOrthonormalize_Private(ksp, 0, p, r, ld, NULL, gm->g, ldh, &off[1]));
+    PetscCall(MatDenseRestoreArray(R, &r));
+    for (PetscInt c = 0; c < p; c++) blk->norms[c] = gm->d[c];
+    PetscCall(KSPBlockMonitorConverged_Private(ksp));
+    if (ksp->reason) break;
+    if (ksp->its >= ksp->max_it) {
+      ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+    if (!off[1]) {
+      ksp->reason = KSP_CONVERGED_HAPPY_BREAKDOWN;
+      break;
+    }
+
+    for (j = 0; j < gm->max_k; j++) {
+      const PetscInt k = off[j + 1] - off[j];
+      PetscInt       kn;
+
+      /* W <- Op V_j, the unused columns of the block are set to zero */
+      Vj = ksp->pc_side == PC_RIGHT ? W : blk->P;
+      PetscCall(MatDenseGetLDA(Vj, &ldp));
+      PetscCall(MatDenseGetArrayWrite(Vj, &pp));
+      for (PetscInt c = 0; c < p; c++) {
+        if (c < k) PetscCall(PetscArraycpy(pp + c * ldp, gm->V + (off[j] + c) * PetscMax(n, 1), n));
+        else PetscCall(PetscArrayzero(pp + c * ldp, n));
+      }
+      PetscCall(MatDenseRestoreArrayWrite(Vj, &pp));
+      if (ksp->pc_side == PC_RIGHT) {
+        PetscCall(KSP_PCMatApply(ksp, W, blk->P));
+        PetscCall(KSPBlockMatMult_Private(ksp));
+        PetscCall(MatCopy(blk->AP, W, SAME_NONZERO_PATTERN));
+      } else {
+        PetscCall(KSPBlockMatMult_Private(ksp));
+        PetscCall(KSP_PCMatApply(ksp, blk->AP, W));
+      }
+
+      /* new block column of the Hessenberg matrix and new block of the basis */
+      PetscCall(MatDenseGetArray(W, &w));
+      PetscCall(KSPBlockGMRESOrthonormalize_Private(ksp, off[j + 1], k, w, ld, gm->H + off[j] * ldh, gm->H + off[j + 1] + off[j] * ldh, ldh, &kn));
+      PetscCall(MatDenseRestoreArray(W, &w));
+      off[j + 2] = off[j + 1] + kn;
+      PetscCall(KSPBlockGMRESUpdateQR_Private(ksp, j));
+      PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+      ksp->its++;
+      PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+
+      /* the residual norms are those of the last rows of the right-hand sides, the last ones of a cycle are computed at the start of the next one */
+      if (!kn) PetscCall(PetscInfo(ksp, "The new block of the basis is numerically dependent on the previous ones at iteration %" PetscInt_FMT "\n", ksp->its));
+      else if (j + 1 < gm->max_k && ksp->its < ksp->max_it) {
+        for (PetscInt c = 0; c < p; c++) {
+          PetscReal nrm = 0.0;
+
+          for (PetscInt i = off[j + 1]; i < off[j + 2]; i++) nrm += PetscRealPart(PetscConj(gm->g[i + c * ldh]) * gm->g[i + c * ldh]);
+          blk->norms[c] = PetscSqrtReal(nrm);
+        }
+        PetscCall(KSPBlockMonitorConverged_Private(ksp));
+      }
+      if (ksp->reason || !kn || ksp->its >= ksp->max_it) {
+        j++;
+        break;
+      }
+    }
+    PetscCall(KSPBlockGMRESUpdateSolution_Private(ksp, off[j], X));
+    if (ksp->reason) break;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSolve_BlockGMRES(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPBlockSolveVec_Private(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGMRESSetRestart_BlockGMRES(KSP ksp, PetscInt max_k)
+{
+  KSP_BlockGMRES *gm = (KSP_BlockGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCheck(max_k >= 1, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Restart must be positive");
+  gm->max_k = max_k;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGMRESGetRestart_BlockGMRES(KSP ksp, PetscInt *max_k)
+{
+  KSP_BlockGMRES *gm = (KSP_BlockGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  *max_k = gm->max_k;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPDestroy_BlockGMRES(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPReset_BlockGMRES(ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetRestart_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetRestart_C", NULL));
+  PetscCall(KSPDestroyDefault(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetFromOptions_BlockGMRES(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_BlockGMRES *gm = (KSP_BlockGMRES *)ksp->data;
+  PetscInt        restart;
+  PetscBool       flg;
+
+  PetscFunctionBegin;
+  PetscOptionsHeadBegin(PetscOptionsObject, "KSP block GMRES options");
+  PetscCall(PetscOptionsInt("-ksp_gmres_restart", "Number of blocks of Krylov search directions", "KSPGMRESSetRestart", gm->max_k, &restart, &flg));
+  if (flg) PetscCall(KSPGMRESSetRestart(ksp, restart));
+  PetscCall(KSPBlockSetFromOptions_Private(ksp, PetscOptionsObject));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPView_BlockGMRES(KSP ksp, PetscViewer viewer)
+{
+  KSP_BlockGMRES *gm = (KSP_BlockGMRES *)ksp->data;
+  PetscBool       iascii;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &iascii));
+  if (iascii) PetscCall(PetscViewerASCIIPrintf(viewer, "  restart=%" PetscInt_FMT " blocks\n", gm->max_k));
+  PetscCall(KSPBlockView_Private(ksp, viewer));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   KSPBLOCKGMRES - The block GMRES method {cite}`gutknecht2006block`, {cite}`calandra2013modified`, which solves for all the columns of a block of
+   right-hand sides given to `KSPMatSolve()` at once
+
+   Options Database Keys:
++  -ksp_gmres_restart <restart>  - the number of blocks of the Krylov basis before restarting, see `KSPGMRESSetRestart()`
+-  -ksp_block_deflation_tol <tol> - threshold on the eigenvalues of the scaled Gram matrix of a new block below which a direction is discarded
+
+   Level: intermediate
+
+   Notes:
+   The Krylov basis is extended at each iteration by a block of as many vectors as there are columns, so the search space grows `p` times
+   faster than with `KSPGMRES` for each of the `p` columns. The operator is applied to the whole block with `MatMatMult()`, the preconditioner
+   with `PCMatApply()`, and the block is orthogonalized with dense matrix-matrix products on the local rows and three reductions per iteration.
+
+   The directions of a new block that are numerically dependent on the basis, for example when some columns have converged or when the right-hand
+   sides are linearly dependent, are discarded. When all of them are, the cycle ends and the method restarts from the true residuals.
+
+   The memory needed for the basis is `p` times that of `KSPGMRES` with the same restart.
+
+   The residual norm reported to the monitors is the largest norm of the columns. Each column has converged when it satisfies the relative tolerance,
+   with respect to its initial residual norm, or the absolute tolerance, and the solve stops when all the columns have converged; a custom convergence
+   test set with `KSPSetConvergenceTest()` is only used by `KSPSolve()`, which solves with a single column.
+
+   Left and right preconditioning are supported, but not symmetric preconditioning. `KSPMatSolveTranspose()` is not supported.
+
+.seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPGMRES`, `KSPBLOCKCG`, `KSPMatSolve()`, `KSPSetMatSolveBatchSize()`,
+          `KSPGMRESSetRestart()`, `KSPHPDDM`
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_BlockGMRES(KSP ksp)
+{
+  KSP_BlockGMRES *gm;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&gm));
+  ksp->data = (void *)gm;
+
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_PRECONDITIONED, PC_LEFT, 3));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_UNPRECONDITIONED, PC_RIGHT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_RIGHT, 1));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_LEFT, 1));
+
+  ksp->ops->setup          = KSPSetUp_BlockGMRES;
+  ksp->ops->solve          = KSPSolve_BlockGMRES;
+  ksp->ops->matsolve       = KSPMatSolve_BlockGMRES;
+  ksp->ops->reset          = KSPReset_BlockGMRES;
+  ksp->ops->destroy        = KSPDestroy_BlockGMRES;
+  ksp->ops->view           = KSPView_BlockGMRES;
+  ksp->ops->setfromoptions = KSPSetFromOptions_BlockGMRES;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+  PetscCall(KSPBlockCreate_Private(ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetRestart_C", KSPGMRESSetRestart_BlockGMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetRestart_C", KSPGMRESGetRestart_BlockGMRES));
+
+  gm->max_k = BLOCKGMRES_DEFAULT_MAXK;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+/*
+    Private data structure shared by the block Krylov methods KSPBLOCKCG and KSPBLOCKGMRES, which iterate on all the columns
+    of a MATDENSE block of right-hand sides at once: the operator is applied with MatMatMult() and the inner products are small
+    dense products computed with BLAS followed by a single reduction
+*/
+#include <petsc/private/kspimpl.h>
+#include <petscblaslapack.h>
+
+/*
+    This structure must be the first member of the data of each block KSP
+*/
+typedef struct {
+  PetscInt   p;        /* number of columns of the block the work data is allocated for */
+  Mat        AP;       /* product of the operator with the block P below */
+  Mat        P;        /* input block of the operator, owned by the implementation */
+  PetscBool  vecsolve; /* called through KSPSolve() with a single right-hand side */
+  PetscReal  tol;      /* threshold on the eigenvalues of scaled Gram matrices below which a direction is discarded */
+  PetscReal *norms;    /* residual norms of the columns */
+  PetscReal *norms0;   /* residual norms of the columns at the first iteration */
+} KSP_Block;
+
+PETSC_INTERN PetscErrorCode KSPBlockCreate_Private(KSP);
+PETSC_INTERN PetscErrorCode KSPBlockReset_Private(KSP);
+PETSC_INTERN PetscErrorCode KSPBlockSetFromOptions_Private(KSP, PetscOptionItems);
+PETSC_INTERN PetscErrorCode KSPBlockView_Private(KSP, PetscViewer);
+PETSC_INTERN PetscErrorCode KSPBlockSetUpWork_Private(KSP, Mat, PetscInt, Mat[], PetscBool *);
+PETSC_INTERN PetscErrorCode KSPBlockMatMult_Private(KSP);
+PETSC_INTERN PetscErrorCode KSPBlockGemm_Private(const char *, PetscInt, PetscInt, PetscInt, PetscScalar, const PetscScalar[], PetscInt, const PetscScalar[], PetscInt, PetscScalar, PetscScalar[], PetscInt);
+PETSC_INTERN PetscErrorCode KSPBlockColumnDot_Private(PetscInt, PetscInt, const PetscScalar[], PetscInt, const PetscScalar[], PetscInt, PetscScalar[]);
+PETSC_INTERN PetscErrorCode KSPBlockOrthonormalize_Private(KSP, PetscInt, PetscScalar[], const PetscReal[], PetscInt *, PetscScalar[], PetscScalar[]);
+PETSC_INTERN PetscErrorCode KSPBlockMonitorConverged_Private(KSP);
+PETSC_INTERN PetscErrorCode KSPBlockSolveVec_Private(KSP);
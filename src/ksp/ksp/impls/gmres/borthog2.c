@@ -36,14 +36,15 @@ PetscErrorCode KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp, PetscInt i
 {
   KSP_GMRES   *gmres = (KSP_GMRES *)ksp->data;
   PetscInt     j;
-  PetscScalar *hh, *hes, *lhh;
+  PetscScalar *hh, *hes, *lhh, *lhh2;
   PetscReal    hnrm, wnrm;
   PetscBool    refine = (PetscBool)(gmres->cgstype == KSP_GMRES_CGS_REFINE_ALWAYS);
 
   PetscFunctionBegin;
   PetscCall(PetscLogEventBegin(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
-  if (!gmres->orthogwork) PetscCall(PetscMalloc1(gmres->max_k + 2, &gmres->orthogwork));
-  lhh = gmres->orthogwork;
+  if (!gmres->orthogwork) PetscCall(PetscMalloc1(2 * (gmres->max_k + 2), &gmres->orthogwork));
+  lhh  = gmres->orthogwork;
+  lhh2 = gmres->orthogwork + gmres->max_k + 2;
 
   /* update Hessenberg matrix and do unmodified Gram-Schmidt */
   hh  = HH(0, it);
@@ -69,8 +70,14 @@ PetscErrorCode KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp, PetscInt i
   /*
          This is really a matrix-vector product:
          [h[0],h[1],...]*[ v[0]; v[1]; ...] subtracted from v[it+1].
+
+     When refinement is possible the products <v,vnew> of the second step, and the norm of vnew
+     needed to decide on it, are computed in the same pass over the basis vectors. For refine_ifneeded
+     this computes the products even when no refinement follows: it costs 2n flops per basis vector
+     more than the former VecMAXPY() and VecNorm() but reads y once less and needs no other reduction
   */
-  PetscCall(VecMAXPY(VEC_VV(it + 1), it + 1, lhh, &VEC_VV(0)));
+  if (gmres->cgstype == KSP_GMRES_CGS_REFINE_NEVER) PetscCall(VecMAXPY(VEC_VV(it + 1), it + 1, lhh, &VEC_VV(0)));
+  else PetscCall(VecMAXPYMDot(VEC_VV(it + 1), it + 1, lhh, &VEC_VV(0), lhh2, gmres->cgstype == KSP_GMRES_CGS_REFINE_IFNEEDED ? &wnrm : NULL));
   /* note lhh[j] is -<v,vnew> , hence the subtraction */
   for (j = 0; j <= it; j++) {
     hh[j] -= lhh[j];  /* hh += <v,vnew> */
@@ -86,7 +93,6 @@ PetscErrorCode KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp, PetscInt i
     for (j = 0; j <= it; j++) hnrm += PetscRealPart(lhh[j] * PetscConj(lhh[j]));
 
     hnrm = PetscSqrtReal(hnrm);
-    PetscCall(VecNorm(VEC_VV(it + 1), NORM_2, &wnrm));
     KSPCheckNorm(ksp, wnrm);
     if (ksp->reason) goto done;
     if (wnrm < hnrm) {
@@ -96,17 +102,16 @@ PetscErrorCode KSPGMRESClassicalGramSchmidtOrthogonalization(KSP ksp, PetscInt i
   }
 
   if (refine) {
-    PetscCall(VecMDot(VEC_VV(it + 1), it + 1, &(VEC_VV(0)), lhh)); /* <v,vnew> */
     for (j = 0; j <= it; j++) {
-      KSPCheckDot(ksp, lhh[j]);
+      KSPCheckDot(ksp, lhh2[j]);
       if (ksp->reason) goto done;
-      lhh[j] = -lhh[j];
+      lhh2[j] = -lhh2[j];
     }
-    PetscCall(VecMAXPY(VEC_VV(it + 1), it + 1, lhh, &VEC_VV(0)));
-    /* note lhh[j] is -<v,vnew> , hence the subtraction */
+    PetscCall(VecMAXPY(VEC_VV(it + 1), it + 1, lhh2, &VEC_VV(0)));
+    /* note lhh2[j] is -<v,vnew> , hence the subtraction */
     for (j = 0; j <= it; j++) {
-      hh[j] -= lhh[j];  /* hh += <v,vnew> */
-      hes[j] -= lhh[j]; /* hes += <v,vnew> */
+      hh[j] -= lhh2[j];  /* hh += <v,vnew> */
+      hes[j] -= lhh2[j]; /* hes += <v,vnew> */
     }
   }
 done:
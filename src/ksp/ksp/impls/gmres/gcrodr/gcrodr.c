@@ -0,0 +1,719 @@
+/*
+    GCRO-DR: GMRES with deflated restarting that keeps a subspace U from one cycle to the next and from one KSPSolve() to the next.
+    With C = Op U orthonormal, each cycle runs the Arnoldi process on (I - C C^H) Op, which gives
+
+        Op [U V_j] = [C V_{j+1}] G,  G = [D^{-1}    B  ]  where D scales the columns of U to unit norm
+                                         [  0    Hbar_j]
+
+    and the residual is minimized over span(U, V_j). At the end of a cycle, U is replaced by the harmonic Ritz vectors of Op in that space
+    associated with the harmonic Ritz values of smallest modulus. When the operator or the preconditioner has changed since C was computed,
+    at the start of KSPSolve(), C is computed again from U.
+*/
+#include <petsc/private/kspimpl.h> /*I "petscksp.h" I*/
+#include <petscblaslapack.h>
+
+#define GCRODR_DEFAULT_MAXK    30
+#define GCRODR_DEFAULT_RECYCLE 10
+
+typedef struct {
+  PetscInt         max_k;         /* dimension of the search space of a cycle, recycled vectors included */
+  PetscInt         k;             /* number of recycled vectors */
+  PetscInt         nr;            /* number of recycled vectors currently available */
+  PetscReal        haptol;        /* tolerance for the happy breakdown */
+  PetscInt         nv;            /* max_k used to allocate the data below */
+  PetscInt         nk;            /* k used to allocate the data below, up to nk + 1 vectors are recycled to keep complex conjugate pairs together */
+  Vec             *V, *W;         /* Arnoldi basis, W = [C V] */
+  Vec             *U, *C, *Unew, *Cnew;
+  Vec             *work;
+  PetscScalar     *hes, *hh, *cc, *ss, *g, *y, *B, *h; /* Hessenberg matrix, its rotated version, the rotations, right-hand side and coefficients */
+  PetscScalar     *G, *N, *A, *P, *Q, *R, *UW, *lwork;  /* dense data of the update of the recycled subspace */
+  PetscScalar     *eig;
+  PetscReal       *eigi, *modul, *un; /* eigi is also the real workspace of geev in complex arithmetic */
+  PetscInt        *perm;
+  PetscBLASInt    *ipiv;
+  PetscObjectId    Aid, Pid; /* operators from which C was computed */
+  PetscObjectState Astate, Pstate;
+  PCSide           side;
+} KSP_GCRODR;
+
+static PetscErrorCode KSPSetUp_GCRODR(KSP ksp)
+{
+  KSP_GCRODR *gm    = (KSP_GCRODR *)ksp->data;
+  PetscInt    max_k = gm->max_k, ld = max_k + 1, k = gm->k + 1;
+
+  PetscFunctionBegin;
+  PetscCheck(gm->k < max_k - 1, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "The number of recycled vectors %" PetscInt_FMT " must be smaller than the restart %" PetscInt_FMT " minus one", gm->k, max_k);
+  if (!gm->V) {
+    gm->nv = max_k;
+    gm->nk = gm->k;
+    PetscCall(KSPCreateVecs(ksp, max_k + 1, &gm->V, 0, NULL));
+    PetscCall(KSPCreateVecs(ksp, 3, &gm->work, 0, NULL));
+    PetscCall(KSPCreateVecs(ksp, k, &gm->U, 0, NULL));
+    PetscCall(KSPCreateVecs(ksp, k, &gm->C, 0, NULL));
+    PetscCall(KSPCreateVecs(ksp, k, &gm->Unew, 0, NULL));
+    PetscCall(KSPCreateVecs(ksp, k, &gm->Cnew, 0, NULL));
+    PetscCall(PetscMalloc1(max_k + 1 + k, &gm->W));
+    PetscCall(PetscCalloc7(ld * max_k, &gm->hes, ld * max_k, &gm->hh, max_k, &gm->cc, max_k, &gm->ss, ld, &gm->g, ld, &gm->y, k * max_k, &gm->B));
+    PetscCall(PetscMalloc7(ld + k, &gm->h, ld * max_k, &gm->G, ld * max_k, &gm->N, max_k * max_k, &gm->A, max_k * max_k, &gm->P, ld * k, &gm->Q, k * k, &gm->R));
+    PetscCall(PetscMalloc6((ld + k) * k, &gm->UW, 8 * max_k, &gm->lwork, max_k, &gm->eig, 2 * max_k, &gm->eigi, max_k, &gm->modul, k, &gm->un));
+    PetscCall(PetscMalloc2(max_k, &gm->perm, max_k, &gm->ipiv));
+    gm->nr = 0;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPReset_GCRODR(KSP ksp)
+{
+  KSP_GCRODR *gm = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  if (!gm->V) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(VecDestroyVecs(gm->nv + 1, &gm->V));
+  PetscCall(VecDestroyVecs(3, &gm->work));
+  PetscCall(VecDestroyVecs(gm->nk + 1, &gm->U));
+  PetscCall(VecDestroyVecs(gm->nk + 1, &gm->C));
+  PetscCall(VecDestroyVecs(gm->nk + 1, &gm->Unew));
+  PetscCall(VecDestroyVecs(gm->nk + 1, &gm->Cnew));
+  PetscCall(PetscFree(gm->W));
+  PetscCall(PetscFree7(gm->hes, gm->hh, gm->cc, gm->ss, gm->g, gm->y, gm->B));
+  PetscCall(PetscFree7(gm->h, gm->G, gm->N, gm->A, gm->P, gm->Q, gm->R));
+  PetscCall(PetscFree6(gm->UW, gm->lwork, gm->eig, gm->eigi, gm->modul, gm->un));
+  PetscCall(PetscFree2(gm->perm, gm->ipiv));
+  gm->nr = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Orthogonalizes w against the n vectors of W by classical Gram-Schmidt, with the norm of w from the same reduction, and a second pass
+   when more than half of w has been removed by the first one; returns the coefficients in h and the norm of the orthogonalized w in nrm
+*/
+static PetscErrorCode KSPGCRODROrthogonalize_Private(KSP ksp, PetscInt n, Vec W[], Vec w, PetscScalar h[], PetscReal *nrm)
+{
+  KSP_GCRODR  *gm   = (KSP_GCRODR *)ksp->data;
+  PetscScalar *coef = gm->y, *h2 = gm->UW;
+  PetscReal    wnrm;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogEventBegin(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
+  PetscCall(VecMDotBegin(w, n, W, h));
+  PetscCall(VecNormBegin(w, NORM_2, &wnrm));
+  PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)w)));
+  PetscCall(VecMDotEnd(w, n, W, h));
+  PetscCall(VecNormEnd(w, NORM_2, &wnrm));
+  for (PetscInt i = 0; i < n; i++) coef[i] = -h[i];
+  PetscCall(VecMAXPY(w, n, coef, W));
+  PetscCall(VecNorm(w, NORM_2, nrm));
+  if (*nrm < PETSC_SQRT2 / 2 * wnrm) {
+    PetscCall(VecMDot(w, n, W, h2));
+    for (PetscInt i = 0; i < n; i++) {
+      h[i] += h2[i];
+      coef[i] = -h2[i];
+    }
+    PetscCall(VecMAXPY(w, n, coef, W));
+    PetscCall(VecNorm(w, NORM_2, nrm));
+  }
+  PetscCall(PetscLogEventEnd(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   C <- Op U made orthonormal, with the same linear combinations applied to U, when the operator or the preconditioner has changed since the
+   last time C was computed
+*/
+static PetscErrorCode KSPGCRODRCheckOperators_Private(KSP ksp)
+{
+  KSP_GCRODR      *gm = (KSP_GCRODR *)ksp->data;
+  Mat              Amat, Pmat;
+  PetscObjectId    Aid, Pid;
+  PetscObjectState Astate, Pstate;
+  PetscScalar     *h = gm->h, *coef = gm->y;
+  PetscReal        nrm;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetOperators(ksp->pc, &Amat, &Pmat));
+  PetscCall(PetscObjectGetId((PetscObject)Amat, &Aid));
+  PetscCall(PetscObjectGetId((PetscObject)Pmat, &Pid));
+  PetscCall(PetscObjectStateGet((PetscObject)Amat, &Astate));
+  PetscCall(PetscObjectStateGet((PetscObject)Pmat, &Pstate));
+  if (gm->nr && (Aid != gm->Aid || Pid != gm->Pid || Astate != gm->Astate || Pstate != gm->Pstate || ksp->pc_side != gm->side)) {
+    PetscInt nr = gm->nr;
+
+    PetscCall(PetscInfo(ksp, "The operator has changed, computing the image of the %" PetscInt_FMT " recycled vectors\n", nr));
+    for (PetscInt i = 0; i < nr; i++) PetscCall(KSP_PCApplyBAorAB(ksp, gm->U[i], gm->C[i], gm->work[0]));
+    for (PetscInt i = 0; i < nr; i++) {
+      PetscCall(KSPGCRODROrthogonalize_Private(ksp, i, gm->C, gm->C[i], h, &nrm));
+      if (nrm == 0.0) {
+        PetscCall(PetscInfo(ksp, "The image of the recycled vector %" PetscInt_FMT " is numerically dependent on the previous ones, %" PetscInt_FMT " vectors are kept\n", i, i));
+        gm->nr = i;
+        break;
+      }
+      for (PetscInt l = 0; l < i; l++) coef[l] = -h[l];
+      PetscCall(VecMAXPY(gm->U[i], i, coef, gm->U));
+      PetscCall(VecScale(gm->C[i], 1.0 / nrm));
+      PetscCall(VecScale(gm->U[i], 1.0 / nrm));
+    }
+  }
+  gm->Aid    = Aid;
+  gm->Pid    = Pid;
+  gm->Astate = Astate;
+  gm->Pstate = Pstate;
+  gm->side   = ksp->pc_side;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* applies the previous Givens rotations to the column c of the Hessenberg matrix and computes a new one to annihilate its subdiagonal entry */
+static PetscErrorCode KSPGCRODRUpdateHessenberg(KSP ksp, PetscInt c, PetscBool hapend, PetscReal *res)
+{
+  KSP_GCRODR  *gm = (KSP_GCRODR *)ksp->data;
+  PetscInt     ld = gm->max_k + 1;
+  PetscScalar *hh = gm->hh + c * ld, *cc = gm->cc, *ss = gm->ss, *g = gm->g, tt;
+  PetscReal    nrm;
+
+  PetscFunctionBegin;
+  PetscCall(PetscArraycpy(hh, gm->hes + c * ld, c + 2));
+  for (PetscInt i = 0; i < c; i++) {
+    tt        = hh[i];
+    hh[i]     = PetscConj(cc[i]) * tt + PetscConj(ss[i]) * hh[i + 1];
+    hh[i + 1] = cc[i] * hh[i + 1] - ss[i] * tt;
+  }
+  if (hapend) {
+    /* the subdiagonal entry is zero, the residual of the least squares problem vanishes */
+    *res = 0.0;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  nrm = PetscSqrtReal(PetscRealPart(PetscConj(hh[c]) * hh[c] + PetscConj(hh[c + 1]) * hh[c + 1]));
+  if (nrm == 0.0) {
+    PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Your matrix or preconditioner is the null operator");
+    ksp->reason = KSP_DIVERGED_NULL;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  cc[c]     = hh[c] / nrm;
+  ss[c]     = hh[c + 1] / nrm;
+  g[c + 1]  = -ss[c] * g[c];
+  g[c]      = PetscConj(cc[c]) * g[c];
+  hh[c]     = nrm;
+  hh[c + 1] = 0.0;
+  *res      = PetscAbsScalar(g[c + 1]);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* x <- x + B^{-1} (V y - U B y) with the solution y of the n x n triangular least squares system, the component along U cancels C B y */
+static PetscErrorCode KSPGCRODRBuildSoln(KSP ksp, PetscInt n)
+{
+  KSP_GCRODR  *gm = (KSP_GCRODR *)ksp->data;
+  PetscInt     ld = gm->max_k + 1, nr = gm->nr, ldb = gm->nk + 1;
+  PetscScalar *hh = gm->hh, *y = gm->y, *coef = gm->h;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(PETSC_SUCCESS);
+  for (PetscInt k = n - 1; k >= 0; k--) {
+    PetscScalar tt = gm->g[k];
+
+    if (hh[k + k * ld] == 0.0) {
+      PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "You reached the break down in GCRO-DR; HH(%" PetscInt_FMT ",%" PetscInt_FMT ") = 0", k, k);
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      PetscCall(PetscInfo(ksp, "Likely your matrix or preconditioner is singular. HH(%" PetscInt_FMT ",%" PetscInt_FMT ") is identically zero\n", k, k));
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+    for (PetscInt j = k + 1; j < n; j++) tt -= hh[k + j * ld] * y[j];
+    y[k] = tt / hh[k + k * ld];
+  }
+  PetscCall(VecSet(gm->work[0], 0.0));
+  PetscCall(VecMAXPY(gm->work[0], n, y, gm->V));
+  if (nr) {
+    for (PetscInt i = 0; i < nr; i++) {
+      coef[i] = 0.0;
+      for (PetscInt j = 0; j < n; j++) coef[i] -= gm->B[i + j * ldb] * y[j];
+    }
+    PetscCall(VecMAXPY(gm->work[0], nr, coef, gm->U));
+  }
+  PetscCall(KSPUnwindPreconditioner(ksp, gm->work[0], gm->work[1]));
+  PetscCall(VecAXPY(ksp->vec_sol, 1.0, gm->work[0]));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Replaces the recycled subspace by the harmonic Ritz vectors of the space [U V_j] of the last cycle of j iterations, associated with the harmonic
+   Ritz values of smallest modulus, which solve G^H G z = theta G^H [C V_{j+1}]^H [U D V_j] z
+*/
+static PetscErrorCode KSPGCRODRUpdateRecycle(KSP ksp, PetscInt j)
+{
+  KSP_GCRODR  *gm = (KSP_GCRODR *)ksp->data;
+  PetscInt     nr = gm->nr, m = nr + j, ld = m + 1, ldh = gm->max_k + 1, ldb = gm->nk + 1, kmax = PetscMin(gm->k, m - 1), kk = 0;
+  PetscScalar *G = gm->G, *N = gm->N, *A = gm->A, *P = gm->P, *Q = gm->Q, *R = gm->R, *UW = gm->UW, *coef = gm->y, one = 1.0, zero = 0.0;
+  PetscReal   *un = gm->un, *modul = gm->modul;
+  PetscInt    *perm = gm->perm;
+  PetscBool   *selected;
+  PetscInt     ldr;
+  PetscBLASInt bm, bld, bkk, lwork, info;
+  Vec         *tmp;
+
+  PetscFunctionBegin;
+  if (kmax < 1) PetscFunctionReturn(PETSC_SUCCESS);
+  /* [C V_{j+1}]^H U and the norms of U with a single reduction */
+  if (nr) {
+    for (PetscInt i = 0; i < nr; i++) {
+      PetscCall(VecMDotBegin(gm->U[i], ld, gm->W, UW + i * ld));
+      PetscCall(VecNormBegin(gm->U[i], NORM_2, un + i));
+    }
+    PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)gm->U[0])));
+    for (PetscInt i = 0; i < nr; i++) {
+      PetscCall(VecMDotEnd(gm->U[i], ld, gm->W, UW + i * ld));
+      PetscCall(VecNormEnd(gm->U[i], NORM_2, un + i));
+    }
+  }
+
+  /* G and N = [C V_{j+1}]^H [U D V_j] */
+  PetscCall(PetscArrayzero(G, ld * m));
+  PetscCall(PetscArrayzero(N, ld * m));
+  for (PetscInt i = 0; i < nr; i++) {
+    G[i + i * ld] = 1.0 / un[i];
+    for (PetscInt l = 0; l < ld; l++) N[l + i * ld] = UW[l + i * ld] / un[i];
+  }
+  for (PetscInt c = 0; c < j; c++) {
+    for (PetscInt i = 0; i < nr; i++) G[i + (nr + c) * ld] = gm->B[i + c * ldb];
+    for (PetscInt i = 0; i <= c + 1; i++) G[nr + i + (nr + c) * ld] = gm->hes[i + c * ldh];
+    N[nr + c + (nr + c) * ld] = 1.0;
+  }
+
+  /* harmonic Ritz pairs from the eigenvalues of (G^H N)^{-1} G^H G */
+  PetscCall(PetscBLASIntCast(m, &bm));
+  PetscCall(PetscBLASIntCast(ld, &bld));
+  PetscCall(PetscBLASIntCast(8 * gm->max_k, &lwork));
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+  PetscCallBLAS("BLASgemm", BLASgemm_("C", "N", &bm, &bm, &bld, &one, G, &bld, G, &bld, &zero, A, &bm));
+  PetscCallBLAS("BLASgemm", BLASgemm_("C", "N", &bm, &bm, &bld, &one, G, &bld, N, &bld, &zero, P, &bm));
+  PetscCallBLAS("LAPACKgesv", LAPACKgesv_(&bm, &bm, P, &bm, gm->ipiv, A, &bm, &info));
+  if (!info) {
+#if !defined(PETSC_USE_COMPLEX)
+    PetscCallBLAS("LAPACKgeev", LAPACKgeev_("N", "V", &bm, A, &bm, gm->eig, gm->eigi, NULL, &bm, P, &bm, gm->lwork, &lwork, &info));
+#else
+    PetscCallBLAS("LAPACKgeev", LAPACKgeev_("N", "V", &bm, A, &bm, gm->eig, NULL, &bm, P, &bm, gm->lwork, &lwork, gm->eigi, &info));
+#endif
+  }
+  PetscCall(PetscFPTrapPop());
+  PetscCall(PetscLogFlops(4.0 * ld * m * m + 2.0 * m * m * m / 3.0 + 2.0 * m * m * m));
+  if (info) {
+    PetscCall(PetscInfo(ksp, "Computation of the harmonic Ritz vectors failed with info %" PetscBLASInt_FMT ", the recycled subspace is not updated\n", info));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
+  /* the vectors associated with the values of smallest modulus, both parts of a complex conjugate pair in real arithmetic */
+  PetscCall(PetscCalloc1(m, &selected));
+  for (PetscInt i = 0; i < m; i++) {
+#if !defined(PETSC_USE_COMPLEX)
+    modul[i] = PetscSqrtReal(gm->eig[i] * gm->eig[i] + gm->eigi[i] * gm->eigi[i]);
+#else
+    modul[i] = PetscAbsScalar(gm->eig[i]);
+#endif
+    perm[i] = i;
+  }
+  PetscCall(PetscSortRealWithPermutation(m, modul, perm));
+  for (PetscInt i = 0; i < m && kk < kmax; i++) {
+    PetscInt e = perm[i];
+
+    if (selected[e]) continue;
+#if !defined(PETSC_USE_COMPLEX)
+    if (gm->eigi[e] != 0.0) {
+      if (gm->eigi[e] < 0.0) e--;
+      selected[e] = selected[e + 1] = PETSC_TRUE;
+      PetscCall(PetscArraycpy(Q + kk * m, P + e * m, m));
+      PetscCall(PetscArraycpy(Q + (kk + 1) * m, P + (e + 1) * m, m));
+      kk += 2;
+      continue;
+    }
+#endif
+    selected[e] = PETSC_TRUE;
+    PetscCall(PetscArraycpy(Q + kk * m, P + e * m, m));
+    kk++;
+  }
+  PetscCall(PetscFree(selected));
+  PetscCall(PetscArraycpy(P, Q, m * kk));
+
+  /* G P = Q R by Gram-Schmidt with reorthogonalization */
+  ldr = kk;
+  PetscCall(PetscBLASIntCast(kk, &bkk));
+  PetscCall(PetscArrayzero(R, ldr * ldr));
+  PetscCallBLAS("BLASgemm", BLASgemm_("N", "N", &bld, &bkk, &bm, &one, G, &bld, P, &bm, &zero, Q, &bld));
+  for (PetscInt c = 0; c < kk; c++) {
+    PetscScalar *q = Q + c * ld;
+    PetscReal    nrm;
+
+    for (PetscInt pass = 0; pass < 2; pass++) {
+      for (PetscInt l = 0; l < c; l++) {
+        PetscScalar dot = 0.0;
+
+        for (PetscInt i = 0; i < ld; i++) dot += PetscConj(Q[i + l * ld]) * q[i];
+        for (PetscInt i = 0; i < ld; i++) q[i] -= dot * Q[i + l * ld];
+        R[l + c * ldr] += dot;
+      }
+    }
+    nrm = 0.0;
+    for (PetscInt i = 0; i < ld; i++) nrm += PetscRealPart(PetscConj(q[i]) * q[i]);
+    nrm = PetscSqrtReal(nrm);
+    if (nrm <= PETSC_MACHINE_EPSILON * PetscAbsScalar(R[0])) {
+      PetscCall(PetscInfo(ksp, "The harmonic Ritz vectors are numerically dependent, %" PetscInt_FMT " vectors are kept\n", c));
+      kk = c;
+      break;
+    }
+    R[c + c * ldr] = nrm;
+    for (PetscInt i = 0; i < ld; i++) q[i] /= nrm;
+  }
+  if (!kk) PetscFunctionReturn(PETSC_SUCCESS);
+
+  /* U <- [U D V_j] P R^{-1} and C <- [C V_{j+1}] Q, so that C = Op U is orthonormal */
+  for (PetscInt c = 0; c < kk; c++) {
+    PetscScalar *p = P + c * m;
+
+    for (PetscInt l = 0; l < c; l++)
+      for (PetscInt i = 0; i < m; i++) p[i] -= P[i + l * m] * R[l + c * ldr];
+    for (PetscInt i = 0; i < m; i++) p[i] /= R[c + c * ldr];
+    PetscCall(VecSet(gm->Unew[c], 0.0));
+    if (nr) {
+      for (PetscInt i = 0; i < nr; i++) coef[i] = p[i] / un[i];
+      PetscCall(VecMAXPY(gm->Unew[c], nr, coef, gm->U));
+    }
+    PetscCall(VecMAXPY(gm->Unew[c], j, p + nr, gm->V));
+    PetscCall(VecSet(gm->Cnew[c], 0.0));
+    PetscCall(VecMAXPY(gm->Cnew[c], ld, Q + c * ld, gm->W));
+  }
+  tmp      = gm->U;
+  gm->U    = gm->Unew;
+  gm->Unew = tmp;
+  tmp      = gm->C;
+  gm->C    = gm->Cnew;
+  gm->Cnew = tmp;
+  gm->nr   = kk;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGCRODRCycle(KSP ksp)
+{
+  KSP_GCRODR *gm = (KSP_GCRODR *)ksp->data;
+  PetscInt    ld = gm->max_k + 1, ldb = gm->nk + 1, nr = gm->nr, mi = gm->max_k - gm->nr, j = 0;
+  Vec        *V  = gm->V;
+  PetscReal   res, tt, hapbnd;
+  PetscBool   hapend = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  for (PetscInt i = 0; i < nr; i++) gm->W[i] = gm->C[i];
+  for (PetscInt i = 0; i <= mi; i++) gm->W[nr + i] = V[i];
+  PetscCall(VecNormalize(V[0], &res));
+  KSPCheckNorm(ksp, res);
+  PetscCall(PetscArrayzero(gm->g, ld));
+  gm->g[0] = res;
+
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->rnorm = res;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  PetscCall(KSPLogResidualHistory(ksp, res));
+  PetscCall(KSPMonitor(ksp, ksp->its, res));
+  if (!res) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    PetscCall(PetscInfo(ksp, "Converged due to zero residual norm on entry\n"));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall((*ksp->converged)(ksp, ksp->its, res, &ksp->reason, ksp->cnvP));
+
+  while (!ksp->reason && j < mi && ksp->its < ksp->max_it) {
+    /* (I - C C^H) Op v_j orthogonalized against V_j */
+    PetscCall(KSP_PCApplyBAorAB(ksp, V[j], V[j + 1], gm->work[0]));
+    PetscCall(KSPGCRODROrthogonalize_Private(ksp, nr + j + 1, gm->W, V[j + 1], gm->h, &tt));
+    KSPCheckNorm(ksp, tt);
+    for (PetscInt i = 0; i < nr; i++) gm->B[i + j * ldb] = gm->h[i];
+    PetscCall(PetscArrayzero(gm->hes + j * ld, ld));
+    PetscCall(PetscArraycpy(gm->hes + j * ld, gm->h + nr, j + 1));
+    gm->hes[j + 1 + j * ld] = tt;
+
+    hapbnd = PetscAbsScalar(tt / gm->g[j]);
+    if (hapbnd > gm->haptol) hapbnd = gm->haptol;
+    if (tt < hapbnd) {
+      PetscCall(PetscInfo(ksp, "Detected happy ending, current hapbnd = %14.12e tt = %14.12e\n", (double)hapbnd, (double)tt));
+      hapend = PETSC_TRUE;
+    } else PetscCall(VecScale(V[j + 1], 1.0 / tt));
+    PetscCall(KSPGCRODRUpdateHessenberg(ksp, j, hapend, &res));
+    if (ksp->reason) break;
+
+    j++;
+    PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+    ksp->its++;
+    ksp->rnorm = res;
+    PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+    PetscCall((*ksp->converged)(ksp, ksp->its, res, &ksp->reason, ksp->cnvP));
+    /* the last residual of a full cycle is monitored at the start of the next one */
+    if (ksp->reason || hapend || (j < mi && ksp->its < ksp->max_it)) {
+      PetscCall(KSPLogResidualHistory(ksp, res));
+      PetscCall(KSPMonitor(ksp, ksp->its, res));
+    }
+    if (hapend) {
+      if (ksp->normtype == KSP_NORM_NONE) { /* convergence test was skipped in this case */
+        ksp->reason = KSP_CONVERGED_HAPPY_BREAKDOWN;
+      } else if (!ksp->reason) {
+        PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Reached happy break down, but convergence was not indicated. Residual norm = %g", (double)res);
+        ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      }
+      break;
+    }
+  }
+
+  /* form the solution (or the solution so far) */
+  PetscCall(KSPGCRODRBuildSoln(ksp, j));
+  if (ksp->reason == KSP_CONVERGED_ITERATING && ksp->its >= ksp->max_it) {
+    ksp->reason = KSP_DIVERGED_ITS;
+    PetscCall(KSPLogResidualHistory(ksp, res));
+    PetscCall(KSPMonitor(ksp, ksp->its, res));
+  }
+  /* the space of the cycle is used to update the recycled subspace, also when converged so that the next solve benefits from it */
+  if (gm->k && j && !hapend && (ksp->reason >= 0 || ksp->reason == KSP_DIVERGED_ITS)) PetscCall(KSPGCRODRUpdateRecycle(ksp, j));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSolve_GCRODR(KSP ksp)
+{
+  KSP_GCRODR *gm         = (KSP_GCRODR *)ksp->data;
+  PetscBool   guess_zero = ksp->guess_zero;
+  PetscScalar *h         = gm->h;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->its = 0;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  PetscCall(KSPGCRODRCheckOperators_Private(ksp));
+  while (!ksp->reason) {
+    PetscCall(KSPInitialResidual(ksp, ksp->vec_sol, gm->work[0], gm->work[1], gm->V[0], ksp->vec_rhs));
+    /* minimize the residual over the recycled subspace: x <- x + U C^H r and r <- r - C C^H r */
+    if (gm->nr) {
+      PetscCall(VecMDot(gm->V[0], gm->nr, gm->C, h));
+      PetscCall(VecSet(gm->work[0], 0.0));
+      PetscCall(VecMAXPY(gm->work[0], gm->nr, h, gm->U));
+      PetscCall(KSPUnwindPreconditioner(ksp, gm->work[0], gm->work[1]));
+      PetscCall(VecAXPY(ksp->vec_sol, 1.0, gm->work[0]));
+      for (PetscInt i = 0; i < gm->nr; i++) h[i] = -h[i];
+      PetscCall(VecMAXPY(gm->V[0], gm->nr, h, gm->C));
+    }
+    PetscCall(KSPGCRODRCycle(ksp));
+    ksp->guess_zero = PETSC_FALSE; /* every future call to KSPInitialResidual() will have nonzero guess */
+  }
+  ksp->guess_zero = guess_zero; /* restore if user provided nonzero initial guess */
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGMRESSetRestart_GCRODR(KSP ksp, PetscInt max_k)
+{
+  KSP_GCRODR *gm = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCheck(max_k >= 1, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Restart must be positive");
+  if (ksp->setupstage && max_k != gm->max_k) {
+    /* free the data structures, then create them again */
+    PetscCall(KSPReset_GCRODR(ksp));
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  gm->max_k = max_k;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGMRESGetRestart_GCRODR(KSP ksp, PetscInt *max_k)
+{
+  KSP_GCRODR *gm = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  *max_k = gm->max_k;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGMRESSetHapTol_GCRODR(KSP ksp, PetscReal tol)
+{
+  KSP_GCRODR *gm = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCheck(tol >= 0.0, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Tolerance must be non-negative");
+  gm->haptol = tol;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGCRODRSetRecycleSize_GCRODR(KSP ksp, PetscInt k)
+{
+  KSP_GCRODR *gm = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCheck(k >= 0, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "The number of recycled vectors must be non-negative");
+  if (ksp->setupstage && k != gm->k) {
+    /* free the data structures, then create them again */
+    PetscCall(KSPReset_GCRODR(ksp));
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  gm->k = k;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGCRODRGetRecycleSize_GCRODR(KSP ksp, PetscInt *k)
+{
+  KSP_GCRODR *gm = (KSP_GCRODR *)ksp->data;
+
+  PetscFunctionBegin;
+  *k = gm->k;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPGCRODRSetRecycleSize - Sets the number of vectors of the subspace recycled by `KSPGCRODR` from one restart cycle to the next and
+  from one `KSPSolve()` to the next
+
+  Logically Collective
+
+  Input Parameters:
++ ksp - the Krylov space solver context
+- k   - the number of recycled vectors
+
+  Options Database Key:
+. -ksp_gcrodr_recycle <k> - the number of recycled vectors
+
+  Level: intermediate
+
+  Notes:
+  The default value is 10. It must be smaller than the restart minus one, see `KSPGMRESSetRestart()`, since the recycled vectors are part of
+  the search space of a cycle. With `k` equal to 0 the method is `KSPGMRES`.
+
+  In real arithmetic one more vector may be recycled to keep both parts of a complex conjugate pair of harmonic Ritz vectors.
+
+.seealso: [](ch_ksp), `KSPGCRODR`, `KSPGCRODRGetRecycleSize()`, `KSPGMRESSetRestart()`
+@*/
+PetscErrorCode KSPGCRODRSetRecycleSize(KSP ksp, PetscInt k)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(ksp, k, 2);
+  PetscTryMethod(ksp, "KSPGCRODRSetRecycleSize_C", (KSP, PetscInt), (ksp, k));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPGCRODRGetRecycleSize - Gets the number of vectors of the subspace recycled by `KSPGCRODR`
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov space solver context
+
+  Output Parameter:
+. k - the number of recycled vectors
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `KSPGCRODR`, `KSPGCRODRSetRecycleSize()`
+@*/
+PetscErrorCode KSPGCRODRGetRecycleSize(KSP ksp, PetscInt *k)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(k, 2);
+  PetscUseMethod(ksp, "KSPGCRODRGetRecycleSize_C", (KSP, PetscInt *), (ksp, k));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPDestroy_GCRODR(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPReset_GCRODR(ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetRestart_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetRestart_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetHapTol_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGCRODRSetRecycleSize_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGCRODRGetRecycleSize_C", NULL));
+  PetscCall(KSPDestroyDefault(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetFromOptions_GCRODR(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_GCRODR *gm = (KSP_GCRODR *)ksp->data;
+  PetscInt    restart, k;
+  PetscReal   haptol;
+  PetscBool   flg;
+
+  PetscFunctionBegin;
+  PetscOptionsHeadBegin(PetscOptionsObject, "KSP GCRO-DR options");
+  PetscCall(PetscOptionsInt("-ksp_gmres_restart", "Number of Krylov search directions, recycled ones included", "KSPGMRESSetRestart", gm->max_k, &restart, &flg));
+  if (flg) PetscCall(KSPGMRESSetRestart(ksp, restart));
+  PetscCall(PetscOptionsInt("-ksp_gcrodr_recycle", "Number of recycled vectors", "KSPGCRODRSetRecycleSize", gm->k, &k, &flg));
+  if (flg) PetscCall(KSPGCRODRSetRecycleSize(ksp, k));
+  PetscCall(PetscOptionsReal("-ksp_gmres_haptol", "Tolerance for exact convergence (happy ending)", "KSPGMRESSetHapTol", gm->haptol, &haptol, &flg));
+  if (flg) PetscCall(KSPGMRESSetHapTol(ksp, haptol));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPView_GCRODR(KSP ksp, PetscViewer viewer)
+{
+  KSP_GCRODR *gm = (KSP_GCRODR *)ksp->data;
+  PetscBool   iascii;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &iascii));
+  if (iascii) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  restart=%" PetscInt_FMT ", recycled vectors=%" PetscInt_FMT "\n", gm->max_k, gm->k));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  happy breakdown tolerance %g\n", (double)gm->haptol));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   KSPGCRODR - GMRES with deflated restarting and recycling of a subspace across restarts and across solves (GCRO-DR) {cite}`parks2006recycling`,
+   for sequences of linear systems with slowly varying operators or right-hand sides
+
+   Options Database Keys:
++  -ksp_gmres_restart <restart>  - the dimension of the search space of a cycle, the recycled vectors included, see `KSPGMRESSetRestart()`
+.  -ksp_gcrodr_recycle <k>       - the number of recycled vectors, see `KSPGCRODRSetRecycleSize()`
+-  -ksp_gmres_haptol <tol>       - the tolerance for the happy breakdown, see `KSPGMRESSetHapTol()`
+
+   Level: intermediate
+
+   Notes:
+   The method keeps a subspace `U` of `k` vectors, with `C` = `Op U` orthonormal where `Op` is the preconditioned operator. Each `KSPSolve()`
+   first minimizes the residual over `U`, which gives a better initial guess when the right-hand sides are related, then each cycle of
+   `restart - k` iterations runs the Arnoldi process on `(I - C C^H) Op` and minimizes the residual over `U` and the new Krylov space. At
+   the end of each cycle, `U` is replaced by the harmonic Ritz vectors of that space associated with the harmonic Ritz values of smallest
+   modulus, which deflates the corresponding eigenvalues from the next cycles and solves.
+
+   The recycled subspace is kept by `KSPSolve()` and `KSPSetOperators()`, and released by `KSPReset()`. When the operator, the matrix
+   used to build the preconditioner or the preconditioning side has changed since the last solve, `C` is computed again from `U` with `k`
+   applications of `Op`; the preconditioner itself is only set up again according to `KSPSetReusePreconditioner()`.
+
+   Left and right preconditioning are supported, but not symmetric preconditioning.
+
+.seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPGMRES`, `KSPDGMRES`, `KSPLGMRES`, `KSPGCRODRSetRecycleSize()`,
+          `KSPGMRESSetRestart()`, `KSPSetReusePreconditioner()`
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_GCRODR(KSP ksp)
+{
+  KSP_GCRODR *gm;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&gm));
+  ksp->data = (void *)gm;
+
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_PRECONDITIONED, PC_LEFT, 3));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_UNPRECONDITIONED, PC_RIGHT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_RIGHT, 1));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_LEFT, 1));
+
+  ksp->ops->setup          = KSPSetUp_GCRODR;
+  ksp->ops->solve          = KSPSolve_GCRODR;
+  ksp->ops->reset          = KSPReset_GCRODR;
+  ksp->ops->destroy        = KSPDestroy_GCRODR;
+  ksp->ops->view           = KSPView_GCRODR;
+  ksp->ops->setfromoptions = KSPSetFromOptions_GCRODR;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetRestart_C", KSPGMRESSetRestart_GCRODR));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetRestart_C", KSPGMRESGetRestart_GCRODR));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetHapTol_C", KSPGMRESSetHapTol_GCRODR));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGCRODRSetRecycleSize_C", KSPGCRODRSetRecycleSize_GCRODR));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGCRODRGetRecycleSize_C", KSPGCRODRGetRecycleSize_GCRODR));
+
+  gm->max_k  = GCRODR_DEFAULT_MAXK;
+  gm->k      = GCRODR_DEFAULT_RECYCLE;
+  gm->haptol = 1.0e-30;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -16,7 +16,7 @@
   PetscScalar *ss_origin;  /* holds sines for rotation matrices */ \
   PetscScalar *rs_origin;  /* holds the right-hand side of the Hessenberg system */ \
 \
-  PetscScalar *orthogwork; /* holds dot products computed in orthogonalization */ \
+  PetscScalar *orthogwork; /* holds dot products computed in orthogonalization, two sets for classical Gram-Schmidt */ \
 \
   /* Work space for computing eigenvalues/singular values */ \
   PetscReal   *Dsvd; \
@@ -0,0 +1,630 @@
+/*
+    Mixed-precision iterative refinement: the residual and the solution are kept in PetscScalar precision while each correction is computed
+    by a right preconditioned GMRES run in single precision on copies of the operator and of the preconditioner, so that the inner
+    iterations move half the bytes of a double precision solve
+*/
+#include <petsc/private/kspimpl.h> /*I "petscksp.h" I*/
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+#include <petscsf.h>
+
+#define MPIR_DEFAULT_INNER_MAXK 30
+#define MPIR_DEFAULT_INNER_RTOL 1.e-4
+
+typedef enum {
+  KSP_MPIR_PC_NONE,
+  KSP_MPIR_PC_JACOBI,
+  KSP_MPIR_PC_SOR,
+  KSP_MPIR_PC_FACTOR
+} KSPMPIRPCType;
+
+/* single-precision copy of the values of a MATSEQAIJ matrix, its nonzero structure is the one of the matrix */
+typedef struct {
+  PetscInt        m;
+  const PetscInt *i, *j, *diag;
+  float          *a;
+} KSPMPIR_AIJ;
+
+typedef struct {
+  PetscInt         max_k;     /* maximum number of iterations of the inner GMRES */
+  PetscReal        rtol;      /* relative tolerance of the inner GMRES */
+  PetscInt         inner_its; /* total number of inner iterations of the last solve */
+  PetscInt         m;         /* local size of the single-precision data below */
+  KSPMPIR_AIJ      A, B;      /* diagonal and off-diagonal blocks of the operator */
+  PetscSF          sf;        /* ghost update of the operator, owned by the matrix */
+  PetscInt         nghost;
+  KSPMPIRPCType    pctype;
+  KSPMPIR_AIJ      P;       /* diagonal block of the matrix used by SOR or factored matrix */
+  PetscInt        *r, *c;   /* row and column permutations of the factored matrix, NULL for the natural ordering */
+  float           *d;       /* inverse of the diagonal for Jacobi and SOR */
+  PetscReal        omega;   /* SOR relaxation factor */
+  PetscInt         sorits;  /* number of local SOR sweeps */
+  MatSORType       sortype;
+  float           *V, *w, *t, *tmp, *ghost;
+  PetscReal       *hes, *cc, *ss, *g, *y, *h;
+  PetscObjectId    Aid, Pid; /* operators the single-precision copies were made from */
+  PetscObjectState Astate, Pstate;
+} KSP_MPIR;
+
+static PetscErrorCode KSPMPIRCopyAIJ_Private(Mat A, PetscBool factored, KSPMPIR_AIJ *c)
+{
+  Mat_SeqAIJ      *a = (Mat_SeqAIJ *)A->data;
+  const MatScalar *aa;
+  PetscInt         nz;
+
+  PetscFunctionBegin;
+  c->m    = A->rmap->n;
+  c->i    = a->i;
+  c->j    = a->j;
+  c->diag = a->diag;
+  nz      = factored ? (c->m ? a->diag[0] + 1 : 0) : a->i[c->m];
+  PetscCall(PetscFree(c->a));
+  PetscCall(PetscMalloc1(nz, &c->a));
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  for (PetscInt k = 0; k < nz; k++) c->a[k] = (float)aa[k];
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPMPIRSetUpOperator_Private(KSP ksp, Mat A)
+{
+  KSP_MPIR   *mp = (KSP_MPIR *)ksp->data;
+  PetscBool   seq, mpi;
+  Mat_MPIAIJ *aij;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectBaseTypeCompare((PetscObject)A, MATSEQAIJ, &seq));
+  PetscCall(PetscObjectBaseTypeCompare((PetscObject)A, MATMPIAIJ, &mpi));
+  PetscCheck(seq || mpi, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "KSPMPIR requires a MATSEQAIJ or MATMPIAIJ operator, not %s", ((PetscObject)A)->type_name);
+  if (seq) {
+    PetscCall(KSPMPIRCopyAIJ_Private(A, PETSC_FALSE, &mp->A));
+    mp->sf = NULL;
+  } else {
+    aij = (Mat_MPIAIJ *)A->data;
+    PetscCall(KSPMPIRCopyAIJ_Private(aij->A, PETSC_FALSE, &mp->A));
+    PetscCall(KSPMPIRCopyAIJ_Private(aij->B, PETSC_FALSE, &mp->B));
+    mp->sf = aij->Mvctx;
+    if (aij->B->cmap->n != mp->nghost) {
+      mp->nghost = aij->B->cmap->n;
+      PetscCall(PetscFree(mp->ghost));
+      PetscCall(PetscMalloc1(mp->nghost, &mp->ghost));
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* single-precision copy of the data of a preconditioner already set up, nested in PCBJACOBI with one block per process or not */
+static PetscErrorCode KSPMPIRSetUpPC_Private(KSP ksp, PC pc)
+{
+  KSP_MPIR *mp = (KSP_MPIR *)ksp->data;
+  PetscBool isnone, isjacobi, issor, isilu, islu, isbjacobi, flg;
+  Mat       P;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)pc, PCNONE, &isnone));
+  PetscCall(PetscObjectTypeCompare((PetscObject)pc, PCJACOBI, &isjacobi));
+  PetscCall(PetscObjectTypeCompare((PetscObject)pc, PCSOR, &issor));
+  PetscCall(PetscObjectTypeCompare((PetscObject)pc, PCILU, &isilu));
+  PetscCall(PetscObjectTypeCompare((PetscObject)pc, PCLU, &islu));
+  PetscCall(PetscObjectTypeCompare((PetscObject)pc, PCBJACOBI, &isbjacobi));
+  PetscCall(PCGetOperators(pc, NULL, &P));
+  if (isbjacobi) {
+    KSP     *subksp;
+    PetscInt n;
+
+    PetscCall(PCBJacobiGetSubKSP(pc, &n, NULL, &subksp));
+    PetscCheck(n == 1, PETSC_COMM_SELF, PETSC_ERR_SUP, "KSPMPIR requires a single PCBJACOBI block per process, not %" PetscInt_FMT, n);
+    PetscCall(PetscObjectTypeCompare((PetscObject)subksp[0], KSPPREONLY, &flg));
+    PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_SUP, "KSPMPIR requires KSPPREONLY for the PCBJACOBI blocks, not %s", ((PetscObject)subksp[0])->type_name);
+    PetscCall(KSPGetPC(subksp[0], &pc));
+    PetscCall(KSPMPIRSetUpPC_Private(ksp, pc));
+  } else if (isnone) {
+    mp->pctype = KSP_MPIR_PC_NONE;
+  } else if (isjacobi) {
+    Vec                d, e;
+    const PetscScalar *dd;
+
+    /* the preconditioner is diagonal, its diagonal is its application to the vector of ones */
+    mp->pctype = KSP_MPIR_PC_JACOBI;
+    PetscCall(MatCreateVecs(P, &e, &d));
+    PetscCall(VecSet(e, 1.0));
+    PetscCall(PCApply(pc, e, d));
+    PetscCall(VecGetArrayRead(d, &dd));
+    for (PetscInt i = 0; i < mp->m; i++) mp->d[i] = (float)dd[i];
+    PetscCall(VecRestoreArrayRead(d, &dd));
+    PetscCall(VecDestroy(&e));
+    PetscCall(VecDestroy(&d));
+  } else if (issor) {
+    PetscInt its, lits;
+
+    mp->pctype = KSP_MPIR_PC_SOR;
+    PetscCall(PetscObjectBaseTypeCompare((PetscObject)P, MATMPIAIJ, &flg));
+    if (flg) P = ((Mat_MPIAIJ *)P->data)->A;
+    PetscCall(PetscObjectBaseTypeCompare((PetscObject)P, MATSEQAIJ, &flg));
+    PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_SUP, "KSPMPIR with PCSOR requires a MATSEQAIJ or MATMPIAIJ matrix, not %s", ((PetscObject)P)->type_name);
+    PetscCall(PCSORGetOmega(pc, &mp->omega));
+    PetscCall(PCSORGetIterations(pc, &its, &lits));
+    PetscCall(PCSORGetSymmetric(pc, &mp->sortype));
+    PetscCheck(!(mp->sortype & SOR_EISENSTAT), PETSC_COMM_SELF, PETSC_ERR_SUP, "KSPMPIR does not support the Eisenstat trick");
+    mp->sorits = its * lits;
+    PetscCall(KSPMPIRCopyAIJ_Private(P, PETSC_FALSE, &mp->P));
+    for (PetscInt i = 0; i < mp->m; i++) {
+      mp->d[i] = 0.0;
+      for (PetscInt k = mp->P.i[i]; k < mp->P.i[i + 1]; k++)
+        if (mp->P.j[k] == i) mp->d[i] = mp->P.a[k];
+      PetscCheck(mp->d[i] != 0.0f, PETSC_COMM_SELF, PETSC_ERR_MAT_LU_ZRPVT, "Zero diagonal in row %" PetscInt_FMT " of the single-precision copy", i);
+      mp->d[i] = 1.0f / mp->d[i];
+    }
+  } else if (isilu || islu) {
+    Mat         F;
+    Mat_SeqAIJ *f;
+    PetscBool   identity;
+
+    mp->pctype = KSP_MPIR_PC_FACTOR;
+    PetscCall(PCFactorGetMatrix(pc, &F));
+    PetscCall(PetscObjectTypeCompare((PetscObject)F, MATSEQAIJ, &flg));
+    PetscCheck(flg && (F->ops->solve == MatSolve_SeqAIJ || F->ops->solve == MatSolve_SeqAIJ_NaturalOrdering || F->ops->solve == MatSolve_SeqAIJ_Inode), PETSC_COMM_SELF, PETSC_ERR_SUP, "KSPMPIR requires a factorization of MATSOLVERPETSC which is not in place");
+    f = (Mat_SeqAIJ *)F->data;
+    PetscCall(KSPMPIRCopyAIJ_Private(F, PETSC_TRUE, &mp->P));
+    PetscCall(PetscFree(mp->r));
+    PetscCall(PetscFree(mp->c));
+    PetscCall(ISIdentity(f->row, &identity));
+    if (!identity) {
+      const PetscInt *idx;
+
+      PetscCall(PetscMalloc1(mp->m, &mp->r));
+      PetscCall(ISGetIndices(f->row, &idx));
+      PetscCall(PetscArraycpy(mp->r, idx, mp->m));
+      PetscCall(ISRestoreIndices(f->row, &idx));
+    }
+    PetscCall(ISIdentity(f->col, &identity));
+    if (!identity) {
+      const PetscInt *idx;
+
+      PetscCall(PetscMalloc1(mp->m, &mp->c));
+      PetscCall(ISGetIndices(f->col, &idx));
+      PetscCall(PetscArraycpy(mp->c, idx, mp->m));
+      PetscCall(ISRestoreIndices(f->col, &idx));
+    }
+  } else SETERRQ(PETSC_COMM_SELF, PETSC_ERR_SUP, "KSPMPIR supports PCNONE, PCJACOBI, PCSOR, PCILU, PCLU and PCBJACOBI with one of them on its blocks, not %s", ((PetscObject)pc)->type_name);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* makes the single-precision copies again when the operators have changed since they were made */
+static PetscErrorCode KSPMPIRCheckOperators_Private(KSP ksp)
+{
+  KSP_MPIR        *mp = (KSP_MPIR *)ksp->data;
+  Mat              Amat, Pmat;
+  PetscObjectId    Aid, Pid;
+  PetscObjectState Astate, Pstate;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetOperators(ksp->pc, &Amat, &Pmat));
+  PetscCall(PetscObjectGetId((PetscObject)Amat, &Aid));
+  PetscCall(PetscObjectGetId((PetscObject)Pmat, &Pid));
+  PetscCall(PetscObjectStateGet((PetscObject)Amat, &Astate));
+  PetscCall(PetscObjectStateGet((PetscObject)Pmat, &Pstate));
+  if (Aid != mp->Aid || Astate != mp->Astate) PetscCall(KSPMPIRSetUpOperator_Private(ksp, Amat));
+  if (Aid != mp->Aid || Astate != mp->Astate || Pid != mp->Pid || Pstate != mp->Pstate) PetscCall(KSPMPIRSetUpPC_Private(ksp, ksp->pc));
+  mp->Aid    = Aid;
+  mp->Pid    = Pid;
+  mp->Astate = Astate;
+  mp->Pstate = Pstate;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static void KSPMPIRMultAdd_AIJ(const KSPMPIR_AIJ *A, const float *x, float *y, PetscBool add)
+{
+  for (PetscInt i = 0; i < A->m; i++) {
+    float sum = add ? y[i] : 0.0f;
+
+    for (PetscInt k = A->i[i]; k < A->i[i + 1]; k++) sum += A->a[k] * x[A->j[k]];
+    y[i] = sum;
+  }
+}
+
+static PetscErrorCode KSPMPIRMatMult_Private(KSP ksp, const float *x, float *y)
+{
+  KSP_MPIR *mp = (KSP_MPIR *)ksp->data;
+
+  PetscFunctionBegin;
+  if (mp->sf) PetscCall(PetscSFBcastBegin(mp->sf, MPI_FLOAT, x, mp->ghost, MPI_REPLACE));
+  KSPMPIRMultAdd_AIJ(&mp->A, x, y, PETSC_FALSE);
+  if (mp->sf) {
+    PetscCall(PetscSFBcastEnd(mp->sf, MPI_FLOAT, x, mp->ghost, MPI_REPLACE));
+    KSPMPIRMultAdd_AIJ(&mp->B, mp->ghost, y, PETSC_TRUE);
+    PetscCall(PetscLogFlops(2.0 * mp->B.i[mp->m]));
+  }
+  PetscCall(PetscLogFlops(2.0 * mp->A.i[mp->m] - mp->m));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPMPIRPCApply_Private(KSP ksp, const float *x, float *y)
+{
+  KSP_MPIR          *mp = (KSP_MPIR *)ksp->data;
+  const KSPMPIR_AIJ *P     = &mp->P;
+  const float        omega = (float)mp->omega;
+  PetscInt           m     = mp->m;
+
+  PetscFunctionBegin;
+  switch (mp->pctype) {
+  case KSP_MPIR_PC_NONE:
+    PetscCall(PetscArraycpy(y, x, m));
+    break;
+  case KSP_MPIR_PC_JACOBI:
+    for (PetscInt i = 0; i < m; i++) y[i] = mp->d[i] * x[i];
+    PetscCall(PetscLogFlops(m));
+    break;
+  case KSP_MPIR_PC_SOR:
+    /* local sweeps from a zero initial guess, as MatSOR() with SOR_ZERO_INITIAL_GUESS on the diagonal block */
+    PetscCall(PetscArrayzero(y, m));
+    for (PetscInt it = 0; it < mp->sorits; it++) {
+      if (mp->sortype & (SOR_FORWARD_SWEEP | SOR_LOCAL_FORWARD_SWEEP)) {
+        for (PetscInt i = 0; i < m; i++) {
+          float sum = x[i];
+
+          for (PetscInt k = P->i[i]; k < P->i[i + 1]; k++)
+            if (P->j[k] != i) sum -= P->a[k] * y[P->j[k]];
+          y[i] = (1.0f - omega) * y[i] + omega * sum * mp->d[i];
+        }
+      }
+      if (mp->sortype & (SOR_BACKWARD_SWEEP | SOR_LOCAL_BACKWARD_SWEEP)) {
+        for (PetscInt i = m - 1; i >= 0; i--) {
+          float sum = x[i];
+
+          for (PetscInt k = P->i[i]; k < P->i[i + 1]; k++)
+            if (P->j[k] != i) sum -= P->a[k] * y[P->j[k]];
+          y[i] = (1.0f - omega) * y[i] + omega * sum * mp->d[i];
+        }
+      }
+    }
+    PetscCall(PetscLogFlops(2.0 * mp->sorits * P->i[m]));
+    break;
+  case KSP_MPIR_PC_FACTOR:
+    /* the triangular solves of MatSolve_SeqAIJ() */
+    for (PetscInt i = 0; i < m; i++) {
+      float sum = x[mp->r ? mp->r[i] : i];
+
+      for (PetscInt k = P->i[i]; k < P->i[i + 1]; k++) sum -= P->a[k] * mp->tmp[P->j[k]];
+      mp->tmp[i] = sum;
+    }
+    for (PetscInt i = m - 1; i >= 0; i--) {
+      float sum = mp->tmp[i];
+
+      for (PetscInt k = P->diag[i + 1] + 1; k < P->diag[i]; k++) sum -= P->a[k] * mp->tmp[P->j[k]];
+      mp->tmp[i]              = sum * P->a[P->diag[i]];
+      y[mp->c ? mp->c[i] : i] = mp->tmp[i];
+    }
+    if (m) PetscCall(PetscLogFlops(2.0 * (P->diag[0] + 1) - m));
+    break;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Right preconditioned GMRES in single precision with classical Gram-Schmidt with reorthogonalization, the inner products are
+   accumulated in PetscReal and each pass needs one reduction, with the norm of the vector from the Pythagorean theorem.
+   The right-hand side is in V, the correction is returned in w
+*/
+static PetscErrorCode KSPMPIRInnerSolve_Private(KSP ksp)
+{
+  KSP_MPIR  *mp = (KSP_MPIR *)ksp->data;
+  PetscInt   m = mp->m, ld = mp->max_k + 1, j = 0;
+  float     *V = mp->V, *w = mp->w;
+  PetscReal *hes = mp->hes, *g = mp->g, *h = mp->h, *y = mp->y, beta, nrm, tt;
+  MPI_Comm   comm;
+  PetscBool  hapend = PETSC_FALSE;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectGetComm((PetscObject)ksp, &comm));
+  beta = 0.0;
+  for (PetscInt i = 0; i < m; i++) beta += (PetscReal)V[i] * (PetscReal)V[i];
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, &beta, 1, MPIU_REAL, MPIU_SUM, comm));
+  beta = PetscSqrtReal(beta);
+  if (beta == 0.0) {
+    PetscCall(PetscArrayzero(w, m));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  for (PetscInt i = 0; i < m; i++) V[i] = (float)(V[i] / beta);
+  PetscCall(PetscArrayzero(g, ld));
+  g[0] = beta;
+  while (j < mp->max_k && !hapend) {
+    float *v = V + (j + 1) * m;
+
+    PetscCall(KSPMPIRPCApply_Private(ksp, V + j * m, mp->t));
+    PetscCall(KSPMPIRMatMult_Private(ksp, mp->t, v));
+    PetscCall(PetscArrayzero(hes + j * ld, ld));
+    for (PetscInt pass = 0; pass < 2; pass++) {
+      PetscCall(PetscArrayzero(h, j + 2));
+      for (PetscInt l = 0; l <= j; l++)
+        for (PetscInt i = 0; i < m; i++) h[l] += (PetscReal)V[i + l * m] * (PetscReal)v[i];
+      for (PetscInt i = 0; i < m; i++) h[j + 1] += (PetscReal)v[i] * (PetscReal)v[i];
+      PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, h, (PetscMPIInt)(j + 2), MPIU_REAL, MPIU_SUM, comm));
+      nrm = h[j + 1];
+      for (PetscInt l = 0; l <= j; l++) {
+        const float c = (float)h[l];
+
+        for (PetscInt i = 0; i < m; i++) v[i] -= c * V[i + l * m];
+        hes[l + j * ld] += h[l];
+        nrm -= h[l] * h[l];
+      }
+    }
+    PetscCall(PetscLogFlops(8.0 * (j + 2) * m));
+    nrm                 = PetscSqrtReal(PetscMax(nrm, 0.0));
+    hes[j + 1 + j * ld] = nrm;
+    if (nrm <= PETSC_SMALL * beta) hapend = PETSC_TRUE;
+    else
+      for (PetscInt i = 0; i < m; i++) v[i] = (float)(v[i] / nrm);
+
+    /* Givens rotations on the new column of the Hessenberg matrix */
+    for (PetscInt l = 0; l < j; l++) {
+      tt                  = hes[l + j * ld];
+      hes[l + j * ld]     = mp->cc[l] * tt + mp->ss[l] * hes[l + 1 + j * ld];
+      hes[l + 1 + j * ld] = mp->cc[l] * hes[l + 1 + j * ld] - mp->ss[l] * tt;
+    }
+    tt = PetscSqrtReal(hes[j + j * ld] * hes[j + j * ld] + hes[j + 1 + j * ld] * hes[j + 1 + j * ld]);
+    if (tt == 0.0) break;
+    mp->cc[j]           = hes[j + j * ld] / tt;
+    mp->ss[j]           = hes[j + 1 + j * ld] / tt;
+    g[j + 1]            = -mp->ss[j] * g[j];
+    g[j]                = mp->cc[j] * g[j];
+    hes[j + j * ld]     = tt;
+    hes[j + 1 + j * ld] = 0.0;
+    j++;
+    mp->inner_its++;
+    if (PetscAbsReal(g[j]) <= mp->rtol * beta) break;
+  }
+
+  /* w = M^{-1} V y */
+  for (PetscInt k = j - 1; k >= 0; k--) {
+    tt = g[k];
+    for (PetscInt l = k + 1; l < j; l++) tt -= hes[k + l * ld] * y[l];
+    y[k] = tt / hes[k + k * ld];
+  }
+  PetscCall(PetscArrayzero(mp->t, m));
+  for (PetscInt l = 0; l < j; l++) {
+    const float c = (float)y[l];
+
+    for (PetscInt i = 0; i < m; i++) mp->t[i] += c * V[i + l * m];
+  }
+  PetscCall(PetscLogFlops(2.0 * j * m));
+  PetscCall(KSPMPIRPCApply_Private(ksp, mp->t, w));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetUp_MPIR(KSP ksp)
+{
+  KSP_MPIR *mp = (KSP_MPIR *)ksp->data;
+  Mat       A;
+  PetscInt  ld = mp->max_k + 1;
+
+  PetscFunctionBegin;
+  PetscCall(KSPSetWorkVecs(ksp, 2));
+  if (!mp->V) {
+    PetscCall(PCGetOperators(ksp->pc, &A, NULL));
+    PetscCall(MatGetLocalSize(A, &mp->m, NULL));
+    PetscCall(PetscMalloc5(ld * mp->m, &mp->V, mp->m, &mp->w, mp->m, &mp->t, mp->m, &mp->tmp, mp->m, &mp->d));
+    PetscCall(PetscMalloc6(ld * mp->max_k, &mp->hes, mp->max_k, &mp->cc, mp->max_k, &mp->ss, ld, &mp->g, ld, &mp->y, ld, &mp->h));
+    mp->Aid = mp->Pid = 0;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSolve_MPIR(KSP ksp)
+{
+  KSP_MPIR          *mp = (KSP_MPIR *)ksp->data;
+  Mat                Amat;
+  Vec                x = ksp->vec_sol, b = ksp->vec_rhs, r = ksp->work[0], z = ksp->work[1];
+  PetscReal          rnorm;
+  const PetscScalar *rr;
+  PetscScalar       *zz;
+
+  PetscFunctionBegin;
+  PetscCall(KSPMPIRCheckOperators_Private(ksp));
+  PetscCall(PCGetOperators(ksp->pc, &Amat, NULL));
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->its = 0;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  mp->inner_its = 0;
+  if (!ksp->guess_zero) {
+    PetscCall(KSP_MatMult(ksp, Amat, x, r));
+    PetscCall(VecAYPX(r, -1.0, b));
+  } else PetscCall(VecCopy(b, r));
+
+  while (PETSC_TRUE) {
+    PetscCall(VecNorm(r, NORM_2, &rnorm));
+    KSPCheckNorm(ksp, rnorm);
+    PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+    ksp->rnorm = rnorm;
+    PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+    PetscCall(KSPLogResidualHistory(ksp, rnorm));
+    PetscCall(KSPMonitor(ksp, ksp->its, rnorm));
+    PetscCall((*ksp->converged)(ksp, ksp->its, rnorm, &ksp->reason, ksp->cnvP));
+    if (ksp->reason) break;
+    if (ksp->its >= ksp->max_it) {
+      ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+
+    /* the residual is scaled before it is rounded so that the inner solve does not underflow or overflow */
+    PetscCall(VecGetArrayRead(r, &rr));
+    for (PetscInt i = 0; i < mp->m; i++) mp->V[i] = (float)(PetscRealPart(rr[i]) / rnorm);
+    PetscCall(VecRestoreArrayRead(r, &rr));
+    PetscCall(KSPMPIRInnerSolve_Private(ksp));
+    PetscCall(VecGetArrayWrite(z, &zz));
+    for (PetscInt i = 0; i < mp->m; i++) zz[i] = rnorm * (PetscReal)mp->w[i];
+    PetscCall(VecRestoreArrayWrite(z, &zz));
+    PetscCall(VecAXPY(x, 1.0, z));
+
+    PetscCall(KSP_MatMult(ksp, Amat, x, r));
+    PetscCall(VecAYPX(r, -1.0, b));
+    PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+    ksp->its++;
+    PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  }
+  PetscCall(PetscInfo(ksp, "%" PetscInt_FMT " inner iterations in single precision for %" PetscInt_FMT " outer iterations\n", mp->inner_its, ksp->its));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPReset_MPIR(KSP ksp)
+{
+  KSP_MPIR *mp = (KSP_MPIR *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree5(mp->V, mp->w, mp->t, mp->tmp, mp->d));
+  PetscCall(PetscFree6(mp->hes, mp->cc, mp->ss, mp->g, mp->y, mp->h));
+  PetscCall(PetscFree(mp->A.a));
+  PetscCall(PetscFree(mp->B.a));
+  PetscCall(PetscFree(mp->P.a));
+  PetscCall(PetscFree(mp->r));
+  PetscCall(PetscFree(mp->c));
+  PetscCall(PetscFree(mp->ghost));
+  mp->nghost = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPDestroy_MPIR(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPReset_MPIR(ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPMPIRSetInnerTolerances_C", NULL));
+  PetscCall(KSPDestroyDefault(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPMPIRSetInnerTolerances_MPIR(KSP ksp, PetscReal rtol, PetscInt max_k)
+{
+  KSP_MPIR *mp = (KSP_MPIR *)ksp->data;
+
+  PetscFunctionBegin;
+  if (rtol == (PetscReal)PETSC_DETERMINE) {
+    mp->rtol = MPIR_DEFAULT_INNER_RTOL;
+  } else if (rtol != (PetscReal)PETSC_CURRENT) {
+    PetscCheck(rtol >= 0.0 && rtol < 1.0, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Relative tolerance %g must be non-negative and less than 1.0", (double)rtol);
+    mp->rtol = rtol;
+  }
+  if (max_k == PETSC_DETERMINE) max_k = MPIR_DEFAULT_INNER_MAXK;
+  if (max_k != PETSC_CURRENT && max_k != mp->max_k) {
+    PetscCheck(max_k >= 1, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Maximum number of inner iterations %" PetscInt_FMT " must be positive", max_k);
+    if (ksp->setupstage) {
+      /* free the data structures, then create them again */
+      PetscCall(KSPReset_MPIR(ksp));
+      ksp->setupstage = KSP_SETUP_NEW;
+    }
+    mp->max_k = max_k;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPMPIRSetInnerTolerances - Sets the tolerances of the inner solver in single precision of `KSPMPIR`
+
+  Logically Collective
+
+  Input Parameters:
++ ksp    - the Krylov space solver context
+. rtol   - the decrease of the norm of the residual of the inner solve relative to the one of the outer residual
+- max_it - the maximum number of inner iterations for each outer iteration
+
+  Options Database Keys:
++ -ksp_mpir_inner_rtol <rtol>     - the relative tolerance of the inner solve
+- -ksp_mpir_inner_max_it <max_it> - the maximum number of inner iterations
+
+  Level: intermediate
+
+  Notes:
+  The defaults are 1.e-4 and 30. Use `PETSC_CURRENT` to keep a value unchanged and `PETSC_DETERMINE` to use the default.
+
+  A tolerance below the unit roundoff of single precision, about 6.e-8, cannot be reached by the inner solve, which then always runs
+  `max_it` iterations.
+
+.seealso: [](ch_ksp), `KSPMPIR`, `KSPSetTolerances()`
+@*/
+PetscErrorCode KSPMPIRSetInnerTolerances(KSP ksp, PetscReal rtol, PetscInt max_it)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveReal(ksp, rtol, 2);
+  PetscValidLogicalCollectiveInt(ksp, max_it, 3);
+  PetscTryMethod(ksp, "KSPMPIRSetInnerTolerances_C", (KSP, PetscReal, PetscInt), (ksp, rtol, max_it));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetFromOptions_MPIR(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_MPIR *mp = (KSP_MPIR *)ksp->data;
+  PetscReal rtol  = mp->rtol;
+  PetscInt  max_k = mp->max_k;
+  PetscBool flg1, flg2;
+
+  PetscFunctionBegin;
+  PetscOptionsHeadBegin(PetscOptionsObject, "KSP MPIR options");
+  PetscCall(PetscOptionsReal("-ksp_mpir_inner_rtol", "Relative tolerance of the inner solve in single precision", "KSPMPIRSetInnerTolerances", rtol, &rtol, &flg1));
+  PetscCall(PetscOptionsInt("-ksp_mpir_inner_max_it", "Maximum number of inner iterations in single precision", "KSPMPIRSetInnerTolerances", max_k, &max_k, &flg2));
+  if (flg1 || flg2) PetscCall(KSPMPIRSetInnerTolerances(ksp, rtol, max_k));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPView_MPIR(KSP ksp, PetscViewer viewer)
+{
+  KSP_MPIR *mp = (KSP_MPIR *)ksp->data;
+  PetscBool iascii;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &iascii));
+  if (iascii) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  inner GMRES in single precision: relative tolerance %g, maximum iterations %" PetscInt_FMT "\n", (double)mp->rtol, mp->max_k));
+    if (ksp->setupstage == KSP_SETUP_NEWRHS) PetscCall(PetscViewerASCIIPrintf(viewer, "  inner iterations of the last solve %" PetscInt_FMT "\n", mp->inner_its));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   KSPMPIR - Mixed-precision iterative refinement, the residual and the solution are updated in `PetscScalar` precision with corrections
+   computed by a right preconditioned `KSPGMRES` in single precision
+
+   Options Database Keys:
++  -ksp_mpir_inner_rtol <rtol>     - the relative tolerance of each inner solve, see `KSPMPIRSetInnerTolerances()`
+-  -ksp_mpir_inner_max_it <max_it> - the maximum number of iterations of each inner solve, see `KSPMPIRSetInnerTolerances()`
+
+   Level: intermediate
+
+   Notes:
+   The values of the operator and the data of the preconditioner are copied in single precision when the operators change, so that the
+   inner iterations read half the bytes of an iteration in double precision. The operator must be `MATSEQAIJ` or `MATMPIAIJ`, or one of
+   their subclasses, and the preconditioner, which is set up in `PetscScalar` precision as usual before being copied, one of `PCNONE`,
+   `PCJACOBI`, `PCSOR`, and `PCILU` or `PCLU` with `MATSOLVERPETSC`, possibly on the blocks of `PCBJACOBI` with a single block per
+   process and `KSPPREONLY`.
+   In parallel, `PCSOR` uses local sweeps on the diagonal block of each process only.
+
+   The method converges to the accuracy of `PetscScalar` precision as long as single precision is enough for the preconditioned operator
+   to reduce the residual at each outer iteration, that is, when the condition number of the operator is well below 1.e8. The outer
+   iterations are monitored with the unpreconditioned norm of the residual. `-info` reports the total number of inner iterations.
+
+   Only real scalars are supported.
+
+.seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPRICHARDSON`, `KSPFGMRES`, `KSPMPIRSetInnerTolerances()`, `MATSEQAIJSINGLE`
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_MPIR(KSP ksp)
+{
+  KSP_MPIR *mp;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&mp));
+  ksp->data = (void *)mp;
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_UNPRECONDITIONED, PC_LEFT, 3));
+
+  ksp->ops->setup          = KSPSetUp_MPIR;
+  ksp->ops->solve          = KSPSolve_MPIR;
+  ksp->ops->reset          = KSPReset_MPIR;
+  ksp->ops->destroy        = KSPDestroy_MPIR;
+  ksp->ops->view           = KSPView_MPIR;
+  ksp->ops->setfromoptions = KSPSetFromOptions_MPIR;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPMPIRSetInnerTolerances_C", KSPMPIRSetInnerTolerances_MPIR));
+
+  mp->max_k = MPIR_DEFAULT_INNER_MAXK;
+  mp->rtol  = MPIR_DEFAULT_INNER_RTOL;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
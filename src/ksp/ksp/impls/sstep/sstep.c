@@ -0,0 +1,470 @@
+/*
+    Routines shared by the s-step Krylov methods KSPSSTEPCG and KSPSSTEPGMRES: the choice of the polynomial basis
+    generated at each outer iteration and its recurrence coefficients
+*/
+#include <../src/ksp/ksp/impls/sstep/sstepimpl.h> /*I "petscksp.h" I*/
+
+/* orders the shifts so that each one maximizes the product of its distances to the previous ones, which keeps the Newton basis well conditioned */
+static PetscErrorCode KSPSStepLejaOrder_Private(PetscInt n, PetscScalar theta[])
+{
+  PetscFunctionBegin;
+  for (PetscInt k = 0; k < n; k++) {
+    PetscInt  best    = k;
+    PetscReal bestval = 0.0;
+
+    for (PetscInt i = k; i < n; i++) {
+      PetscReal val = 0.0;
+
+      if (!k) val = PetscAbsScalar(theta[i]);
+      for (PetscInt j = 0; j < k; j++) {
+        const PetscReal d = PetscAbsScalar(theta[i] - theta[j]);
+
+        if (d == 0.0) {
+          val = PETSC_MIN_REAL;
+          break;
+        }
+        val += PetscLogReal(d);
+      }
+      if (i == k || val > bestval) {
+        best    = i;
+        bestval = val;
+      }
+    }
+    if (best != k) {
+      const PetscScalar t = theta[k];
+
+      theta[k]    = theta[best];
+      theta[best] = t;
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* sets the recurrence coefficients of the basis; theta[] are the n Leja ordered Newton shifts, reused cyclically if n < s */
+static PetscErrorCode KSPSStepSetCoefficients_Private(KSP_SStep *sstep, PetscInt n, const PetscScalar theta[])
+{
+  PetscInt s = sstep->s;
+
+  PetscFunctionBegin;
+  if (!sstep->ready || sstep->basis == KSP_SSTEP_BASIS_MONOMIAL) {
+    for (PetscInt k = 0; k < s; k++) {
+      sstep->alpha[k] = 0.0;
+      sstep->beta[k]  = 0.0;
+      sstep->gamma[k] = 1.0;
+    }
+  } else if (sstep->basis == KSP_SSTEP_BASIS_CHEBYSHEV) {
+    const PetscReal c = 0.5 * (sstep->emax + sstep->emin);
+    PetscReal       h = 0.5 * (sstep->emax - sstep->emin);
+
+    if (h <= 0.0) h = c != 0.0 ? PetscAbsReal(c) : 1.0;
+    /* T_{k+1}((x - c)/h) = 2 (x - c)/h T_k((x - c)/h) - T_{k-1}((x - c)/h) */
+    for (PetscInt k = 0; k < s; k++) {
+      sstep->alpha[k] = c;
+      sstep->beta[k]  = k ? 0.5 * h : 0.0;
+      sstep->gamma[k] = k ? 0.5 * h : h;
+    }
+  } else {
+    PetscReal diam = 0.0, scale;
+
+    /* scale by an estimate of the capacity of the set of shifts, a quarter of its diameter */
+    for (PetscInt i = 0; i < n; i++)
+      for (PetscInt j = 0; j < i; j++) diam = PetscMax(diam, PetscAbsScalar(theta[i] - theta[j]));
+    scale = 0.25 * diam;
+    for (PetscInt i = 0; i < n && scale == 0.0; i++) scale = PetscMax(scale, PetscAbsScalar(theta[i]));
+    if (scale == 0.0) scale = 1.0;
+    for (PetscInt k = 0; k < s; k++) {
+      sstep->alpha[k] = theta[k % n];
+      sstep->beta[k]  = 0.0;
+      sstep->gamma[k] = scale;
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPSStepSetUp_Private(KSP ksp)
+{
+  KSP_SStep *sstep = (KSP_SStep *)ksp->data;
+
+  PetscFunctionBegin;
+  if (!sstep->alpha) PetscCall(PetscMalloc3(sstep->s, &sstep->alpha, sstep->s, &sstep->beta, sstep->s, &sstep->gamma));
+  /* a Newton or Chebyshev basis without a user provided interval waits for the Ritz values of the first outer iteration */
+  sstep->ready = (PetscBool)(sstep->basis == KSP_SSTEP_BASIS_MONOMIAL || sstep->eigset);
+  if (sstep->ready && sstep->basis == KSP_SSTEP_BASIS_NEWTON) {
+    const PetscReal c = 0.5 * (sstep->emax + sstep->emin), h = 0.5 * (sstep->emax - sstep->emin);
+    PetscScalar    *theta;
+
+    /* Chebyshev points of the interval as shifts */
+    PetscCall(PetscMalloc1(sstep->s, &theta));
+    for (PetscInt k = 0; k < sstep->s; k++) theta[k] = c + h * PetscCosReal(PETSC_PI * (k + 0.5) / sstep->s);
+    PetscCall(KSPSStepLejaOrder_Private(sstep->s, theta));
+    PetscCall(KSPSStepSetCoefficients_Private(sstep, sstep->s, theta));
+    PetscCall(PetscFree(theta));
+  } else PetscCall(KSPSStepSetCoefficients_Private(sstep, 0, NULL));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPSStepReset_Private(KSP ksp)
+{
+  KSP_SStep *sstep = (KSP_SStep *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree3(sstep->alpha, sstep->beta, sstep->gamma));
+  sstep->ready = PETSC_FALSE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   KSPSStepSetBasisFromRitz_Private - Computes the Newton shifts or the Chebyshev interval from the eigenvalues of the n x n
+   projection H (with leading dimension ld, overwritten) of the operator on the first Krylov space, if they are still needed
+*/
+PetscErrorCode KSPSStepSetBasisFromRitz_Private(KSP ksp, PetscInt n, PetscScalar H[], PetscInt ld)
+{
+  KSP_SStep   *sstep = (KSP_SStep *)ksp->data;
+  PetscScalar *theta, *work, sdummy = 0;
+  PetscBLASInt bn, bld, lwork, idummy = 1, lierr;
+  PetscBool    finite = PETSC_TRUE;
+#if defined(PETSC_USE_COMPLEX)
+  PetscReal *rwork;
+#else
+  PetscReal *wr, *wi;
+#endif
+
+  PetscFunctionBegin;
+  if (sstep->ready || n < 1) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscBLASIntCast(n, &bn));
+  PetscCall(PetscBLASIntCast(ld, &bld));
+  PetscCall(PetscBLASIntCast(5 * n, &lwork));
+  for (PetscInt j = 0; j < n; j++)
+    for (PetscInt i = 0; i < n; i++) finite = (PetscBool)(finite && !PetscIsInfOrNanScalar(H[i + j * ld]));
+  if (!finite) {
+    PetscCall(PetscInfo(ksp, "Projected operator is not finite, keeping the monomial basis\n"));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscMalloc2(n, &theta, 5 * n, &work));
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+#if defined(PETSC_USE_COMPLEX)
+  PetscCall(PetscMalloc1(2 * n, &rwork));
+  PetscCallBLAS("LAPACKgeev", LAPACKgeev_("N", "N", &bn, H, &bld, theta, &sdummy, &idummy, &sdummy, &idummy, work, &lwork, rwork, &lierr));
+  PetscCall(PetscFree(rwork));
+#else
+  PetscCall(PetscMalloc2(n, &wr, n, &wi));
+  PetscCallBLAS("LAPACKgeev", LAPACKgeev_("N", "N", &bn, H, &bld, wr, wi, &sdummy, &idummy, &sdummy, &idummy, work, &lwork, &lierr));
+  /* the recurrence is kept real: complex conjugate pairs contribute their real part */
+  for (PetscInt i = 0; i < n; i++) theta[i] = wr[i];
+  PetscCall(PetscFree2(wr, wi));
+#endif
+  PetscCall(PetscFPTrapPop());
+  PetscCheck(!lierr, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine %" PetscBLASInt_FMT, lierr);
+
+  if (sstep->basis == KSP_SSTEP_BASIS_CHEBYSHEV) {
+    PetscReal emin = PETSC_MAX_REAL, emax = PETSC_MIN_REAL, d;
+
+    for (PetscInt i = 0; i < n; i++) {
+      emin = PetscMin(emin, PetscRealPart(theta[i]));
+      emax = PetscMax(emax, PetscRealPart(theta[i]));
+    }
+    /* the extreme Ritz values lie inside the spectrum */
+    d           = emax - emin;
+    sstep->emin = emin - 0.05 * d;
+    sstep->emax = emax + 0.05 * d;
+  } else PetscCall(KSPSStepLejaOrder_Private(n, theta));
+  sstep->ready = PETSC_TRUE;
+  PetscCall(KSPSStepSetCoefficients_Private(sstep, n, theta));
+  PetscCall(PetscInfo(ksp, "Using %s basis from %" PetscInt_FMT " Ritz values, first shift %g\n", KSPSStepBases[sstep->basis], n, (double)PetscRealPart(sstep->alpha[0])));
+  PetscCall(PetscFree2(theta, work));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Bc is the (s+1) x s change of basis matrix, stored by columns with leading dimension s+1 */
+PetscErrorCode KSPSStepGetBasisMatrix_Private(KSP ksp, PetscInt s, PetscScalar Bc[])
+{
+  KSP_SStep *sstep = (KSP_SStep *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscArrayzero(Bc, (s + 1) * s));
+  for (PetscInt k = 0; k < s; k++) {
+    if (k) Bc[k - 1 + k * (s + 1)] = sstep->beta[k];
+    Bc[k + k * (s + 1)]     = sstep->alpha[k];
+    Bc[k + 1 + k * (s + 1)] = sstep->gamma[k];
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* the basis can be generated by MatMultPowers(), which exchanges ghost values once per outer iteration, when the operator is the matrix itself */
+PetscErrorCode KSPSStepUsePowers_Private(KSP ksp, PetscBool *flg)
+{
+  Mat          Amat;
+  MatNullSpace nullsp;
+  PetscBool    isnone, diagonalscale;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)ksp->pc, PCNONE, &isnone));
+  PetscCall(PCGetDiagonalScale(ksp->pc, &diagonalscale));
+  PetscCall(PCGetOperators(ksp->pc, &Amat, NULL));
+  PetscCall(MatGetNullSpace(Amat, &nullsp));
+  *flg = (PetscBool)(isnone && !diagonalscale && !nullsp && !ksp->transpose_solve);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPSStepSetFromOptions_Private(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_SStep    *sstep   = (KSP_SStep *)ksp->data;
+  PetscReal     eigs[2] = {sstep->emin, sstep->emax};
+  PetscInt      s, n = 2;
+  KSPSStepBasis basis;
+  PetscBool     flg;
+
+  PetscFunctionBegin;
+  PetscCall(PetscOptionsInt("-ksp_sstep_size", "Number of iterations per outer iteration", "KSPSStepSetSize", sstep->s, &s, &flg));
+  if (flg) PetscCall(KSPSStepSetSize(ksp, s));
+  PetscCall(PetscOptionsEnum("-ksp_sstep_basis", "Polynomial basis generated at each outer iteration", "KSPSStepSetBasis", KSPSStepBases, (PetscEnum)sstep->basis, (PetscEnum *)&basis, &flg));
+  if (flg) PetscCall(KSPSStepSetBasis(ksp, basis));
+  PetscCall(PetscOptionsRealArray("-ksp_sstep_eigenvalues", "Interval containing the spectrum of the preconditioned operator", "KSPSStepSetEigenvalues", eigs, &n, &flg));
+  if (flg) {
+    PetscCheck(n == 2, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_INCOMP, "-ksp_sstep_eigenvalues: must specify emin,emax");
+    PetscCall(KSPSStepSetEigenvalues(ksp, eigs[0], eigs[1]));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPSStepView_Private(KSP ksp, PetscViewer viewer)
+{
+  KSP_SStep *sstep = (KSP_SStep *)ksp->data;
+  PetscBool  iascii, isstring;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &iascii));
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERSTRING, &isstring));
+  if (iascii) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  iterations per outer iteration: %" PetscInt_FMT ", %s basis\n", sstep->s, KSPSStepBases[sstep->basis]));
+    if (sstep->eigset) PetscCall(PetscViewerASCIIPrintf(viewer, "  spectral interval [%g, %g]\n", (double)sstep->emin, (double)sstep->emax));
+  } else if (isstring) {
+    PetscCall(PetscViewerStringSPrintf(viewer, "s=%" PetscInt_FMT " %s basis", sstep->s, KSPSStepBases[sstep->basis]));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSStepSetSize_SStep(KSP ksp, PetscInt s)
+{
+  KSP_SStep *sstep = (KSP_SStep *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCheck(s >= 1, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Number of iterations per outer iteration must be positive, not %" PetscInt_FMT, s);
+  if (ksp->setupstage && s != sstep->s) {
+    /* free the data structures, they are created again with the new size */
+    PetscCall((*ksp->ops->reset)(ksp));
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  sstep->s = s;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSStepGetSize_SStep(KSP ksp, PetscInt *s)
+{
+  KSP_SStep *sstep = (KSP_SStep *)ksp->data;
+
+  PetscFunctionBegin;
+  *s = sstep->s;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSStepSetBasis_SStep(KSP ksp, KSPSStepBasis basis)
+{
+  KSP_SStep *sstep = (KSP_SStep *)ksp->data;
+
+  PetscFunctionBegin;
+  if (ksp->setupstage && basis != sstep->basis) ksp->setupstage = KSP_SETUP_NEW;
+  sstep->basis = basis;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSStepGetBasis_SStep(KSP ksp, KSPSStepBasis *basis)
+{
+  KSP_SStep *sstep = (KSP_SStep *)ksp->data;
+
+  PetscFunctionBegin;
+  *basis = sstep->basis;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSStepSetEigenvalues_SStep(KSP ksp, PetscReal emin, PetscReal emax)
+{
+  KSP_SStep *sstep = (KSP_SStep *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCheck(emax > emin, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_INCOMP, "Maximum eigenvalue %g must be larger than minimum eigenvalue %g", (double)emax, (double)emin);
+  if (ksp->setupstage) ksp->setupstage = KSP_SETUP_NEW;
+  sstep->emin   = emin;
+  sstep->emax   = emax;
+  sstep->eigset = PETSC_TRUE;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPSStepCreate_Private(KSP ksp)
+{
+  KSP_SStep *sstep = (KSP_SStep *)ksp->data;
+
+  PetscFunctionBegin;
+  sstep->s     = KSP_SSTEP_DEFAULT_SIZE;
+  sstep->basis = KSP_SSTEP_BASIS_MONOMIAL;
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSStepSetSize_C", KSPSStepSetSize_SStep));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSStepGetSize_C", KSPSStepGetSize_SStep));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSStepSetBasis_C", KSPSStepSetBasis_SStep));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSStepGetBasis_C", KSPSStepGetBasis_SStep));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSStepSetEigenvalues_C", KSPSStepSetEigenvalues_SStep));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode KSPSStepDestroy_Private(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSStepSetSize_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSStepGetSize_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSStepSetBasis_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSStepGetBasis_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPSStepSetEigenvalues_C", NULL));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPSStepSetSize - Sets the number of iterations performed per outer iteration of the s-step Krylov methods `KSPSSTEPCG` and `KSPSSTEPGMRES`
+
+  Logically Collective
+
+  Input Parameters:
++ ksp - the Krylov space solver context
+- s   - the number of iterations per outer iteration
+
+  Options Database Key:
+. -ksp_sstep_size <s> - the number of iterations per outer iteration
+
+  Level: intermediate
+
+  Notes:
+  The default value is 4. Each outer iteration performs `s` applications of the operator and a single global reduction,
+  where the classical methods perform one or two reductions per iteration.
+
+  Larger values reduce the number of reductions further but make the generated basis more ill conditioned, see `KSPSStepSetBasis()`.
+  The methods reduce the number of iterations of an outer iteration when the basis is found numerically rank deficient.
+
+.seealso: [](ch_ksp), `KSPSSTEPCG`, `KSPSSTEPGMRES`, `KSPSStepGetSize()`, `KSPSStepSetBasis()`, `MatMultPowers()`
+@*/
+PetscErrorCode KSPSStepSetSize(KSP ksp, PetscInt s)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveInt(ksp, s, 2);
+  PetscTryMethod(ksp, "KSPSStepSetSize_C", (KSP, PetscInt), (ksp, s));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPSStepGetSize - Gets the number of iterations performed per outer iteration of the s-step Krylov methods `KSPSSTEPCG` and `KSPSSTEPGMRES`
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov space solver context
+
+  Output Parameter:
+. s - the number of iterations per outer iteration
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `KSPSSTEPCG`, `KSPSSTEPGMRES`, `KSPSStepSetSize()`
+@*/
+PetscErrorCode KSPSStepGetSize(KSP ksp, PetscInt *s)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(s, 2);
+  PetscUseMethod(ksp, "KSPSStepGetSize_C", (KSP, PetscInt *), (ksp, s));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPSStepSetBasis - Sets the polynomial basis generated at each outer iteration of the s-step Krylov methods `KSPSSTEPCG` and `KSPSSTEPGMRES`
+
+  Logically Collective
+
+  Input Parameters:
++ ksp   - the Krylov space solver context
+- basis - the basis, one of `KSP_SSTEP_BASIS_MONOMIAL`, `KSP_SSTEP_BASIS_NEWTON` or `KSP_SSTEP_BASIS_CHEBYSHEV`
+
+  Options Database Key:
+. -ksp_sstep_basis <monomial,newton,chebyshev> - the polynomial basis
+
+  Level: intermediate
+
+  Notes:
+  The default is `KSP_SSTEP_BASIS_MONOMIAL`, which is only well conditioned for small values of the size set with `KSPSStepSetSize()`.
+
+  The Newton basis uses the Ritz values as shifts and the Chebyshev basis an interval containing them. Unless an interval is provided
+  with `KSPSStepSetEigenvalues()`, they are computed from the monomial basis of the first outer iteration of the first solve.
+  In real arithmetic only the real parts of the Ritz values are used.
+
+.seealso: [](ch_ksp), `KSPSSTEPCG`, `KSPSSTEPGMRES`, `KSPSStepBasis`, `KSPSStepGetBasis()`, `KSPSStepSetSize()`, `KSPSStepSetEigenvalues()`
+@*/
+PetscErrorCode KSPSStepSetBasis(KSP ksp, KSPSStepBasis basis)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveEnum(ksp, basis, 2);
+  PetscTryMethod(ksp, "KSPSStepSetBasis_C", (KSP, KSPSStepBasis), (ksp, basis));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPSStepGetBasis - Gets the polynomial basis generated at each outer iteration of the s-step Krylov methods `KSPSSTEPCG` and `KSPSSTEPGMRES`
+
+  Not Collective
+
+  Input Parameter:
+. ksp - the Krylov space solver context
+
+  Output Parameter:
+. basis - the basis
+
+  Level: intermediate
+
+.seealso: [](ch_ksp), `KSPSSTEPCG`, `KSPSSTEPGMRES`, `KSPSStepBasis`, `KSPSStepSetBasis()`
+@*/
+PetscErrorCode KSPSStepGetBasis(KSP ksp, KSPSStepBasis *basis)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscAssertPointer(basis, 2);
+  PetscUseMethod(ksp, "KSPSStepGetBasis_C", (KSP, KSPSStepBasis *), (ksp, basis));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  KSPSStepSetEigenvalues - Sets an interval containing the spectrum of the preconditioned operator, used by the Newton and Chebyshev bases
+  of the s-step Krylov methods `KSPSSTEPCG` and `KSPSSTEPGMRES`
+
+  Logically Collective
+
+  Input Parameters:
++ ksp  - the Krylov space solver context
+. emin - the lower end of the interval
+- emax - the upper end of the interval
+
+  Options Database Key:
+. -ksp_sstep_eigenvalues <emin,emax> - the interval
+
+  Level: advanced
+
+  Note:
+  With this interval the Newton basis uses the Leja ordered Chebyshev points of the interval as shifts, and no Ritz values are computed.
+
+.seealso: [](ch_ksp), `KSPSSTEPCG`, `KSPSSTEPGMRES`, `KSPSStepSetBasis()`, `KSPChebyshevSetEigenvalues()`
+@*/
+PetscErrorCode KSPSStepSetEigenvalues(KSP ksp, PetscReal emin, PetscReal emax)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(ksp, KSP_CLASSID, 1);
+  PetscValidLogicalCollectiveReal(ksp, emin, 2);
+  PetscValidLogicalCollectiveReal(ksp, emax, 3);
+  PetscTryMethod(ksp, "KSPSStepSetEigenvalues_C", (KSP, PetscReal, PetscReal), (ksp, emin, emax));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,341 @@
+/*
+    s-step conjugate gradient method: s iterations per outer iteration with one global reduction, following Chronopoulos and Gear.
+
+    At each outer iteration the residual r and z = M^{-1} r generate the bases
+
+        T = [t_0 ... t_s],  t_0 = r,  t_{k+1} = (A u_k - alpha_k t_k - beta_k t_{k-1}) / gamma_k
+        U = [u_0 ... u_{s-1}],  u_k = M^{-1} t_k
+
+    so that A U = T Bc. The new directions S = U + S_old B are made A-conjugate to the previous block S_old, and x and r are
+    updated with the s by s Gram matrix W = S^H A S = G Bc + E^H B, where G = U^H T and E = (A S_old)^H U are the only inner
+    products of the outer iteration.
+*/
+#include <../src/ksp/ksp/impls/sstep/sstepimpl.h>
+
+typedef struct {
+  KSP_SStep     sstep;         /* must be first */
+  PetscInt      replace;       /* number of outer iterations between residual replacements, 0 for never */
+  PetscInt      nv;            /* size of the blocks of vectors below */
+  Vec          *T, *U;         /* the residual basis and its preconditioned counterpart */
+  Vec          *S[2], *AS[2];  /* current and previous direction blocks and their products with the operator */
+  PetscScalar  *G, *E, *Bc, *B, *W, *a, *work;
+  PetscBLASInt *ipiv;
+} KSP_SStepCG;
+
+static PetscErrorCode KSPSetUp_SStepCG(KSP ksp)
+{
+  KSP_SStepCG *cg = (KSP_SStepCG *)ksp->data;
+  PetscInt     s  = cg->sstep.s;
+
+  PetscFunctionBegin;
+  PetscCall(KSPSStepSetUp_Private(ksp));
+  if (!cg->T) {
+    cg->nv = s;
+    PetscCall(KSPCreateVecs(ksp, s + 1, &cg->T, 0, NULL));
+    for (PetscInt i = 0; i < 2; i++) {
+      PetscCall(KSPCreateVecs(ksp, s, &cg->S[i], 0, NULL));
+      PetscCall(KSPCreateVecs(ksp, s, &cg->AS[i], 0, NULL));
+    }
+    PetscCall(PetscMalloc7(s * (s + 1), &cg->G, s * s, &cg->E, (s + 1) * s, &cg->Bc, s * s, &cg->B, 2 * s * s, &cg->W, 3 * s, &cg->a, 2 * s * s, &cg->work));
+    PetscCall(PetscMalloc1(s, &cg->ipiv));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPReset_SStepCG(KSP ksp)
+{
+  KSP_SStepCG *cg = (KSP_SStepCG *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(VecDestroyVecs(cg->nv + 1, &cg->T));
+  PetscCall(VecDestroyVecs(cg->nv, &cg->U));
+  for (PetscInt i = 0; i < 2; i++) {
+    PetscCall(VecDestroyVecs(cg->nv, &cg->S[i]));
+    PetscCall(VecDestroyVecs(cg->nv, &cg->AS[i]));
+  }
+  PetscCall(PetscFree7(cg->G, cg->E, cg->Bc, cg->B, cg->W, cg->a, cg->work));
+  PetscCall(PetscFree(cg->ipiv));
+  PetscCall(KSPSStepReset_Private(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPDestroy_SStepCG(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPSStepDestroy_Private(ksp));
+  PetscCall(KSPDestroyDefault(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetFromOptions_SStepCG(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_SStepCG *cg = (KSP_SStepCG *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscOptionsHeadBegin(PetscOptionsObject, "KSP s-step CG options");
+  PetscCall(KSPSStepSetFromOptions_Private(ksp, PetscOptionsObject));
+  PetscCall(PetscOptionsInt("-ksp_sstep_residual_replacement", "Number of outer iterations between replacements of the residual by the true residual (0 for never)", "", cg->replace, &cg->replace, NULL));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPView_SStepCG(KSP ksp, PetscViewer viewer)
+{
+  KSP_SStepCG *cg = (KSP_SStepCG *)ksp->data;
+  PetscBool    iascii;
+
+  PetscFunctionBegin;
+  PetscCall(KSPSStepView_Private(ksp, viewer));
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &iascii));
+  if (iascii && cg->replace) PetscCall(PetscViewerASCIIPrintf(viewer, "  residual replaced every %" PetscInt_FMT " outer iterations\n", cg->replace));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSolve_SStepCG(KSP ksp)
+{
+  KSP_SStepCG  *cg    = (KSP_SStepCG *)ksp->data;
+  KSP_SStep    *sstep = &cg->sstep;
+  PetscInt      scur = sstep->s, sold = 0, outer = 0, cur = 0;
+  PetscScalar  *G = cg->G, *E = cg->E, *Bc = cg->Bc, *B = cg->B, *a = cg->a, *f = cg->a + 2 * sstep->s, *GBc = cg->work, rz = 0.0;
+  PetscReal     dp = 0.0;
+  Vec           x, b, r, z, *T = cg->T, *U;
+  Mat           Amat;
+  PetscBool     diagonalscale, usepowers;
+  PetscBLASInt  bse, bsold, one = 1, info;
+  MPI_Comm      comm;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetDiagonalScale(ksp->pc, &diagonalscale));
+  PetscCheck(!diagonalscale, PetscObjectComm((PetscObject)ksp), PETSC_ERR_SUP, "Krylov method %s does not support diagonal scaling", ((PetscObject)ksp)->type_name);
+  PetscCall(PetscObjectGetComm((PetscObject)ksp, &comm));
+  PetscCall(PCGetOperators(ksp->pc, &Amat, NULL));
+  /* without a preconditioner z = r, the two bases coincide and MatMultPowers() generates them */
+  PetscCall(KSPSStepUsePowers_Private(ksp, &usepowers));
+  if (!usepowers && !cg->U) PetscCall(KSPCreateVecs(ksp, cg->nv, &cg->U, 0, NULL));
+  U = usepowers ? T : cg->U;
+  x = ksp->vec_sol;
+  b = ksp->vec_rhs;
+  r = T[0];
+  z = U[0];
+
+  ksp->its = 0;
+  if (!ksp->guess_zero) {
+    PetscCall(KSP_MatMult(ksp, Amat, x, r)); /*     r <- b - Ax     */
+    PetscCall(VecAYPX(r, -1.0, b));
+  } else {
+    PetscCall(VecCopy(b, r)); /*     r <- b (x is 0) */
+  }
+  if (!usepowers) PetscCall(KSP_PCApply(ksp, r, z)); /*     z <- Br   */
+
+  while (PETSC_TRUE) {
+    const PetscInt se0 = PetscMin(scur, ksp->max_it - ksp->its);
+    PetscInt       se  = se0;
+    Vec           *S = cg->S[cur], *AS = cg->AS[cur], *Sold = cg->S[1 - cur], *ASold = cg->AS[1 - cur];
+    PetscScalar   *W = cg->W + cur * sstep->s * sstep->s, *Wold = cg->W + (1 - cur) * sstep->s * sstep->s;
+
+    /* generate the bases T and U */
+    if (usepowers && se) PetscCall(MatMultPowers(Amat, T[0], se, sstep->alpha, sstep->beta, sstep->gamma, T + 1));
+    else {
+      for (PetscInt k = 0; k < se; k++) {
+        PetscCall(KSP_MatMult(ksp, Amat, U[k], T[k + 1]));
+        if (sstep->alpha[k] != 0.0) PetscCall(VecAXPY(T[k + 1], -sstep->alpha[k], T[k]));
+        if (k && sstep->beta[k] != 0.0) PetscCall(VecAXPY(T[k + 1], -sstep->beta[k], T[k - 1]));
+        if (sstep->gamma[k] != 1.0) PetscCall(VecScale(T[k + 1], 1.0 / sstep->gamma[k]));
+        if (k + 1 < se) PetscCall(KSP_PCApply(ksp, T[k + 1], U[k + 1]));
+      }
+    }
+
+    /* all the inner products of the outer iteration in a single reduction */
+    if (se) {
+      for (PetscInt j = 0; j <= se; j++) PetscCall(VecMDotBegin(T[j], se, U, G + j * se0)); /*   G <- U'*T   */
+      if (sold) {
+        for (PetscInt j = 0; j < se; j++) PetscCall(VecMDotBegin(U[j], sold, ASold, E + j * sold));        /*   E <- (A S_old)'*U   */
+        for (PetscInt j = 0; j < sold; j++) PetscCall(VecMDotBegin(Sold[j], sold, ASold, Wold + j * sold)); /*   W_old <- (A S_old)'*S_old   */
+        PetscCall(VecMDotBegin(r, sold, Sold, f));                                                           /*   f <- S_old'*r   */
+      }
+    }
+    if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) PetscCall(VecNormBegin(r, NORM_2, &dp));
+    else if (ksp->normtype == KSP_NORM_PRECONDITIONED) PetscCall(VecNormBegin(z, NORM_2, &dp));
+    else if (ksp->normtype == KSP_NORM_NATURAL) PetscCall(VecDotBegin(r, z, &rz));
+    PetscCall(PetscCommSplitReductionBegin(comm));
+    if (se) {
+      for (PetscInt j = 0; j <= se; j++) PetscCall(VecMDotEnd(T[j], se, U, G + j * se0));
+      if (sold) {
+        for (PetscInt j = 0; j < se; j++) PetscCall(VecMDotEnd(U[j], sold, ASold, E + j * sold));
+        for (PetscInt j = 0; j < sold; j++) PetscCall(VecMDotEnd(Sold[j], sold, ASold, Wold + j * sold));
+        PetscCall(VecMDotEnd(r, sold, Sold, f));
+      }
+    }
+    if (ksp->normtype == KSP_NORM_UNPRECONDITIONED) PetscCall(VecNormEnd(r, NORM_2, &dp));
+    else if (ksp->normtype == KSP_NORM_PRECONDITIONED) PetscCall(VecNormEnd(z, NORM_2, &dp));
+    else if (ksp->normtype == KSP_NORM_NATURAL) {
+      PetscCall(VecDotEnd(r, z, &rz));
+      KSPCheckDot(ksp, rz);
+      dp = PetscSqrtReal(PetscAbsScalar(rz)); /*     dp <- r'*z = r'*B*r = e'*A'*B*A*e */
+    }
+    KSPCheckNorm(ksp, dp);
+    ksp->rnorm = dp;
+    PetscCall(KSPLogResidualHistory(ksp, dp));
+    PetscCall(KSPMonitor(ksp, ksp->its, dp));
+    PetscCall((*ksp->converged)(ksp, ksp->its, dp, &ksp->reason, ksp->cnvP));
+    if (ksp->reason) break;
+    if (!se) {
+      ksp->reason = KSP_DIVERGED_ITS;
+      break;
+    }
+
+    /* the recurrences only make S_old A-conjugate to the previous block and r orthogonal to it in exact arithmetic, so W_old and f are
+       computed rather than reused, which keeps the conjugacy of the new block from drifting */
+    if (sold) {
+      PetscCall(PetscBLASIntCast(sold, &bsold));
+      for (PetscInt j = 0; j < sold; j++) {
+        Wold[j + j * sold] = PetscRealPart(Wold[j + j * sold]);
+        for (PetscInt i = 0; i < j; i++) Wold[i + j * sold] = 0.5 * (Wold[i + j * sold] + PetscConj(Wold[j + i * sold]));
+      }
+      PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+      PetscCallBLAS("LAPACKpotrf", LAPACKpotrf_("U", &bsold, Wold, &bsold, &info));
+      PetscCall(PetscFPTrapPop());
+    } else info = 0;
+
+    /* W = G Bc + E'*B with B = -W_old^{-1} E; fewer iterations are kept while W is not numerically positive definite */
+    while (!info) {
+      PetscCall(KSPSStepGetBasisMatrix_Private(ksp, se, Bc));
+      for (PetscInt j = 0; j < se; j++) {
+        for (PetscInt i = 0; i < se; i++) {
+          PetscScalar sum = 0.0;
+
+          for (PetscInt k = PetscMax(j - 1, 0); k <= j + 1; k++) sum += G[i + k * se0] * Bc[k + j * (se + 1)];
+          GBc[i + j * se] = sum;
+        }
+      }
+      PetscCall(PetscArraycpy(W, GBc, se * se));
+      if (sold) {
+        PetscCall(PetscBLASIntCast(se, &bse));
+        for (PetscInt i = 0; i < sold * se; i++) B[i] = -E[i];
+        PetscCallBLAS("LAPACKpotrs", LAPACKpotrs_("U", &bsold, &bse, Wold, &bsold, B, &bsold, &info));
+        PetscCheck(!info, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine %" PetscBLASInt_FMT, info);
+        for (PetscInt j = 0; j < se; j++)
+          for (PetscInt i = 0; i < se; i++)
+            for (PetscInt l = 0; l < sold; l++) W[i + j * se] += PetscConj(E[l + i * sold]) * B[l + j * sold];
+      }
+      for (PetscInt j = 0; j < se; j++) {
+        W[j + j * se] = PetscRealPart(W[j + j * se]);
+        for (PetscInt i = 0; i < j; i++) W[i + j * se] = 0.5 * (W[i + j * se] + PetscConj(W[j + i * se]));
+      }
+      PetscCall(PetscBLASIntCast(se, &bse));
+      PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+      PetscCallBLAS("LAPACKpotrf", LAPACKpotrf_("U", &bse, W, &bse, &info));
+      PetscCall(PetscFPTrapPop());
+      if (!info || se == 1) break;
+      PetscCall(PetscInfo(ksp, "Gram matrix of the basis is not positive definite, reducing the outer iteration to %" PetscInt_FMT " iterations\n", se / 2));
+      se /= 2;
+      scur = se;
+      info = 0;
+    }
+    if (info) {
+      PetscCheck(!ksp->errorifnotconverged, comm, PETSC_ERR_NOT_CONVERGED, "s-step CG breakdown, the operator may be indefinite");
+      PetscCall(PetscInfo(ksp, "Breakdown, the search direction is not positive definite\n"));
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      break;
+    }
+
+    /* a = W^{-1} S'*r with S'*r = U'*r + B'*S_old'*r */
+    for (PetscInt i = 0; i < se; i++) {
+      a[i] = G[i];
+      for (PetscInt l = 0; l < sold; l++) a[i] += PetscConj(B[l + i * sold]) * f[l];
+    }
+    PetscCallBLAS("LAPACKpotrs", LAPACKpotrs_("U", &bse, &one, W, &bse, a, &bse, &info));
+    PetscCheck(!info, PETSC_COMM_SELF, PETSC_ERR_LIB, "Error in LAPACK routine %" PetscBLASInt_FMT, info);
+
+    /* the Ritz values of the first outer iteration, the eigenvalues of (U'*M*U)^{-1} U'*A*U = G(:,0:s-1)^{-1} G Bc, define the basis */
+    if (!sstep->ready) {
+      PetscScalar *Mhat = GBc + se * se;
+
+      for (PetscInt j = 0; j < se; j++)
+        for (PetscInt i = 0; i < se; i++) Mhat[i + j * se] = G[i + j * se0];
+      PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+      PetscCallBLAS("LAPACKgesv", LAPACKgesv_(&bse, &bse, Mhat, &bse, cg->ipiv, GBc, &bse, &info));
+      PetscCall(PetscFPTrapPop());
+      if (!info) PetscCall(KSPSStepSetBasisFromRitz_Private(ksp, se, GBc, se));
+    }
+
+    /* S = U + S_old B, A S = T Bc + A S_old B */
+    for (PetscInt j = 0; j < se; j++) {
+      const PetscInt lo = PetscMax(j - 1, 0);
+
+      PetscCall(VecCopy(U[j], S[j]));
+      PetscCall(VecSet(AS[j], 0.0));
+      PetscCall(VecMAXPY(AS[j], j + 2 - lo, Bc + lo + j * (se + 1), T + lo));
+      if (sold) {
+        PetscCall(VecMAXPY(S[j], sold, B + j * sold, Sold));
+        PetscCall(VecMAXPY(AS[j], sold, B + j * sold, ASold));
+      }
+    }
+    PetscCall(VecMAXPY(x, se, a, S)); /*     x <- x + S a   */
+    for (PetscInt i = 0; i < se; i++) a[sstep->s + i] = -a[i];
+    PetscCall(VecMAXPY(r, se, a + sstep->s, AS)); /*     r <- r - A S a   */
+    ksp->its += se;
+    outer++;
+    if (cg->replace && !(outer % cg->replace)) {
+      PetscCall(KSP_MatMult(ksp, Amat, x, r)); /*     r <- b - Ax     */
+      PetscCall(VecAYPX(r, -1.0, b));
+    }
+    if (!usepowers) PetscCall(KSP_PCApply(ksp, r, z)); /*     z <- Br   */
+    sold = se;
+    cur  = 1 - cur;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   KSPSSTEPCG - The s-step (communication-avoiding) conjugate gradient method {cite}`chronopoulos_gear_1989`, which performs s iterations
+   with a single global reduction
+
+   Options Database Keys:
++  -ksp_sstep_size <s>                       - the number of iterations per outer iteration, see `KSPSStepSetSize()`
+.  -ksp_sstep_basis <monomial,newton,chebyshev> - the polynomial basis, see `KSPSStepSetBasis()`
+.  -ksp_sstep_eigenvalues <emin,emax>        - an interval containing the spectrum, see `KSPSStepSetEigenvalues()`
+-  -ksp_sstep_residual_replacement <n>       - replace the recursively updated residual by the true residual every n outer iterations
+
+   Level: intermediate
+
+   Notes:
+   Each outer iteration generates `s` basis vectors with `s` applications of the operator and `s` applications of the preconditioner and
+   computes all the inner products it needs in one reduction, where `KSPCG` needs two reductions per iteration. The residual norm is only
+   available, hence monitored and tested for convergence, every `s` iterations.
+
+   Without a preconditioner (`PCNONE`) the basis is generated with `MatMultPowers()`, which for `MATMPIAIJ` exchanges the ghost values once
+   per outer iteration instead of once per iteration.
+
+   The monomial basis is ill conditioned for large `s`; the Newton and Chebyshev bases allow larger values. When the Gram matrix of the basis is
+   numerically singular, the remaining outer iterations use half as many iterations.
+
+   Only left preconditioning is supported; the preconditioner and the operator must be Hermitian positive definite.
+
+.seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPCG`, `KSPPIPECG`, `KSPGROPPCG`, `KSPSSTEPGMRES`, `KSPSStepSetSize()`,
+          `KSPSStepSetBasis()`, `KSPSStepSetEigenvalues()`, `MatMultPowers()`
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_SStepCG(KSP ksp)
+{
+  KSP_SStepCG *cg;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&cg));
+  ksp->data = (void *)cg;
+
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_PRECONDITIONED, PC_LEFT, 3));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_UNPRECONDITIONED, PC_LEFT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NATURAL, PC_LEFT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_LEFT, 1));
+
+  ksp->ops->setup          = KSPSetUp_SStepCG;
+  ksp->ops->solve          = KSPSolve_SStepCG;
+  ksp->ops->reset          = KSPReset_SStepCG;
+  ksp->ops->destroy        = KSPDestroy_SStepCG;
+  ksp->ops->view           = KSPView_SStepCG;
+  ksp->ops->setfromoptions = KSPSetFromOptions_SStepCG;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+  PetscCall(KSPSStepCreate_Private(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,500 @@
+/*
+    s-step GMRES: the Krylov basis is extended by blocks of s vectors generated by the three term recurrence of the s-step basis
+    from the last orthonormal vector, and each block is orthogonalized with a single global reduction by block classical Gram-Schmidt
+    with the Pythagorean inner product: with C = V^H W and P = W^H W from the same reduction, W - V C = Q R where R is the Cholesky
+    factor of P - C^H C.
+
+    Writing the block with its starting vector as [v_j W] = [V Q] Rfull, the relation Op [v_j w_1 ... w_{s-1}] = [v_j W] Bc gives the
+    s new columns of the Hessenberg matrix H of Op V = V H as
+
+        H(:, j:j+s-1) = (Rfull Bc - H(:, 0:j-1) Rfull(0:j-1, 0:s-1)) Rfull(j:j+s-1, 0:s-1)^{-1}
+
+    which are then processed by the Givens rotations of GMRES one column, that is one iteration, at a time.
+*/
+#include <../src/ksp/ksp/impls/sstep/sstepimpl.h>
+
+#define SSTEPGMRES_DEFAULT_MAXK 30
+
+typedef struct {
+  KSP_SStep                 sstep;   /* must be first */
+  PetscInt                  max_k;   /* restart */
+  KSPGMRESCGSRefinementType cgstype; /* reorthogonalization of the blocks */
+  PetscInt                  nv;      /* restart used to allocate the data below */
+  Vec                      *V, *work;
+  PetscScalar              *hes, *hh, *cc, *ss, *g, *y, *Rfull; /* Hessenberg matrix, its rotated version, the rotations and the right-hand side */
+  PetscScalar              *C, *P, *X, *Bc;
+  PetscReal                *d;
+} KSP_SStepGMRES;
+
+static PetscErrorCode KSPSetUp_SStepGMRES(KSP ksp)
+{
+  KSP_SStepGMRES *gm    = (KSP_SStepGMRES *)ksp->data;
+  PetscInt        max_k = gm->max_k, ld = max_k + 1, s = gm->sstep.s;
+
+  PetscFunctionBegin;
+  PetscCall(KSPSStepSetUp_Private(ksp));
+  if (!gm->V) {
+    gm->nv = max_k;
+    PetscCall(KSPCreateVecs(ksp, max_k + 1, &gm->V, 0, NULL));
+    PetscCall(KSPCreateVecs(ksp, 2, &gm->work, 0, NULL));
+    PetscCall(PetscCalloc7(ld * max_k, &gm->hes, ld * max_k, &gm->hh, max_k, &gm->cc, max_k, &gm->ss, ld, &gm->g, ld, &gm->y, ld * (s + 1), &gm->Rfull));
+    PetscCall(PetscMalloc5(2 * ld * s, &gm->C, 2 * s * s, &gm->P, ld * s, &gm->X, (s + 1) * s, &gm->Bc, s, &gm->d));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPReset_SStepGMRES(KSP ksp)
+{
+  KSP_SStepGMRES *gm = (KSP_SStepGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCall(VecDestroyVecs(gm->nv + 1, &gm->V));
+  PetscCall(VecDestroyVecs(2, &gm->work));
+  PetscCall(PetscFree7(gm->hes, gm->hh, gm->cc, gm->ss, gm->g, gm->y, gm->Rfull));
+  PetscCall(PetscFree5(gm->C, gm->P, gm->X, gm->Bc, gm->d));
+  PetscCall(KSPSStepReset_Private(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Orthogonalizes the block W of n vectors against the m orthonormal vectors V with one reduction: on output W <- W - V C and the upper
+   triangle of P holds the Gram matrix (W - V C)^H (W - V C), computed as W^H W - C^H C, and d the diagonal of W^H W
+*/
+static PetscErrorCode KSPSStepGMRESBlockOrthogonalize(KSP ksp, PetscInt m, Vec V[], PetscInt n, Vec W[], PetscScalar C[], PetscScalar P[], PetscReal d[])
+{
+  KSP_SStepGMRES *gm = (KSP_SStepGMRES *)ksp->data;
+  PetscInt        ld = gm->max_k + 1, s = gm->sstep.s;
+  PetscScalar    *coef = gm->y;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogEventBegin(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
+  for (PetscInt k = 0; k < n; k++) {
+    PetscCall(VecMDotBegin(W[k], m, V, C + k * ld));    /*   C <- V'*W   */
+    PetscCall(VecMDotBegin(W[k], k + 1, W, P + k * s)); /*   P <- W'*W   */
+  }
+  PetscCall(PetscCommSplitReductionBegin(PetscObjectComm((PetscObject)ksp)));
+  for (PetscInt k = 0; k < n; k++) {
+    PetscCall(VecMDotEnd(W[k], m, V, C + k * ld));
+    PetscCall(VecMDotEnd(W[k], k + 1, W, P + k * s));
+  }
+  for (PetscInt k = 0; k < n; k++) {
+    d[k] = PetscRealPart(P[k + k * s]);
+    for (PetscInt i = 0; i < m; i++) coef[i] = -C[i + k * ld];
+    PetscCall(VecMAXPY(W[k], m, coef, V));
+    for (PetscInt i = 0; i <= k; i++)
+      for (PetscInt l = 0; l < m; l++) P[i + k * s] -= PetscConj(C[l + i * ld]) * C[l + k * ld];
+  }
+  PetscCall(PetscLogEventEnd(KSP_GMRESOrthogonalization, ksp, 0, 0, 0));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Cholesky factorization of the upper triangle of the s x s matrix P into R, returns the number of leading columns that were factored */
+static PetscErrorCode KSPSStepGMRESFactor(KSP ksp, PetscInt n, const PetscScalar P[], PetscScalar R[], PetscInt *q)
+{
+  PetscInt     s = ((KSP_SStep *)ksp->data)->s;
+  PetscBLASInt bn, bs, info;
+
+  PetscFunctionBegin;
+  PetscCall(PetscBLASIntCast(n, &bn));
+  PetscCall(PetscBLASIntCast(s, &bs));
+  PetscCall(PetscArraycpy(R, P, s * n));
+  PetscCall(PetscFPTrapPush(PETSC_FP_TRAP_OFF));
+  PetscCallBLAS("LAPACKpotrf", LAPACKpotrf_("U", &bn, R, &bs, &info));
+  PetscCall(PetscFPTrapPop());
+  *q = info ? info - 1 : n;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* applies the previous Givens rotations to the column c of the Hessenberg matrix and computes a new one to annihilate its subdiagonal entry */
+static PetscErrorCode KSPSStepGMRESUpdateHessenberg(KSP ksp, PetscInt c, PetscBool hapend, PetscReal *res)
+{
+  KSP_SStepGMRES *gm = (KSP_SStepGMRES *)ksp->data;
+  PetscInt        ld = gm->max_k + 1;
+  PetscScalar    *hh = gm->hh + c * ld, *cc = gm->cc, *ss = gm->ss, *g = gm->g, tt;
+  PetscReal       nrm;
+
+  PetscFunctionBegin;
+  PetscCall(PetscArraycpy(hh, gm->hes + c * ld, c + 2));
+  for (PetscInt i = 0; i < c; i++) {
+    tt        = hh[i];
+    hh[i]     = PetscConj(cc[i]) * tt + PetscConj(ss[i]) * hh[i + 1];
+    hh[i + 1] = cc[i] * hh[i + 1] - ss[i] * tt;
+  }
+  if (hapend) {
+    /* the subdiagonal entry is zero, the residual of the least squares problem vanishes */
+    *res = 0.0;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  nrm = PetscSqrtReal(PetscRealPart(PetscConj(hh[c]) * hh[c] + PetscConj(hh[c + 1]) * hh[c + 1]));
+  if (nrm == 0.0) {
+    PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Your matrix or preconditioner is the null operator");
+    ksp->reason = KSP_DIVERGED_NULL;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  cc[c]     = hh[c] / nrm;
+  ss[c]     = hh[c + 1] / nrm;
+  g[c + 1]  = -ss[c] * g[c];
+  g[c]      = PetscConj(cc[c]) * g[c];
+  hh[c]     = nrm;
+  hh[c + 1] = 0.0;
+  *res      = PetscAbsScalar(g[c + 1]);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* x <- x + B^{-1} V y with the solution y of the n x n triangular least squares system */
+static PetscErrorCode KSPSStepGMRESBuildSoln(KSP ksp, PetscInt n)
+{
+  KSP_SStepGMRES *gm = (KSP_SStepGMRES *)ksp->data;
+  PetscInt        ld = gm->max_k + 1;
+  PetscScalar    *hh = gm->hh, *y = gm->y;
+
+  PetscFunctionBegin;
+  if (!n) PetscFunctionReturn(PETSC_SUCCESS);
+  for (PetscInt k = n - 1; k >= 0; k--) {
+    PetscScalar tt = gm->g[k];
+
+    if (hh[k + k * ld] == 0.0) {
+      PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "You reached the break down in s-step GMRES; HH(%" PetscInt_FMT ",%" PetscInt_FMT ") = 0", k, k);
+      ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      PetscCall(PetscInfo(ksp, "Likely your matrix or preconditioner is singular. HH(%" PetscInt_FMT ",%" PetscInt_FMT ") is identically zero\n", k, k));
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+    for (PetscInt j = k + 1; j < n; j++) tt -= hh[k + j * ld] * y[j];
+    y[k] = tt / hh[k + k * ld];
+  }
+  PetscCall(VecSet(gm->work[0], 0.0));
+  PetscCall(VecMAXPY(gm->work[0], n, y, gm->V));
+  PetscCall(KSPUnwindPreconditioner(ksp, gm->work[0], gm->work[1]));
+  PetscCall(VecAXPY(ksp->vec_sol, 1.0, gm->work[0]));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* computes the Hessenberg columns j, ..., j+q-1 from the orthogonalization coefficients C and R of the block of q+1 vectors */
+static PetscErrorCode KSPSStepGMRESBlockHessenberg(KSP ksp, PetscInt j, PetscInt q, const PetscScalar C[], const PetscScalar R[])
+{
+  KSP_SStepGMRES *gm = (KSP_SStepGMRES *)ksp->data;
+  PetscInt        ld = gm->max_k + 1, s = gm->sstep.s, nr = j + 1 + q;
+  PetscScalar    *Rfull = gm->Rfull, *X = gm->X, *Bc = gm->Bc, *hes = gm->hes;
+
+  PetscFunctionBegin;
+  /* [v_j w_1 ... w_q] = [V Q] Rfull */
+  PetscCall(PetscArrayzero(Rfull, ld * (q + 1)));
+  Rfull[j] = 1.0;
+  for (PetscInt k = 1; k <= q; k++) {
+    for (PetscInt i = 0; i <= j; i++) Rfull[i + k * ld] = C[i + (k - 1) * ld];
+    for (PetscInt i = 0; i < k; i++) Rfull[j + 1 + i + k * ld] = R[i + (k - 1) * s];
+  }
+  PetscCall(KSPSStepGetBasisMatrix_Private(ksp, q, Bc));
+  for (PetscInt k = 0; k < q; k++) {
+    PetscScalar *x = X + k * ld;
+
+    /* Rfull Bc - H(:, 0:j-1) Rfull(0:j-1, :) */
+    for (PetscInt i = 0; i < nr; i++) {
+      x[i] = 0.0;
+      for (PetscInt m = PetscMax(k - 1, 0); m <= k + 1; m++) x[i] += Rfull[i + m * ld] * Bc[m + k * (q + 1)];
+    }
+    for (PetscInt l = 0; l < j; l++)
+      for (PetscInt i = 0; i <= l + 1; i++) x[i] -= hes[i + l * ld] * Rfull[l + k * ld];
+    /* times the inverse of the upper triangular Rfull(j:j+q-1, 0:q-1) */
+    for (PetscInt m = 0; m < k; m++)
+      for (PetscInt i = 0; i < nr; i++) x[i] -= X[i + m * ld] * Rfull[j + m + k * ld];
+    for (PetscInt i = 0; i < nr; i++) x[i] /= Rfull[j + k + k * ld];
+  }
+  /* only the upper Hessenberg part is kept, the entries below it are rounding errors */
+  for (PetscInt k = 0; k < q; k++) {
+    PetscCall(PetscArrayzero(hes + (j + k) * ld, ld));
+    PetscCall(PetscArraycpy(hes + (j + k) * ld, X + k * ld, j + k + 2));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSStepGMRESCycle(KSP ksp)
+{
+  KSP_SStepGMRES *gm    = (KSP_SStepGMRES *)ksp->data;
+  KSP_SStep      *sstep = &gm->sstep;
+  PetscInt        ld = gm->max_k + 1, s = sstep->s, j = 0;
+  PetscScalar    *C = gm->C, *C2 = gm->C + ld * s, *P = gm->P, *R = gm->P + s * s;
+  Vec            *V = gm->V;
+  PetscReal       res;
+  PetscBool       usepowers, hapend = PETSC_FALSE;
+  Mat             Amat;
+
+  PetscFunctionBegin;
+  PetscCall(PCGetOperators(ksp->pc, &Amat, NULL));
+  PetscCall(KSPSStepUsePowers_Private(ksp, &usepowers));
+  PetscCall(VecNormalize(V[0], &res));
+  KSPCheckNorm(ksp, res);
+  PetscCall(PetscArrayzero(gm->g, ld));
+  gm->g[0] = res;
+
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->rnorm = res;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  PetscCall(KSPLogResidualHistory(ksp, res));
+  PetscCall(KSPMonitor(ksp, ksp->its, res));
+  if (!res) {
+    ksp->reason = KSP_CONVERGED_ATOL;
+    PetscCall(PetscInfo(ksp, "Converged due to zero residual norm on entry\n"));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall((*ksp->converged)(ksp, ksp->its, res, &ksp->reason, ksp->cnvP));
+
+  while (!ksp->reason && !hapend && j < gm->max_k && ksp->its < ksp->max_it) {
+    const PetscInt sb = PetscMin(PetscMin(s, gm->max_k - j), ksp->max_it - ksp->its);
+    Vec           *W  = V + j + 1;
+    PetscInt       q, ncol;
+    PetscBool      refine = (PetscBool)(gm->cgstype == KSP_GMRES_CGS_REFINE_ALWAYS);
+
+    /* the block W = [w_1 ... w_sb] generated from w_0 = v_j */
+    if (usepowers) PetscCall(MatMultPowers(Amat, V[j], sb, sstep->alpha, sstep->beta, sstep->gamma, W));
+    else {
+      for (PetscInt k = 0; k < sb; k++) {
+        PetscCall(KSP_PCApplyBAorAB(ksp, V[j + k], W[k], gm->work[1]));
+        if (sstep->alpha[k] != 0.0) PetscCall(VecAXPY(W[k], -sstep->alpha[k], V[j + k]));
+        if (k && sstep->beta[k] != 0.0) PetscCall(VecAXPY(W[k], -sstep->beta[k], V[j + k - 1]));
+        if (sstep->gamma[k] != 1.0) PetscCall(VecScale(W[k], 1.0 / sstep->gamma[k]));
+      }
+    }
+
+    /* W - V C = Q R, with a second pass if the first one loses orthogonality */
+    PetscCall(KSPSStepGMRESBlockOrthogonalize(ksp, j + 1, V, sb, W, C, P, gm->d));
+    PetscCall(KSPSStepGMRESFactor(ksp, sb, P, R, &q));
+    if (gm->cgstype == KSP_GMRES_CGS_REFINE_IFNEEDED)
+      for (PetscInt k = 0; k < q && !refine; k++) refine = (PetscBool)(PetscSqr(PetscRealPart(R[k + k * s])) < PETSC_SQRT_MACHINE_EPSILON * gm->d[k]);
+    if (q < sb || refine) {
+      PetscCall(PetscInfo(ksp, "Reorthogonalizing block at iteration %" PetscInt_FMT "\n", ksp->its));
+      PetscCall(KSPSStepGMRESBlockOrthogonalize(ksp, j + 1, V, sb, W, C2, P, gm->d));
+      for (PetscInt k = 0; k < sb; k++)
+        for (PetscInt i = 0; i <= j; i++) C[i + k * ld] += C2[i + k * ld];
+      PetscCall(KSPSStepGMRESFactor(ksp, sb, P, R, &q));
+    }
+    /* keep the leading vectors that are numerically independent */
+    for (PetscInt k = 0; k < q; k++) {
+      if (PetscRealPart(R[k + k * s]) <= PETSC_SQRT_MACHINE_EPSILON * PetscSqrtReal(gm->d[k])) {
+        q = k;
+        break;
+      }
+    }
+    if (q < sb) PetscCall(PetscInfo(ksp, "Block at iteration %" PetscInt_FMT " truncated to %" PetscInt_FMT " vectors\n", ksp->its, q));
+
+    if (q) {
+      PetscScalar *coef = gm->y;
+
+      /* Q = (W - V C) R^{-1} */
+      for (PetscInt k = 0; k < q; k++) {
+        for (PetscInt i = 0; i < k; i++) coef[i] = -R[i + k * s];
+        PetscCall(VecMAXPY(W[k], k, coef, W));
+        PetscCall(VecScale(W[k], 1.0 / R[k + k * s]));
+      }
+      PetscCall(KSPSStepGMRESBlockHessenberg(ksp, j, q, C, R));
+      ncol = q;
+    } else {
+      /* w_1 = V C(:, 0) lies in the Krylov space, which is invariant: Op v_j = alpha_0 v_j + gamma_0 V C(:, 0) */
+      PetscCall(PetscArrayzero(gm->hes + j * ld, ld));
+      for (PetscInt i = 0; i <= j; i++) gm->hes[i + j * ld] = sstep->gamma[0] * C[i];
+      gm->hes[j + j * ld] += sstep->alpha[0];
+      PetscCall(PetscInfo(ksp, "Detected happy ending at iteration %" PetscInt_FMT "\n", ksp->its));
+      hapend = PETSC_TRUE;
+      ncol   = 1;
+    }
+
+    /* the Ritz values of the first block define the Newton or Chebyshev basis */
+    if (!sstep->ready && !j) {
+      for (PetscInt k = 0; k < ncol; k++) PetscCall(PetscArraycpy(P + k * ncol, gm->hes + k * ld, ncol));
+      PetscCall(KSPSStepSetBasisFromRitz_Private(ksp, ncol, P, ncol));
+    }
+
+    for (PetscInt k = 0; k < ncol; k++) {
+      PetscCall(KSPSStepGMRESUpdateHessenberg(ksp, j, hapend, &res));
+      if (ksp->reason) break;
+      j++;
+      ksp->its++;
+      ksp->rnorm = res;
+      PetscCall((*ksp->converged)(ksp, ksp->its, res, &ksp->reason, ksp->cnvP));
+      /* the last residual of a full cycle is monitored at the start of the next one */
+      if (ksp->reason || hapend || (j < gm->max_k && ksp->its < ksp->max_it)) {
+        PetscCall(KSPLogResidualHistory(ksp, res));
+        PetscCall(KSPMonitor(ksp, ksp->its, res));
+      }
+      if (ksp->reason) break;
+    }
+    if (hapend) {
+      if (ksp->normtype == KSP_NORM_NONE) { /* convergence test was skipped in this case */
+        ksp->reason = KSP_CONVERGED_HAPPY_BREAKDOWN;
+      } else if (!ksp->reason) {
+        PetscCheck(!ksp->errorifnotconverged, PetscObjectComm((PetscObject)ksp), PETSC_ERR_NOT_CONVERGED, "Reached happy break down, but convergence was not indicated. Residual norm = %g", (double)res);
+        ksp->reason = KSP_DIVERGED_BREAKDOWN;
+      }
+    }
+  }
+
+  /* form the solution (or the solution so far) */
+  PetscCall(KSPSStepGMRESBuildSoln(ksp, j));
+  if (ksp->reason == KSP_CONVERGED_ITERATING && ksp->its >= ksp->max_it) {
+    ksp->reason = KSP_DIVERGED_ITS;
+    PetscCall(KSPLogResidualHistory(ksp, res));
+    PetscCall(KSPMonitor(ksp, ksp->its, res));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSolve_SStepGMRES(KSP ksp)
+{
+  KSP_SStepGMRES *gm         = (KSP_SStepGMRES *)ksp->data;
+  PetscBool       guess_zero = ksp->guess_zero;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectSAWsTakeAccess((PetscObject)ksp));
+  ksp->its = 0;
+  PetscCall(PetscObjectSAWsGrantAccess((PetscObject)ksp));
+  while (!ksp->reason) {
+    PetscCall(KSPInitialResidual(ksp, ksp->vec_sol, gm->work[0], gm->work[1], gm->V[0], ksp->vec_rhs));
+    PetscCall(KSPSStepGMRESCycle(ksp));
+    ksp->guess_zero = PETSC_FALSE; /* every future call to KSPInitialResidual() will have nonzero guess */
+  }
+  ksp->guess_zero = guess_zero; /* restore if user provided nonzero initial guess */
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGMRESSetRestart_SStepGMRES(KSP ksp, PetscInt max_k)
+{
+  KSP_SStepGMRES *gm = (KSP_SStepGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  PetscCheck(max_k >= 1, PetscObjectComm((PetscObject)ksp), PETSC_ERR_ARG_OUTOFRANGE, "Restart must be positive");
+  if (ksp->setupstage && max_k != gm->max_k) {
+    /* free the data structures, then create them again */
+    PetscCall(KSPReset_SStepGMRES(ksp));
+    ksp->setupstage = KSP_SETUP_NEW;
+  }
+  gm->max_k = max_k;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGMRESGetRestart_SStepGMRES(KSP ksp, PetscInt *max_k)
+{
+  KSP_SStepGMRES *gm = (KSP_SStepGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  *max_k = gm->max_k;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGMRESSetCGSRefinementType_SStepGMRES(KSP ksp, KSPGMRESCGSRefinementType type)
+{
+  KSP_SStepGMRES *gm = (KSP_SStepGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  gm->cgstype = type;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPGMRESGetCGSRefinementType_SStepGMRES(KSP ksp, KSPGMRESCGSRefinementType *type)
+{
+  KSP_SStepGMRES *gm = (KSP_SStepGMRES *)ksp->data;
+
+  PetscFunctionBegin;
+  *type = gm->cgstype;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPDestroy_SStepGMRES(KSP ksp)
+{
+  PetscFunctionBegin;
+  PetscCall(KSPSStepDestroy_Private(ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetRestart_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetRestart_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetCGSRefinementType_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetCGSRefinementType_C", NULL));
+  PetscCall(KSPDestroyDefault(ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPSetFromOptions_SStepGMRES(KSP ksp, PetscOptionItems PetscOptionsObject)
+{
+  KSP_SStepGMRES *gm = (KSP_SStepGMRES *)ksp->data;
+  PetscInt        restart;
+  PetscBool       flg;
+
+  PetscFunctionBegin;
+  PetscOptionsHeadBegin(PetscOptionsObject, "KSP s-step GMRES options");
+  PetscCall(KSPSStepSetFromOptions_Private(ksp, PetscOptionsObject));
+  PetscCall(PetscOptionsInt("-ksp_gmres_restart", "Number of Krylov search directions", "KSPGMRESSetRestart", gm->max_k, &restart, &flg));
+  if (flg) PetscCall(KSPGMRESSetRestart(ksp, restart));
+  PetscCall(PetscOptionsEnum("-ksp_gmres_cgs_refinement_type", "Type of reorthogonalization of the blocks", "KSPGMRESSetCGSRefinementType", KSPGMRESCGSRefinementTypes, (PetscEnum)gm->cgstype, (PetscEnum *)&gm->cgstype, NULL));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode KSPView_SStepGMRES(KSP ksp, PetscViewer viewer)
+{
+  KSP_SStepGMRES *gm = (KSP_SStepGMRES *)ksp->data;
+  PetscBool       iascii;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &iascii));
+  if (iascii) PetscCall(PetscViewerASCIIPrintf(viewer, "  restart=%" PetscInt_FMT ", block reorthogonalization %s\n", gm->max_k, KSPGMRESCGSRefinementTypes[gm->cgstype]));
+  PetscCall(KSPSStepView_Private(ksp, viewer));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   KSPSSTEPGMRES - The s-step (communication-avoiding) GMRES method {cite}`chronopoulos_1996`, which orthogonalizes blocks of s Krylov
+   vectors with a single global reduction
+
+   Options Database Keys:
++  -ksp_sstep_size <s>                                                         - the number of vectors per block, see `KSPSStepSetSize()`
+.  -ksp_sstep_basis <monomial,newton,chebyshev>                                - the polynomial basis, see `KSPSStepSetBasis()`
+.  -ksp_sstep_eigenvalues <emin,emax>                                          - an interval containing the spectrum, see `KSPSStepSetEigenvalues()`
+.  -ksp_gmres_restart <restart>                                                - the number of Krylov directions to orthogonalize against
+-  -ksp_gmres_cgs_refinement_type <refine_never,refine_ifneeded,refine_always> - whether a second orthogonalization pass is performed on the blocks
+
+   Level: intermediate
+
+   Notes:
+   Each block of `s` vectors is generated from the last basis vector with `s` applications of the preconditioned operator, then orthogonalized
+   against the previous basis vectors and within itself by block classical Gram-Schmidt with the Pythagorean inner product, with one reduction.
+   With the default `KSP_GMRES_CGS_REFINE_IFNEEDED` a second pass, with a second reduction, is made when the first one loses too much accuracy or
+   the Gram matrix of the block is not numerically positive definite; the numerically dependent vectors of a block are discarded.
+
+   The residual norm of every iteration is available, as in `KSPGMRES`, from the Hessenberg matrix of the block.
+
+   Without a preconditioner (`PCNONE`) the block is generated with `MatMultPowers()`, which for `MATMPIAIJ` exchanges the ghost values once
+   per block instead of once per vector.
+
+   Left and right preconditioning are supported, but not symmetric preconditioning.
+
+.seealso: [](ch_ksp), `KSPCreate()`, `KSPSetType()`, `KSPType`, `KSP`, `KSPGMRES`, `KSPPGMRES`, `KSPPIPEFGMRES`, `KSPSSTEPCG`, `KSPSStepSetSize()`,
+          `KSPSStepSetBasis()`, `KSPSStepSetEigenvalues()`, `KSPGMRESSetRestart()`, `KSPGMRESSetCGSRefinementType()`, `MatMultPowers()`
+M*/
+PETSC_EXTERN PetscErrorCode KSPCreate_SStepGMRES(KSP ksp)
+{
+  KSP_SStepGMRES *gm;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&gm));
+  ksp->data = (void *)gm;
+
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_PRECONDITIONED, PC_LEFT, 3));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_UNPRECONDITIONED, PC_RIGHT, 2));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_RIGHT, 1));
+  PetscCall(KSPSetSupportedNorm(ksp, KSP_NORM_NONE, PC_LEFT, 1));
+
+  ksp->ops->setup          = KSPSetUp_SStepGMRES;
+  ksp->ops->solve          = KSPSolve_SStepGMRES;
+  ksp->ops->reset          = KSPReset_SStepGMRES;
+  ksp->ops->destroy        = KSPDestroy_SStepGMRES;
+  ksp->ops->view           = KSPView_SStepGMRES;
+  ksp->ops->setfromoptions = KSPSetFromOptions_SStepGMRES;
+  ksp->ops->buildsolution  = KSPBuildSolutionDefault;
+  ksp->ops->buildresidual  = KSPBuildResidualDefault;
+  PetscCall(KSPSStepCreate_Private(ksp));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetRestart_C", KSPGMRESSetRestart_SStepGMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetRestart_C", KSPGMRESGetRestart_SStepGMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESSetCGSRefinementType_C", KSPGMRESSetCGSRefinementType_SStepGMRES));
+  PetscCall(PetscObjectComposeFunction((PetscObject)ksp, "KSPGMRESGetCGSRefinementType_C", KSPGMRESGetCGSRefinementType_SStepGMRES));
+
+  gm->max_k   = SSTEPGMRES_DEFAULT_MAXK;
+  gm->cgstype = KSP_GMRES_CGS_REFINE_IFNEEDED;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+/*
+    Private data structure shared by the s-step (communication-avoiding) Krylov methods KSPSSTEPCG and KSPSSTEPGMRES
+*/
+#include <petsc/private/kspimpl.h>
+#include <petscblaslapack.h>
+
+#define KSP_SSTEP_DEFAULT_SIZE 4
+
+/*
+    The s basis vectors generated at each outer iteration satisfy the three term recurrence
+
+        p_{k+1} = ((Op - alpha_k) p_k - beta_k p_{k-1}) / gamma_k,   p_{-1} = 0,
+
+    that is Op [p_0 ... p_{s-1}] = [p_0 ... p_s] Bc with the (s+1) x s tridiagonal change of basis matrix Bc.
+    This structure must be the first member of the data of each s-step KSP.
+*/
+typedef struct {
+  PetscInt      s;                   /* number of iterations per outer iteration */
+  KSPSStepBasis basis;               /* polynomial basis of the vectors generated at each outer iteration */
+  PetscBool     eigset;              /* the spectral interval [emin, emax] was provided by the user */
+  PetscReal     emin, emax;          /* spectral interval used by the Chebyshev basis and the Newton shifts */
+  PetscBool     ready;               /* the coefficients match the basis, otherwise they are monomial until Ritz values are known */
+  PetscScalar  *alpha, *beta, *gamma; /* recurrence coefficients of length s */
+} KSP_SStep;
+
+PETSC_INTERN PetscErrorCode KSPSStepCreate_Private(KSP);
+PETSC_INTERN PetscErrorCode KSPSStepDestroy_Private(KSP);
+PETSC_INTERN PetscErrorCode KSPSStepSetUp_Private(KSP);
+PETSC_INTERN PetscErrorCode KSPSStepReset_Private(KSP);
+PETSC_INTERN PetscErrorCode KSPSStepSetFromOptions_Private(KSP, PetscOptionItems);
+PETSC_INTERN PetscErrorCode KSPSStepView_Private(KSP, PetscViewer);
+PETSC_INTERN PetscErrorCode KSPSStepGetBasisMatrix_Private(KSP, PetscInt, PetscScalar[]);
+PETSC_INTERN PetscErrorCode KSPSStepSetBasisFromRitz_Private(KSP, PetscInt, PetscScalar[], PetscInt);
+PETSC_INTERN PetscErrorCode KSPSStepUsePowers_Private(KSP, PetscBool *);
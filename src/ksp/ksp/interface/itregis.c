@@ -43,10 +43,16 @@ PETSC_EXTERN PetscErrorCode KSPCreate_PIPEGCR(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_PGMRES(KSP);
 #if !defined(PETSC_USE_COMPLEX)
 PETSC_EXTERN PetscErrorCode KSPCreate_DGMRES(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_MPIR(KSP);
 #endif
 PETSC_EXTERN PetscErrorCode KSPCreate_TSIRM(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_CGLS(KSP);
 PETSC_EXTERN PetscErrorCode KSPCreate_FETIDP(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_SStepCG(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_SStepGMRES(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_BlockCG(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_BlockGMRES(KSP);
+PETSC_EXTERN PetscErrorCode KSPCreate_GCRODR(KSP);
 #if defined(PETSC_HAVE_HPDDM)
 PETSC_EXTERN PetscErrorCode KSPCreate_HPDDM(KSP);
 #endif
@@ -114,6 +120,14 @@ PetscErrorCode KSPRegisterAll(void)
   PetscCall(KSPRegister(KSPTSIRM, KSPCreate_TSIRM));
   PetscCall(KSPRegister(KSPCGLS, KSPCreate_CGLS));
   PetscCall(KSPRegister(KSPFETIDP, KSPCreate_FETIDP));
+  PetscCall(KSPRegister(KSPSSTEPCG, KSPCreate_SStepCG));
+  PetscCall(KSPRegister(KSPSSTEPGMRES, KSPCreate_SStepGMRES));
+  PetscCall(KSPRegister(KSPBLOCKCG, KSPCreate_BlockCG));
+  PetscCall(KSPRegister(KSPBLOCKGMRES, KSPCreate_BlockGMRES));
+  PetscCall(KSPRegister(KSPGCRODR, KSPCreate_GCRODR));
+#if !defined(PETSC_USE_COMPLEX)
+  PetscCall(KSPRegister(KSPMPIR, KSPCreate_MPIR));
+#endif
 #if defined(PETSC_HAVE_HPDDM)
   PetscCall(KSPRegister(KSPHPDDM, KSPCreate_HPDDM));
 #endif
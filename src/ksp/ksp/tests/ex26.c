@@ -244,6 +244,15 @@ PetscErrorCode FormJacobian_Grid(GridCtx *grid, Mat jac)
       nsize: {{1 2}}
       args: -ksp_view_final_residual -ksp_type preonly -pc_type ml -mx 5 -my 5 -ksp_monitor -mg_levels_ksp_type richardson -mg_levels_pc_type jacobi -pc_mg_type {{additive multiplicative full kaskade}separate output} -nrhs 7 -ksp_matsolve_batch_size {{4 7}separate output}
 
+    test:
+      suffix: matblock
+      args: -ksp_view_final_residual -ksp_type {{blockcg blockgmres}separate output} -pc_type mg -mx 9 -my 9 -pc_mg_levels 3 -pc_mg_galerkin -ksp_monitor_short -mg_levels_ksp_type richardson -mg_levels_pc_type jacobi -nrhs 7 -rand -ksp_matsolve_batch_size {{4 7}separate output}
+
+    test:
+      suffix: matblockgmres_right
+      nsize: 2
+      args: -ksp_view_final_residual -ksp_type blockgmres -ksp_pc_side right -ksp_gmres_restart 2 -pc_type bjacobi -mx 5 -my 5 -ksp_monitor_short -nrhs 3
+
     testset:
       requires: hpddm
       args: -ksp_view_final_residual -ksp_type hpddm -pc_type mg -pc_mg_levels 3 -pc_mg_galerkin -mx 5 -my 5 -ksp_monitor -mg_levels_ksp_type richardson -mg_levels_pc_type jacobi -nrhs 7
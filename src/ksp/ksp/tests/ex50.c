@@ -2,6 +2,22 @@ static char help[] = "Tests point block Jacobi and ILU for different block sizes
 
 #include <petscksp.h>
 
+/* splits the m local rows into variable blocks of sizes 1, 2, ..., bs, 1, 2, ... */
+static PetscErrorCode SetVariableBlockSizes(Mat A, PetscInt m, PetscInt bs)
+{
+  PetscInt *bsizes, nb = 0;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscMalloc1(m, &bsizes));
+  for (PetscInt i = 0, k = 0; k < m; i = (i + 1) % bs) {
+    bsizes[nb++] = PetscMin(i + 1, m - k);
+    k += bsizes[nb - 1];
+  }
+  PetscCall(MatSetVariableBlockSizes(A, nb, bsizes));
+  PetscCall(PetscFree(bsizes));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 int main(int argc, char **args)
 {
   Vec         x, b, u;
@@ -11,11 +27,14 @@ int main(int argc, char **args)
   PetscReal   norm; /* norm of solution error */
   PetscInt    i, j, k, l, n = 27, its, bs = 2, Ii, J;
   PetscScalar v;
+  PetscBool   vbs = PETSC_FALSE, change = PETSC_FALSE;
 
   PetscFunctionBeginUser;
   PetscCall(PetscInitialize(&argc, &args, NULL, help));
   PetscCall(PetscOptionsGetInt(NULL, NULL, "-bs", &bs, NULL));
   PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-vbs", &vbs, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-change_blocks", &change, NULL));
 
   PetscCall(MatCreate(PETSC_COMM_WORLD, &A));
   PetscCall(MatSetSizes(A, n * bs, n * bs, PETSC_DETERMINE, PETSC_DETERMINE));
@@ -46,6 +65,7 @@ int main(int argc, char **args)
 
   PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
   PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  if (vbs) PetscCall(SetVariableBlockSizes(A, n * bs, bs));
   PetscCall(MatCreateVecs(A, &u, &b));
   PetscCall(VecDuplicate(u, &x));
   PetscCall(VecSet(u, 1.0));
@@ -92,6 +112,18 @@ int main(int argc, char **args)
   */
   if (norm > .1) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Norm of residual %g iterations %" PetscInt_FMT " bs %" PetscInt_FMT "\n", (double)norm, its, bs));
 
+  if (change) {
+    /* new values with the variable blocks, the preconditioner is set up again for these blocks */
+    PetscCall(SetVariableBlockSizes(A, n * bs, bs));
+    PetscCall(MatScale(A, 2.0));
+    PetscCall(MatMult(A, u, b));
+    PetscCall(KSPSolve(ksp, b, x));
+    PetscCall(VecAXPY(x, -1.0, u));
+    PetscCall(VecNorm(x, NORM_2, &norm));
+    PetscCall(KSPGetIterationNumber(ksp, &its));
+    if (norm > .1) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Norm of residual %g iterations %" PetscInt_FMT " bs %" PetscInt_FMT "\n", (double)norm, its, bs));
+  }
+
   /*
      Free work space.  All PETSc objects should be destroyed when they
      are no longer needed.
@@ -132,4 +164,14 @@ int main(int argc, char **args)
       requires: kokkos_kernels
       args: -mat_type aijkokkos
 
+  test:
+    suffix: bjbatch
+    args: -n 20 -bs {{1 3 7 11}} -pc_type bjbatch -ksp_type {{gmres bicg}} -vbs {{0 1}}
+    output_file: output/ex50_1.out
+
+  test:
+    suffix: bjbatch_change
+    args: -n 20 -bs 3 -pc_type bjbatch -change_blocks -ksp_view
+    filter: grep -e "number of blocks" -e "block sizes"
+
 TEST*/
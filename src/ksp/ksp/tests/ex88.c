@@ -0,0 +1,95 @@
+static char help[] = "Tests the fused VecMAXPYMDot() in the classical Gram-Schmidt of KSPGMRES against VecMAXPY(), VecMDot() and VecNorm().\n\n"
+                     "The command line options are:\n"
+                     "  -m <m>, where <m> = number of grid points in each direction.\n\n";
+
+#include <petscksp.h>
+#include <petsc/private/vecimpl.h> /* to remove the VecMAXPYMDot() implementation of the solution vector */
+
+/*
+   Solves a nonsymmetric convection-diffusion problem twice with the same GMRES options. The work vectors
+   of KSP are duplicated from the solution vector, so removing its VecMAXPYMDot() implementation makes the
+   second solve use the unfused VecMAXPY(), VecMDot() and VecNorm(). Both solves must take the same number
+   of iterations and agree up to rounding.
+*/
+static PetscErrorCode Solve(Mat A, Vec b, PetscBool fused, Vec *x, PetscInt *its)
+{
+  KSP ksp;
+
+  PetscFunctionBeginUser;
+  PetscCall(MatCreateVecs(A, x, NULL));
+  if (!fused) (*x)->ops->maxpymdot = NULL;
+  PetscCall(KSPCreate(PetscObjectComm((PetscObject)A), &ksp));
+  PetscCall(KSPSetOperators(ksp, A, A));
+  PetscCall(KSPSetType(ksp, KSPGMRES));
+  PetscCall(KSPSetTolerances(ksp, 1.e-10, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPSetFromOptions(ksp));
+  PetscCall(KSPSolve(ksp, b, *x));
+  PetscCall(KSPGetIterationNumber(ksp, its));
+  PetscCall(KSPDestroy(&ksp));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat       A;
+  Vec       b, x[2], u;
+  PetscInt  m = 16, Istart, Iend, its[2];
+  PetscReal nrm, diff;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+
+  PetscCall(MatCreate(PETSC_COMM_WORLD, &A));
+  PetscCall(MatSetSizes(A, PETSC_DECIDE, PETSC_DECIDE, m * m, m * m));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatSeqAIJSetPreallocation(A, 5, NULL));
+  PetscCall(MatMPIAIJSetPreallocation(A, 5, NULL, 5, NULL));
+  PetscCall(MatGetOwnershipRange(A, &Istart, &Iend));
+  for (PetscInt row = Istart; row < Iend; row++) {
+    const PetscInt i = row / m, j = row - i * m;
+
+    if (i > 0) PetscCall(MatSetValue(A, row, row - m, -1.5, INSERT_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(A, row, row + m, -0.5, INSERT_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, row, row - 1, -1.25, INSERT_VALUES));
+    if (j < m - 1) PetscCall(MatSetValue(A, row, row + 1, -0.75, INSERT_VALUES));
+    PetscCall(MatSetValue(A, row, row, 4.0, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+
+  PetscCall(MatCreateVecs(A, &u, &b));
+  PetscCall(VecSet(u, 1.0));
+  PetscCall(MatMult(A, u, b));
+
+  PetscCall(Solve(A, b, PETSC_TRUE, &x[0], &its[0]));
+  PetscCall(Solve(A, b, PETSC_FALSE, &x[1], &its[1]));
+  PetscCall(VecNorm(x[0], NORM_2, &nrm));
+  PetscCall(VecAXPY(x[1], -1.0, x[0]));
+  PetscCall(VecNorm(x[1], NORM_2, &diff));
+  PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Iterations fused %" PetscInt_FMT " unfused %" PetscInt_FMT "\n", its[0], its[1]));
+  if (diff > 100 * PETSC_SMALL * nrm) PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Relative difference of the solutions %g\n", (double)(diff / nrm)));
+
+  PetscCall(VecDestroy(&x[0]));
+  PetscCall(VecDestroy(&x[1]));
+  PetscCall(VecDestroy(&u));
+  PetscCall(VecDestroy(&b));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+      args: -pc_type none -ksp_gmres_restart 20 -ksp_gmres_cgs_refinement_type {{refine_ifneeded refine_always}}
+
+      test:
+         suffix: 1
+
+      test:
+         suffix: 2
+         nsize: 3
+         args: -m 21
+
+TEST*/
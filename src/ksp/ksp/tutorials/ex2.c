@@ -364,6 +364,40 @@ int main(int argc, char **args)
       nsize: 4
       args: -ksp_monitor_short -ksp_type pipecg2 -m 15 -n 9 -ksp_norm_type {{preconditioned unpreconditioned natural}}
 
+   test:
+      suffix: sstepcg
+      args: -ksp_monitor_short -ksp_type sstepcg -m 9 -n 9 -ksp_sstep_basis {{monomial newton chebyshev}separate output}
+
+   test:
+      suffix: sstepcg_none
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type sstepcg -m 8 -n 8 -pc_type none -ksp_sstep_size 6 -ksp_sstep_basis chebyshev -ksp_sstep_residual_replacement 2 -ksp_norm_type {{unpreconditioned natural}separate output}
+
+   test:
+      suffix: sstepgmres
+      args: -ksp_monitor_short -ksp_type sstepgmres -m 9 -n 9 -ksp_sstep_basis {{monomial newton chebyshev}separate output}
+
+   test:
+      suffix: sstepgmres_right
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type sstepgmres -m 8 -n 8 -ksp_pc_side right -ksp_gmres_restart 10 -ksp_sstep_size 5 -ksp_gmres_cgs_refinement_type refine_always
+
+   test:
+      suffix: sstepgmres_none
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type sstepgmres -m 8 -n 8 -pc_type none -ksp_sstep_size 8 -ksp_sstep_basis newton
+
+   test:
+      suffix: mpir
+      requires: double !complex
+      args: -ksp_monitor_short -ksp_type mpir -m 20 -n 20 -ksp_rtol 1e-10 -pc_type {{jacobi sor ilu lu}separate output}
+
+   test:
+      suffix: mpir_bjacobi
+      requires: double !complex
+      nsize: 2
+      args: -ksp_monitor_short -ksp_type mpir -m 20 -n 20 -ksp_rtol 1e-10 -pc_type bjacobi -sub_pc_type ilu -sub_pc_factor_mat_ordering_type rcm -ksp_mpir_inner_rtol 1e-3 -ksp_mpir_inner_max_it 20
+
    test:
       suffix: hpddm
       nsize: 4
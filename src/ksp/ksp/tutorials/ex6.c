@@ -107,4 +107,9 @@ int main(int argc, char **args)
       args: -num_numfac 2 -pc_type lu -pc_factor_mat_solver_type mumps
       requires: mumps
 
+    test:
+      suffix: gcrodr
+      nsize: 2
+      args: -N 100 -num_numfac 4 -ksp_type gcrodr -ksp_gmres_restart 20 -ksp_gcrodr_recycle 5 -ksp_pc_side {{left right}separate output}
+
 TEST*/
@@ -0,0 +1,474 @@
+/*
+   Defines a block Jacobi preconditioner for many tiny blocks on the CPU: the blocks of equal size are packed in groups of
+   PCBJBATCH_LANES interleaved blocks so that the dense LU factorization and the triangular solves of all the blocks of a
+   group are done at once, one SIMD lane per block
+*/
+#include <petsc/private/pcimpl.h>
+
+/*
+   Number of blocks of a group, 8 fills an AVX-512 register or two AVX2 registers of doubles
+*/
+#define PCBJBATCH_LANES 8
+
+typedef struct {
+  PetscInt     bs;      /* size of the blocks of the batch */
+  PetscInt     ngroups; /* number of groups of PCBJBATCH_LANES blocks, the last one is padded with identity blocks */
+  PetscInt    *start;   /* first local row of the block in lane l of group g at g * PCBJBATCH_LANES + l, -1 for padding */
+  PetscScalar *lu;      /* LU factors, entry (i, j) of lane l of group g at ((g * bs + j) * bs + i) * PCBJBATCH_LANES + l */
+  PetscInt    *piv;     /* row interchanges, step k of lane l of group g at (g * bs + k) * PCBJBATCH_LANES + l */
+} PCBJBatch_Batch;
+
+typedef struct {
+  PetscInt         nblocks, min_bs, max_bs;
+  PetscInt        *bsizes;   /* sizes of the blocks the batches were built for */
+  PetscInt         nbatches; /* number of distinct block sizes */
+  PCBJBatch_Batch *batches;
+  PetscInt         nthreads;
+  PetscScalar     *work; /* PCBJBATCH_LANES * max_bs entries per thread */
+  PetscLogDouble   factorflops, solveflops;
+} PC_BJBatch;
+
+/*
+   LU factorization with partial pivoting of the PCBJBATCH_LANES interleaved blocks of a group, the inverses of the pivots are
+   stored on the diagonal. The smallest row with a zero pivot, if any, is returned in zrow
+*/
+static inline void PCBJBatchFactor_Private(PetscInt bs, const PetscInt *start, PetscScalar *a, PetscInt *piv, PetscInt *zrow)
+{
+  const PetscInt W = PCBJBATCH_LANES;
+
+  for (PetscInt k = 0; k < bs; k++) {
+    PetscScalar *colk = a + k * bs * W;
+
+    for (PetscInt l = 0; l < W; l++) {
+      PetscInt  p   = k;
+      PetscReal max = PetscAbsScalar(colk[k * W + l]);
+
+      for (PetscInt i = k + 1; i < bs; i++) {
+        if (PetscAbsScalar(colk[i * W + l]) > max) {
+          max = PetscAbsScalar(colk[i * W + l]);
+          p   = i;
+        }
+      }
+      piv[k * W + l] = p;
+      if (p != k) {
+        for (PetscInt j = 0; j < bs; j++) {
+          const PetscScalar t = a[(j * bs + k) * W + l];
+
+          a[(j * bs + k) * W + l] = a[(j * bs + p) * W + l];
+          a[(j * bs + p) * W + l] = t;
+        }
+      }
+      /* a zero pivot gives an infinite entry so that the KSP stops with KSP_DIVERGED_PC_FAILED */
+      if (max == 0.0) *zrow = PetscMin(*zrow, start[l] + k);
+      colk[k * W + l] = 1.0 / colk[k * W + l];
+    }
+    for (PetscInt i = k + 1; i < bs; i++) {
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < W; l++) colk[i * W + l] *= colk[k * W + l];
+    }
+    for (PetscInt j = k + 1; j < bs; j++) {
+      PetscScalar *colj = a + j * bs * W;
+
+      for (PetscInt i = k + 1; i < bs; i++) {
+        PetscPragmaSIMD
+        for (PetscInt l = 0; l < W; l++) colj[i * W + l] -= colk[i * W + l] * colj[k * W + l];
+      }
+    }
+  }
+}
+
+static inline void PCBJBatchGather_Private(PetscInt bs, const PetscInt *start, const PetscScalar *x, PetscScalar *b)
+{
+  const PetscInt W = PCBJBATCH_LANES;
+
+  for (PetscInt l = 0; l < W; l++) {
+    if (start[l] < 0) {
+      for (PetscInt i = 0; i < bs; i++) b[i * W + l] = 0.0;
+    } else {
+      for (PetscInt i = 0; i < bs; i++) b[i * W + l] = x[start[l] + i];
+    }
+  }
+}
+
+static inline void PCBJBatchScatter_Private(PetscInt bs, const PetscInt *start, const PetscScalar *b, PetscScalar *y)
+{
+  const PetscInt W = PCBJBATCH_LANES;
+
+  for (PetscInt l = 0; l < W; l++) {
+    if (start[l] < 0) continue;
+    for (PetscInt i = 0; i < bs; i++) y[start[l] + i] = b[i * W + l];
+  }
+}
+
+/*
+   Solves with the PCBJBATCH_LANES interleaved right-hand sides of b in place
+*/
+static inline void PCBJBatchSolve_Private(PetscInt bs, const PetscScalar *a, const PetscInt *piv, PetscScalar *b)
+{
+  const PetscInt W = PCBJBATCH_LANES;
+
+  for (PetscInt k = 0; k < bs; k++) {
+    for (PetscInt l = 0; l < W; l++) {
+      const PetscInt p = piv[k * W + l];
+
+      if (p != k) {
+        const PetscScalar t = b[k * W + l];
+
+        b[k * W + l] = b[p * W + l];
+        b[p * W + l] = t;
+      }
+    }
+  }
+  for (PetscInt k = 0; k < bs; k++) {
+    const PetscScalar *colk = a + k * bs * W;
+
+    for (PetscInt i = k + 1; i < bs; i++) {
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < W; l++) b[i * W + l] -= colk[i * W + l] * b[k * W + l];
+    }
+  }
+  for (PetscInt k = bs - 1; k >= 0; k--) {
+    const PetscScalar *colk = a + k * bs * W;
+
+    PetscPragmaSIMD
+    for (PetscInt l = 0; l < W; l++) b[k * W + l] *= colk[k * W + l];
+    for (PetscInt i = 0; i < k; i++) {
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < W; l++) b[i * W + l] -= colk[i * W + l] * b[k * W + l];
+    }
+  }
+}
+
+/*
+   Solves with the transposes of the blocks, P A = L U so A^T = U^T L^T P
+*/
+static inline void PCBJBatchSolveTranspose_Private(PetscInt bs, const PetscScalar *a, const PetscInt *piv, PetscScalar *b)
+{
+  const PetscInt W = PCBJBATCH_LANES;
+
+  for (PetscInt k = 0; k < bs; k++) {
+    const PetscScalar *colk = a + k * bs * W;
+
+    for (PetscInt i = 0; i < k; i++) {
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < W; l++) b[k * W + l] -= colk[i * W + l] * b[i * W + l];
+    }
+    PetscPragmaSIMD
+    for (PetscInt l = 0; l < W; l++) b[k * W + l] *= colk[k * W + l];
+  }
+  for (PetscInt k = bs - 1; k >= 0; k--) {
+    const PetscScalar *colk = a + k * bs * W;
+
+    for (PetscInt i = k + 1; i < bs; i++) {
+      PetscPragmaSIMD
+      for (PetscInt l = 0; l < W; l++) b[k * W + l] -= colk[i * W + l] * b[i * W + l];
+    }
+  }
+  for (PetscInt k = bs - 1; k >= 0; k--) {
+    for (PetscInt l = 0; l < W; l++) {
+      const PetscInt p = piv[k * W + l];
+
+      if (p != k) {
+        const PetscScalar t = b[k * W + l];
+
+        b[k * W + l] = b[p * W + l];
+        b[p * W + l] = t;
+      }
+    }
+  }
+}
+
+static PetscErrorCode PCApply_BJBatch_Private(PC pc, Vec x, Vec y, PetscBool transpose)
+{
+  PC_BJBatch        *jac = (PC_BJBatch *)pc->data;
+  const PetscInt     W = PCBJBATCH_LANES, nt = jac->nthreads;
+  const PetscScalar *xx;
+  PetscScalar       *yy;
+
+  PetscFunctionBegin;
+  PetscCall(VecGetArrayRead(x, &xx));
+  PetscCall(VecGetArrayWrite(y, &yy));
+  PetscPragmaOMP(parallel for num_threads((int)nt) schedule(static, 1) if (nt > 1))
+  for (PetscInt t = 0; t < nt; t++) {
+    PetscScalar *b = jac->work + t * W * jac->max_bs;
+
+    for (PetscInt n = 0; n < jac->nbatches; n++) {
+      const PCBJBatch_Batch *batch = &jac->batches[n];
+      const PetscInt         bs = batch->bs, gs = (batch->ngroups * t) / nt, ge = (batch->ngroups * (t + 1)) / nt;
+
+      for (PetscInt g = gs; g < ge; g++) {
+        const PetscInt    *start = batch->start + g * W, *piv = batch->piv + g * bs * W;
+        const PetscScalar *a     = batch->lu + g * bs * bs * W;
+
+        PCBJBatchGather_Private(bs, start, xx, b);
+        if (transpose) PCBJBatchSolveTranspose_Private(bs, a, piv, b);
+        else PCBJBatchSolve_Private(bs, a, piv, b);
+        PCBJBatchScatter_Private(bs, start, b, yy);
+      }
+    }
+  }
+  PetscCall(VecRestoreArrayRead(x, &xx));
+  PetscCall(VecRestoreArrayWrite(y, &yy));
+  PetscCall(PetscLogFlops(jac->solveflops));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCApply_BJBatch(PC pc, Vec x, Vec y)
+{
+  PetscFunctionBegin;
+  PetscCall(PCApply_BJBatch_Private(pc, x, y, PETSC_FALSE));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCApplyTranspose_BJBatch(PC pc, Vec x, Vec y)
+{
+  PetscFunctionBegin;
+  PetscCall(PCApply_BJBatch_Private(pc, x, y, PETSC_TRUE));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   The local blocks of the matrix, given by MatSetVariableBlockSizes() or else by its block size bs, in which case bsizes is NULL
+*/
+static PetscErrorCode PCBJBatchGetBlocks_Private(PC pc, PetscInt *nblocks, const PetscInt **bsizes, PetscInt *bs)
+{
+  PetscInt nlocal;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetLocalSize(pc->pmat, &nlocal, NULL));
+  PetscCall(MatGetVariableBlockSizes(pc->pmat, nblocks, bsizes));
+  *bs = 0;
+  if (!*nblocks) {
+    PetscCall(MatGetBlockSize(pc->pmat, bs));
+    *nblocks = nlocal / *bs;
+    *bsizes  = NULL;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Sorts the local blocks by size into batches, the blocks of a batch are put in the lanes of the groups in their order in the matrix
+*/
+static PetscErrorCode PCBJBatchSetUpBatches_Private(PC pc)
+{
+  PC_BJBatch     *jac = (PC_BJBatch *)pc->data;
+  const PetscInt  W   = PCBJBATCH_LANES;
+  PetscInt        nblocks, nlocal, bs, *count, *bid, *next, row = 0;
+  const PetscInt *bsizes;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetLocalSize(pc->pmat, &nlocal, NULL));
+  PetscCall(PCBJBatchGetBlocks_Private(pc, &nblocks, &bsizes, &bs));
+  PetscCall(PetscMalloc1(nblocks, &jac->bsizes));
+  for (PetscInt i = 0; i < nblocks; i++) jac->bsizes[i] = bsizes ? bsizes[i] : bs;
+  jac->nblocks     = nblocks;
+  jac->min_bs      = nblocks ? PETSC_INT_MAX : 0;
+  jac->max_bs      = 0;
+  jac->factorflops = 0.0;
+  jac->solveflops  = 0.0;
+  for (PetscInt i = 0; i < nblocks; i++) {
+    const PetscInt b = bsizes ? bsizes[i] : bs;
+
+    jac->min_bs = PetscMin(jac->min_bs, b);
+    jac->max_bs = PetscMax(jac->max_bs, b);
+    jac->factorflops += (2.0 * b * b * b) / 3.0;
+    jac->solveflops += 2.0 * b * b - b;
+  }
+  PetscCall(PetscCalloc3(jac->max_bs + 1, &count, jac->max_bs + 1, &bid, jac->max_bs + 1, &next));
+  for (PetscInt i = 0; i < nblocks; i++) count[bsizes ? bsizes[i] : bs]++;
+  jac->nbatches = 0;
+  for (PetscInt b = 1; b <= jac->max_bs; b++) {
+    if (count[b]) bid[b] = jac->nbatches++;
+  }
+  PetscCall(PetscCalloc1(jac->nbatches, &jac->batches));
+  for (PetscInt b = 1; b <= jac->max_bs; b++) {
+    PCBJBatch_Batch *batch;
+
+    if (!count[b]) continue;
+    batch          = &jac->batches[bid[b]];
+    batch->bs      = b;
+    batch->ngroups = (count[b] + W - 1) / W;
+    PetscCall(PetscMalloc3(batch->ngroups * W, &batch->start, batch->ngroups * b * b * W, &batch->lu, batch->ngroups * b * W, &batch->piv));
+    for (PetscInt s = 0; s < batch->ngroups * W; s++) batch->start[s] = -1;
+  }
+  for (PetscInt i = 0; i < nblocks; i++) {
+    const PetscInt b = bsizes ? bsizes[i] : bs;
+
+    jac->batches[bid[b]].start[next[b]++] = row;
+    row += b;
+  }
+  PetscCheck(row == nlocal, PETSC_COMM_SELF, PETSC_ERR_ARG_SIZ, "Sum of the block sizes %" PetscInt_FMT " does not match the local size %" PetscInt_FMT, row, nlocal);
+  PetscCall(PetscFree3(count, bid, next));
+  PetscCall(PetscMalloc1(jac->nthreads * W * jac->max_bs, &jac->work));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCReset_BJBatch(PC pc)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+
+  PetscFunctionBegin;
+  for (PetscInt n = 0; n < jac->nbatches; n++) PetscCall(PetscFree3(jac->batches[n].start, jac->batches[n].lu, jac->batches[n].piv));
+  PetscCall(PetscFree(jac->batches));
+  PetscCall(PetscFree(jac->work));
+  PetscCall(PetscFree(jac->bsizes));
+  jac->nbatches = 0;
+  jac->nblocks  = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCSetUp_BJBatch(PC pc)
+{
+  PC_BJBatch     *jac = (PC_BJBatch *)pc->data;
+  const PetscInt  W   = PCBJBATCH_LANES;
+  PetscInt        nt, rstart, zrow = PETSC_INT_MAX, nblocks, bs;
+  const PetscInt *bsizes;
+  PetscBool       rebuild;
+
+  PetscFunctionBegin;
+  /* the batches are built again when the nonzero structure or the blocks of the matrix have changed */
+  PetscCall(PCBJBatchGetBlocks_Private(pc, &nblocks, &bsizes, &bs));
+  rebuild = (PetscBool)(!jac->batches || pc->flag == DIFFERENT_NONZERO_PATTERN || nblocks != jac->nblocks);
+  for (PetscInt i = 0; i < nblocks && !rebuild; i++) rebuild = (PetscBool)((bsizes ? bsizes[i] : bs) != jac->bsizes[i]);
+  if (rebuild) {
+    PetscCall(PCReset_BJBatch(pc));
+    PetscCall(PCBJBatchSetUpBatches_Private(pc));
+  }
+  nt = jac->nthreads;
+  PetscCall(MatGetOwnershipRange(pc->pmat, &rstart, NULL));
+  for (PetscInt n = 0; n < jac->nbatches; n++) {
+    PCBJBatch_Batch *batch = &jac->batches[n];
+    const PetscInt   bs    = batch->bs;
+
+    PetscCall(PetscArrayzero(batch->lu, batch->ngroups * bs * bs * W));
+    for (PetscInt s = 0; s < batch->ngroups * W; s++) {
+      PetscScalar *a = batch->lu + (s / W) * bs * bs * W + s % W;
+
+      if (batch->start[s] < 0) {
+        for (PetscInt i = 0; i < bs; i++) a[(i * bs + i) * W] = 1.0;
+        continue;
+      }
+      for (PetscInt i = 0; i < bs; i++) {
+        const PetscInt    *cols;
+        const PetscScalar *vals;
+        PetscInt           ncols;
+
+        PetscCall(MatGetRow(pc->pmat, rstart + batch->start[s] + i, &ncols, &cols, &vals));
+        for (PetscInt k = 0; k < ncols; k++) {
+          const PetscInt j = cols[k] - rstart - batch->start[s];
+
+          if (j >= 0 && j < bs) a[(j * bs + i) * W] = vals[k];
+        }
+        PetscCall(MatRestoreRow(pc->pmat, rstart + batch->start[s] + i, &ncols, &cols, &vals));
+      }
+    }
+  }
+  PetscPragmaOMP(parallel for num_threads((int)nt) schedule(static, 1) if (nt > 1) reduction(min : zrow))
+  for (PetscInt t = 0; t < nt; t++) {
+    for (PetscInt n = 0; n < jac->nbatches; n++) {
+      PCBJBatch_Batch *batch = &jac->batches[n];
+      const PetscInt   bs = batch->bs, gs = (batch->ngroups * t) / nt, ge = (batch->ngroups * (t + 1)) / nt;
+
+      for (PetscInt g = gs; g < ge; g++) PCBJBatchFactor_Private(bs, batch->start + g * W, batch->lu + g * bs * bs * W, batch->piv + g * bs * W, &zrow);
+    }
+  }
+  PetscCall(PetscLogFlops(jac->factorflops));
+  if (zrow < PETSC_INT_MAX) {
+    PetscCheck(!pc->erroriffailure, PETSC_COMM_SELF, PETSC_ERR_MAT_LU_ZRPVT, "Zero pivot in the block of row %" PetscInt_FMT, rstart + zrow);
+    PetscCall(PetscInfo(pc, "Zero pivot in the block of row %" PetscInt_FMT "\n", rstart + zrow));
+    pc->failedreason = PC_FACTOR_NUMERIC_ZEROPIVOT;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCDestroy_BJBatch(PC pc)
+{
+  PetscFunctionBegin;
+  PetscCall(PCReset_BJBatch(pc));
+  PetscCall(PetscFree(pc->data));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCSetFromOptions_BJBatch(PC pc, PetscOptionItems PetscOptionsObject)
+{
+  PC_BJBatch *jac      = (PC_BJBatch *)pc->data;
+  PetscInt    nthreads = jac->nthreads;
+
+  PetscFunctionBegin;
+  PetscOptionsHeadBegin(PetscOptionsObject, "Batched block Jacobi options");
+  PetscCall(PetscOptionsInt("-pc_bjbatch_threads", "Number of threads sharing the groups of blocks", "PCBJBATCH", nthreads, &nthreads, NULL));
+  PetscOptionsHeadEnd();
+#if defined(PETSC_HAVE_OPENMP)
+  if (nthreads == PETSC_DECIDE) nthreads = PetscNumOMPThreads;
+#else
+  if (nthreads > 1) PetscCall(PetscInfo(pc, "Ignoring -pc_bjbatch_threads %" PetscInt_FMT " since PETSc was not configured with OpenMP\n", nthreads));
+  nthreads = 1;
+#endif
+  PetscCheck(nthreads > 0, PetscObjectComm((PetscObject)pc), PETSC_ERR_ARG_OUTOFRANGE, "Number of threads %" PetscInt_FMT " must be positive", nthreads);
+  if (nthreads != jac->nthreads) {
+    PetscCall(PetscFree(jac->work));
+    if (jac->batches) PetscCall(PetscMalloc1(nthreads * PCBJBATCH_LANES * jac->max_bs, &jac->work));
+    jac->nthreads = nthreads;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode PCView_BJBatch(PC pc, PetscViewer viewer)
+{
+  PC_BJBatch *jac = (PC_BJBatch *)pc->data;
+  PetscBool   iascii;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)viewer, PETSCVIEWERASCII, &iascii));
+  if (iascii) {
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  number of blocks: %" PetscInt_FMT "\n", jac->nblocks));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  block sizes: min=%" PetscInt_FMT " max=%" PetscInt_FMT "\n", jac->min_bs, jac->max_bs));
+    PetscCall(PetscViewerASCIIPrintf(viewer, "  batches of equal size blocks: %" PetscInt_FMT " with %d blocks per group\n", jac->nbatches, PCBJBATCH_LANES));
+    if (jac->nthreads > 1) PetscCall(PetscViewerASCIIPrintf(viewer, "  threads: %" PetscInt_FMT "\n", jac->nthreads));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   PCBJBATCH - Block Jacobi preconditioner for many small blocks that factors and solves the blocks in batches on the CPU
+
+   Options Database Key:
+.  -pc_bjbatch_threads <nthr> - number of OpenMP threads sharing the groups of blocks, use `PETSC_DECIDE` for the number given by `-omp_num_threads`
+
+   Level: intermediate
+
+   Notes:
+   The blocks are given by `MatSetVariableBlockSizes()` or, if it was not called, by the block size of the matrix.
+   The blocks of equal size are packed in groups of 8 blocks whose entries are interleaved, so that the dense LU factorization
+   with partial pivoting and the triangular solves of the 8 blocks of a group are done together, one SIMD lane per block.
+   The last group of each size is padded with identity blocks.
+
+   It computes the same preconditioner as `PCVPBJACOBI` but keeps the LU factors of the blocks instead of their inverses.
+   It is the CPU counterpart of `PCBJKOKKOS` with a direct solver for the blocks.
+
+   If a zero pivot is found the `PCFailedReason` is set to `PC_FACTOR_NUMERIC_ZEROPIVOT`, or an error is generated if
+   `PCSetErrorIfFailure()` was called.
+
+   This works for `MATAIJ` and `MATBAIJ` matrices.
+
+.seealso: [](ch_ksp), `PCCreate()`, `PCSetType()`, `PCType`, `PC`, `PCJACOBI`, `PCPBJACOBI`, `PCVPBJACOBI`, `PCBJACOBI`, `PCBJKOKKOS`, `MatSetVariableBlockSizes()`
+M*/
+
+PETSC_EXTERN PetscErrorCode PCCreate_BJBatch(PC pc)
+{
+  PC_BJBatch *jac;
+
+  PetscFunctionBegin;
+  PetscCall(PetscNew(&jac));
+  jac->nthreads = 1;
+  pc->data      = (void *)jac;
+
+  pc->ops->apply          = PCApply_BJBatch;
+  pc->ops->applytranspose = PCApplyTranspose_BJBatch;
+  pc->ops->setup          = PCSetUp_BJBatch;
+  pc->ops->reset          = PCReset_BJBatch;
+  pc->ops->destroy        = PCDestroy_BJBatch;
+  pc->ops->setfromoptions = PCSetFromOptions_BJBatch;
+  pc->ops->view           = PCView_BJBatch;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,83 @@
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJVBR(Mat, MatType, MatReuse, Mat *);
+
+/* only the diagonal part is stored as MATSEQAIJVBR, the off-diagonal part has no square block structure */
+static PetscErrorCode MatMPIAIJSetPreallocation_MPIAIJVBR(Mat B, PetscInt d_nz, const PetscInt d_nnz[], PetscInt o_nz, const PetscInt o_nnz[])
+{
+  Mat_MPIAIJ *b = (Mat_MPIAIJ *)B->data;
+
+  PetscFunctionBegin;
+  PetscCall(MatMPIAIJSetPreallocation_MPIAIJ(B, d_nz, d_nnz, o_nz, o_nnz));
+  PetscCall(MatConvert_SeqAIJ_SeqAIJVBR(b->A, MATSEQAIJVBR, MAT_INPLACE_MATRIX, &b->A));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* the local blocks set with MatSetVariableBlockSizes() are those of the diagonal part */
+static PetscErrorCode MatAssemblyEnd_MPIAIJVBR(Mat A, MatAssemblyType mode)
+{
+  Mat_MPIAIJ *a = (Mat_MPIAIJ *)A->data;
+
+  PetscFunctionBegin;
+  PetscCall(MatAssemblyEnd_MPIAIJ(A, mode));
+  if (mode == MAT_FINAL_ASSEMBLY && A->bsizes) PetscCall(MatSetVariableBlockSizes(a->A, A->nblocks, A->bsizes));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJVBR(Mat A, MatType type, MatReuse reuse, Mat *newmat)
+{
+  Mat         B = *newmat;
+  Mat_MPIAIJ *b;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) PetscCall(MatDuplicate(A, MAT_COPY_VALUES, &B));
+
+  b = (Mat_MPIAIJ *)B->data;
+  if (b->A) PetscCall(MatConvert_SeqAIJ_SeqAIJVBR(b->A, MATSEQAIJVBR, MAT_INPLACE_MATRIX, &b->A));
+  B->ops->assemblyend = MatAssemblyEnd_MPIAIJVBR;
+  PetscCall(PetscObjectChangeTypeName((PetscObject)B, MATMPIAIJVBR));
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatMPIAIJSetPreallocation_C", MatMPIAIJSetPreallocation_MPIAIJVBR));
+  *newmat = B;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJVBR(Mat A)
+{
+  PetscFunctionBegin;
+  PetscCall(MatSetType(A, MATMPIAIJ));
+  PetscCall(MatConvert_MPIAIJ_MPIAIJVBR(A, MATMPIAIJVBR, MAT_INPLACE_MATRIX, &A));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   MATMPIAIJVBR - MATMPIAIJVBR = "mpiaijvbr" - A parallel sparse matrix type whose diagonal portion on each process is
+   stored as a `MATSEQAIJVBR` matrix, the off-diagonal portion is a `MATSEQAIJ` matrix.
+
+   Options Database Key:
+. -mat_type mpiaijvbr - sets the matrix type to `MATMPIAIJVBR` during a call to `MatSetFromOptions()`
+
+   Level: intermediate
+
+   Note:
+   The blocks set with `MatSetVariableBlockSizes()` are passed to the diagonal portion when the matrix is assembled, they
+   are used by `MatMult()`, `MatMultAdd()` and by `MatSOR()` or ILU(0) in `PCBJACOBI` and `PCASM`.
+
+.seealso: [](ch_matrices), `Mat`, `MATAIJVBR`, `MATSEQAIJVBR`, `MATMPIAIJ`, `MatSetVariableBlockSizes()`
+M*/
+
+/*MC
+   MATAIJVBR - "aijvbr" - A matrix type to be used for sparse matrices with a variable block structure.
+
+   This matrix type is identical to `MATSEQAIJVBR` when constructed with a single process communicator,
+   and `MATMPIAIJVBR` otherwise.  As a result, for single process communicators,
+   `MatSeqAIJSetPreallocation()` is supported, and similarly `MatMPIAIJSetPreallocation()` is supported
+   for communicators controlling multiple processes.  It is recommended that you call both of
+   the above preallocation routines for simplicity.
+
+   Options Database Key:
+. -mat_type aijvbr - sets the matrix type to `MATAIJVBR`
+
+  Level: beginner
+
+.seealso: [](ch_matrices), `Mat`, `MATSEQAIJVBR`, `MATMPIAIJVBR`, `MATSEQAIJ`, `MATMPIAIJ`, `MATAIJSELL`, `MatSetVariableBlockSizes()`
+M*/
@@ -69,6 +69,8 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatResetHash_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatMPIAIJSetPreallocationCSR_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatDiagonalScaleLocal_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatMultPowers_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatSetConcurrentSetValues_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatConvert_mpiaij_mpibaij_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatConvert_mpiaij_mpisbaij_C", NULL));
 #if defined(PETSC_HAVE_CUDA)
@@ -97,6 +99,7 @@ PetscErrorCode MatDestroy_MPIAIJ(Mat mat)
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatMPIAIJSetUseScalableIncreaseOverlap_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatConvert_mpiaij_mpiaijperm_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatConvert_mpiaij_mpiaijsell_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatConvert_mpiaij_mpiaijvbr_C", NULL));
 #if defined(PETSC_HAVE_MKL_SPARSE)
   PetscCall(PetscObjectComposeFunction((PetscObject)mat, "MatConvert_mpiaij_mpiaijmkl_C", NULL));
 #endif
@@ -140,13 +143,20 @@ static PetscErrorCode MatRestoreRowIJ_MPIAIJ(Mat A, PetscInt oshift, PetscBool s
   for communicators controlling multiple processes.  It is recommended that you call both of
   the above preallocation routines for simplicity.
 
-   Options Database Key:
-. -mat_type aij - sets the matrix type to `MATAIJ` during a call to `MatSetFromOptions()`
+   Options Database Keys:
++ -mat_type aij                     - sets the matrix type to `MATAIJ` during a call to `MatSetFromOptions()`
+- -mat_aij_detect_block_size <bool> - look for a uniform block size in the nonzero structure at the first final assembly and convert the matrix to `MATBAIJ` if one is found
+
+   Notes:
+   With `-mat_aij_detect_block_size` a matrix that has no block size is checked at the end of its first `MatAssemblyEnd()` with
+   `MAT_FINAL_ASSEMBLY`. If the rows come in groups of bs rows, bs <= 16, with the same nonzero columns, made of runs of bs
+   consecutive columns starting at a multiple of bs, the matrix is converted in place to `MATBAIJ` with block size bs and its block
+   kernels are used from then on. The decision is reported with `-info`. Options set with `MatSetOption()` are not kept by the conversion.
 
   Developer Note:
   Level: beginner
 
-    Subclasses include `MATAIJCUSPARSE`, `MATAIJPERM`, `MATAIJSELL`, `MATAIJMKL`, `MATAIJCRL`, `MATAIJKOKKOS`,and also automatically switches over to use inodes when
+    Subclasses include `MATAIJCUSPARSE`, `MATAIJPERM`, `MATAIJSELL`, `MATAIJVBR`, `MATAIJMKL`, `MATAIJCRL`, `MATAIJKOKKOS`,and also automatically switches over to use inodes when
    enough exist.
 
 .seealso: [](ch_matrices), `Mat`, `MATMPIAIJ`, `MATSEQAIJ`, `MatCreateAIJ()`, `MatCreateSeqAIJ()`, `MATSEQAIJ`, `MATMPIAIJ`
@@ -635,6 +645,53 @@ PetscErrorCode MatSetValues_MPIAIJ(Mat mat, PetscInt m, const PetscInt im[], Pet
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   MatSetValues() for MAT_CONCURRENT_SET_VALUES, see MatSetValues_SeqAIJ_Concurrent(); the stash cannot be shared by the threads so only
+   local rows may be set, the global column indices of the off-diagonal part are mapped with the colmap that is only read here
+*/
+static PetscErrorCode MatSetValues_MPIAIJ_Concurrent(Mat mat, PetscInt m, const PetscInt im[], PetscInt n, const PetscInt in[], const PetscScalar v[], InsertMode addv)
+{
+  Mat_MPIAIJ *aij    = (Mat_MPIAIJ *)mat->data;
+  Mat_SeqAIJ *a      = (Mat_SeqAIJ *)aij->A->data, *b = (Mat_SeqAIJ *)aij->B->data;
+  PetscInt    rstart = mat->rmap->rstart, rend = mat->rmap->rend, cstart = mat->cmap->rstart, cend = mat->cmap->rend;
+  PetscScalar value  = 0.0;
+
+  PetscFunctionBegin;
+  PetscCheck(mat->assembled || mat->was_assembled, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "The nonzero structure must be assembled before MatSetValues() with MAT_CONCURRENT_SET_VALUES");
+  PetscCheck(aij->colmap || !aij->B->cmap->n, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Missing colmap for MAT_CONCURRENT_SET_VALUES");
+  for (PetscInt i = 0; i < m; i++) {
+    const PetscInt row = im[i] - rstart;
+
+    if (im[i] < 0) continue;
+    PetscCheck(im[i] >= rstart && im[i] < rend, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Setting off process row %" PetscInt_FMT " with MAT_CONCURRENT_SET_VALUES", im[i]);
+    for (PetscInt j = 0; j < n; j++) {
+      PetscInt  col;
+      PetscBool found;
+
+      if (in[j] < 0) continue;
+      PetscCheck(in[j] < mat->cmap->N, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Column too large: col %" PetscInt_FMT " max %" PetscInt_FMT, in[j], mat->cmap->N - 1);
+      if (v && !mat->structure_only) value = aij->roworiented ? v[i * n + j] : v[i + j * m];
+      if (!mat->structure_only && value == 0.0 && a->ignorezeroentries && addv == ADD_VALUES && im[i] != in[j]) continue;
+      if (in[j] >= cstart && in[j] < cend) found = MatSeqAIJSetValueConcurrent_Private(a, row, in[j] - cstart, value, addv);
+      else {
+        col = -1;
+        if (aij->colmap) {
+#if defined(PETSC_USE_CTABLE)
+          PetscCall(PetscHMapIGetWithDefault(aij->colmap, in[j] + 1, 0, &col));
+          col--;
+#else
+          col = aij->colmap[in[j]] - 1;
+#endif
+        }
+        found = (PetscBool)(col >= 0 && MatSeqAIJSetValueConcurrent_Private(b, row, col, value, addv));
+      }
+      if (found || (in[j] >= cstart && in[j] < cend ? a->nonew : b->nonew) == 1) continue;
+      SETERRQ(PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Inserting a new nonzero at global row/column (%" PetscInt_FMT ", %" PetscInt_FMT ") into matrix with MAT_CONCURRENT_SET_VALUES", im[i], in[j]);
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*
     This function sets the j and ilen arrays (of the diagonal and off-diagonal part) of an MPIAIJ-matrix.
     The values in mat_i have to be sorted and the values in mat_j have to be sorted for each row (CSR-like).
@@ -771,6 +828,39 @@ static PetscErrorCode MatAssemblyBegin_MPIAIJ(Mat mat, MatAssemblyType mode)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* Looks once for a uniform block structure in a MATMPIAIJ matrix without a block size and converts it to MATMPIBAIJ if one is found */
+static PetscErrorCode MatAssemblyEnd_MPIAIJ_DetectBlockSize(Mat mat)
+{
+  Mat_MPIAIJ *aij  = (Mat_MPIAIJ *)mat->data;
+  PetscInt    mask = 0, bs = 1;
+  PetscBool   ismpiaij;
+
+  PetscFunctionBegin;
+  aij->detectblocksize = PETSC_FALSE;
+  PetscCall(PetscObjectTypeCompare((PetscObject)mat, MATMPIAIJ, &ismpiaij));
+  if (!ismpiaij || mat->rmap->bs > 1 || mat->cmap->bs > 1 || mat->structure_only || !mat->rmap->N) PetscFunctionReturn(PETSC_SUCCESS);
+  /* the blocks must not straddle the ownership ranges, then they lie either in the diagonal or in the off-diagonal part */
+  for (PetscInt k = 2; k <= 16; k++) {
+    if (mat->rmap->n % k == 0 && mat->rmap->rstart % k == 0 && mat->cmap->n % k == 0 && mat->cmap->rstart % k == 0) mask |= (PetscInt)1 << k;
+  }
+  PetscCall(MatSeqAIJGetBlockSizeMask_Private(aij->A, mat->cmap->rstart, NULL, &mask));
+  PetscCall(MatSeqAIJGetBlockSizeMask_Private(aij->B, 0, aij->garray, &mask));
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, &mask, 1, MPIU_INT, MPI_BAND, PetscObjectComm((PetscObject)mat)));
+  for (PetscInt k = 2; k <= 16; k++) {
+    if (mask & ((PetscInt)1 << k)) bs = k;
+  }
+  if (bs == 1) {
+    PetscCall(PetscInfo(mat, "No uniform block structure found in the nonzero structure\n"));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscInfo(mat, "Found a uniform block size %" PetscInt_FMT " in the nonzero structure, converting to MATMPIBAIJ\n", bs));
+  /* the converter preallocates the diagonal part with the block size of aij->A, the off-diagonal part takes the one of mat */
+  PetscCall(PetscLayoutSetBlockSize(aij->A->rmap, bs));
+  PetscCall(PetscLayoutSetBlockSize(aij->A->cmap, bs));
+  PetscCall(MatAIJConvertToBAIJ_Private(mat, bs));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PetscErrorCode MatAssemblyEnd_MPIAIJ(Mat mat, MatAssemblyType mode)
 {
   Mat_MPIAIJ  *aij = (Mat_MPIAIJ *)mat->data;
@@ -832,6 +922,7 @@ PetscErrorCode MatAssemblyEnd_MPIAIJ(Mat mat, MatAssemblyType mode)
 #endif
   PetscCall(MatAssemblyBegin(aij->B, mode));
   PetscCall(MatAssemblyEnd(aij->B, mode));
+  if (mat->ops->setvalues == MatSetValues_MPIAIJ_Concurrent && mode == MAT_FINAL_ASSEMBLY && !aij->colmap) PetscCall(MatCreateColmap_MPIAIJ_Private(mat));
 
   PetscCall(PetscFree2(aij->rowvalues, aij->rowindices));
 
@@ -847,6 +938,7 @@ PetscErrorCode MatAssemblyEnd_MPIAIJ(Mat mat, MatAssemblyType mode)
 #if defined(PETSC_HAVE_DEVICE)
   mat->offloadmask = PETSC_OFFLOAD_BOTH;
 #endif
+  if (aij->detectblocksize && mode == MAT_FINAL_ASSEMBLY) PetscCall(MatAssemblyEnd_MPIAIJ_DetectBlockSize(mat)); /* mat may be a MATMPIBAIJ matrix after this call */
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -1710,6 +1802,24 @@ PetscErrorCode MatSetOption_MPIAIJ(Mat A, MatOption op, PetscBool flg)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* MatSetOption() with MAT_CONCURRENT_SET_VALUES, composed to declare that the type supports it */
+static PetscErrorCode MatSetConcurrentSetValues_MPIAIJ(Mat A, PetscBool flg)
+{
+  Mat_MPIAIJ *a = (Mat_MPIAIJ *)A->data;
+
+  PetscFunctionBegin;
+  if (flg) {
+    PetscBool device;
+
+    PetscCheck(PetscDefined(HAVE_OPENMP), PETSC_COMM_SELF, PETSC_ERR_SUP, "MAT_CONCURRENT_SET_VALUES requires PETSc configured with OpenMP");
+    PetscCall(PetscObjectTypeCompareAny((PetscObject)A, &device, MATMPIAIJCUSPARSE, MATMPIAIJHIPSPARSE, MATMPIAIJKOKKOS, MATMPIAIJVIENNACL, ""));
+    PetscCheck(!device, PETSC_COMM_SELF, PETSC_ERR_SUP, "MAT_CONCURRENT_SET_VALUES is not supported for matrix type %s", ((PetscObject)A)->type_name);
+    if ((A->assembled || A->was_assembled) && !a->colmap) PetscCall(MatCreateColmap_MPIAIJ_Private(A));
+    A->ops->setvalues = MatSetValues_MPIAIJ_Concurrent;
+  } else A->ops->setvalues = MatSetValues_MPIAIJ;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PetscErrorCode MatGetRow_MPIAIJ(Mat matin, PetscInt row, PetscInt *nz, PetscInt **idx, PetscScalar **v)
 {
   Mat_MPIAIJ  *mat = (Mat_MPIAIJ *)matin->data;
@@ -2659,13 +2769,15 @@ PetscErrorCode MatMPIAIJSetUseScalableIncreaseOverlap(Mat A, PetscBool sc)
 
 PetscErrorCode MatSetFromOptions_MPIAIJ(Mat A, PetscOptionItems PetscOptionsObject)
 {
-  PetscBool sc = PETSC_FALSE, flg;
+  Mat_MPIAIJ *aij = (Mat_MPIAIJ *)A->data;
+  PetscBool   sc  = PETSC_FALSE, flg;
 
   PetscFunctionBegin;
   PetscOptionsHeadBegin(PetscOptionsObject, "MPIAIJ options");
   if (A->ops->increaseoverlap == MatIncreaseOverlap_MPIAIJ_Scalable) sc = PETSC_TRUE;
   PetscCall(PetscOptionsBool("-mat_increase_overlap_scalable", "Use a scalable algorithm to compute the overlap", "MatIncreaseOverlap", sc, &sc, &flg));
   if (flg) PetscCall(MatMPIAIJSetUseScalableIncreaseOverlap(A, sc));
+  PetscCall(PetscOptionsBool("-mat_aij_detect_block_size", "Look for a uniform block size in the nonzero structure at the first assembly and convert to MATBAIJ", "MATAIJ", aij->detectblocksize, &aij->detectblocksize, NULL));
   PetscOptionsHeadEnd();
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -5980,6 +6092,7 @@ PetscErrorCode MatGetBrowsOfAoCols_MPIAIJ(Mat A, Mat B, MatReuse scall, PetscInt
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJCRL(Mat, MatType, MatReuse, Mat *);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJPERM(Mat, MatType, MatReuse, Mat *);
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJSELL(Mat, MatType, MatReuse, Mat *);
+PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJVBR(Mat, MatType, MatReuse, Mat *);
 #if defined(PETSC_HAVE_MKL_SPARSE)
 PETSC_INTERN PetscErrorCode MatConvert_MPIAIJ_MPIAIJMKL(Mat, MatType, MatReuse, Mat *);
 #endif
@@ -6730,6 +6843,9 @@ static PetscErrorCode MatSetValuesCOO_MPIAIJ(Mat mat, const PetscScalar v[], Ins
   const PetscCount    *Cperm1;
   PetscContainer       container;
   MatCOOStruct_MPIAIJ *coo;
+#if defined(_OPENMP)
+  const int nt = (int)PetscMax(((Mat_SeqAIJ *)A->data)->threads.nthreads, 1);
+#endif
 
   PetscFunctionBegin;
   PetscCall(PetscObjectQuery((PetscObject)mat, "__PETSc_MatCOOStruct_Host", (PetscObject *)&container));
@@ -6753,29 +6869,40 @@ static PetscErrorCode MatSetValuesCOO_MPIAIJ(Mat mat, const PetscScalar v[], Ins
   PetscCall(MatSeqAIJGetArray(B, &Ba));
 
   /* Pack entries to be sent to remote */
+  PetscPragmaOMP(parallel for num_threads(nt) if (nt > 1) schedule(static))
   for (PetscCount i = 0; i < coo->sendlen; i++) sendbuf[i] = v[Cperm1[i]];
 
   /* Send remote entries to their owner and overlap the communication with local computation */
   PetscCall(PetscSFReduceWithMemTypeBegin(coo->sf, MPIU_SCALAR, PETSC_MEMTYPE_HOST, sendbuf, PETSC_MEMTYPE_HOST, recvbuf, MPI_REPLACE));
-  /* Add local entries to A and B */
-  for (PetscCount i = 0; i < coo->Annz; i++) { /* All nonzeros in A are either zero'ed or added with a value (i.e., initialized) */
-    PetscScalar sum = 0.0;                     /* Do partial summation first to improve numerical stability */
-    for (PetscCount k = Ajmap1[i]; k < Ajmap1[i + 1]; k++) sum += v[Aperm1[k]];
-    Aa[i] = (imode == INSERT_VALUES ? 0.0 : Aa[i]) + sum;
-  }
-  for (PetscCount i = 0; i < coo->Bnnz; i++) {
-    PetscScalar sum = 0.0;
-    for (PetscCount k = Bjmap1[i]; k < Bjmap1[i + 1]; k++) sum += v[Bperm1[k]];
-    Ba[i] = (imode == INSERT_VALUES ? 0.0 : Ba[i]) + sum;
+  /* Add local entries to A and B, with the threads of -mat_seqaij_threads sharing the nonzeros of both */
+  PetscPragmaOMP(parallel num_threads(nt) if (nt > 1))
+  {
+    PetscPragmaOMP(for schedule(static) nowait)
+    for (PetscCount i = 0; i < coo->Annz; i++) { /* All nonzeros in A are either zero'ed or added with a value (i.e., initialized) */
+      PetscScalar sum = 0.0;                     /* Do partial summation first to improve numerical stability */
+      for (PetscCount k = Ajmap1[i]; k < Ajmap1[i + 1]; k++) sum += v[Aperm1[k]];
+      Aa[i] = (imode == INSERT_VALUES ? 0.0 : Aa[i]) + sum;
+    }
+    PetscPragmaOMP(for schedule(static))
+    for (PetscCount i = 0; i < coo->Bnnz; i++) {
+      PetscScalar sum = 0.0;
+      for (PetscCount k = Bjmap1[i]; k < Bjmap1[i + 1]; k++) sum += v[Bperm1[k]];
+      Ba[i] = (imode == INSERT_VALUES ? 0.0 : Ba[i]) + sum;
+    }
   }
   PetscCall(PetscSFReduceEnd(coo->sf, MPIU_SCALAR, sendbuf, recvbuf, MPI_REPLACE));
 
-  /* Add received remote entries to A and B */
-  for (PetscCount i = 0; i < coo->Annz2; i++) {
-    for (PetscCount k = Ajmap2[i]; k < Ajmap2[i + 1]; k++) Aa[Aimap2[i]] += recvbuf[Aperm2[k]];
-  }
-  for (PetscCount i = 0; i < coo->Bnnz2; i++) {
-    for (PetscCount k = Bjmap2[i]; k < Bjmap2[i + 1]; k++) Ba[Bimap2[i]] += recvbuf[Bperm2[k]];
+  /* Add received remote entries to A and B, each of the Annz2 and Bnnz2 nonzeros is distinct */
+  PetscPragmaOMP(parallel num_threads(nt) if (nt > 1))
+  {
+    PetscPragmaOMP(for schedule(static) nowait)
+    for (PetscCount i = 0; i < coo->Annz2; i++) {
+      for (PetscCount k = Ajmap2[i]; k < Ajmap2[i + 1]; k++) Aa[Aimap2[i]] += recvbuf[Aperm2[k]];
+    }
+    PetscPragmaOMP(for schedule(static))
+    for (PetscCount i = 0; i < coo->Bnnz2; i++) {
+      for (PetscCount k = Bjmap2[i]; k < Bjmap2[i + 1]; k++) Ba[Bimap2[i]] += recvbuf[Bperm2[k]];
+    }
   }
   PetscCall(MatSeqAIJRestoreArray(A, &Aa));
   PetscCall(MatSeqAIJRestoreArray(B, &Ba));
@@ -6846,8 +6973,11 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJ(Mat B)
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatResetHash_C", MatResetHash_MPIAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatMPIAIJSetPreallocationCSR_C", MatMPIAIJSetPreallocationCSR_MPIAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatDiagonalScaleLocal_C", MatDiagonalScaleLocal_MPIAIJ));
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatMultPowers_C", MatMultPowers_MPIAIJ));
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSetConcurrentSetValues_C", MatSetConcurrentSetValues_MPIAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_mpiaij_mpiaijperm_C", MatConvert_MPIAIJ_MPIAIJPERM));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_mpiaij_mpiaijsell_C", MatConvert_MPIAIJ_MPIAIJSELL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_mpiaij_mpiaijvbr_C", MatConvert_MPIAIJ_MPIAIJVBR));
 #if defined(PETSC_HAVE_CUDA)
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_mpiaij_mpiaijcusparse_C", MatConvert_MPIAIJ_MPIAIJCUSPARSE));
 #endif
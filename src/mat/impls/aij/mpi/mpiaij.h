@@ -65,7 +65,8 @@ typedef struct {                                /* used by MatPtAPXXX_MPIAIJ_MPI
 typedef struct {
   MPIAIJHEADER;
   Vec       diag;
-  PetscInt *ld; /* number of entries per row left of diagonal block */
+  PetscInt *ld;              /* number of entries per row left of diagonal block */
+  PetscBool detectblocksize; /* look for a uniform block structure at the first final assembly, see -mat_aij_detect_block_size */
 
   /* Used by device classes */
   void *spptr;
@@ -181,6 +182,7 @@ PETSC_INTERN PetscErrorCode MatGetSeqMats_MPIAIJ(Mat, Mat *, Mat *);
 PETSC_INTERN PetscErrorCode MatSetSeqMats_MPIAIJ(Mat, IS, IS, IS, MatStructure, Mat, Mat);
 
 PETSC_INTERN PetscErrorCode MatSetPreallocationCOO_MPIAIJ(Mat, PetscCount, PetscInt[], PetscInt[]);
+PETSC_INTERN PetscErrorCode MatMultPowers_MPIAIJ(Mat, Vec, PetscInt, const PetscScalar[], const PetscScalar[], const PetscScalar[], Vec[]);
 
 /* compute apa = A[i,:]*P = Ad[i,:]*P_loc + Ao*[i,:]*P_oth using sparse axpy */
 #define AProw_scalable(i, ad, ao, p_loc, p_oth, api, apj, apa) \
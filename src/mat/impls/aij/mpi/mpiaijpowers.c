@@ -0,0 +1,280 @@
+#include <../src/mat/impls/aij/mpi/mpiaij.h>
+
+/*
+   The ghost region of MatMultPowers_MPIAIJ(): the local entries are the owned rows followed by the off-process rows sorted by
+   their distance, in the graph of A, to the owned rows. A row at distance d < s is needed for the first s - d powers, so each
+   process computes the rows at distance at most s - k of the k-th power redundantly with its neighbors and x is only
+   gathered once, at distance at most s.
+*/
+typedef struct {
+  PetscInt         s;            /* depth of the ghost region */
+  PetscInt        *nlevel;       /* nlevel[d] local entries are at distance at most d, d = 0, ..., s */
+  PetscInt        *gidx, ngidx;  /* global indices of the local entries and the allocated length */
+  PetscHMapI       g2l;          /* local index of the off-process entries */
+  IS               isrow, iscol; /* the off-process rows at distance less than s, sorted, and all the columns */
+  Mat             *sub;          /* these rows of A */
+  PetscInt        *ai, *aj;      /* the local rows at distance less than s, with local column indices */
+  PetscScalar     *aa;
+  Vec              xghost;       /* the entries of x at distance 1, ..., s */
+  VecScatter       scatter;
+  PetscScalar     *work;         /* three local vectors for the recurrence */
+  PetscObjectState nonzerostate; /* nonzero state of A when the ghost region was built */
+  PetscObjectState state;        /* state of A when the values of the local rows were copied, it changes on all processes together */
+} Mat_MPIAIJ_MultPowers;
+
+static PetscErrorCode MatMultPowersReset_MPIAIJ(Mat_MPIAIJ_MultPowers *mp)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscFree(mp->nlevel));
+  PetscCall(PetscFree(mp->gidx));
+  PetscCall(PetscHMapIDestroy(&mp->g2l));
+  PetscCall(ISDestroy(&mp->isrow));
+  PetscCall(ISDestroy(&mp->iscol));
+  if (mp->sub) PetscCall(MatDestroySubMatrices(1, &mp->sub));
+  PetscCall(PetscFree(mp->ai));
+  PetscCall(PetscFree2(mp->aj, mp->aa));
+  PetscCall(VecDestroy(&mp->xghost));
+  PetscCall(VecScatterDestroy(&mp->scatter));
+  PetscCall(PetscFree(mp->work));
+  mp->ngidx = 0;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatMultPowersDestroy_MPIAIJ(void **ctx)
+{
+  PetscFunctionBegin;
+  PetscCall(MatMultPowersReset_MPIAIJ((Mat_MPIAIJ_MultPowers *)*ctx));
+  PetscCall(PetscFree(*ctx));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* appends the global index col to the local entries */
+static PetscErrorCode MatMultPowersAppend_MPIAIJ(Mat_MPIAIJ_MultPowers *mp, PetscInt *nlocal, PetscInt col)
+{
+  PetscFunctionBegin;
+  if (*nlocal == mp->ngidx) {
+    mp->ngidx = PetscMax(2 * mp->ngidx, 16);
+    PetscCall(PetscRealloc(mp->ngidx * sizeof(PetscInt), &mp->gidx));
+  }
+  PetscCall(PetscHMapISet(mp->g2l, col, *nlocal));
+  mp->gidx[(*nlocal)++] = col;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* local index of the global column col of A, which must be in the ghost region */
+static inline PetscErrorCode MatMultPowersGetLocal_MPIAIJ(Mat A, Mat_MPIAIJ_MultPowers *mp, PetscInt col, PetscInt *lcol)
+{
+  PetscFunctionBegin;
+  if (col >= A->cmap->rstart && col < A->cmap->rend) *lcol = col - A->cmap->rstart;
+  else {
+    PetscCall(PetscHMapIGetWithDefault(mp->g2l, col, -1, lcol));
+    PetscCheck(*lcol >= 0, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Column %" PetscInt_FMT " is not in the ghost region", col);
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Finds the entries at distance 1, ..., s by gathering, one level after the other, the rows of the previous level and creates
+   the scatter of x. Collective, every process fetches s - 1 levels even when it has no more rows to fetch
+*/
+static PetscErrorCode MatMultPowersSetUp_MPIAIJ(Mat A, PetscInt s, Mat_MPIAIJ_MultPowers *mp)
+{
+  Mat_MPIAIJ     *aij = (Mat_MPIAIJ *)A->data;
+  Mat_SeqAIJ     *ad = (Mat_SeqAIJ *)aij->A->data, *bd = (Mat_SeqAIJ *)aij->B->data, *sd;
+  const PetscInt  n = A->rmap->n, rstart = A->rmap->rstart, rend = A->rmap->rend;
+  PetscInt        nB, nlocal, nrows, *rows;
+  IS              isfrom;
+  Vec             x;
+  const PetscInt *sj;
+
+  PetscFunctionBegin;
+  PetscCall(MatMultPowersReset_MPIAIJ(mp));
+  PetscCall(PetscMalloc1(s + 1, &mp->nlevel));
+  PetscCall(PetscHMapICreate(&mp->g2l));
+  PetscCall(ISCreateStride(PETSC_COMM_SELF, A->cmap->N, 0, 1, &mp->iscol));
+
+  /* the owned rows, then the off-diagonal columns in the order of garray */
+  PetscCall(MatGetSize(aij->B, NULL, &nB));
+  mp->ngidx = n + nB;
+  PetscCall(PetscMalloc1(mp->ngidx, &mp->gidx));
+  for (PetscInt i = 0; i < n; i++) mp->gidx[i] = rstart + i;
+  nlocal = n;
+  for (PetscInt k = 0; k < nB; k++) PetscCall(MatMultPowersAppend_MPIAIJ(mp, &nlocal, aij->garray[k]));
+  mp->nlevel[0] = n;
+  mp->nlevel[1] = nlocal;
+  for (PetscInt d = 2; d <= s; d++) {
+    const PetscInt nprev = mp->nlevel[d - 1] - mp->nlevel[d - 2];
+    IS             is;
+    Mat           *sub;
+
+    PetscCall(ISCreateGeneral(PETSC_COMM_SELF, nprev, mp->gidx + mp->nlevel[d - 2], PETSC_COPY_VALUES, &is));
+    PetscCall(MatCreateSubMatrices(A, 1, &is, &mp->iscol, MAT_INITIAL_MATRIX, &sub));
+    sd = (Mat_SeqAIJ *)sub[0]->data;
+    for (PetscInt k = 0; k < sd->i[nprev]; k++) {
+      const PetscInt col = sd->j[k];
+      PetscBool      has;
+
+      if (col >= rstart && col < rend) continue;
+      PetscCall(PetscHMapIHas(mp->g2l, col, &has));
+      if (!has) PetscCall(MatMultPowersAppend_MPIAIJ(mp, &nlocal, col));
+    }
+    PetscCall(MatDestroySubMatrices(1, &sub));
+    PetscCall(ISDestroy(&is));
+    /* sorting each level keeps the rows requested from each process sorted */
+    PetscCall(PetscSortInt(nlocal - mp->nlevel[d - 1], mp->gidx + mp->nlevel[d - 1]));
+    for (PetscInt l = mp->nlevel[d - 1]; l < nlocal; l++) PetscCall(PetscHMapISet(mp->g2l, mp->gidx[l], l));
+    mp->nlevel[d] = nlocal;
+  }
+
+  /* the off-process rows at distance less than s, sorted, their values are gathered again when A changes */
+  nrows = mp->nlevel[s - 1] - n;
+  PetscCall(PetscMalloc1(nrows, &rows));
+  PetscCall(PetscArraycpy(rows, mp->gidx + n, nrows));
+  PetscCall(PetscSortInt(nrows, rows));
+  PetscCall(ISCreateGeneral(PETSC_COMM_SELF, nrows, rows, PETSC_OWN_POINTER, &mp->isrow));
+  PetscCall(MatCreateSubMatrices(A, 1, &mp->isrow, &mp->iscol, MAT_INITIAL_MATRIX, &mp->sub));
+  sd = (Mat_SeqAIJ *)mp->sub[0]->data;
+
+  /* the nonzero structure of the local rows, the column indices are set with the values */
+  PetscCall(PetscMalloc1(n + nrows + 1, &mp->ai));
+  mp->ai[0] = 0;
+  PetscCall(ISGetIndices(mp->isrow, &sj));
+  for (PetscInt r = 0; r < n + nrows; r++) {
+    if (r < n) mp->ai[r + 1] = mp->ai[r] + (ad->i[r + 1] - ad->i[r]) + (bd->i[r + 1] - bd->i[r]);
+    else {
+      PetscInt pos;
+
+      PetscCall(PetscFindInt(mp->gidx[r], nrows, sj, &pos));
+      mp->ai[r + 1] = mp->ai[r] + (sd->i[pos + 1] - sd->i[pos]);
+    }
+  }
+  PetscCall(ISRestoreIndices(mp->isrow, &sj));
+  PetscCall(PetscMalloc2(mp->ai[n + nrows], &mp->aj, mp->ai[n + nrows], &mp->aa));
+
+  /* a single scatter of the entries of x at distance 1, ..., s */
+  nlocal = mp->nlevel[s];
+  PetscCall(VecCreateSeq(PETSC_COMM_SELF, nlocal - n, &mp->xghost));
+  PetscCall(MatCreateVecs(A, &x, NULL));
+  PetscCall(ISCreateGeneral(PETSC_COMM_SELF, nlocal - n, mp->gidx + n, PETSC_USE_POINTER, &isfrom));
+  PetscCall(VecScatterCreate(x, isfrom, mp->xghost, NULL, &mp->scatter));
+  PetscCall(ISDestroy(&isfrom));
+  PetscCall(VecDestroy(&x));
+  PetscCall(PetscMalloc1(3 * nlocal, &mp->work));
+  mp->s            = s;
+  mp->nonzerostate = A->nonzerostate;
+  mp->state        = -1;
+  PetscCall(PetscInfo(A, "Ghost region of depth %" PetscInt_FMT " with %" PetscInt_FMT " entries for %" PetscInt_FMT " local rows\n", s, nlocal - n, n));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* copies the values of the owned rows and of the gathered off-process rows into the local rows */
+static PetscErrorCode MatMultPowersSetValues_MPIAIJ(Mat A, Mat_MPIAIJ_MultPowers *mp)
+{
+  Mat_MPIAIJ      *aij = (Mat_MPIAIJ *)A->data;
+  Mat_SeqAIJ      *ad = (Mat_SeqAIJ *)aij->A->data, *bd = (Mat_SeqAIJ *)aij->B->data, *sd;
+  const PetscInt   n = A->rmap->n, nlocal = mp->nlevel[mp->s - 1];
+  const PetscInt  *sj;
+  const MatScalar *aa, *ba, *sa;
+  PetscObjectState state;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectStateGet((PetscObject)A, &state));
+  if (mp->state == state) PetscFunctionReturn(PETSC_SUCCESS);
+  if (mp->state != -1) PetscCall(MatCreateSubMatrices(A, 1, &mp->isrow, &mp->iscol, MAT_REUSE_MATRIX, &mp->sub));
+  sd = (Mat_SeqAIJ *)mp->sub[0]->data;
+  PetscCall(MatSeqAIJGetArrayRead(aij->A, &aa));
+  PetscCall(MatSeqAIJGetArrayRead(aij->B, &ba));
+  PetscCall(MatSeqAIJGetArrayRead(mp->sub[0], &sa));
+  PetscCall(ISGetIndices(mp->isrow, &sj));
+  for (PetscInt r = 0; r < nlocal; r++) {
+    PetscInt k = mp->ai[r];
+
+    if (r < n) {
+      for (PetscInt l = ad->i[r]; l < ad->i[r + 1]; l++, k++) {
+        mp->aj[k] = ad->j[l];
+        mp->aa[k] = aa[l];
+      }
+      /* the off-diagonal columns are the first level, in the order of garray */
+      for (PetscInt l = bd->i[r]; l < bd->i[r + 1]; l++, k++) {
+        mp->aj[k] = n + bd->j[l];
+        mp->aa[k] = ba[l];
+      }
+    } else {
+      PetscInt pos;
+
+      PetscCall(PetscFindInt(mp->gidx[r], nlocal - n, sj, &pos));
+      for (PetscInt l = sd->i[pos]; l < sd->i[pos + 1]; l++, k++) {
+        PetscCall(MatMultPowersGetLocal_MPIAIJ(A, mp, sd->j[l], &mp->aj[k]));
+        mp->aa[k] = sa[l];
+      }
+    }
+  }
+  PetscCall(ISRestoreIndices(mp->isrow, &sj));
+  PetscCall(MatSeqAIJRestoreArrayRead(mp->sub[0], &sa));
+  PetscCall(MatSeqAIJRestoreArrayRead(aij->B, &ba));
+  PetscCall(MatSeqAIJRestoreArrayRead(aij->A, &aa));
+  mp->state = state;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatMultPowers_MPIAIJ(Mat A, Vec x, PetscInt s, const PetscScalar alpha[], const PetscScalar beta[], const PetscScalar gamma[], Vec y[])
+{
+  Mat_MPIAIJ_MultPowers *mp;
+  const PetscInt        n = A->rmap->n;
+  PetscScalar          *v[3];
+  const PetscScalar    *xa, *xg;
+  PetscLogDouble        flops = 0.0;
+
+  PetscFunctionBegin;
+  PetscCheck(A->rmap->n == A->cmap->n && A->rmap->rstart == A->cmap->rstart, PETSC_COMM_SELF, PETSC_ERR_SUP, "Only for matrices with the same row and column layouts");
+  PetscCall(PetscObjectContainerQuery((PetscObject)A, "MatMultPowers_MPIAIJ", (void **)&mp));
+  if (!mp) {
+    PetscCall(PetscNew(&mp));
+    mp->nonzerostate = -1;
+    PetscCall(PetscObjectContainerCompose((PetscObject)A, "MatMultPowers_MPIAIJ", mp, MatMultPowersDestroy_MPIAIJ));
+  }
+  /* the ghost region is collective to build, every process sees the same nonzero state and s */
+  if (mp->nonzerostate != A->nonzerostate || mp->s != s) PetscCall(MatMultPowersSetUp_MPIAIJ(A, s, mp));
+  PetscCall(MatMultPowersSetValues_MPIAIJ(A, mp));
+
+  /* v[0] is the local part of the previous power, v[1] the one before it, v[2] the new one */
+  v[0] = mp->work;
+  v[1] = mp->work + mp->nlevel[s];
+  v[2] = mp->work + 2 * mp->nlevel[s];
+  PetscCall(VecScatterBegin(mp->scatter, x, mp->xghost, INSERT_VALUES, SCATTER_FORWARD));
+  PetscCall(VecGetArrayRead(x, &xa));
+  PetscCall(PetscArraycpy(v[0], xa, n));
+  PetscCall(VecRestoreArrayRead(x, &xa));
+  PetscCall(VecScatterEnd(mp->scatter, x, mp->xghost, INSERT_VALUES, SCATTER_FORWARD));
+  PetscCall(VecGetArrayRead(mp->xghost, &xg));
+  PetscCall(PetscArraycpy(v[0] + n, xg, mp->nlevel[s] - n));
+  PetscCall(VecRestoreArrayRead(mp->xghost, &xg));
+  PetscCall(PetscArrayzero(v[1], mp->nlevel[s]));
+
+  for (PetscInt k = 0; k < s; k++) {
+    const PetscInt    m  = mp->nlevel[s - k - 1];
+    const PetscScalar a  = alpha ? alpha[k] : 0.0;
+    const PetscScalar b  = beta && k > 0 ? beta[k] : 0.0;
+    const PetscScalar gi = gamma ? 1.0 / gamma[k] : 1.0;
+    const PetscInt   *ai = mp->ai, *aj = mp->aj;
+    const PetscScalar *aa = mp->aa, *vk = v[0], *vkm1 = v[1];
+    PetscScalar       *w  = v[2], *ya;
+
+    /* the rows at distance at most s - k - 1 only couple with entries at distance at most s - k, known from the previous power */
+    for (PetscInt r = 0; r < m; r++) {
+      PetscScalar sum = 0.0;
+
+      for (PetscInt l = ai[r]; l < ai[r + 1]; l++) sum += aa[l] * vk[aj[l]];
+      w[r] = (sum - a * vk[r] - b * vkm1[r]) * gi;
+    }
+    flops += 2.0 * ai[m] + 4.0 * m;
+    PetscCall(VecGetArrayWrite(y[k], &ya));
+    PetscCall(PetscArraycpy(ya, w, n));
+    PetscCall(VecRestoreArrayWrite(y[k], &ya));
+    v[2] = v[1];
+    v[1] = v[0];
+    v[0] = w;
+  }
+  PetscCall(PetscLogFlops(flops));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -29,6 +29,80 @@ static PetscErrorCode MatSeqAIJSetTypeFromOptions(Mat A)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+static PetscErrorCode MatSetFromOptions_SeqAIJ(Mat A, PetscOptionItems PetscOptionsObject)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  PetscFunctionBegin;
+  PetscOptionsHeadBegin(PetscOptionsObject, "SeqAIJ options");
+  PetscCall(PetscOptionsBool("-mat_aij_detect_block_size", "Look for a uniform block size in the nonzero structure at the first assembly and convert to MATBAIJ", "MATAIJ", a->detectblocksize, &a->detectblocksize, NULL));
+  PetscOptionsHeadEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatSeqAIJSetThreadsFromOptions(Mat A)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  PetscFunctionBegin;
+  a->threads.nthreads     = 1;
+  a->threads.nonzerostate = -1;
+  PetscObjectOptionsBegin((PetscObject)A);
+  PetscCall(PetscOptionsInt("-mat_seqaij_threads", "Number of threads used by MatMult() and MatMultAdd() with a persistent nonzero-balanced row partition", "MATSEQAIJ", a->threads.nthreads, &a->threads.nthreads, NULL));
+  PetscOptionsEnd();
+#if defined(PETSC_HAVE_OPENMP)
+  if (a->threads.nthreads == PETSC_DECIDE) a->threads.nthreads = PetscNumOMPThreads;
+#else
+  if (a->threads.nthreads > 1) PetscCall(PetscInfo(A, "Ignoring -mat_seqaij_threads %" PetscInt_FMT " since PETSc was not configured with OpenMP\n", a->threads.nthreads));
+  a->threads.nthreads = 1;
+#endif
+  PetscCheck(a->threads.nthreads > 0, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Number of threads %" PetscInt_FMT " must be positive", a->threads.nthreads);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatSeqAIJSetCompressedIndicesFromOptions(Mat A)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  PetscFunctionBegin;
+  a->cindices.nonzerostate = -1;
+  PetscObjectOptionsBegin((PetscObject)A);
+  PetscCall(PetscOptionsBool("-mat_seqaij_compressed_indices", "Use 16-bit column offsets from the first column of each row in MatMult() and MatMultAdd()", "MATSEQAIJ", a->cindices.use, &a->cindices.use, NULL));
+  PetscOptionsEnd();
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatSeqAIJSetSORScheduleFromOptions(Mat A)
+{
+  Mat_SeqAIJ *a          = (Mat_SeqAIJ *)A->data;
+  const char *schedule[] = {"sequential", "levels", "colors"};
+  PetscInt    type       = (PetscInt)a->sor.type;
+
+  PetscFunctionBegin;
+  a->sor.nonzerostate = -1;
+  PetscObjectOptionsBegin((PetscObject)A);
+  PetscCall(PetscOptionsEList("-mat_seqaij_sor_schedule", "Order of the row updates in MatSOR(), levels and colors can use several threads", "MATSEQAIJ", schedule, PETSC_STATIC_ARRAY_LENGTH(schedule), schedule[type], &type, NULL));
+  PetscOptionsEnd();
+  a->sor.type = (MatSeqAIJSORScheduleType)type;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatSeqAIJSetMultTransposeFromOptions(Mat A)
+{
+  Mat_SeqAIJ *a       = (Mat_SeqAIJ *)A->data;
+  const char *types[] = {"auto", "sequential", "private", "colors", "transpose"};
+  PetscInt    type    = (PetscInt)a->multtranspose.type;
+
+  PetscFunctionBegin;
+  a->multtranspose.nonzerostate = -1;
+  a->multtranspose.state        = -1;
+  PetscObjectOptionsBegin((PetscObject)A);
+  PetscCall(PetscOptionsEList("-mat_seqaij_multtranspose", "How the threads share MatMultTranspose(): private accumulators, colors of rows without common columns or a cached explicit transpose", "MATSEQAIJ", types, PETSC_STATIC_ARRAY_LENGTH(types), types[type], &type, NULL));
+  PetscOptionsEnd();
+  a->multtranspose.type = (MatSeqAIJMultTransposeType)type;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode MatGetColumnReductions_SeqAIJ(Mat A, PetscInt type, PetscReal *reductions)
 {
   PetscInt    i, m, n;
@@ -476,6 +550,39 @@ PetscErrorCode MatSetValues_SeqAIJ(Mat A, PetscInt m, const PetscInt im[], Petsc
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   MatSetValues() for MAT_CONCURRENT_SET_VALUES: may be called by several threads at once since it never changes the
+   nonzero structure and updates the values atomically; the flops are not logged and the diagonal is invalidated and
+   the object state increased by MatAssemblyEnd()
+*/
+static PetscErrorCode MatSetValues_SeqAIJ_Concurrent(Mat A, PetscInt m, const PetscInt im[], PetscInt n, const PetscInt in[], const PetscScalar v[], InsertMode is)
+{
+  Mat_SeqAIJ *a                 = (Mat_SeqAIJ *)A->data;
+  MatScalar   value             = 0.0;
+  PetscBool   ignorezeroentries = a->ignorezeroentries;
+  PetscBool   roworiented       = a->roworiented;
+
+  PetscFunctionBegin;
+  PetscCheck(A->assembled || A->was_assembled, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "The nonzero structure must be assembled before MatSetValues() with MAT_CONCURRENT_SET_VALUES");
+  for (PetscInt k = 0; k < m; k++) {
+    const PetscInt row = im[k];
+
+    if (row < 0) continue;
+    PetscCheck(row < A->rmap->n, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Row too large: row %" PetscInt_FMT " max %" PetscInt_FMT, row, A->rmap->n - 1);
+    for (PetscInt l = 0; l < n; l++) {
+      const PetscInt col = in[l];
+
+      if (col < 0) continue;
+      PetscCheck(col < A->cmap->n, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Column too large: col %" PetscInt_FMT " max %" PetscInt_FMT, col, A->cmap->n - 1);
+      if (v && !A->structure_only) value = roworiented ? v[l + k * n] : v[k + l * m];
+      if (!A->structure_only && value == 0.0 && ignorezeroentries && is == ADD_VALUES && row != col) continue;
+      if (MatSeqAIJSetValueConcurrent_Private(a, row, col, value, is) || a->nonew == 1) continue;
+      SETERRQ(PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Inserting a new nonzero at (%" PetscInt_FMT ",%" PetscInt_FMT ") in the matrix with MAT_CONCURRENT_SET_VALUES", row, col);
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode MatSetValues_SeqAIJ_SortedFullNoPreallocation(Mat A, PetscInt m, const PetscInt im[], PetscInt n, const PetscInt in[], const PetscScalar v[], InsertMode is)
 {
   Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
@@ -1093,6 +1200,95 @@ PetscErrorCode MatView_SeqAIJ(Mat A, PetscViewer viewer)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   Clears in *mask the bits 1 << bs of the block sizes bs <= 16 for which the rows of A are not made of full, aligned bs x bs blocks,
+   the global column of the local column j is garray[j] if garray is given and cstart + j otherwise
+*/
+PetscErrorCode MatSeqAIJGetBlockSizeMask_Private(Mat A, PetscInt cstart, const PetscInt garray[], PetscInt *mask)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ *)A->data;
+  const PetscInt *ai = a->i, *aj = a->j, m = A->rmap->n;
+
+  PetscFunctionBegin;
+  for (PetscInt bs = 2; bs <= 16; bs++) {
+    PetscBool valid = PETSC_TRUE;
+
+    if (!(*mask & ((PetscInt)1 << bs))) continue;
+    if (m % bs) valid = PETSC_FALSE;
+    for (PetscInt i = 0; valid && i < m; i += bs) {
+      const PetscInt len = ai[i + 1] - ai[i], *cols = aj + ai[i];
+
+      /* the rows of a block row share their columns, which come in runs of bs consecutive columns starting at a multiple of bs */
+      if (len % bs) valid = PETSC_FALSE;
+      for (PetscInt r = 1; valid && r < bs; r++) {
+        valid = (PetscBool)(ai[i + r + 1] - ai[i + r] == len);
+        if (valid) PetscCall(PetscArraycmp(cols, aj + ai[i + r], len, &valid));
+      }
+      for (PetscInt k = 0; valid && k < len; k += bs) {
+        const PetscInt col = garray ? garray[cols[k]] : cstart + cols[k];
+
+        if (col % bs) valid = PETSC_FALSE;
+        for (PetscInt l = 1; valid && l < bs; l++) valid = (PetscBool)((garray ? garray[cols[k + l]] : cstart + cols[k + l]) == col + l);
+      }
+    }
+    if (!valid) *mask &= ~((PetscInt)1 << bs);
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Replaces the assembled AIJ matrix A with a BAIJ matrix with block size bs, keeping its prefix, name and local to global mappings,
+   called at the end of the type-specific MatAssemblyEnd() so A->assembled is not set yet
+*/
+PetscErrorCode MatAIJConvertToBAIJ_Private(Mat A, PetscInt bs)
+{
+  Mat                    B;
+  const char            *prefix;
+  ISLocalToGlobalMapping rmapping = A->rmap->mapping, cmapping = A->cmap->mapping;
+
+  PetscFunctionBegin;
+  /* the converters take the block size from the layouts, which may be shared with vectors so they get back their block size */
+  PetscCall(PetscLayoutSetBlockSize(A->rmap, bs));
+  PetscCall(PetscLayoutSetBlockSize(A->cmap, bs));
+  A->assembled = PETSC_TRUE;
+  PetscCall(MatConvert(A, MATBAIJ, MAT_INITIAL_MATRIX, &B));
+  PetscCall(PetscLayoutSetBlockSize(A->rmap, 1));
+  PetscCall(PetscLayoutSetBlockSize(A->cmap, 1));
+  PetscCall(PetscObjectGetOptionsPrefix((PetscObject)A, &prefix));
+  PetscCall(PetscObjectSetOptionsPrefix((PetscObject)B, prefix));
+  if (((PetscObject)A)->name) PetscCall(PetscObjectSetName((PetscObject)B, ((PetscObject)A)->name));
+  if (rmapping) PetscCall(MatSetLocalToGlobalMapping(B, rmapping, cmapping));
+  PetscCall(MatHeaderReplace(A, &B));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Looks once for a uniform block structure in a MATSEQAIJ matrix without a block size and converts it to MATSEQBAIJ if one is found */
+static PetscErrorCode MatAssemblyEnd_SeqAIJ_DetectBlockSize(Mat A)
+{
+  Mat_SeqAIJ *a    = (Mat_SeqAIJ *)A->data;
+  PetscInt    mask = 0, bs = 1;
+  PetscBool   isseqaij;
+
+  PetscFunctionBegin;
+  a->detectblocksize = PETSC_FALSE;
+  PetscCall(PetscObjectTypeCompare((PetscObject)A, MATSEQAIJ, &isseqaij));
+  if (!isseqaij || A->rmap->bs > 1 || A->cmap->bs > 1 || A->structure_only || !A->rmap->n) PetscFunctionReturn(PETSC_SUCCESS);
+  for (PetscInt k = 2; k <= 16; k++) {
+    if (A->rmap->n % k == 0 && A->cmap->n % k == 0) mask |= (PetscInt)1 << k;
+  }
+  PetscCall(MatSeqAIJGetBlockSizeMask_Private(A, 0, NULL, &mask));
+  for (PetscInt k = 2; k <= 16; k++) {
+    if (mask & ((PetscInt)1 << k)) bs = k;
+  }
+  if (bs == 1) {
+    PetscCall(PetscInfo(A, "No uniform block structure found in the nonzero structure\n"));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(PetscInfo(A, "Found a uniform block size %" PetscInt_FMT " in the nonzero structure, converting to MATSEQBAIJ\n", bs));
+  PetscCall(MatAIJConvertToBAIJ_Private(A, bs));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PetscErrorCode MatAssemblyEnd_SeqAIJ(Mat A, MatAssemblyType mode)
 {
   Mat_SeqAIJ *a      = (Mat_SeqAIJ *)A->data;
@@ -1107,6 +1303,8 @@ PetscErrorCode MatAssemblyEnd_SeqAIJ(Mat A, MatAssemblyType mode)
   if (A->was_assembled && A->ass_nonzerostate == A->nonzerostate) {
     /* we need to respect users asking to use or not the inodes routine in between matrix assemblies */
     PetscCall(MatAssemblyEnd_SeqAIJ_Inode(A, mode));
+    PetscCall(MatSeqAIJSetUpThreads_Private(A));
+    PetscCall(MatSeqAIJSetUpCompressedIndices_Private(A));
     PetscFunctionReturn(PETSC_SUCCESS);
   }
 
@@ -1161,6 +1359,111 @@ PetscErrorCode MatAssemblyEnd_SeqAIJ(Mat A, MatAssemblyType mode)
 
   if (!A->structure_only) PetscCall(MatCheckCompressedRow(A, a->nonzerorowcnt, &a->compressedrow, a->i, m, ratio));
   PetscCall(MatAssemblyEnd_SeqAIJ_Inode(A, mode));
+  PetscCall(MatSeqAIJSetUpThreads_Private(A));
+  PetscCall(MatSeqAIJSetUpCompressedIndices_Private(A));
+  if (a->detectblocksize) PetscCall(MatAssemblyEnd_SeqAIJ_DetectBlockSize(A)); /* A may be a MATSEQBAIJ matrix after this call */
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Builds the row (and inode) partition used by the thread-parallel kernels; it only depends on the nonzero
+   structure so it is computed once and reused by every MatMult() until the structure changes
+*/
+PetscErrorCode MatSeqAIJSetUpThreads_Private(Mat A)
+{
+  Mat_SeqAIJ *a  = (Mat_SeqAIJ *)A->data;
+  PetscInt    nt = a->threads.nthreads;
+
+  PetscFunctionBegin;
+  if (nt < 2 || A->structure_only || !a->i) PetscFunctionReturn(PETSC_SUCCESS);
+  if (MatSeqAIJUseThreads_Private(A) && (!a->inode.size || a->threads.node_count == a->inode.node_count)) PetscFunctionReturn(PETSC_SUCCESS);
+  if (!a->threads.rstart) PetscCall(PetscMalloc3(nt + 1, &a->threads.rstart, nt + 1, &a->threads.nstart, nt + 1, &a->threads.nrow));
+  if (a->compressedrow.use) MatSeqAIJPartitionRows_Private(a->compressedrow.nrows, a->compressedrow.i, nt, a->threads.rstart);
+  else MatSeqAIJPartitionRows_Private(A->rmap->n, a->i, nt, a->threads.rstart);
+  a->threads.compressed = a->compressedrow.use;
+  a->threads.node_count = 0;
+  if (a->inode.size && a->inode.node_count) {
+    const PetscInt  *ns    = a->inode.size, *ai = a->i, node_count = a->inode.node_count, m = A->rmap->n;
+    const PetscCount total = (PetscCount)ai[m] + m;
+    PetscInt         t     = 1, row = 0;
+
+    a->threads.nstart[0] = 0;
+    a->threads.nrow[0]   = 0;
+    for (PetscInt i = 0; i < node_count && t < nt; i++) { /* start a new piece at the first inode whose weighted offset reaches the target */
+      while (t < nt && (PetscCount)ai[row] + row >= (total * t) / nt) {
+        a->threads.nstart[t] = i;
+        a->threads.nrow[t++] = row;
+      }
+      row += ns[i];
+    }
+    for (; t <= nt; t++) {
+      a->threads.nstart[t] = node_count;
+      a->threads.nrow[t]   = m;
+    }
+    a->threads.node_count = node_count;
+  }
+  a->threads.nonzerostate = A->nonzerostate;
+  PetscCall(PetscInfo(A, "Using %" PetscInt_FMT " threads with a nonzero-balanced row partition in the thread-parallel kernels\n", nt));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatSeqAIJDestroyThreads_Private(Mat A)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree3(a->threads.rstart, a->threads.nstart, a->threads.nrow));
+  a->threads.node_count   = 0;
+  a->threads.nonzerostate = -1;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Builds the 16-bit column offsets used by MatMult() and MatMultAdd(); a row whose columns span more than USHRT_MAX + 1
+   columns keeps using its full indices. Like the row partition it only depends on the nonzero structure
+*/
+PetscErrorCode MatSeqAIJSetUpCompressedIndices_Private(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ *)A->data;
+  PetscInt        m = A->rmap->n, *base;
+  unsigned short *cj;
+
+  PetscFunctionBegin;
+  if (!a->cindices.use || A->structure_only || !a->i || MatSeqAIJUseCompressedIndices_Private(A)) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscFree2(a->cindices.base, a->cindices.j));
+  PetscCall(PetscMalloc2(m, &a->cindices.base, a->i[m], &a->cindices.j));
+  base                = a->cindices.base;
+  cj                  = a->cindices.j;
+  a->cindices.nescape = 0;
+  for (PetscInt i = 0; i < m; i++) {
+    const PetscInt *aj = a->j + a->i[i], n = a->i[i + 1] - a->i[i];
+    PetscInt        cmin = PETSC_INT_MAX, cmax = -1;
+
+    for (PetscInt k = 0; k < n; k++) {
+      cmin = PetscMin(cmin, aj[k]);
+      cmax = PetscMax(cmax, aj[k]);
+    }
+    if (!n) base[i] = 0;
+    else if (cmax - cmin > (PetscInt)USHRT_MAX) {
+      base[i] = -1;
+      a->cindices.nescape++;
+    } else {
+      base[i] = cmin;
+      for (PetscInt k = 0; k < n; k++) cj[a->i[i] + k] = (unsigned short)(aj[k] - cmin);
+    }
+  }
+  a->cindices.nonzerostate = A->nonzerostate;
+  PetscCall(PetscInfo(A, "Using 16-bit column offsets in the products, %" PetscInt_FMT " of %" PetscInt_FMT " rows keep their full column indices\n", a->cindices.nescape, m));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatSeqAIJDestroyCompressedIndices_Private(Mat A)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree2(a->cindices.base, a->cindices.j));
+  a->cindices.nonzerostate = -1;
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -1231,6 +1534,12 @@ static PetscErrorCode MatReset_SeqAIJ(Mat A)
   PetscCall(ISDestroy(&a->icol));
   PetscCall(PetscFree(a->saved_values));
   PetscCall(PetscFree2(a->compressedrow.i, a->compressedrow.rindex));
+  PetscCall(MatSeqAIJDestroyThreads_Private(A));
+  PetscCall(MatSeqAIJDestroyCompressedIndices_Private(A));
+  PetscCall(MatSeqAIJDestroySORSchedule_Private(A));
+  PetscCall(MatSeqAIJDestroyMultTranspose_Private(A));
+  PetscCall(MatSeqAIJDestroySolveLevels_Private(A));
+  PetscCall(MatSeqAIJDestroyIterativeILU_Private(A));
   PetscCall(MatDestroy_SeqAIJ_Inode(A));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
@@ -1268,6 +1577,10 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaij_seqbaij_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaij_seqaijperm_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaij_seqaijsell_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaij_seqaijvbr_C", NULL));
+#if !defined(PETSC_USE_COMPLEX)
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaij_seqaijsingle_C", NULL));
+#endif
 #if defined(PETSC_HAVE_MKL_SPARSE)
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaij_seqaijmkl_C", NULL));
 #endif
@@ -1311,10 +1624,13 @@ PetscErrorCode MatDestroy_SeqAIJ(Mat A)
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatSeqAIJKron_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatSetPreallocationCOO_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatSetValuesCOO_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatSetConcurrentSetValues_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatFactorGetSolverType_C", NULL));
   /* these calls do not belong here: the subclasses Duplicate/Destroy are wrong */
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaijsell_seqaij_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaijvbr_seqaij_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaijperm_seqaij_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaijsingle_seqaij_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaij_seqaijviennacl_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatProductSetFromOptions_seqaijviennacl_seqdense_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatProductSetFromOptions_seqaijviennacl_seqaij_C", NULL));
@@ -1367,6 +1683,21 @@ PetscErrorCode MatSetOption_SeqAIJ(Mat A, MatOption op, PetscBool flg)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* MatSetOption() with MAT_CONCURRENT_SET_VALUES, composed to declare that the type supports it */
+static PetscErrorCode MatSetConcurrentSetValues_SeqAIJ(Mat A, PetscBool flg)
+{
+  PetscFunctionBegin;
+  if (flg) {
+    PetscBool device;
+
+    PetscCheck(PetscDefined(HAVE_OPENMP), PETSC_COMM_SELF, PETSC_ERR_SUP, "MAT_CONCURRENT_SET_VALUES requires PETSc configured with OpenMP");
+    PetscCall(PetscObjectTypeCompareAny((PetscObject)A, &device, MATSEQAIJCUSPARSE, MATSEQAIJHIPSPARSE, MATSEQAIJKOKKOS, MATSEQAIJVIENNACL, ""));
+    PetscCheck(!device, PETSC_COMM_SELF, PETSC_ERR_SUP, "MAT_CONCURRENT_SET_VALUES is not supported for matrix type %s", ((PetscObject)A)->type_name);
+    A->ops->setvalues = MatSetValues_SeqAIJ_Concurrent;
+  } else A->ops->setvalues = A->sortedfull ? MatSetValues_SeqAIJ_SortedFull : MatSetValues_SeqAIJ;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode MatGetDiagonal_SeqAIJ(Mat A, Vec v)
 {
   Mat_SeqAIJ        *a = (Mat_SeqAIJ *)A->data;
@@ -1402,14 +1733,189 @@ static PetscErrorCode MatGetDiagonal_SeqAIJ(Mat A, Vec v)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   Greedy coloring of the nonempty rows such that two rows of the same color have no column in common, the rows of a color
+   can then scatter their contributions to A^T x concurrently. Like the row partition it only depends on the nonzero structure
+*/
+static PetscErrorCode MatSeqAIJSetUpMultTransposeColors_Private(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ *)A->data;
+  const PetscInt *ai = a->i, *aj = a->j, m = A->rmap->n, n = A->cmap->n;
+  PetscInt       *color, *forbidden, *cptr, *crow, nc = 0;
+
+  PetscFunctionBegin;
+  if (a->multtranspose.perm && a->multtranspose.nonzerostate == A->nonzerostate) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscFree(a->multtranspose.cstart));
+  PetscCall(PetscFree(a->multtranspose.perm));
+  /* the rows of each column, in increasing order */
+  PetscCall(PetscCalloc1(n + 1, &cptr));
+  PetscCall(PetscMalloc3(ai[m], &crow, m, &color, m + 1, &forbidden));
+  for (PetscInt k = 0; k < ai[m]; k++) cptr[aj[k] + 1]++;
+  for (PetscInt j = 0; j < n; j++) cptr[j + 1] += cptr[j];
+  for (PetscInt i = 0; i < m; i++)
+    for (PetscInt k = ai[i]; k < ai[i + 1]; k++) crow[cptr[aj[k]]++] = i;
+  for (PetscInt j = n; j > 0; j--) cptr[j] = cptr[j - 1];
+  cptr[0] = 0;
+  for (PetscInt c = 0; c <= m; c++) forbidden[c] = -1;
+
+  /* the smallest color not used by the rows before row i that share a column with it */
+  for (PetscInt i = 0; i < m; i++) {
+    PetscInt c = 0;
+
+    color[i] = -1;
+    if (ai[i + 1] == ai[i]) continue;
+    for (PetscInt k = ai[i]; k < ai[i + 1]; k++) {
+      for (PetscInt l = cptr[aj[k]]; l < cptr[aj[k] + 1] && crow[l] < i; l++) {
+        if (color[crow[l]] >= 0) forbidden[color[crow[l]]] = i;
+      }
+    }
+    while (forbidden[c] == i) c++;
+    color[i] = c;
+    nc       = PetscMax(nc, c + 1);
+  }
+
+  /* counting sort of the nonempty rows by color */
+  PetscCall(PetscCalloc1(nc + 1, &a->multtranspose.cstart));
+  PetscCall(PetscMalloc1(m, &a->multtranspose.perm));
+  for (PetscInt i = 0; i < m; i++)
+    if (color[i] >= 0) a->multtranspose.cstart[color[i] + 1]++;
+  for (PetscInt c = 0; c < nc; c++) a->multtranspose.cstart[c + 1] += a->multtranspose.cstart[c];
+  for (PetscInt i = 0; i < m; i++)
+    if (color[i] >= 0) a->multtranspose.perm[a->multtranspose.cstart[color[i]]++] = i;
+  for (PetscInt c = nc; c > 0; c--) a->multtranspose.cstart[c] = a->multtranspose.cstart[c - 1];
+  a->multtranspose.cstart[0] = 0;
+  PetscCall(PetscFree(cptr));
+  PetscCall(PetscFree3(crow, color, forbidden));
+  a->multtranspose.ncolors      = nc;
+  a->multtranspose.nonzerostate = A->nonzerostate;
+  PetscCall(PetscInfo(A, "Using %" PetscInt_FMT " colors of rows in MatMultTranspose()\n", nc));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Computes the explicit transpose used by MatMultTranspose(), again only when the matrix has changed since it was computed */
+static PetscErrorCode MatSeqAIJSetUpMultTransposeTranspose_Private(Mat A)
+{
+  Mat_SeqAIJ      *a = (Mat_SeqAIJ *)A->data;
+  PetscObjectState state;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectStateGet((PetscObject)A, &state));
+  if (a->multtranspose.At && a->multtranspose.state == state) PetscFunctionReturn(PETSC_SUCCESS);
+  if (a->multtranspose.At && a->multtranspose.nonzerostate != A->nonzerostate) PetscCall(MatDestroy(&a->multtranspose.At));
+  if (!a->multtranspose.At) {
+    PetscCall(MatTranspose(A, MAT_INITIAL_MATRIX, &a->multtranspose.At));
+    ((Mat_SeqAIJ *)a->multtranspose.At->data)->threads.nthreads = a->threads.nthreads;
+    PetscCall(MatSeqAIJSetUpThreads_Private(a->multtranspose.At));
+    PetscCall(PetscInfo(A, "Using an explicit transpose in MatMultTranspose()\n"));
+  } else PetscCall(MatTranspose(A, MAT_REUSE_MATRIX, &a->multtranspose.At));
+  a->multtranspose.state        = state;
+  a->multtranspose.nonzerostate = A->nonzerostate;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatSeqAIJDestroyMultTranspose_Private(Mat A)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree(a->multtranspose.cstart));
+  PetscCall(PetscFree(a->multtranspose.perm));
+  PetscCall(PetscFree(a->multtranspose.work));
+  PetscCall(MatDestroy(&a->multtranspose.At));
+  a->multtranspose.ncolors      = 0;
+  a->multtranspose.nwork        = 0;
+  a->multtranspose.nonzerostate = -1;
+  a->multtranspose.state        = -1;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   The way the threads share MatMultTranspose(): the private accumulators cost (nthreads - 1) * n additional entries to set
+   and to sum, the explicit transpose is used instead when this is more than the number of nonzeros
+*/
+static MatSeqAIJMultTransposeType MatSeqAIJGetMultTransposeType_Private(Mat A)
+{
+  Mat_SeqAIJ                *a    = (Mat_SeqAIJ *)A->data;
+  MatSeqAIJMultTransposeType type = a->multtranspose.type;
+
+  if (a->threads.nthreads < 2 || !a->i) return MAT_SEQAIJ_MULTTRANSPOSE_SEQUENTIAL;
+  if (type == MAT_SEQAIJ_MULTTRANSPOSE_AUTO) type = (PetscCount)(a->threads.nthreads - 1) * A->cmap->n <= (PetscCount)a->nz ? MAT_SEQAIJ_MULTTRANSPOSE_PRIVATE : MAT_SEQAIJ_MULTTRANSPOSE_TRANSPOSE;
+  if (type == MAT_SEQAIJ_MULTTRANSPOSE_PRIVATE && !MatSeqAIJUseThreads_Private(A)) return MAT_SEQAIJ_MULTTRANSPOSE_SEQUENTIAL;
+  return type;
+}
+
+/* y += A^T x with the private accumulators or the colors, thread 0 adds its rows directly into y */
+static PetscErrorCode MatMultTransposeAdd_SeqAIJ_Threaded(Mat A, MatSeqAIJMultTransposeType type, const PetscScalar *x, PetscScalar *y)
+{
+  Mat_SeqAIJ      *a  = (Mat_SeqAIJ *)A->data;
+  const PetscInt   nt = a->threads.nthreads, n = A->cmap->n, *aj = a->j;
+  const MatScalar *aa;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  if (type == MAT_SEQAIJ_MULTTRANSPOSE_PRIVATE) {
+    const PetscInt *ii = a->i, *ridx = NULL, *rstart = a->threads.rstart;
+    PetscScalar    *work;
+
+    if (a->multtranspose.nwork < (nt - 1) * n) {
+      PetscCall(PetscFree(a->multtranspose.work));
+      PetscCall(PetscMalloc1((nt - 1) * n, &a->multtranspose.work));
+      a->multtranspose.nwork = (nt - 1) * n;
+    }
+    work = a->multtranspose.work;
+    if (a->threads.compressed) {
+      ii   = a->compressedrow.i;
+      ridx = a->compressedrow.rindex;
+    }
+    PetscPragmaOMP(parallel for num_threads((int)nt) schedule(static, 1))
+    for (PetscInt t = 0; t < nt; t++) {
+      PetscScalar *w = t ? work + (t - 1) * n : y;
+
+      if (t)
+        for (PetscInt j = 0; j < n; j++) w[j] = 0.0;
+      for (PetscInt i = rstart[t]; i < rstart[t + 1]; i++) {
+        const PetscScalar alpha = x[ridx ? ridx[i] : i];
+
+        for (PetscInt k = ii[i]; k < ii[i + 1]; k++) w[aj[k]] += alpha * aa[k];
+      }
+    }
+    PetscPragmaOMP(parallel for num_threads((int)nt) schedule(static))
+    for (PetscInt j = 0; j < n; j++) {
+      PetscScalar sum = y[j];
+
+      for (PetscInt t = 1; t < nt; t++) sum += work[(t - 1) * n + j];
+      y[j] = sum;
+    }
+    PetscCall(PetscLogFlops((nt - 1.0) * n));
+  } else {
+    const PetscInt *ai = a->i, *perm = a->multtranspose.perm, *cstart = a->multtranspose.cstart, nc = a->multtranspose.ncolors;
+
+    PetscPragmaOMP(parallel num_threads((int)nt))
+    {
+      for (PetscInt c = 0; c < nc; c++) {
+        PetscPragmaOMP(for schedule(static))
+        for (PetscInt r = cstart[c]; r < cstart[c + 1]; r++) {
+          const PetscInt    i     = perm[r];
+          const PetscScalar alpha = x[i];
+
+          for (PetscInt k = ai[i]; k < ai[i + 1]; k++) y[aj[k]] += alpha * aa[k];
+        }
+      }
+    }
+  }
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 #include <../src/mat/impls/aij/seq/ftn-kernels/fmult.h>
 PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat A, Vec xx, Vec zz, Vec yy)
 {
-  Mat_SeqAIJ        *a = (Mat_SeqAIJ *)A->data;
-  const MatScalar   *aa;
-  PetscScalar       *y;
-  const PetscScalar *x;
-  PetscInt           m = A->rmap->n;
+  Mat_SeqAIJ                *a = (Mat_SeqAIJ *)A->data;
+  const MatScalar           *aa;
+  PetscScalar               *y;
+  const PetscScalar         *x;
+  PetscInt                   m    = A->rmap->n;
+  MatSeqAIJMultTransposeType type = MatSeqAIJGetMultTransposeType_Private(A);
 #if !defined(PETSC_USE_FORTRAN_KERNEL_MULTTRANSPOSEAIJ)
   const MatScalar  *v;
   PetscScalar       alpha;
@@ -1420,9 +1926,22 @@ PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat A, Vec xx, Vec zz, Vec yy)
 #endif
 
   PetscFunctionBegin;
+  if (type == MAT_SEQAIJ_MULTTRANSPOSE_TRANSPOSE) {
+    PetscCall(MatSeqAIJSetUpMultTransposeTranspose_Private(A));
+    PetscCall(MatMultAdd(a->multtranspose.At, xx, zz, yy));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  if (type == MAT_SEQAIJ_MULTTRANSPOSE_COLORS) PetscCall(MatSeqAIJSetUpMultTransposeColors_Private(A));
   if (zz != yy) PetscCall(VecCopy(zz, yy));
   PetscCall(VecGetArrayRead(xx, &x));
   PetscCall(VecGetArray(yy, &y));
+  if (type != MAT_SEQAIJ_MULTTRANSPOSE_SEQUENTIAL) {
+    PetscCall(MatMultTransposeAdd_SeqAIJ_Threaded(A, type, x, y));
+    PetscCall(PetscLogFlops(2.0 * a->nz));
+    PetscCall(VecRestoreArrayRead(xx, &x));
+    PetscCall(VecRestoreArray(yy, &y));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
   PetscCall(MatSeqAIJGetArrayRead(A, &aa));
 
 #if defined(PETSC_USE_FORTRAN_KERNEL_MULTTRANSPOSEAIJ)
@@ -1456,12 +1975,74 @@ PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat A, Vec xx, Vec zz, Vec yy)
 
 PetscErrorCode MatMultTranspose_SeqAIJ(Mat A, Vec xx, Vec yy)
 {
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
   PetscFunctionBegin;
+  if (MatSeqAIJGetMultTransposeType_Private(A) == MAT_SEQAIJ_MULTTRANSPOSE_TRANSPOSE) {
+    PetscCall(MatSeqAIJSetUpMultTransposeTranspose_Private(A));
+    PetscCall(MatMult(a->multtranspose.At, xx, yy));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
   PetscCall(VecSet(yy, 0.0));
   PetscCall(MatMultTransposeAdd_SeqAIJ(A, xx, yy, yy));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* z = A x, or z = y + A x if y is given, reading the 16-bit column offsets of the rows that have them */
+static PetscErrorCode MatMultAdd_SeqAIJ_CompressedIndices(Mat A, Vec xx, Vec yy, Vec zz)
+{
+  Mat_SeqAIJ           *a = (Mat_SeqAIJ *)A->data;
+  const PetscScalar    *x, *y = NULL;
+  PetscScalar          *z;
+  const MatScalar      *a_a;
+  const PetscInt       *ii = a->i, *ridx = NULL, *rstart = NULL, *base = a->cindices.base;
+  const unsigned short *cj = a->cindices.j;
+  PetscInt              m = A->rmap->n, nt = 1;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJGetArrayRead(A, &a_a));
+  PetscCall(VecGetArrayRead(xx, &x));
+  if (yy) PetscCall(VecGetArrayPair(yy, zz, (PetscScalar **)&y, &z));
+  else PetscCall(VecGetArrayWrite(zz, &z));
+  if (a->compressedrow.use) {
+    if (!yy) PetscCall(PetscArrayzero(z, m));
+    else if (zz != yy) PetscCall(PetscArraycpy(z, y, m));
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  if (MatSeqAIJUseThreads_Private(A)) { /* each thread owns a fixed set of (possibly compressed) rows */
+    nt     = a->threads.nthreads;
+    rstart = a->threads.rstart;
+  }
+  PetscPragmaOMP(parallel for num_threads((int)nt) schedule(static, 1) if (nt > 1))
+  for (PetscInt t = 0; t < nt; t++) {
+    const PetscInt rs = rstart ? rstart[t] : 0, re = rstart ? rstart[t + 1] : m;
+
+    for (PetscInt i = rs; i < re; i++) {
+      const PetscInt r   = ridx ? ridx[i] : i;
+      PetscScalar    sum = y ? y[r] : 0.0;
+
+      if (base[r] >= 0) {
+        const PetscScalar *xb = x + base[r];
+
+        PetscPragmaSIMD
+        for (PetscInt k = ii[i]; k < ii[i + 1]; k++) sum += a_a[k] * xb[cj[k]];
+      } else {
+        PetscPragmaSIMD
+        for (PetscInt k = ii[i]; k < ii[i + 1]; k++) sum += a_a[k] * x[a->j[k]];
+      }
+      z[r] = sum;
+    }
+  }
+  PetscCall(PetscLogFlops(yy ? 2.0 * a->nz : 2.0 * a->nz - a->nonzerorowcnt));
+  PetscCall(VecRestoreArrayRead(xx, &x));
+  if (yy) PetscCall(VecRestoreArrayPair(yy, zz, (PetscScalar **)&y, &z));
+  else PetscCall(VecRestoreArrayWrite(zz, &z));
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &a_a));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 #include <../src/mat/impls/aij/seq/ftn-kernels/fmult.h>
 
 PetscErrorCode MatMult_SeqAIJ(Mat A, Vec xx, Vec yy)
@@ -1479,6 +2060,10 @@ PetscErrorCode MatMult_SeqAIJ(Mat A, Vec xx, Vec yy)
 #endif
 
   PetscFunctionBegin;
+  if (MatSeqAIJUseCompressedIndices_Private(A)) {
+    PetscCall(MatMultAdd_SeqAIJ_CompressedIndices(A, xx, NULL, yy));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
   if (a->inode.use && a->inode.checked) {
     PetscCall(MatMult_SeqAIJ_Inode(A, xx, yy));
     PetscFunctionReturn(PETSC_SUCCESS);
@@ -1487,7 +2072,26 @@ PetscErrorCode MatMult_SeqAIJ(Mat A, Vec xx, Vec yy)
   PetscCall(VecGetArrayRead(xx, &x));
   PetscCall(VecGetArray(yy, &y));
   ii = a->i;
-  if (usecprow) { /* use compressed row format */
+  if (MatSeqAIJUseThreads_Private(A)) { /* each thread owns a fixed set of (possibly compressed) rows */
+    const PetscInt nt = a->threads.nthreads, *rstart = a->threads.rstart;
+
+    if (usecprow) {
+      PetscCall(PetscArrayzero(y, m));
+      ii   = a->compressedrow.i;
+      ridx = a->compressedrow.rindex;
+    }
+    PetscPragmaOMP(parallel for num_threads((int)nt) schedule(static, 1))
+    for (PetscInt t = 0; t < nt; t++) {
+      for (PetscInt i = rstart[t]; i < rstart[t + 1]; i++) {
+        PetscInt           n   = ii[i + 1] - ii[i];
+        const PetscInt    *aj  = a->j + ii[i];
+        const PetscScalar *aa  = a_a + ii[i];
+        PetscScalar        sum = 0.0;
+        PetscSparseDensePlusDot(sum, x, aa, aj, n);
+        y[ridx ? ridx[i] : i] = sum;
+      }
+    }
+  } else if (usecprow) { /* use compressed row format */
     PetscCall(PetscArrayzero(y, m));
     m    = a->compressedrow.nrows;
     ii   = a->compressedrow.i;
@@ -1637,6 +2241,10 @@ PetscErrorCode MatMultAdd_SeqAIJ(Mat A, Vec xx, Vec yy, Vec zz)
   PetscBool          usecprow = a->compressedrow.use;
 
   PetscFunctionBegin;
+  if (MatSeqAIJUseCompressedIndices_Private(A)) {
+    PetscCall(MatMultAdd_SeqAIJ_CompressedIndices(A, xx, yy, zz));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
   if (a->inode.use && a->inode.checked) {
     PetscCall(MatMultAdd_SeqAIJ_Inode(A, xx, yy, zz));
     PetscFunctionReturn(PETSC_SUCCESS);
@@ -1644,7 +2252,28 @@ PetscErrorCode MatMultAdd_SeqAIJ(Mat A, Vec xx, Vec yy, Vec zz)
   PetscCall(MatSeqAIJGetArrayRead(A, &a_a));
   PetscCall(VecGetArrayRead(xx, &x));
   PetscCall(VecGetArrayPair(yy, zz, &y, &z));
-  if (usecprow) { /* use compressed row format */
+  if (MatSeqAIJUseThreads_Private(A)) { /* each thread owns a fixed set of (possibly compressed) rows */
+    const PetscInt nt = a->threads.nthreads, *rstart = a->threads.rstart;
+
+    ii = a->i;
+    if (usecprow) {
+      if (zz != yy) PetscCall(PetscArraycpy(z, y, m));
+      ii   = a->compressedrow.i;
+      ridx = a->compressedrow.rindex;
+    }
+    PetscPragmaOMP(parallel for num_threads((int)nt) schedule(static, 1))
+    for (PetscInt t = 0; t < nt; t++) {
+      for (PetscInt i = rstart[t]; i < rstart[t + 1]; i++) {
+        PetscInt           r   = ridx ? ridx[i] : i;
+        PetscInt           n   = ii[i + 1] - ii[i];
+        const PetscInt    *aj  = a->j + ii[i];
+        const PetscScalar *aa  = a_a + ii[i];
+        PetscScalar        sum = y[r];
+        PetscSparseDensePlusDot(sum, x, aa, aj, n);
+        z[r] = sum;
+      }
+    }
+  } else if (usecprow) { /* use compressed row format */
     if (zz != yy) PetscCall(PetscArraycpy(z, y, m));
     m    = a->compressedrow.nrows;
     ii   = a->compressedrow.i;
@@ -1880,7 +2509,7 @@ static PetscErrorCode MatInvertVariableBlockDiagonal_SeqAIJ(Mat A, PetscInt nblo
 /*
    Negative shift indicates do not generate an error if there is a zero diagonal, just invert it anyways
 */
-static PetscErrorCode MatInvertDiagonal_SeqAIJ(Mat A, PetscScalar omega, PetscScalar fshift)
+PetscErrorCode MatInvertDiagonal_SeqAIJ(Mat A, PetscScalar omega, PetscScalar fshift)
 {
   Mat_SeqAIJ      *a = (Mat_SeqAIJ *)A->data;
   PetscInt         i, *diag, m = A->rmap->n;
@@ -1922,6 +2551,174 @@ static PetscErrorCode MatInvertDiagonal_SeqAIJ(Mat A, PetscScalar omega, PetscSc
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   Groups the rows into levels or colors such that the rows of a group do not couple with each other in A + A^T. Updating the groups
+   one after the other in increasing (decreasing) order is then a forward (backward) sweep; with levels every row sees the same
+   values as in the natural order so the results are identical to the sequential sweeps
+*/
+static PetscErrorCode MatSeqAIJSetUpSORSchedule_Private(Mat A)
+{
+  Mat_SeqAIJ     *a = (Mat_SeqAIJ *)A->data;
+  PetscInt        m = A->rmap->n, ng = 0, *group;
+  const PetscInt *ai = a->i, *aj = a->j;
+
+  PetscFunctionBegin;
+  if (a->sor.perm && a->sor.nonzerostate == A->nonzerostate) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(MatSeqAIJDestroySORSchedule_Private(A));
+  PetscCall(PetscMalloc1(m, &group));
+  if (a->sor.type == MAT_SEQAIJ_SOR_LEVELS) {
+    PetscInt *lower;
+
+    /* the level of a row is one more than the largest level of its neighbors that come before it in the natural order */
+    PetscCall(PetscCalloc1(m, &lower));
+    for (PetscInt i = 0; i < m; i++) {
+      PetscInt lev = lower[i];
+
+      for (PetscInt k = ai[i]; k < ai[i + 1]; k++)
+        if (aj[k] < i) lev = PetscMax(lev, group[aj[k]] + 1);
+      group[i] = lev;
+      for (PetscInt k = ai[i]; k < ai[i + 1]; k++)
+        if (aj[k] > i) lower[aj[k]] = PetscMax(lower[aj[k]], lev + 1);
+      ng = PetscMax(ng, lev + 1);
+    }
+    PetscCall(PetscFree(lower));
+  } else {
+    Mat                    S;
+    MatColoring            mc;
+    ISColoring             iscoloring;
+    const ISColoringValue *colors;
+
+    PetscCall(MatTranspose(A, MAT_INITIAL_MATRIX, &S));
+    PetscCall(MatAXPY(S, 1.0, A, DIFFERENT_NONZERO_PATTERN));
+    PetscCall(MatColoringCreate(S, &mc));
+    PetscCall(MatColoringSetDistance(mc, 1));
+    PetscCall(MatColoringSetType(mc, MATCOLORINGGREEDY));
+    PetscCall(MatColoringSetWeightType(mc, MAT_COLORING_WEIGHT_LEXICAL));
+    PetscCall(MatColoringApply(mc, &iscoloring));
+    PetscCall(ISColoringGetColors(iscoloring, NULL, &ng, &colors));
+    for (PetscInt i = 0; i < m; i++) group[i] = (PetscInt)colors[i];
+    PetscCall(ISColoringDestroy(&iscoloring));
+    PetscCall(MatColoringDestroy(&mc));
+    PetscCall(MatDestroy(&S));
+  }
+  /* counting sort of the rows by group */
+  PetscCall(PetscCalloc1(ng + 1, &a->sor.gstart));
+  PetscCall(PetscMalloc1(m, &a->sor.perm));
+  for (PetscInt i = 0; i < m; i++) a->sor.gstart[group[i] + 1]++;
+  for (PetscInt g = 0; g < ng; g++) a->sor.gstart[g + 1] += a->sor.gstart[g];
+  for (PetscInt i = 0; i < m; i++) a->sor.perm[a->sor.gstart[group[i]]++] = i;
+  for (PetscInt g = ng; g > 0; g--) a->sor.gstart[g] = a->sor.gstart[g - 1];
+  a->sor.gstart[0] = 0;
+  PetscCall(PetscFree(group));
+  a->sor.ngroups      = ng;
+  a->sor.nonzerostate = A->nonzerostate;
+  PetscCall(PetscInfo(A, "Using %" PetscInt_FMT " %s of rows in MatSOR()\n", ng, a->sor.type == MAT_SEQAIJ_SOR_LEVELS ? "levels" : "colors"));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatSeqAIJDestroySORSchedule_Private(Mat A)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree(a->sor.gstart));
+  PetscCall(PetscFree(a->sor.perm));
+  a->sor.ngroups      = 0;
+  a->sor.nonzerostate = -1;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   The local sweeps of MatSOR_SeqAIJ() applied group by group, the rows of a group are shared among the threads. Each row is
+   computed with a fixed sequence of operations so the results do not depend on the number of threads. With levels these are
+   the operations of MatSOR_SeqAIJ(); with colors the lower-triangular part saved by the forward sweep is not valid in the
+   backward sweep, and an unset initial guess could be read, so the whole row is used instead
+*/
+static PetscErrorCode MatSOR_SeqAIJ_Scheduled(Mat A, const PetscScalar *b, PetscReal omega, MatSORType flag, PetscInt its, PetscScalar *x)
+{
+  Mat_SeqAIJ        *a      = (Mat_SeqAIJ *)A->data;
+  const PetscInt    *ai     = a->i, *aj = a->j, *diag = a->diag, *perm = a->sor.perm, *gstart = a->sor.gstart, ng = a->sor.ngroups;
+  const PetscScalar *idiag  = a->idiag, *mdiag = a->mdiag;
+  PetscScalar       *t      = a->ssor_work;
+  const PetscBool    fwd    = (PetscBool)((flag & SOR_FORWARD_SWEEP) || (flag & SOR_LOCAL_FORWARD_SWEEP));
+  const PetscBool    bwd    = (PetscBool)((flag & SOR_BACKWARD_SWEEP) || (flag & SOR_LOCAL_BACKWARD_SWEEP));
+  const PetscBool    levels = (PetscBool)(a->sor.type == MAT_SEQAIJ_SOR_LEVELS);
+  PetscBool          guess0 = (PetscBool)!!(flag & SOR_ZERO_INITIAL_GUESS);
+  const MatScalar   *aa;
+#if defined(_OPENMP)
+  const int nt = (int)PetscMax(a->threads.nthreads, 1);
+#endif
+
+  PetscFunctionBegin;
+  if (guess0 && !levels) {
+    PetscCall(PetscArrayzero(x, A->rmap->n));
+    guess0 = PETSC_FALSE;
+  }
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  for (PetscInt it = 0; it < its; it++) {
+    const PetscBool zero = (PetscBool)(!it && guess0);
+
+    PetscPragmaOMP(parallel num_threads(nt) if (nt > 1))
+    {
+      if (fwd) {
+        for (PetscInt g = 0; g < ng; g++) {
+          PetscPragmaOMP(for schedule(static))
+          for (PetscInt r = gstart[g]; r < gstart[g + 1]; r++) {
+            const PetscInt   i   = perm[r];
+            PetscInt         n   = diag[i] - ai[i];
+            const PetscInt  *idx = aj + ai[i];
+            const MatScalar *v   = aa + ai[i];
+            PetscScalar      sum = b[i];
+
+            PetscSparseDenseMinusDot(sum, x, v, idx, n);
+            t[i] = sum; /* save application of the lower-triangular part */
+            if (zero) x[i] = sum * idiag[i];
+            else {
+              n   = ai[i + 1] - diag[i] - 1;
+              idx = aj + diag[i] + 1;
+              v   = aa + diag[i] + 1;
+              PetscSparseDenseMinusDot(sum, x, v, idx, n);
+              x[i] = (1. - omega) * x[i] + sum * idiag[i]; /* omega in idiag */
+            }
+          }
+        }
+      }
+      if (bwd) {
+        for (PetscInt g = ng - 1; g >= 0; g--) {
+          PetscPragmaOMP(for schedule(static))
+          for (PetscInt r = gstart[g]; r < gstart[g + 1]; r++) {
+            const PetscInt   i = perm[r];
+            PetscInt         n;
+            const PetscInt  *idx;
+            const MatScalar *v;
+            PetscScalar      sum;
+
+            if (!levels || (!fwd && !zero)) { /* whole matrix (no checkpointing available) */
+              sum = b[i];
+              n   = ai[i + 1] - ai[i];
+              idx = aj + ai[i];
+              v   = aa + ai[i];
+              PetscSparseDenseMinusDot(sum, x, v, idx, n);
+              x[i] = (1. - omega) * x[i] + (sum + mdiag[i] * x[i]) * idiag[i];
+            } else { /* lower-triangular part has been saved, so only apply upper-triangular */
+              sum = fwd ? t[i] : b[i];
+              n   = ai[i + 1] - diag[i] - 1;
+              idx = aj + diag[i] + 1;
+              v   = aa + diag[i] + 1;
+              PetscSparseDenseMinusDot(sum, x, v, idx, n);
+              if (!fwd) x[i] = sum * idiag[i];
+              else x[i] = (1. - omega) * x[i] + sum * idiag[i]; /* omega in idiag */
+            }
+          }
+        }
+      }
+    }
+  }
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  PetscCall(PetscLogFlops(2.0 * its * (fwd + bwd) * a->nz));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PetscErrorCode MatSOR_SeqAIJ(Mat A, Vec bb, PetscReal omega, MatSORType flag, PetscReal fshift, PetscInt its, PetscInt lits, Vec xx)
 {
   Mat_SeqAIJ        *a = (Mat_SeqAIJ *)A->data;
@@ -1932,7 +2729,7 @@ PetscErrorCode MatSOR_SeqAIJ(Mat A, Vec bb, PetscReal omega, MatSORType flag, Pe
   const PetscInt    *idx, *diag;
 
   PetscFunctionBegin;
-  if (a->inode.use && a->inode.checked && omega == 1.0 && fshift == 0.0) {
+  if (a->sor.type == MAT_SEQAIJ_SOR_SEQUENTIAL && a->inode.use && a->inode.checked && omega == 1.0 && fshift == 0.0) {
     PetscCall(MatSOR_SeqAIJ_Inode(A, bb, omega, flag, fshift, its, lits, xx));
     PetscFunctionReturn(PETSC_SUCCESS);
   }
@@ -1943,6 +2740,16 @@ PetscErrorCode MatSOR_SeqAIJ(Mat A, Vec bb, PetscReal omega, MatSORType flag, Pe
   a->fshift = fshift;
   a->omega  = omega;
 
+  if (a->sor.type != MAT_SEQAIJ_SOR_SEQUENTIAL && flag != SOR_APPLY_UPPER && flag != SOR_APPLY_LOWER && !(flag & SOR_EISENSTAT)) {
+    PetscCall(MatSeqAIJSetUpSORSchedule_Private(A));
+    PetscCall(VecGetArray(xx, &x));
+    PetscCall(VecGetArrayRead(bb, &b));
+    PetscCall(MatSOR_SeqAIJ_Scheduled(A, b, omega, flag, its, x));
+    PetscCall(VecRestoreArray(xx, &x));
+    PetscCall(VecRestoreArrayRead(bb, &b));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
   diag  = a->diag;
   t     = a->ssor_work;
   idiag = a->idiag;
@@ -3554,7 +4361,7 @@ static struct _MatOps MatOps_Values = {MatSetValues_SeqAIJ,
                                        NULL,
                                        /* 74*/ NULL,
                                        MatFDColoringApply_AIJ,
-                                       NULL,
+                                       MatSetFromOptions_SeqAIJ,
                                        NULL,
                                        NULL,
                                        /* 79*/ MatFindZeroDiagonals_SeqAIJ,
@@ -3961,6 +4768,30 @@ PetscErrorCode MatSeqAIJSetPreallocation(Mat B, PetscInt nz, const PetscInt nnz[
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   With -omp_first_touch zeros the preallocated j and a arrays with the threads of the row partition the thread-parallel
+   kernels will use, so that the pages of each row land on the NUMA node of the thread that multiplies with it
+*/
+static PetscErrorCode MatSeqAIJFirstTouch_Private(Mat A)
+{
+#if defined(PETSC_HAVE_OPENMP)
+  Mat_SeqAIJ *a  = (Mat_SeqAIJ *)A->data;
+  PetscInt    nt = a->threads.nthreads > 1 ? a->threads.nthreads : PetscNumOMPThreads, m = A->rmap->n, *start;
+#endif
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_OPENMP)
+  if (!PetscOMPFirstTouch || nt < 2 || !a->i[m]) PetscFunctionReturn(PETSC_SUCCESS);
+  PetscCall(PetscMalloc1(nt + 1, &start));
+  MatSeqAIJPartitionRows_Private(m, a->i, nt, start);
+  for (PetscInt t = 0; t <= nt; t++) start[t] = a->i[start[t]];
+  PetscCall(PetscMemzeroFirstTouch_Private(a->j, sizeof(PetscInt), a->i[m], nt, start));
+  if (a->a) PetscCall(PetscMemzeroFirstTouch_Private(a->a, sizeof(MatScalar), a->i[m], nt, start));
+  PetscCall(PetscFree(start));
+#endif
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PetscErrorCode MatSeqAIJSetPreallocation_SeqAIJ(Mat B, PetscInt nz, const PetscInt *nnz)
 {
   Mat_SeqAIJ *b              = (Mat_SeqAIJ *)B->data;
@@ -4029,6 +4860,7 @@ PetscErrorCode MatSeqAIJSetPreallocation_SeqAIJ(Mat B, PetscInt nz, const PetscI
     }
     b->i[0] = 0;
     for (i = 1; i < B->rmap->n + 1; i++) b->i[i] = b->i[i - 1] + b->imax[i - 1];
+    PetscCall(MatSeqAIJFirstTouch_Private(B));
   } else {
     b->free_a  = PETSC_FALSE;
     b->free_ij = PETSC_FALSE;
@@ -4327,8 +5159,15 @@ PetscErrorCode MatMatMultSymbolic_SeqDense_SeqAIJ(Mat A, Mat B, PetscReal fill,
    MATSEQAIJ - MATSEQAIJ = "seqaij" - A matrix type to be used for sequential sparse matrices,
    based on compressed sparse row format.
 
-   Options Database Key:
-. -mat_type seqaij - sets the matrix type to "seqaij" during a call to MatSetFromOptions()
+   Options Database Keys:
++ -mat_type seqaij                                                     - sets the matrix type to "seqaij" during a call to MatSetFromOptions()
+. -mat_seqaij_threads <nthr>                                           - number of OpenMP threads used by `MatMult()`, `MatMultAdd()`, `MatMultTranspose()`, `MatSetValuesCOO()` and the scheduled `MatSOR()`, use `PETSC_DECIDE` for the number given by `-omp_num_threads`
+. -mat_seqaij_compressed_indices <bool>                                - use 16-bit column offsets in `MatMult()` and `MatMultAdd()`
+. -mat_seqaij_sor_schedule <sequential,levels,colors>                  - order of the row updates in the local sweeps of `MatSOR()`
+. -mat_seqaij_multtranspose <auto,sequential,private,colors,transpose> - how the `-mat_seqaij_threads` threads share `MatMultTranspose()` and `MatMultTransposeAdd()`
+. -mat_seqaij_solve_threads <nthr>                                     - number of OpenMP threads used by `MatSolve()` with the `MAT_FACTOR_LU` and `MAT_FACTOR_ILU` factors
+. -mat_seqaij_ilu_sweeps <sweeps>                                      - compute the `MAT_FACTOR_ILU` factors with this number of sweeps of the iterative ILU of Chow and Patel
+- -mat_seqaij_ilu_jacobi_its <its>                                     - approximate the triangular solves of `MatSolve()` with `MAT_FACTOR_ILU` factors by this number of Jacobi iterations
 
    Level: beginner
 
@@ -4340,6 +5179,48 @@ PetscErrorCode MatMatMultSymbolic_SeqDense_SeqAIJ(Mat A, Mat B, PetscReal fill,
     `MatSetOptions`(,`MAT_STRUCTURE_ONLY`,`PETSC_TRUE`) may be called for this matrix type. In this no
     space is allocated for the nonzero entries and any entries passed with `MatSetValues()` are ignored
 
+    With `-mat_seqaij_threads` a partition of the rows with about the same number of nonzeros per thread is computed
+    in `MatAssemblyEnd()` and reused by every product until the nonzero structure changes. Each row is computed by a
+    single thread in the same order as the sequential code so the results do not depend on the number of threads.
+    This is intended for hybrid MPI+OpenMP runs, the option also applies to the diagonal and off-diagonal blocks of `MATMPIAIJ`.
+    `MatSetValuesCOO()` shares the nonzeros among the threads, for `MATMPIAIJ` while the off-process values are being exchanged.
+
+    With `-mat_seqaij_compressed_indices` `MatAssemblyEnd()` also stores, for each row whose columns span at most 65536 columns,
+    the column indices as 16-bit offsets from the first column of the row, which `MatMult()` and `MatMultAdd()` then read instead
+    of the `PetscInt` indices. This divides the index traffic of the products by 2, or by 4 with 64-bit indices, for matrices with a
+    small bandwidth such as the diagonal blocks of `MATMPIAIJ`; the other rows keep using their full indices. The offsets take precedence
+    over the inode kernels and are rebuilt only when the nonzero structure changes.
+
+    With `-mat_seqaij_sor_schedule levels` or `colors` the rows are grouped, once per nonzero structure, into groups of rows that
+    do not couple with each other in $A + A^T$, and the local sweeps of `MatSOR()` update the groups one after the other with
+    the rows of each group shared among the `-mat_seqaij_threads` threads. The dependency levels give exactly the same results as
+    the sequential sweeps, whatever the number of threads, but a grid-like matrix has many small levels. A greedy coloring from
+    `MatColoring` gives a few large groups but changes the order of the updates, so the smoother differs from the sequential one,
+    although its results still do not depend on the number of threads. The inode `MatSOR()` is not used with these schedules.
+
+    With `-mat_seqaij_threads` the threads of `MatMultTranspose()` and `MatMultTransposeAdd()` scatter the contributions of different
+    rows into the same entries of the result. With `-mat_seqaij_multtranspose private` each thread accumulates its rows of the partition
+    into its own copy of the result and the copies are summed, with `colors` the nonempty rows are greedily colored, once per nonzero
+    structure, such that rows of the same color have no column in common and the rows of each color are shared among the threads,
+    and with `transpose` the explicit transpose is computed, again only when the matrix has changed, and used by the threaded `MatMult()`.
+    The default `auto` uses the private copies when their size, the number of threads minus one times the number of columns, does not
+    exceed the number of nonzeros, and the explicit transpose otherwise. Only `sequential` and `transpose` give results that do not
+    depend on the number of threads.
+
+    With `-mat_seqaij_solve_threads` given to a `MAT_FACTOR_LU` or `MAT_FACTOR_ILU` factor, with its options prefix, the symbolic
+    factorization also computes the dependency levels of the rows of the triangular factors, and `MatSolve()` then solves each
+    factor level by level with the rows of each level shared among the threads. The levels are reused by all the numeric
+    factorizations and solves until the next symbolic factorization, and the results do not depend on the number of threads. The speedup depends on the number of rows
+    per level, which is largest for factors with few fill-in levels; the inode `MatSolve()` is not used with this option.
+
+    With `-mat_seqaij_ilu_sweeps` given to a `MAT_FACTOR_ILU` factor the numeric factorization does not eliminate the rows one after
+    the other but computes all the entries of the factors, with the pattern of the symbolic factorization, by fixed-point sweeps
+    that only depend on the values of the previous sweep [Chow and Patel, SIAM J. Sci. Comput. 37, 2015]. The sweeps use the
+    `-mat_seqaij_solve_threads` threads and converge to the ILU factors, a few sweeps are usually enough for a preconditioner.
+    The `MatFactorInfo` shifts are not applied. With `-mat_seqaij_ilu_jacobi_its` `MatSolve()` approximates the solves with L and U by
+    this number of Jacobi iterations, which also use all the threads; together they give a fully parallel setup and application
+    of `PCILU`. The other solves, such as `MatSolveTranspose()`, remain exact.
+
   Developer Note:
     It would be nice if all matrix formats supported passing `NULL` in for the numerical values
 
@@ -4836,11 +5717,14 @@ PetscErrorCode MatSetPreallocationCOO_SeqAIJ(Mat mat, PetscCount coo_n, PetscInt
 static PetscErrorCode MatSetValuesCOO_SeqAIJ(Mat A, const PetscScalar v[], InsertMode imode)
 {
   Mat_SeqAIJ          *aseq = (Mat_SeqAIJ *)A->data;
-  PetscCount           i, j, Annz = aseq->nz;
+  PetscCount           Annz = aseq->nz;
   PetscCount          *perm, *jmap;
   PetscScalar         *Aa;
   PetscContainer       container;
   MatCOOStruct_SeqAIJ *coo;
+#if defined(_OPENMP)
+  const int nt = (int)PetscMax(aseq->threads.nthreads, 1);
+#endif
 
   PetscFunctionBegin;
   PetscCall(PetscObjectQuery((PetscObject)A, "__PETSc_MatCOOStruct_Host", (PetscObject *)&container));
@@ -4849,9 +5733,11 @@ static PetscErrorCode MatSetValuesCOO_SeqAIJ(Mat A, const PetscScalar v[], Inser
   perm = coo->perm;
   jmap = coo->jmap;
   PetscCall(MatSeqAIJGetArray(A, &Aa));
-  for (i = 0; i < Annz; i++) {
+  /* each nonzero sums its own entries in the same order whatever the number of threads */
+  PetscPragmaOMP(parallel for num_threads(nt) if (nt > 1) schedule(static))
+  for (PetscCount i = 0; i < Annz; i++) {
     PetscScalar sum = 0.0;
-    for (j = jmap[i]; j < jmap[i + 1]; j++) sum += v[perm[j]];
+    for (PetscCount j = jmap[i]; j < jmap[i + 1]; j++) sum += v[perm[j]];
     Aa[i] = (imode == INSERT_VALUES ? 0.0 : Aa[i]) + sum;
   }
   PetscCall(MatSeqAIJRestoreArray(A, &Aa));
@@ -4915,6 +5801,10 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaij_seqbaij_C", MatConvert_SeqAIJ_SeqBAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaij_seqaijperm_C", MatConvert_SeqAIJ_SeqAIJPERM));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaij_seqaijsell_C", MatConvert_SeqAIJ_SeqAIJSELL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaij_seqaijvbr_C", MatConvert_SeqAIJ_SeqAIJVBR));
+#if !defined(PETSC_USE_COMPLEX)
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaij_seqaijsingle_C", MatConvert_SeqAIJ_SeqAIJSingle));
+#endif
 #if defined(PETSC_HAVE_MKL_SPARSE)
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaij_seqaijmkl_C", MatConvert_SeqAIJ_SeqAIJMKL));
 #endif
@@ -4958,7 +5848,12 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJ(Mat B)
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSeqAIJKron_C", MatSeqAIJKron_SeqAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSetPreallocationCOO_C", MatSetPreallocationCOO_SeqAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSetValuesCOO_C", MatSetValuesCOO_SeqAIJ));
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSetConcurrentSetValues_C", MatSetConcurrentSetValues_SeqAIJ));
   PetscCall(MatCreate_SeqAIJ_Inode(B));
+  PetscCall(MatSeqAIJSetThreadsFromOptions(B));
+  PetscCall(MatSeqAIJSetCompressedIndicesFromOptions(B));
+  PetscCall(MatSeqAIJSetSORScheduleFromOptions(B));
+  PetscCall(MatSeqAIJSetMultTransposeFromOptions(B));
   PetscCall(PetscObjectChangeTypeName((PetscObject)B, MATSEQAIJ));
   PetscCall(MatSeqAIJSetTypeFromOptions(B)); /* this allows changing the matrix subtype to say MATSEQAIJPERM */
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -5055,6 +5950,14 @@ PetscErrorCode MatDuplicateNoCreate_SeqAIJ(Mat C, Mat A, MatDuplicateOption cpva
     C->nonzerostate  = A->nonzerostate;
 
     PetscCall(MatDuplicate_SeqAIJ_Inode(A, cpvalues, &C));
+    c->threads.nthreads   = a->threads.nthreads;
+    c->cindices.use       = a->cindices.use;
+    c->sor.type           = a->sor.type;
+    c->multtranspose.type = a->multtranspose.type;
+    if (C->assembled) {
+      PetscCall(MatSeqAIJSetUpThreads_Private(C));
+      PetscCall(MatSeqAIJSetUpCompressedIndices_Private(C));
+    }
   }
   PetscCall(PetscFunctionListDuplicate(((PetscObject)A)->qlist, &((PetscObject)C)->qlist));
   PetscFunctionReturn(PETSC_SUCCESS);
@@ -5564,6 +6467,10 @@ PetscErrorCode MatSeqAIJRegisterAll(void)
   PetscCall(MatSeqAIJRegister(MATSEQAIJCRL, MatConvert_SeqAIJ_SeqAIJCRL));
   PetscCall(MatSeqAIJRegister(MATSEQAIJPERM, MatConvert_SeqAIJ_SeqAIJPERM));
   PetscCall(MatSeqAIJRegister(MATSEQAIJSELL, MatConvert_SeqAIJ_SeqAIJSELL));
+  PetscCall(MatSeqAIJRegister(MATSEQAIJVBR, MatConvert_SeqAIJ_SeqAIJVBR));
+#if !defined(PETSC_USE_COMPLEX)
+  PetscCall(MatSeqAIJRegister(MATSEQAIJSINGLE, MatConvert_SeqAIJ_SeqAIJSingle));
+#endif
 #if defined(PETSC_HAVE_MKL_SPARSE)
   PetscCall(MatSeqAIJRegister(MATSEQAIJMKL, MatConvert_SeqAIJ_SeqAIJMKL));
 #endif
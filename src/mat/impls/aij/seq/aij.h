@@ -97,6 +97,15 @@ typedef struct {
   PetscScalar *apa;       /* temporary array for storing one row of A*P */
 } Mat_AP;
 
+typedef struct { /* used by MatPtAP() with the threaded algorithm, each thread computes its rows of C without forming A*P */
+  PetscInt       nt;        /* number of threads */
+  PetscInt      *rstart;    /* thread t computes the rows rstart[t] <= k < rstart[t + 1] of C */
+  PetscInt      *pti, *ptj; /* structure of P^T */
+  PetscInt      *ptmap;     /* location in P of each entry of P^T */
+  PetscInt      *loc;       /* loc[t * pn + j] is the location in the current row of C of column j for thread t, -1 if absent */
+  PetscLogDouble flops;     /* flops of the numeric phase */
+} Mat_PtAP_Threaded;
+
 typedef struct {
   MatTransposeColoring matcoloring;
   Mat                  Rt;   /* sparse or dense matrix of R^T */
@@ -134,6 +143,83 @@ typedef struct {
   PetscObjectState mat_nonzerostate; /* non-zero state when inodes were checked for */
 } Mat_SeqAIJ_Inode;
 
+/* Persistent partition of the rows among threads used by the thread-parallel kernels, see -mat_seqaij_threads */
+typedef struct {
+  PetscInt         nthreads;     /* number of threads requested, the kernels run sequentially if this is less than 2 */
+  PetscInt        *rstart;       /* thread t owns rows [rstart[t], rstart[t+1]), balanced by number of nonzeros */
+  PetscBool        compressed;   /* rstart[] refers to the rows of compressedrow rather than all the rows */
+  PetscInt        *nstart;       /* thread t owns inodes [nstart[t], nstart[t+1]) */
+  PetscInt        *nrow;         /* nrow[t] is the first row of inode nstart[t] */
+  PetscInt         node_count;   /* number of inodes nstart[] was built for */
+  PetscObjectState nonzerostate; /* nonzero state of the matrix when the partition was built */
+} Mat_SeqAIJ_Threads;
+
+/* Column indices stored as 16-bit offsets from the first column of each row, used by MatMult() and MatMultAdd(), see -mat_seqaij_compressed_indices */
+typedef struct {
+  PetscBool        use;          /* build and use the offsets at assembly */
+  PetscInt        *base;         /* first column of each row, or -1 if the columns of the row span too many columns and its full indices are used */
+  unsigned short  *j;            /* j[k] = a->j[k] - base[i] for the nonzeros k of the rows i with base[i] >= 0 */
+  PetscInt         nescape;      /* number of rows that use their full indices */
+  PetscObjectState nonzerostate; /* nonzero state of the matrix when the offsets were built */
+} Mat_SeqAIJ_CompressedIndices;
+
+/* Order in which MatSOR() updates the rows, see -mat_seqaij_sor_schedule */
+typedef enum {
+  MAT_SEQAIJ_SOR_SEQUENTIAL, /* the natural order, one row after the other */
+  MAT_SEQAIJ_SOR_LEVELS,     /* by dependency levels, which gives the same results as the natural order */
+  MAT_SEQAIJ_SOR_COLORS      /* by the colors of a distance one coloring of the graph of A + A^T */
+} MatSeqAIJSORScheduleType;
+
+/* Groups of rows that do not couple with each other and can be updated concurrently by MatSOR() */
+typedef struct {
+  MatSeqAIJSORScheduleType type;
+  PetscInt                 ngroups;      /* number of levels or colors */
+  PetscInt                *gstart;       /* rows perm[gstart[g]], ..., perm[gstart[g + 1] - 1] form group g */
+  PetscInt                *perm;         /* the rows in increasing group order, in increasing order within a group */
+  PetscObjectState         nonzerostate; /* nonzero state of the matrix when the groups were built */
+} Mat_SeqAIJ_SORSchedule;
+
+/* How MatMultTranspose() and MatMultTransposeAdd() share the scatter into y among the threads, see -mat_seqaij_multtranspose */
+typedef enum {
+  MAT_SEQAIJ_MULTTRANSPOSE_AUTO,       /* private accumulators, or the cached transpose when they would be too large */
+  MAT_SEQAIJ_MULTTRANSPOSE_SEQUENTIAL, /* a single thread */
+  MAT_SEQAIJ_MULTTRANSPOSE_PRIVATE,    /* each thread scatters its rows into its own copy of y, the copies are then summed */
+  MAT_SEQAIJ_MULTTRANSPOSE_COLORS,     /* rows of the same color have no column in common and are shared among the threads */
+  MAT_SEQAIJ_MULTTRANSPOSE_TRANSPOSE   /* MatMult() with an explicit transpose, computed again when the matrix changes */
+} MatSeqAIJMultTransposeType;
+
+typedef struct {
+  MatSeqAIJMultTransposeType type;
+  PetscInt                   ncolors;
+  PetscInt                  *cstart;       /* rows perm[cstart[c]], ..., perm[cstart[c + 1] - 1] have color c */
+  PetscInt                  *perm;         /* the nonempty rows in increasing color order */
+  PetscObjectState           nonzerostate; /* nonzero state of the matrix when the colors were built */
+  PetscScalar               *work;         /* the accumulators of the threads 1, ..., nthreads - 1 */
+  PetscInt                   nwork;
+  Mat                        At;           /* the cached transpose */
+  PetscObjectState           state;        /* state of the matrix when At was computed */
+} Mat_SeqAIJ_MultTranspose;
+
+/* Dependency levels of the rows of the triangular factors of an LU or ILU factor, solved level by level by MatSolve(), see -mat_seqaij_solve_threads */
+typedef struct {
+  PetscInt  nthreads;   /* number of threads used by MatSolve() */
+  PetscInt  nlevels[2]; /* number of levels of L (0) and of U (1) */
+  PetscInt *lstart[2];  /* rows perm[f][lstart[f][l]], ..., perm[f][lstart[f][l + 1] - 1] form level l of factor f */
+  PetscInt *perm[2];    /* the rows of factor f in increasing level order */
+} Mat_SeqAIJ_SolveLevels;
+
+/* Iterative ILU of Chow and Patel and Jacobi triangular solves of an ILU factor, see -mat_seqaij_ilu_sweeps and -mat_seqaij_ilu_jacobi_its */
+typedef struct {
+  PetscInt     sweeps; /* number of fixed-point sweeps computing the factors, 0 for the Gaussian elimination */
+  PetscInt     its;    /* number of Jacobi iterations of each triangular solve of MatSolve(), 0 for exact solves */
+  PetscInt    *ucol;   /* the off-diagonal entries of column j of U are urow[k], upos[k] for ucol[j] <= k < ucol[j + 1] */
+  PetscInt    *urow;   /* their rows, in increasing order */
+  PetscInt    *upos;   /* their positions in the values of the factor */
+  PetscScalar *a0;     /* the entries of the permuted matrix on the pattern of the factors */
+  PetscScalar *old;    /* the values of the factors after the previous sweep */
+  PetscScalar *jwork;  /* the two work vectors of the Jacobi iterations */
+} Mat_SeqAIJ_IterativeILU;
+
 PETSC_INTERN PetscErrorCode MatView_SeqAIJ_Inode(Mat, PetscViewer);
 PETSC_INTERN PetscErrorCode MatAssemblyEnd_SeqAIJ_Inode(Mat, MatAssemblyType);
 PETSC_INTERN PetscErrorCode MatDestroy_SeqAIJ_Inode(Mat);
@@ -147,8 +233,15 @@ PETSC_INTERN PetscErrorCode MatSeqAIJRestoreArray_SeqAIJ(Mat, PetscScalar **);
 
 typedef struct {
   SEQAIJHEADER(MatScalar);
-  Mat_SeqAIJ_Inode inode;
-  MatScalar       *saved_values; /* location for stashing nonzero values of matrix */
+  Mat_SeqAIJ_Inode             inode;
+  Mat_SeqAIJ_Threads           threads;
+  Mat_SeqAIJ_CompressedIndices cindices;
+  Mat_SeqAIJ_SORSchedule       sor;
+  Mat_SeqAIJ_MultTranspose     multtranspose;
+  Mat_SeqAIJ_SolveLevels       solvelevels;
+  Mat_SeqAIJ_IterativeILU      iterilu;
+  MatScalar                   *saved_values;   /* location for stashing nonzero values of matrix */
+  PetscBool                    detectblocksize; /* look for a uniform block structure at the first final assembly, see -mat_aij_detect_block_size */
 
   PetscScalar *idiag, *mdiag, *ssor_work; /* inverse of diagonal entries, diagonal values and workspace for Eisenstat trick */
   PetscBool    idiagvalid;                /* current idiag[] and mdiag[] are valid */
@@ -303,6 +396,140 @@ static inline PetscErrorCode MatSeqXAIJFreeAIJ(Mat AA, MatScalar **a, PetscInt *
     } \
   } while (0)
 
+/*
+   Splits the m rows with offsets ii[] into nt contiguous pieces with about the same number of nonzeros,
+   each row counts as one extra nonzero to account for the per-row overhead of the kernels
+*/
+static inline void MatSeqAIJPartitionRows_Private(PetscInt m, const PetscInt ii[], PetscInt nt, PetscInt rstart[])
+{
+  const PetscCount total = (PetscCount)(ii[m] - ii[0]) + m;
+
+  rstart[0] = 0;
+  for (PetscInt t = 1; t < nt; t++) {
+    const PetscCount target = (total * t) / nt;
+    PetscInt         lo = rstart[t - 1], hi = m;
+
+    while (lo < hi) { /* first row whose weighted offset reaches the target */
+      const PetscInt mid = lo + (hi - lo) / 2;
+
+      if ((PetscCount)(ii[mid] - ii[0]) + mid < target) lo = mid + 1;
+      else hi = mid;
+    }
+    rstart[t] = lo;
+  }
+  rstart[nt] = m;
+}
+
+/*
+   Same as MatSeqAIJPartitionRows_Private() with the prefix sums w[] of the work of the rows, for example their number of products,
+   which can exceed PetscInt
+*/
+static inline void MatSeqAIJPartitionRowsByWork_Private(PetscInt m, const PetscCount w[], PetscInt nt, PetscInt rstart[])
+{
+  const PetscCount total = w[m] - w[0] + m;
+
+  rstart[0] = 0;
+  for (PetscInt t = 1; t < nt; t++) {
+    const PetscCount target = (total * t) / nt;
+    PetscInt         lo = rstart[t - 1], hi = m;
+
+    while (lo < hi) {
+      const PetscInt mid = lo + (hi - lo) / 2;
+
+      if (w[mid] - w[0] + mid < target) lo = mid + 1;
+      else hi = mid;
+    }
+    rstart[t] = lo;
+  }
+  rstart[nt] = m;
+}
+
+/* Is the row partition of the thread-parallel kernels up-to-date with the nonzero structure of A */
+static inline PetscBool MatSeqAIJUseThreads_Private(Mat A)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  return (PetscBool)(a->threads.nthreads > 1 && a->threads.rstart && a->threads.nonzerostate == A->nonzerostate && a->threads.compressed == a->compressedrow.use);
+}
+
+PETSC_INTERN PetscErrorCode MatSeqAIJSetUpThreads_Private(Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJGetBlockSizeMask_Private(Mat, PetscInt, const PetscInt[], PetscInt *);
+PETSC_INTERN PetscErrorCode MatAIJConvertToBAIJ_Private(Mat, PetscInt);
+PETSC_INTERN PetscErrorCode MatSeqAIJDestroyThreads_Private(Mat);
+
+/* Are the 16-bit column offsets up-to-date with the nonzero structure of A */
+static inline PetscBool MatSeqAIJUseCompressedIndices_Private(Mat A)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  return (PetscBool)(a->cindices.use && a->cindices.base && a->cindices.nonzerostate == A->nonzerostate);
+}
+
+PETSC_INTERN PetscErrorCode MatSeqAIJSetUpCompressedIndices_Private(Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJDestroyCompressedIndices_Private(Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJDestroySORSchedule_Private(Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJDestroyMultTranspose_Private(Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJSetUpSolveLevels_Private(Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJUseSolveLevels_Private(Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJDestroySolveLevels_Private(Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJSetUpIterativeILU_Private(Mat);
+PETSC_INTERN PetscErrorCode MatSeqAIJDestroyIterativeILU_Private(Mat);
+
+/* Adds or inserts value into *ap so that threads calling MatSetValues() concurrently with MAT_CONCURRENT_SET_VALUES do not lose updates */
+static inline void MatSetValueAtomic_Private(MatScalar *ap, MatScalar value, InsertMode is)
+{
+#if defined(PETSC_USE_REAL___FLOAT128) || defined(PETSC_USE_REAL___FP16)
+  PetscPragmaOMP(critical(MatSetValueAtomic_Private))
+  {
+    if (is == ADD_VALUES) *ap += value;
+    else *ap = value;
+  }
+#elif defined(PETSC_USE_COMPLEX)
+  PetscReal *r = (PetscReal *)ap, re = PetscRealPart(value), im = PetscImaginaryPart(value);
+
+  /* the real and imaginary parts are updated separately, concurrent INSERT_VALUES may mix them */
+  if (is == ADD_VALUES) {
+    PetscPragmaOMP(atomic update)
+    r[0] += re;
+    PetscPragmaOMP(atomic update)
+    r[1] += im;
+  } else {
+    PetscPragmaOMP(atomic write)
+    r[0] = re;
+    PetscPragmaOMP(atomic write)
+    r[1] = im;
+  }
+#else
+  if (is == ADD_VALUES) {
+    PetscPragmaOMP(atomic update)
+    *ap += value;
+  } else {
+    PetscPragmaOMP(atomic write)
+    *ap = value;
+  }
+#endif
+}
+
+/*
+   Adds or inserts value at (row, col) of the assembled nonzero structure of a, without changing the structure,
+   returns PETSC_FALSE if (row, col) is not in the nonzero structure
+*/
+static inline PetscBool MatSeqAIJSetValueConcurrent_Private(Mat_SeqAIJ *a, PetscInt row, PetscInt col, MatScalar value, InsertMode is)
+{
+  const PetscInt *rp  = a->j + a->i[row];
+  PetscInt        low = 0, high = a->ilen[row];
+
+  while (low < high) {
+    const PetscInt t = low + (high - low) / 2;
+
+    if (rp[t] < col) low = t + 1;
+    else high = t;
+  }
+  if (low == a->ilen[row] || rp[low] != col) return PETSC_FALSE;
+  if (a->a) MatSetValueAtomic_Private(a->a + a->i[row] + low, value, is);
+  return PETSC_TRUE;
+}
+
 PETSC_INTERN PetscErrorCode MatSeqAIJSetPreallocation_SeqAIJ(Mat, PetscInt, const PetscInt *);
 PETSC_INTERN PetscErrorCode MatSetPreallocationCOO_SeqAIJ(Mat, PetscCount, PetscInt[], PetscInt[]);
 
@@ -326,6 +553,7 @@ PETSC_INTERN PetscErrorCode MatMultAdd_SeqAIJ_Inode(Mat, Vec, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultTranspose_SeqAIJ(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultTransposeAdd_SeqAIJ(Mat, Vec, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ(Mat, Vec, PetscReal, MatSORType, PetscReal, PetscInt, PetscInt, Vec);
+PETSC_INTERN PetscErrorCode MatInvertDiagonal_SeqAIJ(Mat, PetscScalar, PetscScalar);
 PETSC_INTERN PetscErrorCode MatSOR_SeqAIJ_Inode(Mat, Vec, PetscReal, MatSORType, PetscReal, PetscInt, PetscInt, Vec);
 
 PETSC_INTERN PetscErrorCode MatSetOption_SeqAIJ(Mat, MatOption, PetscBool);
@@ -380,12 +608,14 @@ PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Heap(Mat, Mat, Pets
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_BTHeap(Mat, Mat, PetscReal, Mat);
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_RowMerge(Mat, Mat, PetscReal, Mat);
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_LLCondensed(Mat, Mat, PetscReal, Mat);
+PETSC_INTERN PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_HashThreaded(Mat, Mat, PetscReal, Mat);
 #if defined(PETSC_HAVE_HYPRE)
 PETSC_INTERN PetscErrorCode MatMatMultSymbolic_AIJ_AIJ_wHYPRE(Mat, Mat, PetscReal, Mat);
 #endif
 
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ(Mat, Mat, Mat);
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Sorted(Mat, Mat, Mat);
+PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_HashThreaded(Mat, Mat, Mat);
 
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqDense_SeqAIJ(Mat, Mat, Mat);
 PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable(Mat, Mat, Mat);
@@ -393,6 +623,8 @@ PETSC_INTERN PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_Scalable(Mat, Mat, M
 PETSC_INTERN PetscErrorCode MatPtAPSymbolic_SeqAIJ_SeqAIJ_SparseAxpy(Mat, Mat, PetscReal, Mat);
 PETSC_INTERN PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ(Mat, Mat, Mat);
 PETSC_INTERN PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ_SparseAxpy(Mat, Mat, Mat);
+PETSC_INTERN PetscErrorCode MatPtAPSymbolic_SeqAIJ_SeqAIJ_Threaded(Mat, Mat, PetscReal, Mat);
+PETSC_INTERN PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ_Threaded(Mat, Mat, Mat);
 
 PETSC_INTERN PetscErrorCode MatRARtSymbolic_SeqAIJ_SeqAIJ(Mat, Mat, PetscReal, Mat);
 PETSC_INTERN PetscErrorCode MatRARtSymbolic_SeqAIJ_SeqAIJ_matmattransposemult(Mat, Mat, PetscReal, Mat);
@@ -453,6 +685,10 @@ PETSC_INTERN PetscErrorCode MatConvert_AIJ_ScaLAPACK(Mat, MatType, MatReuse, Mat
 PETSC_INTERN PetscErrorCode MatConvert_AIJ_HYPRE(Mat, MatType, MatReuse, Mat *);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJPERM(Mat, MatType, MatReuse, Mat *);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSELL(Mat, MatType, MatReuse, Mat *);
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJVBR(Mat, MatType, MatReuse, Mat *);
+#if !defined(PETSC_USE_COMPLEX)
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSingle(Mat, MatType, MatReuse, Mat *);
+#endif
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJMKL(Mat, MatType, MatReuse, Mat *);
 PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJViennaCL(Mat, MatType, MatReuse, Mat *);
 PETSC_INTERN PetscErrorCode MatReorderForNonzeroDiagonal_SeqAIJ(Mat, PetscReal, IS, IS);
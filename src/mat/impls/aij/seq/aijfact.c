@@ -425,6 +425,7 @@ PetscErrorCode MatLUFactorSymbolic_SeqAIJ(Mat B, Mat A, IS isrow, IS iscol, cons
   B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ;
   if (a->inode.size) B->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Inode;
   PetscCall(MatSeqAIJCheckInode_FactorLU(B));
+  PetscCall(MatSeqAIJSetUpSolveLevels_Private(B));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -601,6 +602,7 @@ PetscErrorCode MatLUFactorNumeric_SeqAIJ(Mat B, Mat A, const MatFactorInfo *info
   } else {
     C->ops->solve = MatSolve_SeqAIJ;
   }
+  PetscCall(MatSeqAIJUseSolveLevels_Private(C));
   C->ops->solveadd          = MatSolveAdd_SeqAIJ;
   C->ops->solvetranspose    = MatSolveTranspose_SeqAIJ;
   C->ops->solvetransposeadd = MatSolveTransposeAdd_SeqAIJ;
@@ -1779,6 +1781,8 @@ PetscErrorCode MatILUFactorSymbolic_SeqAIJ(Mat fact, Mat A, IS isrow, IS iscol,
     /* special case: ilu(0) with natural ordering */
     PetscCall(MatILUFactorSymbolic_SeqAIJ_ilu0(fact, A, isrow, iscol, info));
     if (a->inode.size) fact->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Inode;
+    PetscCall(MatSeqAIJSetUpIterativeILU_Private(fact));
+    PetscCall(MatSeqAIJSetUpSolveLevels_Private(fact));
     PetscFunctionReturn(PETSC_SUCCESS);
   }
 
@@ -1911,6 +1915,8 @@ PetscErrorCode MatILUFactorSymbolic_SeqAIJ(Mat fact, Mat A, IS isrow, IS iscol,
   fact->ops->lufactornumeric   = MatLUFactorNumeric_SeqAIJ;
   if (a->inode.size) fact->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Inode;
   PetscCall(MatSeqAIJCheckInode_FactorLU(fact));
+  PetscCall(MatSeqAIJSetUpIterativeILU_Private(fact));
+  PetscCall(MatSeqAIJSetUpSolveLevels_Private(fact));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -3284,6 +3290,461 @@ PetscErrorCode MatSolve_SeqAIJ(Mat A, Vec bb, Vec xx)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   MatSolve_SeqAIJ() with the rows of each triangular factor solved level by level, the rows of a level are shared among the
+   threads. Each row is computed with the operations of MatSolve_SeqAIJ() so the results do not depend on the number of threads
+*/
+static PetscErrorCode MatSolve_SeqAIJ_Levels(Mat A, Vec bb, Vec xx)
+{
+  Mat_SeqAIJ        *a  = (Mat_SeqAIJ *)A->data;
+  const PetscInt    *ai = a->i, *aj = a->j, *adiag = a->diag, *r, *c;
+  const PetscInt     nlL = a->solvelevels.nlevels[0], *lstartL = a->solvelevels.lstart[0], *permL = a->solvelevels.perm[0];
+  const PetscInt     nlU = a->solvelevels.nlevels[1], *lstartU = a->solvelevels.lstart[1], *permU = a->solvelevels.perm[1];
+  PetscScalar       *x, *tmp = a->solve_work;
+  const PetscScalar *b;
+  const MatScalar   *aa;
+#if defined(_OPENMP)
+  const int nt = (int)a->solvelevels.nthreads;
+#endif
+
+  PetscFunctionBegin;
+  if (!permL) { /* for example a duplicate of the factor, which shares the function table but not the levels */
+    PetscCall(MatSolve_SeqAIJ(A, bb, xx));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  PetscCall(VecGetArrayRead(bb, &b));
+  PetscCall(VecGetArrayWrite(xx, &x));
+  PetscCall(ISGetIndices(a->row, &r));
+  PetscCall(ISGetIndices(a->col, &c));
+
+  PetscPragmaOMP(parallel num_threads(nt))
+  {
+    /* forward solve the lower triangular */
+    for (PetscInt l = 0; l < nlL; l++) {
+      PetscPragmaOMP(for schedule(static))
+      for (PetscInt k = lstartL[l]; k < lstartL[l + 1]; k++) {
+        const PetscInt   i   = permL[k], nz = ai[i + 1] - ai[i];
+        const PetscInt  *vi  = aj + ai[i];
+        const MatScalar *v   = aa + ai[i];
+        PetscScalar      sum = b[r[i]];
+
+        PetscSparseDenseMinusDot(sum, tmp, v, vi, nz);
+        tmp[i] = sum;
+      }
+    }
+
+    /* backward solve the upper triangular */
+    for (PetscInt l = 0; l < nlU; l++) {
+      PetscPragmaOMP(for schedule(static))
+      for (PetscInt k = lstartU[l]; k < lstartU[l + 1]; k++) {
+        const PetscInt   i   = permU[k], nz = adiag[i] - adiag[i + 1] - 1;
+        const PetscInt  *vi  = aj + adiag[i + 1] + 1;
+        const MatScalar *v   = aa + adiag[i + 1] + 1;
+        PetscScalar      sum = tmp[i];
+
+        PetscSparseDenseMinusDot(sum, tmp, v, vi, nz);
+        x[c[i]] = tmp[i] = sum * v[nz]; /* v[nz] = aa[adiag[i]] */
+      }
+    }
+  }
+
+  PetscCall(ISRestoreIndices(a->row, &r));
+  PetscCall(ISRestoreIndices(a->col, &c));
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  PetscCall(VecRestoreArrayRead(bb, &b));
+  PetscCall(VecRestoreArrayWrite(xx, &x));
+  PetscCall(PetscLogFlops(2.0 * a->nz - A->cmap->n));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   MatSolve_SeqAIJ() with each triangular solve approximated by a fixed number of Jacobi iterations, see -mat_seqaij_ilu_jacobi_its.
+   All the rows of an iteration are independent so they are shared among the threads; the results do not depend on their number
+*/
+static PetscErrorCode MatSolve_SeqAIJ_Jacobi(Mat A, Vec bb, Vec xx)
+{
+  Mat_SeqAIJ        *a   = (Mat_SeqAIJ *)A->data;
+  const PetscInt     n   = A->rmap->n, its = a->iterilu.its, *ai = a->i, *aj = a->j, *adiag = a->diag, *r, *c;
+  PetscScalar       *w0, *w1, *y, *z0, *z1, *x;
+  const PetscScalar *b;
+  const MatScalar   *aa;
+#if defined(_OPENMP)
+  const int nt = (int)a->solvelevels.nthreads;
+#endif
+
+  PetscFunctionBegin;
+  if (!a->iterilu.jwork) { /* for example a duplicate of the factor, which shares the function table but not the work vectors */
+    PetscCall(MatSolve_SeqAIJ(A, bb, xx));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  w0 = a->iterilu.jwork;
+  w1 = w0 + n;
+  y  = its % 2 ? w1 : w0;
+  z0 = a->solve_work;
+  z1 = its % 2 ? w0 : w1;
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  PetscCall(VecGetArrayRead(bb, &b));
+  PetscCall(VecGetArrayWrite(xx, &x));
+  PetscCall(ISGetIndices(a->row, &r));
+  PetscCall(ISGetIndices(a->col, &c));
+
+  PetscPragmaOMP(parallel num_threads(nt) if (nt > 1))
+  {
+    /* L y = b with the unit diagonal, from y = b; the result is in w0 or w1 depending on the parity of its */
+    PetscPragmaOMP(for schedule(static))
+    for (PetscInt i = 0; i < n; i++) w0[i] = b[r[i]];
+    for (PetscInt it = 0; it < its; it++) {
+      const PetscScalar *yold = it % 2 ? w1 : w0;
+      PetscScalar       *ynew = it % 2 ? w0 : w1;
+
+      PetscPragmaOMP(for schedule(static))
+      for (PetscInt i = 0; i < n; i++) {
+        const PetscInt   nz  = ai[i + 1] - ai[i];
+        const PetscInt  *vi  = aj + ai[i];
+        const MatScalar *v   = aa + ai[i];
+        PetscScalar      sum = b[r[i]];
+
+        PetscSparseDenseMinusDot(sum, yold, v, vi, nz);
+        ynew[i] = sum;
+      }
+    }
+
+    /* U z = y from z = D^{-1} y, using z0 and the work vector that does not hold y */
+    PetscPragmaOMP(for schedule(static))
+    for (PetscInt i = 0; i < n; i++) z0[i] = y[i] * aa[adiag[i]];
+    for (PetscInt it = 0; it < its; it++) {
+      const PetscScalar *zold = it % 2 ? z1 : z0;
+      PetscScalar       *znew = it % 2 ? z0 : z1;
+
+      PetscPragmaOMP(for schedule(static))
+      for (PetscInt i = 0; i < n; i++) {
+        const PetscInt   nz  = adiag[i] - adiag[i + 1] - 1;
+        const PetscInt  *vi  = aj + adiag[i + 1] + 1;
+        const MatScalar *v   = aa + adiag[i + 1] + 1;
+        PetscScalar      sum = y[i];
+
+        PetscSparseDenseMinusDot(sum, zold, v, vi, nz);
+        znew[i] = sum * v[nz]; /* v[nz] = aa[adiag[i]] */
+      }
+    }
+    PetscPragmaOMP(for schedule(static))
+    for (PetscInt i = 0; i < n; i++) x[c[i]] = its % 2 ? z1[i] : z0[i];
+  }
+
+  PetscCall(ISRestoreIndices(a->row, &r));
+  PetscCall(ISRestoreIndices(a->col, &c));
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  PetscCall(VecRestoreArrayRead(bb, &b));
+  PetscCall(VecRestoreArrayWrite(xx, &x));
+  PetscCall(PetscLogFlops((its + 1.0) * (2.0 * a->nz - A->cmap->n)));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatSeqAIJSetSolveThreadsFromOptions(Mat fact)
+{
+  Mat_SeqAIJ *b  = (Mat_SeqAIJ *)fact->data;
+  PetscInt    nt = b->solvelevels.nthreads > 0 ? b->solvelevels.nthreads : 1;
+
+  PetscFunctionBegin;
+  PetscObjectOptionsBegin((PetscObject)fact);
+  PetscCall(PetscOptionsInt("-mat_seqaij_solve_threads", "Number of threads used by MatSolve() with LU and ILU factors, which then solves the triangular factors level by level", "MATSEQAIJ", nt, &nt, NULL));
+  PetscOptionsEnd();
+#if defined(PETSC_HAVE_OPENMP)
+  if (nt == PETSC_DECIDE) nt = PetscNumOMPThreads;
+#else
+  if (nt > 1) PetscCall(PetscInfo(fact, "Ignoring -mat_seqaij_solve_threads %" PetscInt_FMT " since PETSc was not configured with OpenMP\n", nt));
+  nt = 1;
+#endif
+  PetscCheck(nt > 0, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Number of threads %" PetscInt_FMT " must be positive", nt);
+  b->solvelevels.nthreads = nt;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Called at the end of the symbolic LU and ILU factorizations, after MatSeqAIJSetUpIterativeILU_Private(). With
+   -mat_seqaij_solve_threads the dependency levels of the rows of the factors are computed from their nonzero structure. Row i
+   of L depends on the rows of its columns, which all come before i, and row i of U on the rows of its columns, which all come
+   after i; the level of a row is one more than the largest level of the rows it depends on. The levels are reused by all the
+   numeric factorizations and solves with this symbolic factorization, see MatSeqAIJUseSolveLevels_Private()
+*/
+PetscErrorCode MatSeqAIJSetUpSolveLevels_Private(Mat fact)
+{
+  Mat_SeqAIJ     *b = (Mat_SeqAIJ *)fact->data;
+  const PetscInt  n = fact->rmap->n, *bi = b->i, *bj = b->j, *bdiag = b->diag;
+  PetscInt        nt, *level;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJDestroySolveLevels_Private(fact));
+  PetscCall(MatSeqAIJSetSolveThreadsFromOptions(fact));
+  nt = b->solvelevels.nthreads;
+  if (b->iterilu.its || nt < 2 || !n) PetscFunctionReturn(PETSC_SUCCESS);
+
+  PetscCall(PetscMalloc1(n, &level));
+  for (PetscInt f = 0; f < 2; f++) {
+    PetscInt nl = 0, *lstart, *perm;
+
+    for (PetscInt ii = 0; ii < n; ii++) {
+      const PetscInt i = f ? n - 1 - ii : ii, kstart = f ? bdiag[i + 1] + 1 : bi[i], kend = f ? bdiag[i] : bi[i + 1];
+      PetscInt       lev = 0;
+
+      for (PetscInt k = kstart; k < kend; k++) lev = PetscMax(lev, level[bj[k]] + 1);
+      level[i] = lev;
+      nl       = PetscMax(nl, lev + 1);
+    }
+    /* counting sort of the rows by level */
+    PetscCall(PetscCalloc1(nl + 1, &lstart));
+    PetscCall(PetscMalloc1(n, &perm));
+    for (PetscInt i = 0; i < n; i++) lstart[level[i] + 1]++;
+    for (PetscInt l = 0; l < nl; l++) lstart[l + 1] += lstart[l];
+    for (PetscInt i = 0; i < n; i++) perm[lstart[level[i]]++] = i;
+    for (PetscInt l = nl; l > 0; l--) lstart[l] = lstart[l - 1];
+    lstart[0] = 0;
+
+    b->solvelevels.nlevels[f] = nl;
+    b->solvelevels.lstart[f]  = lstart;
+    b->solvelevels.perm[f]    = perm;
+  }
+  PetscCall(PetscFree(level));
+  PetscCall(PetscInfo(fact, "Using %" PetscInt_FMT " levels for L and %" PetscInt_FMT " levels for U with %" PetscInt_FMT " threads in MatSolve()\n", b->solvelevels.nlevels[0], b->solvelevels.nlevels[1], nt));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Called at the end of the numeric LU and ILU factorizations. With the levels of MatSeqAIJSetUpSolveLevels_Private() MatSolve()
+   becomes MatSolve_SeqAIJ_Levels(), with -mat_seqaij_ilu_jacobi_its it becomes MatSolve_SeqAIJ_Jacobi() instead
+*/
+PetscErrorCode MatSeqAIJUseSolveLevels_Private(Mat fact)
+{
+  Mat_SeqAIJ *b = (Mat_SeqAIJ *)fact->data;
+
+  PetscFunctionBegin;
+  if (b->iterilu.its) fact->ops->solve = MatSolve_SeqAIJ_Jacobi;
+  else if (b->solvelevels.nlevels[0]) fact->ops->solve = MatSolve_SeqAIJ_Levels;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatSeqAIJDestroySolveLevels_Private(Mat A)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  PetscFunctionBegin;
+  for (PetscInt f = 0; f < 2; f++) {
+    PetscCall(PetscFree(a->solvelevels.lstart[f]));
+    PetscCall(PetscFree(a->solvelevels.perm[f]));
+    a->solvelevels.nlevels[f] = 0;
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* The position of col in the sorted array cols[n], or -1 if it is not there */
+static inline PetscInt MatSeqAIJFindColumn_Private(const PetscInt cols[], PetscInt n, PetscInt col)
+{
+  PetscInt lo = 0, hi = n;
+
+  while (lo < hi) {
+    const PetscInt mid = lo + (hi - lo) / 2;
+
+    if (cols[mid] < col) lo = mid + 1;
+    else hi = mid;
+  }
+  return lo < n && cols[lo] == col ? lo : -1;
+}
+
+/*
+   The fine-grained iterative ILU of Chow and Patel: with S the pattern of the factors and A the permuted matrix, each sweep
+   computes from the values of the previous sweep, for all (i, j) in S,
+
+     l_ij = (a_ij - sum_{k < j} l_ik u_kj) / u_jj   if i > j
+     u_ij =  a_ij - sum_{k < i} l_ik u_kj           if i <= j
+
+   starting from l_ij = a_ij / a_jj and u_ij = a_ij. The sums merge row i of L with column j of U. All the entries of a sweep
+   are independent so the rows are shared among the threads, and the results do not depend on their number. The fixed point
+   is the ILU factorization with this pattern, which the sweeps approach without the sequential dependencies of the elimination
+*/
+static PetscErrorCode MatLUFactorNumeric_SeqAIJ_Iterative(Mat B, Mat A, const MatFactorInfo *info)
+{
+  Mat_SeqAIJ      *a  = (Mat_SeqAIJ *)A->data, *b = (Mat_SeqAIJ *)B->data;
+  const PetscInt   n  = A->rmap->n, *ai = a->i, *aj = a->j, *bi = b->i, *bj = b->j, *bdiag = b->diag, nzf = bdiag[0] + 1;
+  const PetscInt  *ucol = b->iterilu.ucol, *urow = b->iterilu.urow, *upos = b->iterilu.upos, *r, *ic;
+  PetscScalar     *a0 = b->iterilu.a0, *old = b->iterilu.old;
+  const MatScalar *aa;
+  MatScalar       *ba;
+  PetscInt         sweeps = b->iterilu.sweeps;
+  PetscBool        row_identity, col_identity;
+  int              nt;
+
+  PetscFunctionBegin;
+  if (!ucol) { /* for example a duplicate of the factor, which shares the function table but not the columns of U */
+    PetscCall(MatLUFactorNumeric_SeqAIJ(B, A, info));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  nt = (int)PetscMax(b->solvelevels.nthreads, 1);
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  PetscCall(MatSeqAIJGetArrayWrite(B, &ba));
+  PetscCall(ISGetIndices(b->row, &r));
+  PetscCall(ISGetIndices(b->icol, &ic));
+
+  /* the entries of the permuted matrix on the pattern of the factors, the other entries are dropped */
+  PetscPragmaOMP(parallel for num_threads(nt) schedule(static) if (nt > 1))
+  for (PetscInt i = 0; i < n; i++) {
+    const PetscInt nl = bi[i + 1] - bi[i], us = bdiag[i + 1] + 1, nu = bdiag[i] - us;
+
+    for (PetscInt k = bi[i]; k < bi[i + 1]; k++) a0[k] = 0.0;
+    for (PetscInt k = us; k <= bdiag[i]; k++) a0[k] = 0.0;
+    for (PetscInt k = ai[r[i]]; k < ai[r[i] + 1]; k++) {
+      const PetscInt j = ic[aj[k]];
+      PetscInt       loc;
+
+      if (j < i) {
+        if ((loc = MatSeqAIJFindColumn_Private(bj + bi[i], nl, j)) >= 0) a0[bi[i] + loc] = aa[k];
+      } else if (j > i) {
+        if ((loc = MatSeqAIJFindColumn_Private(bj + us, nu, j)) >= 0) a0[us + loc] = aa[k];
+      } else a0[bdiag[i]] = aa[k];
+    }
+  }
+  /* the initial guess divides by the diagonal of the matrix, with a zero pivot there the factors are left equal to the matrix
+     and the check of the pivots below reports it */
+  for (PetscInt i = 0; i < n; i++) {
+    if (PetscAbsScalar(a0[bdiag[i]]) <= info->zeropivot) {
+      sweeps = 0;
+      break;
+    }
+  }
+  if (sweeps) {
+    PetscPragmaOMP(parallel for num_threads(nt) schedule(static) if (nt > 1))
+    for (PetscInt i = 0; i < n; i++) {
+      for (PetscInt k = bi[i]; k < bi[i + 1]; k++) ba[k] = a0[k] / a0[bdiag[bj[k]]];
+      for (PetscInt k = bdiag[i + 1] + 1; k <= bdiag[i]; k++) ba[k] = a0[k];
+    }
+  } else PetscCall(PetscArraycpy(ba, a0, nzf));
+
+  for (PetscInt sweep = 0; sweep < sweeps; sweep++) {
+    PetscCall(PetscArraycpy(old, ba, nzf));
+    PetscPragmaOMP(parallel for num_threads(nt) schedule(static) if (nt > 1))
+    for (PetscInt i = 0; i < n; i++) {
+      /* the entries of row i of L, the sum only involves the entries of row i of L before column j */
+      for (PetscInt p = bi[i]; p < bi[i + 1]; p++) {
+        const PetscInt j   = bj[p];
+        PetscScalar    sum = a0[p];
+
+        for (PetscInt k = bi[i], q = ucol[j]; k < p && q < ucol[j + 1]; k++) {
+          while (q < ucol[j + 1] && urow[q] < bj[k]) q++;
+          if (q < ucol[j + 1] && urow[q] == bj[k]) sum -= old[k] * old[upos[q]];
+        }
+        ba[p] = sum / old[bdiag[j]];
+      }
+      /* the entries of row i of U, the diagonal is stored last */
+      for (PetscInt p = bdiag[i + 1] + 1; p <= bdiag[i]; p++) {
+        const PetscInt j   = bj[p];
+        PetscScalar    sum = a0[p];
+
+        for (PetscInt k = bi[i], q = ucol[j]; k < bi[i + 1] && q < ucol[j + 1]; k++) {
+          while (q < ucol[j + 1] && urow[q] < bj[k]) q++;
+          if (q < ucol[j + 1] && urow[q] == bj[k]) sum -= old[k] * old[upos[q]];
+        }
+        ba[p] = sum;
+      }
+    }
+  }
+
+  /* MatSolve() expects the inverses of the diagonal entries of U */
+  B->factorerrortype = MAT_FACTOR_NOERROR;
+  for (PetscInt i = 0; i < n; i++) {
+    if (PetscAbsScalar(ba[bdiag[i]]) <= info->zeropivot) {
+      PetscCheck(!A->erroriffailure, PETSC_COMM_SELF, PETSC_ERR_MAT_LU_ZRPVT, "Zero pivot row %" PetscInt_FMT " value %g tolerance %g", i, (double)PetscAbsScalar(ba[bdiag[i]]), (double)info->zeropivot);
+      PetscCall(PetscInfo(B, "Zero pivot in row %" PetscInt_FMT " of the iterative ILU, value %g tolerance %g\n", i, (double)PetscAbsScalar(ba[bdiag[i]]), (double)info->zeropivot));
+      B->factorerrortype             = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+      B->factorerror_zeropivot_value = PetscAbsScalar(ba[bdiag[i]]);
+      B->factorerror_zeropivot_row   = i;
+      break;
+    }
+    ba[bdiag[i]] = 1.0 / ba[bdiag[i]];
+  }
+  PetscCall(PetscInfo(B, "Computed the ILU factors with %" PetscInt_FMT " sweeps of the iterative ILU using %d threads\n", sweeps, nt));
+
+  PetscCall(ISRestoreIndices(b->icol, &ic));
+  PetscCall(ISRestoreIndices(b->row, &r));
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  PetscCall(MatSeqAIJRestoreArrayWrite(B, &ba));
+
+  PetscCall(ISIdentity(b->row, &row_identity));
+  PetscCall(ISIdentity(b->icol, &col_identity));
+  if (b->inode.size) {
+    B->ops->solve = MatSolve_SeqAIJ_Inode;
+  } else if (row_identity && col_identity) {
+    B->ops->solve = MatSolve_SeqAIJ_NaturalOrdering;
+  } else {
+    B->ops->solve = MatSolve_SeqAIJ;
+  }
+  PetscCall(MatSeqAIJUseSolveLevels_Private(B));
+  B->ops->solveadd          = MatSolveAdd_SeqAIJ;
+  B->ops->solvetranspose    = MatSolveTranspose_SeqAIJ;
+  B->ops->solvetransposeadd = MatSolveTransposeAdd_SeqAIJ;
+  B->ops->matsolve          = MatMatSolve_SeqAIJ;
+  B->ops->matsolvetranspose = MatMatSolveTranspose_SeqAIJ;
+  B->assembled              = PETSC_TRUE;
+  B->preallocated           = PETSC_TRUE;
+  PetscCall(PetscLogFlops(2.0 * sweeps * nzf));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Called at the end of MatILUFactorSymbolic_SeqAIJ(), reads -mat_seqaij_ilu_sweeps and -mat_seqaij_ilu_jacobi_its. With sweeps
+   the numeric factorization becomes MatLUFactorNumeric_SeqAIJ_Iterative(), which needs the off-diagonal entries of U by columns
+*/
+PetscErrorCode MatSeqAIJSetUpIterativeILU_Private(Mat fact)
+{
+  Mat_SeqAIJ     *b      = (Mat_SeqAIJ *)fact->data;
+  const PetscInt  n      = fact->rmap->n, *bj = b->j, *bdiag = b->diag;
+  PetscInt        sweeps = b->iterilu.sweeps, its = b->iterilu.its, nzu, *ucol;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJDestroyIterativeILU_Private(fact));
+  PetscObjectOptionsBegin((PetscObject)fact);
+  PetscCall(PetscOptionsInt("-mat_seqaij_ilu_sweeps", "Number of sweeps of the iterative ILU of Chow and Patel that computes the ILU factors, 0 for the Gaussian elimination", "MATSEQAIJ", sweeps, &sweeps, NULL));
+  PetscCall(PetscOptionsInt("-mat_seqaij_ilu_jacobi_its", "Number of Jacobi iterations that approximate each triangular solve of MatSolve() with ILU factors, 0 for exact solves", "MATSEQAIJ", its, &its, NULL));
+  PetscOptionsEnd();
+  PetscCheck(sweeps >= 0, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Number of sweeps %" PetscInt_FMT " cannot be negative", sweeps);
+  PetscCheck(its >= 0, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Number of Jacobi iterations %" PetscInt_FMT " cannot be negative", its);
+  b->iterilu.sweeps = sweeps;
+  b->iterilu.its    = its;
+  if (its) PetscCall(PetscMalloc1(2 * n, &b->iterilu.jwork));
+  if (!sweeps) PetscFunctionReturn(PETSC_SUCCESS);
+
+  /* counting sort of the off-diagonal entries of U by column, in increasing row order */
+  nzu = bdiag[0] - bdiag[n] - n;
+  PetscCall(PetscCalloc1(n + 1, &ucol));
+  PetscCall(PetscMalloc2(nzu, &b->iterilu.urow, nzu, &b->iterilu.upos));
+  for (PetscInt i = 0; i < n; i++)
+    for (PetscInt k = bdiag[i + 1] + 1; k < bdiag[i]; k++) ucol[bj[k] + 1]++;
+  for (PetscInt j = 0; j < n; j++) ucol[j + 1] += ucol[j];
+  for (PetscInt i = 0; i < n; i++) {
+    for (PetscInt k = bdiag[i + 1] + 1; k < bdiag[i]; k++) {
+      b->iterilu.urow[ucol[bj[k]]]   = i;
+      b->iterilu.upos[ucol[bj[k]]++] = k;
+    }
+  }
+  for (PetscInt j = n; j > 0; j--) ucol[j] = ucol[j - 1];
+  ucol[0]         = 0;
+  b->iterilu.ucol = ucol;
+  PetscCall(PetscMalloc2(bdiag[0] + 1, &b->iterilu.a0, bdiag[0] + 1, &b->iterilu.old));
+  fact->ops->lufactornumeric = MatLUFactorNumeric_SeqAIJ_Iterative;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatSeqAIJDestroyIterativeILU_Private(Mat A)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree(a->iterilu.ucol));
+  PetscCall(PetscFree2(a->iterilu.urow, a->iterilu.upos));
+  PetscCall(PetscFree2(a->iterilu.a0, a->iterilu.old));
+  PetscCall(PetscFree(a->iterilu.jwork));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 #if 0
 // unused
 /*
@@ -0,0 +1,324 @@
+/*
+  Defines basic operations for the MATSEQAIJSINGLE matrix class.
+  This class is derived from the MATSEQAIJ class, but keeps a copy of the nonzero values
+  rounded to single precision that is used by MatMult(), MatMultAdd() and MatSOR(),
+  which accumulate in the precision of PetscScalar.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+
+typedef struct {
+  float           *val;   /* the nonzero values of the matrix rounded to single precision */
+  PetscInt         nz;    /* length of val[] */
+  PetscObjectState state; /* state of the matrix when val[] was last filled */
+} Mat_SeqAIJSingle;
+
+/* Refill the single precision values if and only if the matrix has changed since they were last filled */
+static PetscErrorCode MatSeqAIJSingleUpdate_Private(Mat A)
+{
+  Mat_SeqAIJ       *a  = (Mat_SeqAIJ *)A->data;
+  Mat_SeqAIJSingle *as = (Mat_SeqAIJSingle *)A->spptr;
+  const MatScalar  *aa;
+  PetscObjectState  state;
+  PetscInt          nz = a->i[A->rmap->n];
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectStateGet((PetscObject)A, &state));
+  if (as->val && as->state == state && as->nz == nz) PetscFunctionReturn(PETSC_SUCCESS);
+  if (as->nz != nz || !as->val) {
+    PetscCall(PetscFree(as->val));
+    PetscCall(PetscMalloc1(nz, &as->val));
+    as->nz = nz;
+  }
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  PetscPragmaSIMD
+  for (PetscInt i = 0; i < nz; i++) as->val[i] = (float)aa[i];
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  as->state = state;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* z = A x, or z = y + A x if y is given; y and z may be the same array */
+static PetscErrorCode MatMultAdd_SeqAIJSingle_Private(Mat A, Vec xx, Vec yy, Vec zz)
+{
+  Mat_SeqAIJ        *a  = (Mat_SeqAIJ *)A->data;
+  Mat_SeqAIJSingle  *as = (Mat_SeqAIJSingle *)A->spptr;
+  const PetscScalar *x, *y = NULL;
+  PetscScalar       *z;
+  const PetscInt    *ii = a->i, *ridx = NULL;
+  PetscInt           m = A->rmap->n, nt = 1;
+  const PetscInt    *rstart = NULL;
+  const float       *val;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJSingleUpdate_Private(A));
+  val = as->val;
+  PetscCall(VecGetArrayRead(xx, &x));
+  if (yy) PetscCall(VecGetArrayPair(yy, zz, (PetscScalar **)&y, &z));
+  else PetscCall(VecGetArrayWrite(zz, &z));
+  if (a->compressedrow.use) {
+    if (!yy) PetscCall(PetscArrayzero(z, m));
+    else if (zz != yy) PetscCall(PetscArraycpy(z, y, m));
+    m    = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  }
+  if (MatSeqAIJUseThreads_Private(A)) { /* each thread owns a fixed set of (possibly compressed) rows */
+    nt     = a->threads.nthreads;
+    rstart = a->threads.rstart;
+  }
+  PetscPragmaOMP(parallel for num_threads((int)nt) schedule(static, 1) if (nt > 1))
+  for (PetscInt t = 0; t < nt; t++) {
+    const PetscInt rs = rstart ? rstart[t] : 0, re = rstart ? rstart[t + 1] : m;
+
+    for (PetscInt i = rs; i < re; i++) {
+      const PetscInt r   = ridx ? ridx[i] : i;
+      PetscScalar    sum = y ? y[r] : 0.0;
+
+      PetscPragmaSIMD
+      for (PetscInt j = ii[i]; j < ii[i + 1]; j++) sum += (PetscScalar)val[j] * x[a->j[j]];
+      z[r] = sum;
+    }
+  }
+  PetscCall(PetscLogFlops(yy ? 2.0 * a->nz : 2.0 * a->nz - a->nonzerorowcnt));
+  PetscCall(VecRestoreArrayRead(xx, &x));
+  if (yy) PetscCall(VecRestoreArrayPair(yy, zz, (PetscScalar **)&y, &z));
+  else PetscCall(VecRestoreArrayWrite(zz, &z));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatMult_SeqAIJSingle(Mat A, Vec xx, Vec yy)
+{
+  PetscFunctionBegin;
+  PetscCall(MatMultAdd_SeqAIJSingle_Private(A, xx, NULL, yy));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatMultAdd_SeqAIJSingle(Mat A, Vec xx, Vec yy, Vec zz)
+{
+  PetscFunctionBegin;
+  PetscCall(MatMultAdd_SeqAIJSingle_Private(A, xx, yy, zz));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* sum -= val[j] x[aj[j]] for j in [js, je), accumulating in the precision of sum */
+#define MatSeqAIJSingleMinusDot_Private(sum, x, val, aj, js, je) \
+  do { \
+    PetscPragmaSIMD \
+    for (PetscInt __j = (js); __j < (je); __j++) sum -= (PetscScalar)(val)[__j] * (x)[(aj)[__j]]; \
+  } while (0)
+
+/*
+   Same algorithm as MatSOR_SeqAIJ() for the local sweeps; the diagonal and its inverse are kept in the precision of PetscScalar.
+   Eisenstat's trick and the application of the triangular parts use the full precision values.
+*/
+static PetscErrorCode MatSOR_SeqAIJSingle(Mat A, Vec bb, PetscReal omega, MatSORType flag, PetscReal fshift, PetscInt its, PetscInt lits, Vec xx)
+{
+  Mat_SeqAIJ        *a  = (Mat_SeqAIJ *)A->data;
+  Mat_SeqAIJSingle  *as = (Mat_SeqAIJSingle *)A->spptr;
+  PetscScalar       *x, sum, *t;
+  const PetscScalar *b, *xb, *idiag, *mdiag;
+  const PetscInt    *ai = a->i, *aj = a->j, *diag;
+  const float       *val;
+  PetscInt           m = A->rmap->n;
+
+  PetscFunctionBegin;
+  if (flag == SOR_APPLY_UPPER || flag == SOR_APPLY_LOWER || (flag & SOR_EISENSTAT)) {
+    PetscCall(MatSOR_SeqAIJ(A, bb, omega, flag, fshift, its, lits, xx));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  its = its * lits;
+
+  if (fshift != a->fshift || omega != a->omega) a->idiagvalid = PETSC_FALSE; /* must recompute idiag[] */
+  if (!a->idiagvalid) PetscCall(MatInvertDiagonal_SeqAIJ(A, omega, fshift));
+  a->fshift = fshift;
+  a->omega  = omega;
+  PetscCall(MatSeqAIJSingleUpdate_Private(A));
+
+  diag  = a->diag;
+  t     = a->ssor_work;
+  idiag = a->idiag;
+  mdiag = a->mdiag;
+  val   = as->val;
+
+  PetscCall(VecGetArray(xx, &x));
+  PetscCall(VecGetArrayRead(bb, &b));
+  /* We count flops by assuming the upper triangular and lower triangular parts have the same number of nonzeros */
+  if (flag & SOR_ZERO_INITIAL_GUESS) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (PetscInt i = 0; i < m; i++) {
+        sum = b[i];
+        MatSeqAIJSingleMinusDot_Private(sum, x, val, aj, ai[i], diag[i]);
+        t[i] = sum;
+        x[i] = sum * idiag[i];
+      }
+      xb = t;
+      PetscCall(PetscLogFlops(a->nz));
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (PetscInt i = m - 1; i >= 0; i--) {
+        sum = xb[i];
+        MatSeqAIJSingleMinusDot_Private(sum, x, val, aj, diag[i] + 1, ai[i + 1]);
+        if (xb == b) x[i] = sum * idiag[i];
+        else x[i] = (1 - omega) * x[i] + sum * idiag[i]; /* omega in idiag */
+      }
+      PetscCall(PetscLogFlops(a->nz)); /* assumes 1/2 in upper */
+    }
+    its--;
+  }
+  while (its--) {
+    if (flag & SOR_FORWARD_SWEEP || flag & SOR_LOCAL_FORWARD_SWEEP) {
+      for (PetscInt i = 0; i < m; i++) {
+        sum = b[i];
+        MatSeqAIJSingleMinusDot_Private(sum, x, val, aj, ai[i], diag[i]);
+        t[i] = sum; /* save application of the lower-triangular part */
+        MatSeqAIJSingleMinusDot_Private(sum, x, val, aj, diag[i] + 1, ai[i + 1]);
+        x[i] = (1. - omega) * x[i] + sum * idiag[i]; /* omega in idiag */
+      }
+      xb = t;
+      PetscCall(PetscLogFlops(2.0 * a->nz));
+    } else xb = b;
+    if (flag & SOR_BACKWARD_SWEEP || flag & SOR_LOCAL_BACKWARD_SWEEP) {
+      for (PetscInt i = m - 1; i >= 0; i--) {
+        sum = xb[i];
+        if (xb == b) { /* whole matrix (no checkpointing available) */
+          MatSeqAIJSingleMinusDot_Private(sum, x, val, aj, ai[i], ai[i + 1]);
+          x[i] = (1. - omega) * x[i] + (sum + mdiag[i] * x[i]) * idiag[i];
+        } else { /* lower-triangular part has been saved, so only apply upper-triangular */
+          MatSeqAIJSingleMinusDot_Private(sum, x, val, aj, diag[i] + 1, ai[i + 1]);
+          x[i] = (1. - omega) * x[i] + sum * idiag[i]; /* omega in idiag */
+        }
+      }
+      if (xb == b) {
+        PetscCall(PetscLogFlops(2.0 * a->nz));
+      } else {
+        PetscCall(PetscLogFlops(a->nz)); /* assumes 1/2 in upper */
+      }
+    }
+  }
+  PetscCall(VecRestoreArray(xx, &x));
+  PetscCall(VecRestoreArrayRead(bb, &b));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatAssemblyEnd_SeqAIJSingle(Mat A, MatAssemblyType mode)
+{
+  Mat_SeqAIJ *a = (Mat_SeqAIJ *)A->data;
+
+  PetscFunctionBegin;
+  if (mode == MAT_FLUSH_ASSEMBLY) PetscFunctionReturn(PETSC_SUCCESS);
+  /* the inode kernels would bypass the single precision values */
+  a->inode.use = PETSC_FALSE;
+  PetscCall(MatAssemblyEnd_SeqAIJ(A, mode));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJSingle_SeqAIJ(Mat A, MatType type, MatReuse reuse, Mat *newmat)
+{
+  Mat               B = *newmat;
+  Mat_SeqAIJSingle *as;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) PetscCall(MatDuplicate(A, MAT_COPY_VALUES, &B));
+
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJ;
+  B->ops->destroy     = MatDestroy_SeqAIJ;
+  B->ops->mult        = MatMult_SeqAIJ;
+  B->ops->multadd     = MatMultAdd_SeqAIJ;
+  B->ops->sor         = MatSOR_SeqAIJ;
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaijsingle_seqaij_C", NULL));
+
+  as = (Mat_SeqAIJSingle *)B->spptr;
+  PetscCall(PetscFree(as->val));
+  PetscCall(PetscFree(B->spptr));
+
+  PetscCall(PetscObjectChangeTypeName((PetscObject)B, MATSEQAIJ));
+  *newmat = B;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatDestroy_SeqAIJSingle(Mat A)
+{
+  Mat_SeqAIJSingle *as = (Mat_SeqAIJSingle *)A->spptr;
+
+  PetscFunctionBegin;
+  /* If MatHeaderMerge() was used, then this matrix will not have an spptr pointer */
+  if (as) {
+    PetscCall(PetscFree(as->val));
+    PetscCall(PetscFree(A->spptr));
+  }
+  PetscCall(PetscObjectChangeTypeName((PetscObject)A, MATSEQAIJ));
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaijsingle_seqaij_C", NULL));
+  PetscCall(MatDestroy_SeqAIJ(A));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJSingle converts a SeqAIJ matrix into a SeqAIJSingle matrix.
+ * This routine is called by MatCreate_SeqAIJSingle(), but can also be used to convert an assembled SeqAIJ matrix. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJSingle(Mat A, MatType type, MatReuse reuse, Mat *newmat)
+{
+  Mat               B = *newmat;
+  Mat_SeqAIJSingle *as;
+  PetscBool         sametype;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) PetscCall(MatDuplicate(A, MAT_COPY_VALUES, &B));
+
+  PetscCall(PetscObjectTypeCompare((PetscObject)A, type, &sametype));
+  if (sametype) PetscFunctionReturn(PETSC_SUCCESS);
+
+  PetscCall(PetscNew(&as));
+  B->spptr = (void *)as;
+
+  ((Mat_SeqAIJ *)B->data)->inode.use = PETSC_FALSE;
+
+  B->ops->assemblyend = MatAssemblyEnd_SeqAIJSingle;
+  B->ops->destroy     = MatDestroy_SeqAIJSingle;
+  B->ops->mult        = MatMult_SeqAIJSingle;
+  B->ops->multadd     = MatMultAdd_SeqAIJSingle;
+  B->ops->sor         = MatSOR_SeqAIJSingle;
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaijsingle_seqaij_C", MatConvert_SeqAIJSingle_SeqAIJ));
+
+  PetscCall(PetscObjectChangeTypeName((PetscObject)B, MATSEQAIJSINGLE));
+  *newmat = B;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   MATSEQAIJSINGLE - MATSEQAIJSINGLE = "seqaijsingle" - A `MATSEQAIJ` matrix that applies itself with its nonzero values
+   rounded to single precision.
+
+   Options Database Key:
+. -mat_type seqaijsingle - sets the matrix type to `MATSEQAIJSINGLE` during a call to `MatSetFromOptions()`
+
+   Level: intermediate
+
+   Notes:
+   The matrix is assembled, stored and factored exactly like `MATSEQAIJ`. In addition it keeps a copy of the nonzero values
+   in single precision that is refreshed whenever the matrix changes; `MatMult()`, `MatMultAdd()` and the local sweeps of `MatSOR()`
+   read only this copy and the column indices, while the vectors and all the sums stay in the precision of `PetscScalar`.
+   This reduces the memory traffic of these bandwidth bound operations by about a third with 32-bit indices, at the cost of a
+   relative perturbation of the operator of the order of the single precision machine epsilon. It is meant for operators whose
+   application does not need full precision, for example inside the smoothers of `PCMG` or the subdomain solves of `PCBJACOBI`.
+
+   The storage of the matrix grows by half, since the full precision values are kept for all the other operations.
+
+   The inode kernels are not used by this class.
+
+   Because `MATSEQAIJSINGLE` is a subtype of `MATSEQAIJ`, the option `-mat_seqaij_type seqaijsingle` can be used to make
+   sequential `MATSEQAIJ` matrices default to being instances of `MATSEQAIJSINGLE`.
+
+   This type is only available for real scalars.
+
+.seealso: [](ch_matrices), `Mat`, `MATSEQAIJ`, `MATSEQAIJSELL`, `MatCreateSeqAIJ()`, `MatSeqAIJSetType()`
+M*/
+
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSingle(Mat A)
+{
+  PetscFunctionBegin;
+  PetscCall(MatSetType(A, MATSEQAIJ));
+  PetscCall(MatConvert_SeqAIJ_SeqAIJSingle(A, MATSEQAIJSINGLE, MAT_INPLACE_MATRIX, &A));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
@@ -0,0 +1,672 @@
+/*
+  Defines basic operations for the MATSEQAIJVBR matrix class.
+  This class is derived from the MATSEQAIJ class, but maintains a "shadow" copy of the matrix in variable block row (VBR)
+  format: the rows and the columns are partitioned into the blocks set with MatSetVariableBlockSizes(), or into blocks of
+  the block size of the matrix, and every block that contains a nonzero is stored as a dense block, column by column.
+  The shadow copy is used for MatMult(), MatMultAdd(), MatSOR() and the ILU(0) factorization.
+*/
+
+#include <../src/mat/impls/aij/seq/aij.h>
+#include <petsc/private/kernels/blockinvert.h>
+
+typedef struct {
+  PetscObjectState state;        /* state of the matrix when the shadow copy was last filled */
+  PetscObjectState nonzerostate; /* nonzero state of the matrix when the block structure was last built */
+  PetscBool        use;          /* there is a block structure, otherwise the MATSEQAIJ routines are used */
+  PetscInt         nblocks, maxbs, nonzerorowcnt;
+  PetscInt        *bstart;          /* first row (and column) of each block */
+  PetscInt        *bi, *bj, *bdiag; /* block compressed row structure, bdiag[] is the location of the diagonal block of each block row, or -1 */
+  PetscInt        *boff;            /* location of each block in bval[] */
+  PetscInt        *amap;            /* location in bval[] of each nonzero of the MATSEQAIJ storage */
+  MatScalar       *bval;
+  PetscObjectState idiagstate; /* state of the matrix when the diagonal blocks were last inverted */
+  PetscInt        *ioff;
+  MatScalar       *idiag; /* inverses of the diagonal blocks for MatSOR(), at ioff[] */
+  PetscScalar     *work;
+} Mat_SeqAIJVBR;
+
+/* the ILU(0) factor on the block structure of the matrix, the inverses of the diagonal blocks of U are stored */
+typedef struct {
+  PetscInt     nblocks, maxbs;
+  PetscInt    *bstart, *bi, *bj, *bdiag, *boff;
+  MatScalar   *bval;
+  PetscScalar *work;
+} Mat_SeqAIJVBR_ILU;
+
+/* y += v x and y -= v x, for the m x n block v */
+static inline void MatSeqAIJVBRBlockMultAdd_Private(PetscInt m, PetscInt n, const MatScalar *v, const PetscScalar *x, PetscScalar *y)
+{
+  for (PetscInt c = 0; c < n; c++) {
+    const PetscScalar xc = x[c];
+
+    PetscPragmaSIMD
+    for (PetscInt r = 0; r < m; r++) y[r] += v[c * m + r] * xc;
+  }
+}
+
+static inline void MatSeqAIJVBRBlockMultSub_Private(PetscInt m, PetscInt n, const MatScalar *v, const PetscScalar *x, PetscScalar *y)
+{
+  for (PetscInt c = 0; c < n; c++) {
+    const PetscScalar xc = x[c];
+
+    PetscPragmaSIMD
+    for (PetscInt r = 0; r < m; r++) y[r] -= v[c * m + r] * xc;
+  }
+}
+
+/* C = A B and C -= A B, for the m x p block A and the p x n block B */
+static inline void MatSeqAIJVBRBlockGemm_Private(PetscInt m, PetscInt n, PetscInt p, const MatScalar *A, const MatScalar *B, MatScalar *C)
+{
+  for (PetscInt j = 0; j < n; j++) {
+    for (PetscInt r = 0; r < m; r++) C[j * m + r] = 0.0;
+    for (PetscInt l = 0; l < p; l++) {
+      const MatScalar b = B[j * p + l];
+
+      PetscPragmaSIMD
+      for (PetscInt r = 0; r < m; r++) C[j * m + r] += A[l * m + r] * b;
+    }
+  }
+}
+
+static inline void MatSeqAIJVBRBlockGemmSub_Private(PetscInt m, PetscInt n, PetscInt p, const MatScalar *A, const MatScalar *B, MatScalar *C)
+{
+  for (PetscInt j = 0; j < n; j++) {
+    for (PetscInt l = 0; l < p; l++) {
+      const MatScalar b = B[j * p + l];
+
+      PetscPragmaSIMD
+      for (PetscInt r = 0; r < m; r++) C[j * m + r] -= A[l * m + r] * b;
+    }
+  }
+}
+
+static PetscErrorCode MatSeqAIJVBRReset_Private(Mat_SeqAIJVBR *vbr)
+{
+  PetscFunctionBegin;
+  PetscCall(PetscFree(vbr->bstart));
+  PetscCall(PetscFree2(vbr->bi, vbr->bdiag));
+  PetscCall(PetscFree2(vbr->bj, vbr->boff));
+  PetscCall(PetscFree(vbr->amap));
+  PetscCall(PetscFree(vbr->bval));
+  PetscCall(PetscFree2(vbr->ioff, vbr->idiag));
+  PetscCall(PetscFree(vbr->work));
+  vbr->use          = PETSC_FALSE;
+  vbr->nblocks      = 0;
+  vbr->nonzerostate = -1;
+  vbr->idiagstate   = -1;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Build or update the shadow copy if and only if needed, we track the ObjectState and the blocks to determine when this needs to be done */
+static PetscErrorCode MatSeqAIJVBR_build_shadow(Mat A)
+{
+  Mat_SeqAIJ      *a   = (Mat_SeqAIJ *)A->data;
+  Mat_SeqAIJVBR   *vbr = (Mat_SeqAIJVBR *)A->spptr;
+  const PetscInt  *ai = a->i, *aj = a->j, *bsizes, m = A->rmap->n;
+  PetscInt         nb, bs, nbz;
+  PetscBool        same;
+  const MatScalar *aa;
+  PetscObjectState state;
+
+  PetscFunctionBegin;
+  PetscCall(MatGetVariableBlockSizes(A, &nb, &bsizes));
+  PetscCall(MatGetBlockSize(A, &bs));
+  if (!bsizes) nb = bs > 1 ? m / bs : 0;
+  same = (PetscBool)(vbr->bstart && nb == vbr->nblocks);
+  for (PetscInt i = 0; same && i < nb; i++) same = (PetscBool)(vbr->bstart[i + 1] - vbr->bstart[i] == (bsizes ? bsizes[i] : bs));
+  PetscCall(PetscObjectStateGet((PetscObject)A, &state));
+  if (same && vbr->state == state) PetscFunctionReturn(PETSC_SUCCESS);
+  if (!nb || A->cmap->n != m) {
+    if (vbr->bstart) PetscCall(MatSeqAIJVBRReset_Private(vbr));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
+  if (!same || vbr->nonzerostate != A->nonzerostate) {
+    PetscInt *rowblock, *mark, *bstart;
+
+    PetscCall(PetscLogEventBegin(MAT_Convert, A, 0, 0, 0));
+    PetscCall(MatSeqAIJVBRReset_Private(vbr));
+    PetscCall(PetscMalloc1(nb + 1, &vbr->bstart));
+    bstart     = vbr->bstart;
+    bstart[0]  = 0;
+    vbr->maxbs = 0;
+    for (PetscInt i = 0; i < nb; i++) {
+      bstart[i + 1] = bstart[i] + (bsizes ? bsizes[i] : bs);
+      vbr->maxbs    = PetscMax(vbr->maxbs, bstart[i + 1] - bstart[i]);
+    }
+    PetscCall(PetscMalloc2(m, &rowblock, nb, &mark));
+    for (PetscInt i = 0; i < nb; i++) {
+      for (PetscInt r = bstart[i]; r < bstart[i + 1]; r++) rowblock[r] = i;
+      mark[i] = -1;
+    }
+
+    /* count the nonzero blocks of each block row, then list them */
+    PetscCall(PetscMalloc2(nb + 1, &vbr->bi, nb, &vbr->bdiag));
+    vbr->bi[0] = 0;
+    for (PetscInt i = 0; i < nb; i++) {
+      PetscInt cnt = 0;
+
+      for (PetscInt r = bstart[i]; r < bstart[i + 1]; r++) {
+        for (PetscInt k = ai[r]; k < ai[r + 1]; k++) {
+          const PetscInt j = rowblock[aj[k]];
+
+          if (mark[j] != i) {
+            mark[j] = i;
+            cnt++;
+          }
+        }
+      }
+      vbr->bi[i + 1] = vbr->bi[i] + cnt;
+    }
+    nbz = vbr->bi[nb];
+    PetscCall(PetscMalloc2(nbz, &vbr->bj, nbz + 1, &vbr->boff));
+    for (PetscInt i = 0; i < nb; i++) mark[i] = -1;
+    vbr->boff[0]       = 0;
+    vbr->nonzerorowcnt = 0;
+    for (PetscInt i = 0; i < nb; i++) {
+      PetscInt p = vbr->bi[i];
+
+      for (PetscInt r = bstart[i]; r < bstart[i + 1]; r++) {
+        for (PetscInt k = ai[r]; k < ai[r + 1]; k++) {
+          const PetscInt j = rowblock[aj[k]];
+
+          if (mark[j] != i) {
+            mark[j]       = i;
+            vbr->bj[p++] = j;
+          }
+        }
+      }
+      PetscCall(PetscSortInt(vbr->bi[i + 1] - vbr->bi[i], vbr->bj + vbr->bi[i]));
+      vbr->bdiag[i] = -1;
+      for (PetscInt k = vbr->bi[i]; k < vbr->bi[i + 1]; k++) {
+        const PetscInt j = vbr->bj[k];
+
+        vbr->boff[k + 1] = vbr->boff[k] + (bstart[i + 1] - bstart[i]) * (bstart[j + 1] - bstart[j]);
+        if (j == i) vbr->bdiag[i] = k;
+      }
+      if (vbr->bi[i + 1] > vbr->bi[i]) vbr->nonzerorowcnt += bstart[i + 1] - bstart[i];
+    }
+
+    /* the location of each nonzero in the blocks, mark[] now gives the location of the blocks in the current block row */
+    PetscCall(PetscMalloc1(ai[m], &vbr->amap));
+    for (PetscInt i = 0; i < nb; i++) {
+      const PetscInt bsi = bstart[i + 1] - bstart[i];
+
+      for (PetscInt k = vbr->bi[i]; k < vbr->bi[i + 1]; k++) mark[vbr->bj[k]] = k;
+      for (PetscInt r = bstart[i]; r < bstart[i + 1]; r++) {
+        for (PetscInt k = ai[r]; k < ai[r + 1]; k++) {
+          const PetscInt c = aj[k], j = rowblock[c];
+
+          vbr->amap[k] = vbr->boff[mark[j]] + (c - bstart[j]) * bsi + r - bstart[i];
+        }
+      }
+    }
+    PetscCall(PetscFree2(rowblock, mark));
+    PetscCall(PetscMalloc1(vbr->boff[nbz], &vbr->bval));
+    PetscCall(PetscMalloc1(vbr->maxbs, &vbr->work));
+    vbr->nblocks      = nb;
+    vbr->nonzerostate = A->nonzerostate;
+    PetscCall(PetscLogEventEnd(MAT_Convert, A, 0, 0, 0));
+    PetscCall(PetscInfo(A, "%" PetscInt_FMT " blocks of size at most %" PetscInt_FMT ", %" PetscInt_FMT " nonzero blocks storing %" PetscInt_FMT " values for %" PetscInt_FMT " nonzeros\n", nb, vbr->maxbs, nbz, vbr->boff[nbz], ai[m]));
+  }
+
+  nbz = vbr->bi[nb];
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  PetscCall(PetscArrayzero(vbr->bval, vbr->boff[nbz]));
+  for (PetscInt k = 0; k < ai[m]; k++) vbr->bval[vbr->amap[k]] = aa[k];
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  vbr->use   = PETSC_TRUE;
+  vbr->state = state;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static void MatSeqAIJVBRMultAdd_Private(const Mat_SeqAIJVBR *vbr, const PetscScalar *x, PetscScalar *y)
+{
+  const PetscInt *bstart = vbr->bstart, *bi = vbr->bi, *bj = vbr->bj, *boff = vbr->boff;
+
+  for (PetscInt i = 0; i < vbr->nblocks; i++) {
+    const PetscInt m = bstart[i + 1] - bstart[i];
+
+    for (PetscInt k = bi[i]; k < bi[i + 1]; k++) {
+      const PetscInt j = bj[k];
+
+      MatSeqAIJVBRBlockMultAdd_Private(m, bstart[j + 1] - bstart[j], vbr->bval + boff[k], x + bstart[j], y + bstart[i]);
+    }
+  }
+}
+
+static PetscErrorCode MatMult_SeqAIJVBR(Mat A, Vec xx, Vec yy)
+{
+  Mat_SeqAIJVBR     *vbr = (Mat_SeqAIJVBR *)A->spptr;
+  const PetscScalar *x;
+  PetscScalar       *y;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJVBR_build_shadow(A));
+  if (!vbr->use) {
+    PetscCall(MatMult_SeqAIJ(A, xx, yy));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(VecGetArrayRead(xx, &x));
+  PetscCall(VecGetArrayWrite(yy, &y));
+  PetscCall(PetscArrayzero(y, A->rmap->n));
+  MatSeqAIJVBRMultAdd_Private(vbr, x, y);
+  PetscCall(VecRestoreArrayRead(xx, &x));
+  PetscCall(VecRestoreArrayWrite(yy, &y));
+  PetscCall(PetscLogFlops(2.0 * vbr->boff[vbr->bi[vbr->nblocks]] - vbr->nonzerorowcnt));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatMultAdd_SeqAIJVBR(Mat A, Vec xx, Vec yy, Vec zz)
+{
+  Mat_SeqAIJVBR     *vbr = (Mat_SeqAIJVBR *)A->spptr;
+  const PetscScalar *x;
+  PetscScalar       *z;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJVBR_build_shadow(A));
+  if (!vbr->use) {
+    PetscCall(MatMultAdd_SeqAIJ(A, xx, yy, zz));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCall(VecCopy(yy, zz));
+  PetscCall(VecGetArrayRead(xx, &x));
+  PetscCall(VecGetArray(zz, &z));
+  MatSeqAIJVBRMultAdd_Private(vbr, x, z);
+  PetscCall(VecRestoreArrayRead(xx, &x));
+  PetscCall(VecRestoreArray(zz, &z));
+  PetscCall(PetscLogFlops(2.0 * vbr->boff[vbr->bi[vbr->nblocks]]));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatSeqAIJVBRInvertDiagonal_Private(Mat A)
+{
+  Mat_SeqAIJVBR *vbr = (Mat_SeqAIJVBR *)A->spptr;
+  const PetscInt nb  = vbr->nblocks, *bstart = vbr->bstart;
+  PetscInt      *pivots;
+  PetscScalar   *work;
+  PetscBool      allowzeropivot = PetscNot(A->erroriffailure), zeropivotdetected;
+  PetscLogDouble flops          = 0.0;
+
+  PetscFunctionBegin;
+  if (vbr->idiagstate == vbr->state) PetscFunctionReturn(PETSC_SUCCESS);
+  if (!vbr->ioff) {
+    PetscInt n = 0;
+
+    for (PetscInt i = 0; i < nb; i++) n += (bstart[i + 1] - bstart[i]) * (bstart[i + 1] - bstart[i]);
+    PetscCall(PetscMalloc2(nb + 1, &vbr->ioff, n, &vbr->idiag));
+    vbr->ioff[0] = 0;
+    for (PetscInt i = 0; i < nb; i++) vbr->ioff[i + 1] = vbr->ioff[i] + (bstart[i + 1] - bstart[i]) * (bstart[i + 1] - bstart[i]);
+  }
+  PetscCall(PetscMalloc2(vbr->maxbs, &pivots, vbr->maxbs, &work));
+  for (PetscInt i = 0; i < nb; i++) {
+    const PetscInt bs = bstart[i + 1] - bstart[i];
+
+    PetscCheck(vbr->bdiag[i] >= 0, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Matrix is missing diagonal block %" PetscInt_FMT, i);
+    PetscCall(PetscArraycpy(vbr->idiag + vbr->ioff[i], vbr->bval + vbr->boff[vbr->bdiag[i]], bs * bs));
+    PetscCall(PetscKernel_A_gets_inverse_A(bs, vbr->idiag + vbr->ioff[i], pivots, work, allowzeropivot, &zeropivotdetected));
+    if (zeropivotdetected) A->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+    flops += 4.0 * bs * bs * bs / 3.0;
+  }
+  PetscCall(PetscFree2(pivots, work));
+  PetscCall(PetscLogFlops(flops));
+  PetscCall(PetscInfo(A, "Inverted %" PetscInt_FMT " diagonal blocks for the block relaxation\n", nb));
+  vbr->idiagstate = vbr->state;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* x_i += omega inv(A_ii) (b_i - sum_k A_ik x_k) using the blocks k0 <= k < k1 of block row i */
+static inline void MatSeqAIJVBRRelax_Private(const Mat_SeqAIJVBR *vbr, PetscInt i, PetscInt k0, PetscInt k1, PetscReal omega, const PetscScalar *b, PetscScalar *x)
+{
+  const PetscInt *bstart = vbr->bstart, m = bstart[i + 1] - bstart[i];
+  PetscScalar    *s      = vbr->work;
+
+  for (PetscInt r = 0; r < m; r++) s[r] = b[bstart[i] + r];
+  for (PetscInt k = k0; k < k1; k++) {
+    const PetscInt j = vbr->bj[k];
+
+    MatSeqAIJVBRBlockMultSub_Private(m, bstart[j + 1] - bstart[j], vbr->bval + vbr->boff[k], x + bstart[j], s);
+  }
+  for (PetscInt r = 0; r < m; r++) s[r] *= omega;
+  MatSeqAIJVBRBlockMultAdd_Private(m, m, vbr->idiag + vbr->ioff[i], s, x + bstart[i]);
+}
+
+/*
+   Block Gauss-Seidel/SOR with the diagonal blocks; Eisenstat, the application of the triangular parts and diagonal
+   shifts are handled by the point relaxation of MATSEQAIJ
+*/
+static PetscErrorCode MatSOR_SeqAIJVBR(Mat A, Vec bb, PetscReal omega, MatSORType flag, PetscReal fshift, PetscInt its, PetscInt lits, Vec xx)
+{
+  Mat_SeqAIJVBR     *vbr = (Mat_SeqAIJVBR *)A->spptr;
+  const PetscInt    *bi, *bdiag;
+  const PetscScalar *b;
+  PetscScalar       *x;
+  PetscBool          zero = (flag & SOR_ZERO_INITIAL_GUESS) ? PETSC_TRUE : PETSC_FALSE;
+  PetscInt           nb, nsweeps = 0;
+
+  PetscFunctionBegin;
+  PetscCall(MatSeqAIJVBR_build_shadow(A));
+  if (!vbr->use || (flag & (SOR_EISENSTAT | SOR_APPLY_UPPER | SOR_APPLY_LOWER)) || fshift != 0.0) {
+    PetscCall(MatSOR_SeqAIJ(A, bb, omega, flag, fshift, its, lits, xx));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  PetscCheck(its > 0 && lits > 0, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Relaxation requires global its %" PetscInt_FMT " and local its %" PetscInt_FMT " both positive", its, lits);
+  PetscCall(MatSeqAIJVBRInvertDiagonal_Private(A));
+  nb    = vbr->nblocks;
+  bi    = vbr->bi;
+  bdiag = vbr->bdiag;
+
+  PetscCall(VecGetArrayRead(bb, &b));
+  PetscCall(VecGetArray(xx, &x));
+  /* with a zero initial guess the first sweep only needs the blocks on one side of the diagonal */
+  if (zero) PetscCall(PetscArrayzero(x, A->rmap->n));
+  for (PetscInt it = 0; it < its * lits; it++) {
+    if (flag & (SOR_FORWARD_SWEEP | SOR_LOCAL_FORWARD_SWEEP)) {
+      for (PetscInt i = 0; i < nb; i++) MatSeqAIJVBRRelax_Private(vbr, i, bi[i], zero ? bdiag[i] : bi[i + 1], omega, b, x);
+      zero = PETSC_FALSE;
+      nsweeps++;
+    }
+    if (flag & (SOR_BACKWARD_SWEEP | SOR_LOCAL_BACKWARD_SWEEP)) {
+      for (PetscInt i = nb - 1; i >= 0; i--) MatSeqAIJVBRRelax_Private(vbr, i, zero ? bdiag[i] + 1 : bi[i], bi[i + 1], omega, b, x);
+      zero = PETSC_FALSE;
+      nsweeps++;
+    }
+  }
+  PetscCall(VecRestoreArrayRead(bb, &b));
+  PetscCall(VecRestoreArray(xx, &x));
+  PetscCall(PetscLogFlops(nsweeps * (2.0 * vbr->boff[bi[nb]] + 2.0 * vbr->ioff[nb])));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatSeqAIJVBRILUDestroy_Private(void **data)
+{
+  Mat_SeqAIJVBR_ILU *ilu = *(Mat_SeqAIJVBR_ILU **)data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree5(ilu->bstart, ilu->bi, ilu->bdiag, ilu->bj, ilu->boff));
+  PetscCall(PetscFree2(ilu->bval, ilu->work));
+  PetscCall(PetscFree(ilu));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatSolve_SeqAIJVBR_ILU(Mat fact, Vec bb, Vec xx)
+{
+  Mat_SeqAIJVBR_ILU *ilu;
+  const PetscInt    *bstart, *bi, *bj, *bdiag, *boff;
+  PetscScalar       *x, *s;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectContainerQuery((PetscObject)fact, "MatSeqAIJVBR_ILU", (void **)&ilu));
+  bstart = ilu->bstart;
+  bi     = ilu->bi;
+  bj     = ilu->bj;
+  bdiag  = ilu->bdiag;
+  boff   = ilu->boff;
+  s      = ilu->work;
+  PetscCall(VecCopy(bb, xx));
+  PetscCall(VecGetArray(xx, &x));
+
+  /* forward solve with the unit lower triangular L */
+  for (PetscInt i = 0; i < ilu->nblocks; i++) {
+    const PetscInt m = bstart[i + 1] - bstart[i];
+
+    for (PetscInt k = bi[i]; k < bdiag[i]; k++) {
+      const PetscInt j = bj[k];
+
+      MatSeqAIJVBRBlockMultSub_Private(m, bstart[j + 1] - bstart[j], ilu->bval + boff[k], x + bstart[j], x + bstart[i]);
+    }
+  }
+
+  /* backward solve with U, whose diagonal blocks are inverted */
+  for (PetscInt i = ilu->nblocks - 1; i >= 0; i--) {
+    const PetscInt m = bstart[i + 1] - bstart[i];
+
+    for (PetscInt r = 0; r < m; r++) s[r] = x[bstart[i] + r];
+    for (PetscInt k = bdiag[i] + 1; k < bi[i + 1]; k++) {
+      const PetscInt j = bj[k];
+
+      MatSeqAIJVBRBlockMultSub_Private(m, bstart[j + 1] - bstart[j], ilu->bval + boff[k], x + bstart[j], s);
+    }
+    for (PetscInt r = 0; r < m; r++) x[bstart[i] + r] = 0.0;
+    MatSeqAIJVBRBlockMultAdd_Private(m, m, ilu->bval + boff[bdiag[i]], s, x + bstart[i]);
+  }
+  PetscCall(VecRestoreArray(xx, &x));
+  PetscCall(PetscLogFlops(2.0 * boff[bi[ilu->nblocks]] - fact->rmap->n));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatILUFactorNumeric_SeqAIJVBR(Mat fact, Mat A, const MatFactorInfo *info)
+{
+  Mat_SeqAIJVBR     *vbr = (Mat_SeqAIJVBR *)A->spptr;
+  Mat_SeqAIJVBR_ILU *ilu;
+  const PetscInt    *bstart, *bi, *bj, *bdiag, *boff;
+  PetscInt           nb, *colpos, *pivots;
+  MatScalar         *bval, *w;
+  PetscScalar       *work;
+  PetscBool          allowzeropivot = PetscNot(A->erroriffailure), zeropivotdetected;
+  PetscLogDouble     flops          = 0.0;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectContainerQuery((PetscObject)fact, "MatSeqAIJVBR_ILU", (void **)&ilu));
+  PetscCall(MatSeqAIJVBR_build_shadow(A));
+  nb = ilu->nblocks;
+  PetscCheck(vbr->use && vbr->nblocks == nb && vbr->bi[nb] == ilu->bi[nb], PETSC_COMM_SELF, PETSC_ERR_ARG_INCOMP, "The block structure of the matrix changed since the symbolic factorization");
+  bstart = ilu->bstart;
+  bi     = ilu->bi;
+  bj     = ilu->bj;
+  bdiag  = ilu->bdiag;
+  boff   = ilu->boff;
+  bval   = ilu->bval;
+  PetscCall(PetscArraycpy(bval, vbr->bval, boff[bi[nb]]));
+  PetscCall(PetscMalloc4(nb, &colpos, ilu->maxbs * ilu->maxbs, &w, ilu->maxbs, &pivots, ilu->maxbs, &work));
+  for (PetscInt i = 0; i < nb; i++) colpos[i] = -1;
+
+  fact->factorerrortype = MAT_FACTOR_NOERROR;
+  for (PetscInt i = 0; i < nb; i++) {
+    const PetscInt m = bstart[i + 1] - bstart[i];
+
+    for (PetscInt k = bi[i]; k < bi[i + 1]; k++) colpos[bj[k]] = k;
+    /* eliminate with the previous block rows, dropping the blocks outside of the structure of block row i */
+    for (PetscInt k = bi[i]; k < bdiag[i]; k++) {
+      const PetscInt l = bj[k], p = bstart[l + 1] - bstart[l];
+      MatScalar     *L = bval + boff[k];
+
+      PetscCall(PetscArraycpy(w, L, m * p));
+      MatSeqAIJVBRBlockGemm_Private(m, p, p, w, bval + boff[bdiag[l]], L);
+      flops += 2.0 * m * p * p;
+      for (PetscInt kk = bdiag[l] + 1; kk < bi[l + 1]; kk++) {
+        const PetscInt j = bj[kk], n = bstart[j + 1] - bstart[j];
+
+        if (colpos[j] < 0) continue;
+        MatSeqAIJVBRBlockGemmSub_Private(m, n, p, L, bval + boff[kk], bval + boff[colpos[j]]);
+        flops += 2.0 * m * n * p;
+      }
+    }
+    for (PetscInt k = bi[i]; k < bi[i + 1]; k++) colpos[bj[k]] = -1;
+    PetscCall(PetscKernel_A_gets_inverse_A(m, bval + boff[bdiag[i]], pivots, work, allowzeropivot, &zeropivotdetected));
+    if (zeropivotdetected) fact->factorerrortype = MAT_FACTOR_NUMERIC_ZEROPIVOT;
+    flops += 4.0 * m * m * m / 3.0;
+  }
+  PetscCall(PetscFree4(colpos, w, pivots, work));
+
+  fact->ops->solve             = MatSolve_SeqAIJVBR_ILU;
+  fact->ops->solvetranspose    = NULL;
+  fact->ops->solveadd          = NULL;
+  fact->ops->solvetransposeadd = NULL;
+  fact->ops->matsolve          = NULL;
+  fact->ops->matsolvetranspose = NULL;
+  fact->assembled              = PETSC_TRUE;
+  fact->preallocated           = PETSC_TRUE;
+  PetscCall(PetscLogFlops(flops));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   ILU(0) on the blocks of the matrix when it has a block structure, the natural ordering is used and all diagonal blocks
+   exist, otherwise the ILU of MATSEQAIJ
+*/
+static PetscErrorCode MatILUFactorSymbolic_SeqAIJVBR(Mat fact, Mat A, IS isrow, IS iscol, const MatFactorInfo *info)
+{
+  Mat_SeqAIJVBR     *vbr = (Mat_SeqAIJVBR *)A->spptr;
+  Mat_SeqAIJVBR_ILU *ilu;
+  PetscBool          isvbr, row_identity = PETSC_TRUE, col_identity = PETSC_TRUE, diagonal = PETSC_TRUE;
+  PetscInt           nb, nbz;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectTypeCompare((PetscObject)A, MATSEQAIJVBR, &isvbr));
+  if (isvbr) PetscCall(MatSeqAIJVBR_build_shadow(A));
+  if (isrow) PetscCall(ISIdentity(isrow, &row_identity));
+  if (iscol) PetscCall(ISIdentity(iscol, &col_identity));
+  for (PetscInt i = 0; isvbr && vbr->use && i < vbr->nblocks; i++) diagonal = (PetscBool)(diagonal && vbr->bdiag[i] >= 0);
+  if (!isvbr || !vbr->use || info->levels > 0 || !row_identity || !col_identity || !diagonal) {
+    PetscCall(PetscInfo(A, "Using the ILU factorization of MATSEQAIJ\n"));
+    PetscCall(MatILUFactorSymbolic_SeqAIJ(fact, A, isrow, iscol, info));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
+  nb  = vbr->nblocks;
+  nbz = vbr->bi[nb];
+  PetscCall(PetscNew(&ilu));
+  ilu->nblocks = nb;
+  ilu->maxbs   = vbr->maxbs;
+  PetscCall(PetscMalloc5(nb + 1, &ilu->bstart, nb + 1, &ilu->bi, nb, &ilu->bdiag, nbz, &ilu->bj, nbz + 1, &ilu->boff));
+  PetscCall(PetscArraycpy(ilu->bstart, vbr->bstart, nb + 1));
+  PetscCall(PetscArraycpy(ilu->bi, vbr->bi, nb + 1));
+  PetscCall(PetscArraycpy(ilu->bdiag, vbr->bdiag, nb));
+  PetscCall(PetscArraycpy(ilu->bj, vbr->bj, nbz));
+  PetscCall(PetscArraycpy(ilu->boff, vbr->boff, nbz + 1));
+  PetscCall(PetscMalloc2(vbr->boff[nbz], &ilu->bval, vbr->maxbs, &ilu->work));
+  PetscCall(PetscObjectContainerCompose((PetscObject)fact, "MatSeqAIJVBR_ILU", ilu, MatSeqAIJVBRILUDestroy_Private));
+
+  PetscCall(MatSeqAIJSetPreallocation_SeqAIJ(fact, MAT_SKIP_ALLOCATION, NULL));
+  fact->ops->lufactornumeric     = MatILUFactorNumeric_SeqAIJVBR;
+  fact->info.factor_mallocs      = 0;
+  fact->info.fill_ratio_given    = info->fill;
+  fact->info.fill_ratio_needed   = ((Mat_SeqAIJ *)A->data)->nz ? (PetscReal)vbr->boff[nbz] / ((Mat_SeqAIJ *)A->data)->nz : 1.0;
+  PetscCall(PetscInfo(A, "Using the ILU(0) factorization on %" PetscInt_FMT " blocks\n", nb));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaij_petsc(Mat, MatFactorType, Mat *);
+
+PETSC_INTERN PetscErrorCode MatGetFactor_seqaijvbr_petsc(Mat A, MatFactorType ftype, Mat *B)
+{
+  PetscFunctionBegin;
+  PetscCall(MatGetFactor_seqaij_petsc(A, ftype, B));
+  if (ftype == MAT_FACTOR_ILU && *B) (*B)->ops->ilufactorsymbolic = MatILUFactorSymbolic_SeqAIJVBR;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJVBR_SeqAIJ(Mat A, MatType type, MatReuse reuse, Mat *newmat)
+{
+  /* This routine is only called to convert a MATAIJVBR to its base PETSc type, */
+  /* so we will ignore 'MatType type'. */
+  Mat B = *newmat;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) PetscCall(MatDuplicate(A, MAT_COPY_VALUES, &B));
+
+  /* Reset the original function pointers. */
+  B->ops->duplicate = MatDuplicate_SeqAIJ;
+  B->ops->destroy   = MatDestroy_SeqAIJ;
+  B->ops->mult      = MatMult_SeqAIJ;
+  B->ops->multadd   = MatMultAdd_SeqAIJ;
+  B->ops->sor       = MatSOR_SeqAIJ;
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaijvbr_seqaij_C", NULL));
+
+  /* Free everything in the Mat_SeqAIJVBR data structure. */
+  PetscCall(MatSeqAIJVBRReset_Private((Mat_SeqAIJVBR *)B->spptr));
+  PetscCall(PetscFree(B->spptr));
+
+  /* Change the type of B to MATSEQAIJ. */
+  PetscCall(PetscObjectChangeTypeName((PetscObject)B, MATSEQAIJ));
+
+  *newmat = B;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatDestroy_SeqAIJVBR(Mat A)
+{
+  PetscFunctionBegin;
+  /* If MatHeaderMerge() was used, then this SeqAIJVBR matrix will not have an spptr pointer. */
+  if (A->spptr) {
+    PetscCall(MatSeqAIJVBRReset_Private((Mat_SeqAIJVBR *)A->spptr));
+    PetscCall(PetscFree(A->spptr));
+  }
+  /* Change the type of A back to SEQAIJ and use MatDestroy_SeqAIJ() to destroy everything that remains. */
+  PetscCall(PetscObjectChangeTypeName((PetscObject)A, MATSEQAIJ));
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqaijvbr_seqaij_C", NULL));
+  PetscCall(MatDestroy_SeqAIJ(A));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode MatDuplicate_SeqAIJVBR(Mat A, MatDuplicateOption op, Mat *M)
+{
+  PetscFunctionBegin;
+  PetscCall(MatDuplicate_SeqAIJ(A, op, M));
+  /* We don't duplicate the shadow copy -- that will be constructed as needed, but it needs the blocks. */
+  if (A->bsizes) PetscCall(MatSetVariableBlockSizes(*M, A->nblocks, A->bsizes));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* MatConvert_SeqAIJ_SeqAIJVBR converts a SeqAIJ matrix into a SeqAIJVBR matrix. This routine is called by the
+ * MatCreate_SeqAIJVBR() routine, but can also be used to convert an assembled SeqAIJ matrix into a SeqAIJVBR one. */
+PETSC_INTERN PetscErrorCode MatConvert_SeqAIJ_SeqAIJVBR(Mat A, MatType type, MatReuse reuse, Mat *newmat)
+{
+  Mat            B = *newmat;
+  Mat_SeqAIJVBR *vbr;
+  PetscBool      sametype;
+
+  PetscFunctionBegin;
+  if (reuse == MAT_INITIAL_MATRIX) PetscCall(MatDuplicate(A, MAT_COPY_VALUES, &B));
+  PetscCall(PetscObjectTypeCompare((PetscObject)A, type, &sametype));
+  if (sametype) PetscFunctionReturn(PETSC_SUCCESS);
+
+  PetscCall(PetscNew(&vbr));
+  vbr->nonzerostate = -1;
+  vbr->idiagstate   = -1;
+  B->spptr          = (void *)vbr;
+
+  /* Set function pointers for methods that we inherit from AIJ but override. */
+  B->ops->duplicate = MatDuplicate_SeqAIJVBR;
+  B->ops->destroy   = MatDestroy_SeqAIJVBR;
+  B->ops->mult      = MatMult_SeqAIJVBR;
+  B->ops->multadd   = MatMultAdd_SeqAIJVBR;
+  B->ops->sor       = MatSOR_SeqAIJVBR;
+
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqaijvbr_seqaij_C", MatConvert_SeqAIJVBR_SeqAIJ));
+  PetscCall(PetscObjectChangeTypeName((PetscObject)B, MATSEQAIJVBR));
+  *newmat = B;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*MC
+   MATSEQAIJVBR - MATSEQAIJVBR = "seqaijvbr" - A sequential sparse matrix type that keeps, next to its `MATSEQAIJ` storage,
+   a copy in variable block row (VBR) format, where every block that contains a nonzero is stored as a dense block.
+
+   Options Database Key:
+. -mat_type seqaijvbr - sets the matrix type to `MATSEQAIJVBR` during a call to `MatSetFromOptions()`
+
+   Level: intermediate
+
+   Notes:
+   The blocks are those set with `MatSetVariableBlockSizes()` or, if none are set, those of the block size of the matrix,
+   they partition both the rows and the columns so the matrix must be square. Without blocks the `MATSEQAIJ` routines are used.
+
+   The VBR copy is constructed the first time it is needed after the matrix changes and is used for `MatMult()`,
+   `MatMultAdd()`, block Gauss-Seidel/SOR in `MatSOR()` (with no diagonal shift) and for ILU(0) in the natural ordering,
+   which is then computed on the blocks, using small dense kernels. The other operations are those of `MATSEQAIJ`.
+
+   Because `MATSEQAIJVBR` is a subtype of `MATSEQAIJ`, the option `-mat_seqaij_type seqaijvbr` can be used to make
+   sequential `MATSEQAIJ` matrices default to being instances of `MATSEQAIJVBR`.
+
+.seealso: [](ch_matrices), `Mat`, `MATAIJVBR`, `MATMPIAIJVBR`, `MATSEQAIJ`, `MatSetVariableBlockSizes()`, `PCVPBJACOBI`
+M*/
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJVBR(Mat A)
+{
+  PetscFunctionBegin;
+  PetscCall(MatSetType(A, MATSEQAIJ));
+  PetscCall(MatConvert_SeqAIJ_SeqAIJVBR(A, MATSEQAIJVBR, MAT_INPLACE_MATRIX, &A));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
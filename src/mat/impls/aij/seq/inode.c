@@ -346,31 +346,27 @@ static PetscErrorCode MatRestoreColumnIJ_SeqAIJ_Inode(Mat A, PetscInt oshift, Pe
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
-PetscErrorCode MatMult_SeqAIJ_Inode(Mat A, Vec xx, Vec yy)
+/*
+   Computes y = A x for the inodes [nstart, nend), the first of which begins at the given row. It does not use
+   PetscFunctionBegin/PetscCall() so that the threads of MatMult_SeqAIJ_Inode() can call it concurrently
+*/
+static PetscErrorCode MatMult_SeqAIJ_Inode_Private(const Mat_SeqAIJ *a, const PetscScalar *x, PetscScalar *y, PetscInt nstart, PetscInt nend, PetscInt row, PetscInt *nonzerorows)
 {
-  Mat_SeqAIJ        *a = (Mat_SeqAIJ *)A->data;
-  PetscScalar        sum1, sum2, sum3, sum4, sum5, tmp0, tmp1;
-  PetscScalar       *y;
-  const PetscScalar *x;
-  const MatScalar   *v1, *v2, *v3, *v4, *v5;
-  PetscInt           i1, i2, n, i, row, node_max, nsz, sz, nonzerorow = 0;
-  const PetscInt    *idx, *ns, *ii;
+  PetscScalar      sum1, sum2, sum3, sum4, sum5, tmp0, tmp1;
+  const MatScalar *v1, *v2, *v3, *v4, *v5;
+  PetscInt         i1, i2, n, i, nsz, sz, nonzerorow = 0;
+  const PetscInt  *idx, *ns = a->inode.size, *ii;
 
 #if defined(PETSC_HAVE_PRAGMA_DISJOINT)
   #pragma disjoint(*x, *y, *v1, *v2, *v3, *v4, *v5)
 #endif
 
-  PetscFunctionBegin;
-  PetscCheck(a->inode.size, PETSC_COMM_SELF, PETSC_ERR_COR, "Missing Inode Structure");
-  node_max = a->inode.node_count;
-  ns       = a->inode.size; /* Node Size array */
-  PetscCall(VecGetArrayRead(xx, &x));
-  PetscCall(VecGetArray(yy, &y));
-  idx = a->j;
-  v1  = a->a;
-  ii  = a->i;
+  *nonzerorows = 0;
+  idx          = a->j + a->i[row];
+  v1           = a->a + a->i[row];
+  ii           = a->i + row;
 
-  for (i = 0, row = 0; i < node_max; ++i) {
+  for (i = nstart; i < nend; ++i) {
     nsz = ns[i];
     n   = ii[1] - ii[0];
     nonzerorow += (n > 0) * nsz;
@@ -540,40 +536,59 @@ PetscErrorCode MatMult_SeqAIJ_Inode(Mat A, Vec xx, Vec yy)
       idx += 4 * sz;
       break;
     default:
-      SETERRQ(PETSC_COMM_SELF, PETSC_ERR_COR, "Node size not supported, node row %" PetscInt_FMT " size %" PetscInt_FMT, row, nsz);
+      return PETSC_ERR_COR;
     }
   }
-  PetscCall(VecRestoreArrayRead(xx, &x));
-  PetscCall(VecRestoreArray(yy, &y));
-  PetscCall(PetscLogFlops(2.0 * a->nz - nonzerorow));
-  PetscFunctionReturn(PETSC_SUCCESS);
+  *nonzerorows = nonzerorow;
+  return PETSC_SUCCESS;
 }
 
-/* Almost same code as the MatMult_SeqAIJ_Inode() */
-PetscErrorCode MatMultAdd_SeqAIJ_Inode(Mat A, Vec xx, Vec zz, Vec yy)
+PetscErrorCode MatMult_SeqAIJ_Inode(Mat A, Vec xx, Vec yy)
 {
   Mat_SeqAIJ        *a = (Mat_SeqAIJ *)A->data;
-  PetscScalar        sum1, sum2, sum3, sum4, sum5, tmp0, tmp1;
-  const MatScalar   *v1, *v2, *v3, *v4, *v5;
+  PetscScalar       *y;
   const PetscScalar *x;
-  PetscScalar       *y, *z, *zt;
-  PetscInt           i1, i2, n, i, row, node_max, nsz, sz;
-  const PetscInt    *idx, *ns, *ii;
+  PetscInt           nonzerorow = 0;
+  int                err        = 0;
 
   PetscFunctionBegin;
   PetscCheck(a->inode.size, PETSC_COMM_SELF, PETSC_ERR_COR, "Missing Inode Structure");
-  node_max = a->inode.node_count;
-  ns       = a->inode.size; /* Node Size array */
-
   PetscCall(VecGetArrayRead(xx, &x));
-  PetscCall(VecGetArrayPair(zz, yy, &z, &y));
-  zt = z;
+  PetscCall(VecGetArray(yy, &y));
+  if (MatSeqAIJUseThreads_Private(A) && a->threads.node_count == a->inode.node_count) { /* each thread owns a fixed set of inodes */
+    const PetscInt nt = a->threads.nthreads, *nstart = a->threads.nstart, *nrow = a->threads.nrow;
 
-  idx = a->j;
-  v1  = a->a;
-  ii  = a->i;
+    PetscPragmaOMP(parallel for num_threads((int)nt) schedule(static, 1) reduction(+ : nonzerorow) reduction(max : err))
+    for (PetscInt t = 0; t < nt; t++) {
+      PetscInt nzr;
+      int      terr = (int)MatMult_SeqAIJ_Inode_Private(a, x, y, nstart[t], nstart[t + 1], nrow[t], &nzr);
 
-  for (i = 0, row = 0; i < node_max; ++i) {
+      err = PetscMax(err, terr);
+      nonzerorow += nzr;
+    }
+  } else err = (int)MatMult_SeqAIJ_Inode_Private(a, x, y, 0, a->inode.node_count, 0, &nonzerorow);
+  PetscCheck(!err, PETSC_COMM_SELF, PETSC_ERR_COR, "Node size not supported");
+  PetscCall(VecRestoreArrayRead(xx, &x));
+  PetscCall(VecRestoreArray(yy, &y));
+  PetscCall(PetscLogFlops(2.0 * a->nz - nonzerorow));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Almost same code as the MatMult_SeqAIJ_Inode_Private() */
+static PetscErrorCode MatMultAdd_SeqAIJ_Inode_Private(const Mat_SeqAIJ *a, const PetscScalar *x, const PetscScalar *z, PetscScalar *y, PetscInt nstart, PetscInt nend, PetscInt row)
+{
+  PetscScalar        sum1, sum2, sum3, sum4, sum5, tmp0, tmp1;
+  const MatScalar   *v1, *v2, *v3, *v4, *v5;
+  const PetscScalar *zt;
+  PetscInt           i1, i2, n, i, nsz, sz;
+  const PetscInt    *idx, *ns = a->inode.size, *ii;
+
+  zt  = z + row;
+  idx = a->j + a->i[row];
+  v1  = a->a + a->i[row];
+  ii  = a->i + row;
+
+  for (i = nstart; i < nend; ++i) {
     nsz = ns[i];
     n   = ii[1] - ii[0];
     ii += nsz;
@@ -740,9 +755,35 @@ PetscErrorCode MatMultAdd_SeqAIJ_Inode(Mat A, Vec xx, Vec zz, Vec yy)
       idx += 4 * sz;
       break;
     default:
-      SETERRQ(PETSC_COMM_SELF, PETSC_ERR_COR, "Node size not yet supported");
+      return PETSC_ERR_COR;
     }
   }
+  return PETSC_SUCCESS;
+}
+
+/* Almost same code as the MatMult_SeqAIJ_Inode() */
+PetscErrorCode MatMultAdd_SeqAIJ_Inode(Mat A, Vec xx, Vec zz, Vec yy)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ *)A->data;
+  const PetscScalar *x;
+  PetscScalar       *y, *z;
+  int                err = 0;
+
+  PetscFunctionBegin;
+  PetscCheck(a->inode.size, PETSC_COMM_SELF, PETSC_ERR_COR, "Missing Inode Structure");
+  PetscCall(VecGetArrayRead(xx, &x));
+  PetscCall(VecGetArrayPair(zz, yy, &z, &y));
+  if (MatSeqAIJUseThreads_Private(A) && a->threads.node_count == a->inode.node_count) { /* each thread owns a fixed set of inodes */
+    const PetscInt nt = a->threads.nthreads, *nstart = a->threads.nstart, *nrow = a->threads.nrow;
+
+    PetscPragmaOMP(parallel for num_threads((int)nt) schedule(static, 1) reduction(max : err))
+    for (PetscInt t = 0; t < nt; t++) {
+      int terr = (int)MatMultAdd_SeqAIJ_Inode_Private(a, x, z, y, nstart[t], nstart[t + 1], nrow[t]);
+
+      err = PetscMax(err, terr);
+    }
+  } else err = (int)MatMultAdd_SeqAIJ_Inode_Private(a, x, z, y, 0, a->inode.node_count, 0);
+  PetscCheck(!err, PETSC_COMM_SELF, PETSC_ERR_COR, "Node size not yet supported");
   PetscCall(VecRestoreArrayRead(xx, &x));
   PetscCall(VecRestoreArrayPair(zz, yy, &z, &y));
   PetscCall(PetscLogFlops(2.0 * a->nz));
@@ -1941,6 +1982,7 @@ PetscErrorCode MatLUFactorNumeric_SeqAIJ_Inode(Mat B, Mat A, const MatFactorInfo
   } else {
     C->ops->solve = MatSolve_SeqAIJ;
   }
+  PetscCall(MatSeqAIJUseSolveLevels_Private(C));
   C->ops->solveadd          = MatSolveAdd_SeqAIJ;
   C->ops->solvetranspose    = MatSolveTranspose_SeqAIJ;
   C->ops->solvetransposeadd = MatSolveTransposeAdd_SeqAIJ;
@@ -131,6 +131,13 @@ PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ(Mat A, Mat B, PetscReal fill, Ma
     PetscFunctionReturn(PETSC_SUCCESS);
   }
 
+  /* hash_threaded */
+  PetscCall(PetscStrcmp(alg, "hash_threaded", &flg));
+  if (flg) {
+    PetscCall(MatMatMultSymbolic_SeqAIJ_SeqAIJ_HashThreaded(A, B, fill, C));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
 #if defined(PETSC_HAVE_HYPRE)
   PetscCall(PetscStrcmp(alg, "hypre", &flg));
   if (flg) {
@@ -1199,6 +1206,247 @@ PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_Sorted(Mat A, Mat B, PetscReal f
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* Hash tables and row partition of the threaded hash-accumulator product, composed with C */
+typedef struct {
+  PetscInt       nt;     /* number of threads */
+  PetscInt      *rstart; /* thread t computes the rows rstart[t] <= i < rstart[t + 1] of C */
+  PetscInt      *hstart; /* the hash table of thread t is hkeys[hstart[t] + h] for h < hstart[t + 1] - hstart[t], a power of 2 */
+  PetscInt      *hkeys;  /* column held by the slot, -1 for an empty slot */
+  PetscInt      *hvals;  /* location in C of the column held by the slot, or scratch space of the symbolic phase */
+  PetscLogDouble flops;  /* flops of the numeric phase */
+} MatMatMultHash_SeqAIJ;
+
+static PetscErrorCode MatMatMultHashDestroy_SeqAIJ(void **data)
+{
+  MatMatMultHash_SeqAIJ *hash = (MatMatMultHash_SeqAIJ *)*data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree2(hash->rstart, hash->hstart));
+  PetscCall(PetscFree2(hash->hkeys, hash->hvals));
+  PetscCall(PetscFree(*data));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Finds col in the open addressing table keys[] of size mask + 1, inserting it if absent, returns whether it was inserted */
+static inline PetscBool MatMatMultHashInsert_Private(PetscInt keys[], PetscInt mask, PetscInt col, PetscInt *slot)
+{
+  PetscInt h = (PetscInt)(PetscHashInt(col) & (PetscHash_t)mask);
+
+  while (keys[h] != col) {
+    if (keys[h] < 0) {
+      keys[h] = col;
+      *slot   = h;
+      return PETSC_TRUE;
+    }
+    h = (h + 1) & mask;
+  }
+  *slot = h;
+  return PETSC_FALSE;
+}
+
+/*
+   Empties the table after the n columns cols[] have been inserted, every slot is either on the probe path of
+   one of the columns or has been emptied by a previous walk, so no slot is left behind
+*/
+static inline void MatMatMultHashClear_Private(PetscInt keys[], PetscInt mask, PetscInt n, const PetscInt cols[])
+{
+  for (PetscInt k = 0; k < n; k++) {
+    for (PetscInt h = (PetscInt)(PetscHashInt(cols[k]) & (PetscHash_t)mask); keys[h] >= 0; h = (h + 1) & mask) keys[h] = -1;
+  }
+}
+
+/* Sorts a row of C inside the threads, where PETSc functions cannot be called: insertion sort for short rows, heapsort otherwise */
+static inline void MatMatMultHashSortRow_Private(PetscInt n, PetscInt v[])
+{
+  if (n <= 32) {
+    for (PetscInt i = 1; i < n; i++) {
+      PetscInt j, t = v[i];
+
+      for (j = i; j > 0 && v[j - 1] > t; j--) v[j] = v[j - 1];
+      v[j] = t;
+    }
+  } else {
+    for (PetscInt end = n, start = n / 2; end > 1;) {
+      PetscInt root, child, t;
+
+      if (start > 0) start--; /* build the heap */
+      else {                  /* move the largest entry to the end */
+        end--;
+        t      = v[end];
+        v[end] = v[0];
+        v[0]   = t;
+      }
+      for (root = start; (child = 2 * root + 1) < end; root = child) { /* sift down */
+        if (child + 1 < end && v[child] < v[child + 1]) child++;
+        if (v[root] >= v[child]) break;
+        t        = v[root];
+        v[root]  = v[child];
+        v[child] = t;
+      }
+    }
+  }
+}
+
+/* hash_threaded: the rows of C are split among the threads by the flops, each thread counts and then fills its rows with its own hash table */
+PetscErrorCode MatMatMultSymbolic_SeqAIJ_SeqAIJ_HashThreaded(Mat A, Mat B, PetscReal fill, Mat C)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ *)A->data, *b = (Mat_SeqAIJ *)B->data, *c;
+  const PetscInt        *ai = a->i, *aj = a->j, *bi = b->i, *bj = b->j;
+  PetscInt               am = A->rmap->N, bn = B->cmap->N, bm = B->rmap->N, nt = 1, *ci, *cj;
+  const PetscBool        forcediag = C->force_diagonals;
+  PetscCount            *flops;
+  PetscReal              afill;
+  MatMatMultHash_SeqAIJ *hash;
+
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_OPENMP)
+  nt = a->threads.nthreads > 1 ? a->threads.nthreads : PetscNumOMPThreads;
+#endif
+  nt = PetscMax(PetscMin(nt, am), 1);
+  PetscCall(PetscNew(&hash));
+  hash->nt = nt;
+
+  /* The number of products of each row bounds the length of the row of C, it balances the threads and sizes their tables */
+  PetscCall(PetscMalloc1(am + 1, &flops));
+  flops[0] = 0;
+  for (PetscInt i = 0; i < am; i++) {
+    flops[i + 1] = flops[i];
+    for (PetscInt k = ai[i]; k < ai[i + 1]; k++) flops[i + 1] += bi[aj[k] + 1] - bi[aj[k]];
+  }
+  hash->flops = 2.0 * flops[am];
+  PetscCall(PetscMalloc2(nt + 1, &hash->rstart, nt + 1, &hash->hstart));
+  MatSeqAIJPartitionRowsByWork_Private(am, flops, nt, hash->rstart);
+  hash->hstart[0] = 0;
+  for (PetscInt t = 0; t < nt; t++) {
+    PetscInt maxlen = 0, size = 2;
+
+    for (PetscInt i = hash->rstart[t]; i < hash->rstart[t + 1]; i++) maxlen = PetscMax(maxlen, (PetscInt)PetscMin(flops[i + 1] - flops[i] + (forcediag ? 1 : 0), (PetscCount)bn));
+    while (size < 2 * maxlen) size *= 2;
+    hash->hstart[t + 1] = hash->hstart[t] + size;
+  }
+  PetscCall(PetscFree(flops));
+  PetscCall(PetscMalloc2(hash->hstart[nt], &hash->hkeys, hash->hstart[nt], &hash->hvals));
+  for (PetscInt h = 0; h < hash->hstart[nt]; h++) hash->hkeys[h] = -1;
+
+  /* Count the entries of each row of C */
+  PetscCall(PetscMalloc1(am + 1, &ci));
+  ci[0] = 0;
+  PetscPragmaOMP(parallel for num_threads((int)nt) if (nt > 1) schedule(static, 1))
+  for (PetscInt t = 0; t < nt; t++) {
+    PetscInt *keys = hash->hkeys + hash->hstart[t], *list = hash->hvals + hash->hstart[t], mask = hash->hstart[t + 1] - hash->hstart[t] - 1, slot;
+
+    for (PetscInt i = hash->rstart[t]; i < hash->rstart[t + 1]; i++) {
+      PetscInt len = 0;
+
+      for (PetscInt k = ai[i]; k < ai[i + 1]; k++) {
+        for (PetscInt l = bi[aj[k]]; l < bi[aj[k] + 1]; l++) {
+          if (MatMatMultHashInsert_Private(keys, mask, bj[l], &slot)) list[len++] = bj[l];
+        }
+      }
+      if (forcediag && i < bn && MatMatMultHashInsert_Private(keys, mask, i, &slot)) list[len++] = i;
+      MatMatMultHashClear_Private(keys, mask, len, list);
+      ci[i + 1] = len;
+    }
+  }
+  for (PetscInt i = 0; i < am; i++) ci[i + 1] += ci[i];
+
+  /* Fill and sort the rows of C */
+  PetscCall(PetscMalloc1(ci[am], &cj));
+  PetscPragmaOMP(parallel for num_threads((int)nt) if (nt > 1) schedule(static, 1))
+  for (PetscInt t = 0; t < nt; t++) {
+    PetscInt *keys = hash->hkeys + hash->hstart[t], mask = hash->hstart[t + 1] - hash->hstart[t] - 1, slot;
+
+    for (PetscInt i = hash->rstart[t]; i < hash->rstart[t + 1]; i++) {
+      PetscInt *crow = cj + ci[i], len = 0;
+
+      for (PetscInt k = ai[i]; k < ai[i + 1]; k++) {
+        for (PetscInt l = bi[aj[k]]; l < bi[aj[k] + 1]; l++) {
+          if (MatMatMultHashInsert_Private(keys, mask, bj[l], &slot)) crow[len++] = bj[l];
+        }
+      }
+      if (forcediag && i < bn && MatMatMultHashInsert_Private(keys, mask, i, &slot)) crow[len++] = i;
+      MatMatMultHashClear_Private(keys, mask, len, crow);
+      MatMatMultHashSortRow_Private(len, crow);
+    }
+  }
+
+  /* put together the new symbolic matrix */
+  PetscCall(MatSetSeqAIJWithArrays_private(PetscObjectComm((PetscObject)A), am, bn, ci, cj, NULL, ((PetscObject)A)->type_name, C));
+  PetscCall(MatSetBlockSizesFromMats(C, A, B));
+
+  /* These are PETSc arrays, so change flags so arrays can be deleted by PETSc */
+  c          = (Mat_SeqAIJ *)C->data;
+  c->free_a  = PETSC_TRUE;
+  c->free_ij = PETSC_TRUE;
+  c->nonew   = 0;
+
+  PetscCall(PetscObjectContainerCompose((PetscObject)C, "__PETSc__mm_hash", hash, MatMatMultHashDestroy_SeqAIJ));
+  C->ops->matmultnumeric = MatMatMultNumeric_SeqAIJ_SeqAIJ_HashThreaded;
+
+  /* set MatInfo */
+  afill = (PetscReal)ci[am] / PetscMax(ai[am] + bi[bm], 1) + 1.e-5;
+  if (afill < 1.0) afill = 1.0;
+  C->info.mallocs           = 0;
+  C->info.fill_ratio_given  = fill;
+  C->info.fill_ratio_needed = afill;
+  PetscCall(PetscInfo(C, "Using %" PetscInt_FMT " threads; Fill ratio: given %g needed %g.\n", nt, (double)fill, (double)afill));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatMatMultNumeric_SeqAIJ_SeqAIJ_HashThreaded(Mat A, Mat B, Mat C)
+{
+  Mat_SeqAIJ            *a = (Mat_SeqAIJ *)A->data, *b = (Mat_SeqAIJ *)B->data, *c = (Mat_SeqAIJ *)C->data;
+  const PetscInt        *ai = a->i, *aj = a->j, *bi = b->i, *bj = b->j, *ci = c->i, *cj = c->j;
+  PetscInt               cm = C->rmap->n;
+  const PetscScalar     *aa, *ba;
+  PetscScalar           *ca;
+  PetscContainer         container;
+  MatMatMultHash_SeqAIJ *hash;
+
+  PetscFunctionBegin;
+  PetscCall(PetscObjectQuery((PetscObject)C, "__PETSc__mm_hash", (PetscObject *)&container));
+  PetscCheck(container, PetscObjectComm((PetscObject)C), PETSC_ERR_PLIB, "Missing the hash tables of the symbolic phase");
+  PetscCall(PetscContainerGetPointer(container, (void **)&hash));
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  PetscCall(MatSeqAIJGetArrayRead(B, &ba));
+  if (!c->a) { /* first call of the numeric phase, allocate ca */
+    PetscCall(PetscMalloc1(ci[cm] + 1, &ca));
+    c->a      = ca;
+    c->free_a = PETSC_TRUE;
+  } else ca = c->a;
+
+  PetscPragmaOMP(parallel for num_threads((int)hash->nt) if (hash->nt > 1) schedule(static, 1))
+  for (PetscInt t = 0; t < hash->nt; t++) {
+    PetscInt *keys = hash->hkeys + hash->hstart[t], *vals = hash->hvals + hash->hstart[t], mask = hash->hstart[t + 1] - hash->hstart[t] - 1, slot;
+
+    for (PetscInt i = hash->rstart[t]; i < hash->rstart[t + 1]; i++) {
+      for (PetscInt p = ci[i]; p < ci[i + 1]; p++) { /* map the columns of the row of C to their locations */
+        (void)MatMatMultHashInsert_Private(keys, mask, cj[p], &slot);
+        vals[slot] = p;
+        ca[p]      = 0.0;
+      }
+      for (PetscInt k = ai[i]; k < ai[i + 1]; k++) {
+        const PetscScalar aik = aa[k];
+
+        for (PetscInt l = bi[aj[k]]; l < bi[aj[k] + 1]; l++) {
+          (void)MatMatMultHashInsert_Private(keys, mask, bj[l], &slot);
+          ca[vals[slot]] += aik * ba[l];
+        }
+      }
+      MatMatMultHashClear_Private(keys, mask, ci[i + 1] - ci[i], cj + ci[i]);
+    }
+  }
+#if defined(PETSC_HAVE_DEVICE)
+  if (C->offloadmask != PETSC_OFFLOAD_UNALLOCATED) C->offloadmask = PETSC_OFFLOAD_CPU;
+#endif
+  PetscCall(MatAssemblyBegin(C, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(C, MAT_FINAL_ASSEMBLY));
+  PetscCall(PetscLogFlops(hash->flops));
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  PetscCall(MatSeqAIJRestoreArrayRead(B, &ba));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode MatDestroy_SeqAIJ_MatMatMultTrans(void *data)
 {
   Mat_MatMatTransMult *abt = (Mat_MatMatTransMult *)data;
@@ -1980,11 +2228,11 @@ static PetscErrorCode MatProductSetFromOptions_SeqAIJ_AB(Mat C)
   PetscInt     alg     = 0; /* default algorithm */
   PetscBool    flg     = PETSC_FALSE;
 #if !defined(PETSC_HAVE_HYPRE)
-  const char *algTypes[7] = {"sorted", "scalable", "scalable_fast", "heap", "btheap", "llcondensed", "rowmerge"};
-  PetscInt    nalg        = 7;
-#else
-  const char *algTypes[8] = {"sorted", "scalable", "scalable_fast", "heap", "btheap", "llcondensed", "rowmerge", "hypre"};
+  const char *algTypes[8] = {"sorted", "scalable", "scalable_fast", "heap", "btheap", "llcondensed", "rowmerge", "hash_threaded"};
   PetscInt    nalg        = 8;
+#else
+  const char *algTypes[9] = {"sorted", "scalable", "scalable_fast", "heap", "btheap", "llcondensed", "rowmerge", "hash_threaded", "hypre"};
+  PetscInt    nalg        = 9;
 #endif
 
   PetscFunctionBegin;
@@ -2073,11 +2321,11 @@ static PetscErrorCode MatProductSetFromOptions_SeqAIJ_PtAP(Mat C)
   PetscBool    flg     = PETSC_FALSE;
   PetscInt     alg     = 0; /* default algorithm -- alg=1 should be default!!! */
 #if !defined(PETSC_HAVE_HYPRE)
-  const char *algTypes[2] = {"scalable", "rap"};
-  PetscInt    nalg        = 2;
-#else
-  const char *algTypes[3] = {"scalable", "rap", "hypre"};
+  const char *algTypes[3] = {"scalable", "rap", "threaded"};
   PetscInt    nalg        = 3;
+#else
+  const char *algTypes[4] = {"scalable", "rap", "threaded", "hypre"};
+  PetscInt    nalg        = 4;
 #endif
 
   PetscFunctionBegin;
@@ -49,6 +49,14 @@ PetscErrorCode MatProductSymbolic_PtAP_SeqAIJ_SeqAIJ(Mat C)
     PetscFunctionReturn(PETSC_SUCCESS);
   }
 
+  /* "threaded" */
+  PetscCall(PetscStrcmp(alg, "threaded", &flg));
+  if (flg) {
+    PetscCall(MatPtAPSymbolic_SeqAIJ_SeqAIJ_Threaded(A, P, fill, C));
+    C->ops->productnumeric = MatProductNumeric_PtAP;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+
   /* hypre */
 #if defined(PETSC_HAVE_HYPRE)
   PetscCall(PetscStrcmp(alg, "hypre", &flg));
@@ -275,6 +283,133 @@ PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ_SparseAxpy(Mat A, Mat P, Mat C)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+static PetscErrorCode MatDestroy_SeqAIJ_PtAP_Threaded(void *data)
+{
+  Mat_PtAP_Threaded *ptap = (Mat_PtAP_Threaded *)data;
+
+  PetscFunctionBegin;
+  PetscCall(PetscFree(ptap->rstart));
+  PetscCall(PetscFree3(ptap->pti, ptap->ptj, ptap->ptmap));
+  PetscCall(PetscFree(ptap->loc));
+  PetscCall(PetscFree(ptap));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   The structure of C is the one of the scalable algorithm. The numeric phase computes row k of C as the sum of P(i,k) A(i,:) P
+   over the rows i of column k of P, so the rows of C are independent and A*P is never stored, at the cost of computing
+   the rows of A*P once per entry of their row of P
+*/
+PetscErrorCode MatPtAPSymbolic_SeqAIJ_SeqAIJ_Threaded(Mat A, Mat P, PetscReal fill, Mat C)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ *)A->data, *p = (Mat_SeqAIJ *)P->data;
+  const PetscInt    *ai = a->i, *aj = a->j, *pi = p->i, *pj = p->j;
+  PetscInt           pm = P->rmap->n, pn = P->cmap->n, nt = 1, *next;
+  PetscCount        *work;
+  Mat_Product       *product = C->product;
+  Mat_PtAP_Threaded *ptap;
+
+  PetscFunctionBegin;
+  PetscCheck(product, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Missing product struct");
+  PetscCheck(!product->data, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Extra product struct not empty");
+  PetscCall(MatPtAPSymbolic_SeqAIJ_SeqAIJ_SparseAxpy(A, P, fill, C));
+
+  PetscCall(PetscNew(&ptap));
+#if defined(PETSC_HAVE_OPENMP)
+  nt = a->threads.nthreads > 1 ? a->threads.nthreads : PetscNumOMPThreads;
+#endif
+  nt       = PetscMax(PetscMin(nt, pn), 1);
+  ptap->nt = nt;
+
+  /* P^T with the location in P of its entries, so that new values of P are picked up by the numeric phase */
+  PetscCall(PetscMalloc3(pn + 1, &ptap->pti, pi[pm], &ptap->ptj, pi[pm], &ptap->ptmap));
+  PetscCall(PetscArrayzero(ptap->pti, pn + 1));
+  for (PetscInt k = 0; k < pi[pm]; k++) ptap->pti[pj[k] + 1]++;
+  for (PetscInt k = 0; k < pn; k++) ptap->pti[k + 1] += ptap->pti[k];
+  PetscCall(PetscMalloc1(pn, &next));
+  PetscCall(PetscArraycpy(next, ptap->pti, pn));
+  for (PetscInt i = 0; i < pm; i++) {
+    for (PetscInt k = pi[i]; k < pi[i + 1]; k++) {
+      ptap->ptj[next[pj[k]]]     = i;
+      ptap->ptmap[next[pj[k]]++] = k;
+    }
+  }
+  PetscCall(PetscFree(next));
+
+  /* Balance the threads by the number of products of their rows of C */
+  PetscCall(PetscMalloc1(pn + 1, &work));
+  work[0] = 0;
+  for (PetscInt k = 0; k < pn; k++) {
+    work[k + 1] = work[k];
+    for (PetscInt q = ptap->pti[k]; q < ptap->pti[k + 1]; q++) {
+      const PetscInt i = ptap->ptj[q];
+
+      for (PetscInt s = ai[i]; s < ai[i + 1]; s++) work[k + 1] += 1 + pi[aj[s] + 1] - pi[aj[s]];
+    }
+  }
+  ptap->flops = 2.0 * work[pn];
+  PetscCall(PetscMalloc1(nt + 1, &ptap->rstart));
+  MatSeqAIJPartitionRowsByWork_Private(pn, work, nt, ptap->rstart);
+  PetscCall(PetscFree(work));
+  PetscCall(PetscMalloc1(nt * pn, &ptap->loc));
+  for (PetscInt k = 0; k < nt * pn; k++) ptap->loc[k] = -1;
+
+  product->data       = ptap;
+  product->destroy    = MatDestroy_SeqAIJ_PtAP_Threaded;
+  C->ops->ptapnumeric = MatPtAPNumeric_SeqAIJ_SeqAIJ_Threaded;
+  PetscCall(PetscInfo(C, "Using %" PetscInt_FMT " threads\n", nt));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ_Threaded(Mat A, Mat P, Mat C)
+{
+  Mat_SeqAIJ        *a = (Mat_SeqAIJ *)A->data, *p = (Mat_SeqAIJ *)P->data, *c = (Mat_SeqAIJ *)C->data;
+  const PetscInt    *ai = a->i, *aj = a->j, *pi = p->i, *pj = p->j, *ci = c->i, *cj = c->j, pn = P->cmap->n;
+  const PetscScalar *aa, *pa;
+  PetscScalar       *ca = c->a;
+  Mat_PtAP_Threaded *ptap;
+
+  PetscFunctionBegin;
+  MatCheckProduct(C, 3);
+  ptap = (Mat_PtAP_Threaded *)C->product->data;
+  PetscCheck(ptap, PetscObjectComm((PetscObject)C), PETSC_ERR_PLIB, "Missing data structure");
+  PetscCall(MatSeqAIJGetArrayRead(A, &aa));
+  PetscCall(MatSeqAIJGetArrayRead(P, &pa));
+
+  PetscPragmaOMP(parallel for num_threads((int)ptap->nt) if (ptap->nt > 1) schedule(static, 1))
+  for (PetscInt t = 0; t < ptap->nt; t++) {
+    PetscInt *loc = ptap->loc + t * pn;
+
+    for (PetscInt k = ptap->rstart[t]; k < ptap->rstart[t + 1]; k++) {
+      for (PetscInt r = ci[k]; r < ci[k + 1]; r++) {
+        loc[cj[r]] = r;
+        ca[r]      = 0.0;
+      }
+      for (PetscInt q = ptap->pti[k]; q < ptap->pti[k + 1]; q++) {
+        const PetscInt    i   = ptap->ptj[q];
+        const PetscScalar pik = pa[ptap->ptmap[q]];
+
+        for (PetscInt s = ai[i]; s < ai[i + 1]; s++) {
+          const PetscInt    j   = aj[s];
+          const PetscScalar pka = pik * aa[s];
+
+          for (PetscInt l = pi[j]; l < pi[j + 1]; l++) ca[loc[pj[l]]] += pka * pa[l];
+        }
+      }
+      for (PetscInt r = ci[k]; r < ci[k + 1]; r++) loc[cj[r]] = -1;
+    }
+  }
+#if defined(PETSC_HAVE_DEVICE)
+  if (C->offloadmask != PETSC_OFFLOAD_UNALLOCATED) C->offloadmask = PETSC_OFFLOAD_CPU;
+#endif
+  PetscCall(MatSeqAIJRestoreArrayRead(A, &aa));
+  PetscCall(MatSeqAIJRestoreArrayRead(P, &pa));
+  PetscCall(PetscLogFlops(ptap->flops));
+  PetscCall(MatAssemblyBegin(C, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(C, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PetscErrorCode MatPtAPNumeric_SeqAIJ_SeqAIJ(Mat A, Mat P, Mat C)
 {
   Mat_MatTransMatMult *atb;
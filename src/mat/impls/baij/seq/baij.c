@@ -1594,6 +1594,7 @@ PetscErrorCode MatDestroy_SeqBAIJ(Mat A)
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatSeqBAIJSetPreallocationCSR_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqbaij_seqbstrm_C", NULL));
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatIsTranspose_C", NULL));
+  PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatSetConcurrentSetValues_C", NULL));
 #if defined(PETSC_HAVE_HYPRE)
   PetscCall(PetscObjectComposeFunction((PetscObject)A, "MatConvert_seqbaij_hypre_C", NULL));
 #endif
@@ -1602,6 +1603,99 @@ PetscErrorCode MatDestroy_SeqBAIJ(Mat A)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* Returns the position of block column bcol in block row brow of the assembled nonzero structure of a, or -1 */
+static inline PetscInt MatSeqBAIJFindBlock_Private(Mat_SeqBAIJ *a, PetscInt brow, PetscInt bcol)
+{
+  const PetscInt *rp  = a->j + a->i[brow];
+  PetscInt        low = 0, high = a->ilen[brow];
+
+  while (low < high) {
+    const PetscInt t = low + (high - low) / 2;
+
+    if (rp[t] < bcol) low = t + 1;
+    else high = t;
+  }
+  return (low < a->ilen[brow] && rp[low] == bcol) ? a->i[brow] + low : -1;
+}
+
+/* MatSetValuesBlocked() for MAT_CONCURRENT_SET_VALUES, see MatSetValues_SeqAIJ_Concurrent() */
+static PetscErrorCode MatSetValuesBlocked_SeqBAIJ_Concurrent(Mat A, PetscInt m, const PetscInt im[], PetscInt n, const PetscInt in[], const PetscScalar v[], InsertMode is)
+{
+  Mat_SeqBAIJ *a           = (Mat_SeqBAIJ *)A->data;
+  PetscInt     bs          = A->rmap->bs, bs2 = a->bs2;
+  PetscBool    roworiented = a->roworiented;
+  PetscInt     stepval     = roworiented ? (n - 1) * bs : (m - 1) * bs;
+
+  PetscFunctionBegin;
+  PetscCheck(A->assembled || A->was_assembled, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "The nonzero structure must be assembled before MatSetValuesBlocked() with MAT_CONCURRENT_SET_VALUES");
+  for (PetscInt k = 0; k < m; k++) {
+    const PetscInt row = im[k];
+
+    if (row < 0) continue;
+    PetscCheck(row < a->mbs, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Block row index too large %" PetscInt_FMT " max %" PetscInt_FMT, row, a->mbs - 1);
+    for (PetscInt l = 0; l < n; l++) {
+      const PetscInt     col = in[l];
+      const PetscScalar *value;
+      MatScalar         *bap;
+      PetscInt           p;
+
+      if (col < 0) continue;
+      PetscCheck(col < a->nbs, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Block column index too large %" PetscInt_FMT " max %" PetscInt_FMT, col, a->nbs - 1);
+      p = MatSeqBAIJFindBlock_Private(a, row, col);
+      if (p < 0) {
+        PetscCheck(a->nonew == 1, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Inserting a new nonzero block (%" PetscInt_FMT ", %" PetscInt_FMT ") in the matrix with MAT_CONCURRENT_SET_VALUES", row, col);
+        continue;
+      }
+      if (A->structure_only) continue;
+      bap = a->a + bs2 * p;
+      /* the blocks are stored column-major */
+      if (roworiented) {
+        value = v + (k * (stepval + bs) + l) * bs;
+        for (PetscInt ii = 0; ii < bs; ii++, value += stepval) {
+          for (PetscInt jj = ii; jj < bs2; jj += bs) MatSetValueAtomic_Private(bap + jj, *value++, is);
+        }
+      } else {
+        value = v + (l * (stepval + bs) + k) * bs;
+        for (PetscInt ii = 0; ii < bs; ii++, value += bs + stepval, bap += bs) {
+          for (PetscInt jj = 0; jj < bs; jj++) MatSetValueAtomic_Private(bap + jj, value[jj], is);
+        }
+      }
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* MatSetValues() for MAT_CONCURRENT_SET_VALUES, see MatSetValues_SeqAIJ_Concurrent() */
+static PetscErrorCode MatSetValues_SeqBAIJ_Concurrent(Mat A, PetscInt m, const PetscInt im[], PetscInt n, const PetscInt in[], const PetscScalar v[], InsertMode is)
+{
+  Mat_SeqBAIJ *a           = (Mat_SeqBAIJ *)A->data;
+  PetscInt     bs          = A->rmap->bs, bs2 = a->bs2;
+  PetscBool    roworiented = a->roworiented;
+
+  PetscFunctionBegin;
+  PetscCheck(A->assembled || A->was_assembled, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "The nonzero structure must be assembled before MatSetValues() with MAT_CONCURRENT_SET_VALUES");
+  for (PetscInt k = 0; k < m; k++) {
+    const PetscInt row = im[k];
+
+    if (row < 0) continue;
+    PetscCheck(row < A->rmap->N, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Row too large: row %" PetscInt_FMT " max %" PetscInt_FMT, row, A->rmap->N - 1);
+    for (PetscInt l = 0; l < n; l++) {
+      const PetscInt col = in[l];
+      PetscInt       p;
+
+      if (col < 0) continue;
+      PetscCheck(col < A->cmap->n, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Column too large: col %" PetscInt_FMT " max %" PetscInt_FMT, col, A->cmap->n - 1);
+      p = MatSeqBAIJFindBlock_Private(a, row / bs, col / bs);
+      if (p < 0) {
+        PetscCheck(a->nonew == 1, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Inserting a new nonzero (%" PetscInt_FMT ", %" PetscInt_FMT ") in the matrix with MAT_CONCURRENT_SET_VALUES", row, col);
+        continue;
+      }
+      if (!A->structure_only) MatSetValueAtomic_Private(a->a + bs2 * p + bs * (col % bs) + row % bs, roworiented ? v[l + k * n] : v[k + l * m], is);
+    }
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 static PetscErrorCode MatSetOption_SeqBAIJ(Mat A, MatOption op, PetscBool flg)
 {
   Mat_SeqBAIJ *a = (Mat_SeqBAIJ *)A->data;
@@ -1632,6 +1726,16 @@ static PetscErrorCode MatSetOption_SeqBAIJ(Mat A, MatOption op, PetscBool flg)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/* MatSetOption() with MAT_CONCURRENT_SET_VALUES, composed to declare that the type supports it */
+static PetscErrorCode MatSetConcurrentSetValues_SeqBAIJ(Mat A, PetscBool flg)
+{
+  PetscFunctionBegin;
+  PetscCheck(!flg || PetscDefined(HAVE_OPENMP), PETSC_COMM_SELF, PETSC_ERR_SUP, "MAT_CONCURRENT_SET_VALUES requires PETSc configured with OpenMP");
+  A->ops->setvalues        = flg ? MatSetValues_SeqBAIJ_Concurrent : MatSetValues_SeqBAIJ;
+  A->ops->setvaluesblocked = flg ? MatSetValuesBlocked_SeqBAIJ_Concurrent : MatSetValuesBlocked_SeqBAIJ;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /* used for both SeqBAIJ and SeqSBAIJ matrices */
 PetscErrorCode MatGetRow_SeqBAIJ_private(Mat A, PetscInt row, PetscInt *nz, PetscInt **idx, PetscScalar **v, PetscInt *ai, PetscInt *aj, PetscScalar *aa)
 {
@@ -3262,11 +3366,19 @@ PetscErrorCode MatSeqBAIJSetPreallocation_SeqBAIJ(Mat B, PetscInt bs, PetscInt n
       B->ops->mult    = MatMult_SeqBAIJ_7;
       B->ops->multadd = MatMultAdd_SeqBAIJ_7;
       break;
+    case 8:
+      B->ops->mult    = MatMult_SeqBAIJ_8;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_8;
+      break;
     case 9: {
-      PetscInt version = 1;
+      PetscInt  version = 1;
+      PetscBool avx2;
+
       PetscCall(PetscOptionsGetInt(NULL, ((PetscObject)B)->prefix, "-mat_baij_mult_version", &version, NULL));
+      PetscCall(MatSeqBAIJUseAVX2_Private(&avx2));
+      if (version == 1 && !avx2) version = 0;
       switch (version) {
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+#if defined(PETSC_X86_AVX2_KERNELS_SUPPORTED) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
       case 1:
         B->ops->mult    = MatMult_SeqBAIJ_9_AVX2;
         B->ops->multadd = MatMultAdd_SeqBAIJ_9_AVX2;
@@ -3274,20 +3386,27 @@ PetscErrorCode MatSeqBAIJSetPreallocation_SeqBAIJ(Mat B, PetscInt bs, PetscInt n
         break;
 #endif
       default:
-        B->ops->mult    = MatMult_SeqBAIJ_N;
-        B->ops->multadd = MatMultAdd_SeqBAIJ_N;
-        PetscCall(PetscInfo(B, "Using BLAS for MatMult for BAIJ for blocksize %" PetscInt_FMT "\n", bs));
+        B->ops->mult    = MatMult_SeqBAIJ_9;
+        B->ops->multadd = MatMultAdd_SeqBAIJ_9;
         break;
       }
       break;
     }
+    case 10:
+      B->ops->mult    = MatMult_SeqBAIJ_10;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_10;
+      break;
     case 11:
       B->ops->mult    = MatMult_SeqBAIJ_11;
       B->ops->multadd = MatMultAdd_SeqBAIJ_11;
       break;
     case 12: {
-      PetscInt version = 1;
+      PetscInt  version = 1;
+      PetscBool avx2;
+
       PetscCall(PetscOptionsGetInt(NULL, ((PetscObject)B)->prefix, "-mat_baij_mult_version", &version, NULL));
+      PetscCall(MatSeqBAIJUseAVX2_Private(&avx2));
+      if (version == 3 && !avx2) version = 1;
       switch (version) {
       case 1:
         B->ops->mult    = MatMult_SeqBAIJ_12_ver1;
@@ -3299,7 +3418,7 @@ PetscErrorCode MatSeqBAIJSetPreallocation_SeqBAIJ(Mat B, PetscInt bs, PetscInt n
         B->ops->multadd = MatMultAdd_SeqBAIJ_12_ver2;
         PetscCall(PetscInfo(B, "Using version %" PetscInt_FMT " of MatMult for BAIJ for blocksize %" PetscInt_FMT "\n", version, bs));
         break;
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+#if defined(PETSC_X86_AVX2_KERNELS_SUPPORTED) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
       case 3:
         B->ops->mult    = MatMult_SeqBAIJ_12_AVX2;
         B->ops->multadd = MatMultAdd_SeqBAIJ_12_ver1;
@@ -3314,6 +3433,14 @@ PetscErrorCode MatSeqBAIJSetPreallocation_SeqBAIJ(Mat B, PetscInt bs, PetscInt n
       }
       break;
     }
+    case 13:
+      B->ops->mult    = MatMult_SeqBAIJ_13;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_13;
+      break;
+    case 14:
+      B->ops->mult    = MatMult_SeqBAIJ_14;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_14;
+      break;
     case 15: {
       PetscInt version = 1;
       PetscCall(PetscOptionsGetInt(NULL, ((PetscObject)B)->prefix, "-mat_baij_mult_version", &version, NULL));
@@ -3335,13 +3462,16 @@ PetscErrorCode MatSeqBAIJSetPreallocation_SeqBAIJ(Mat B, PetscInt bs, PetscInt n
         PetscCall(PetscInfo(B, "Using version %" PetscInt_FMT " of MatMult for BAIJ for blocksize %" PetscInt_FMT "\n", version, bs));
         break;
       default:
-        B->ops->mult = MatMult_SeqBAIJ_N;
-        PetscCall(PetscInfo(B, "Using BLAS for MatMult for BAIJ for blocksize %" PetscInt_FMT "\n", bs));
+        B->ops->mult = MatMult_SeqBAIJ_15;
         break;
       }
-      B->ops->multadd = MatMultAdd_SeqBAIJ_N;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_15;
       break;
     }
+    case 16:
+      B->ops->mult    = MatMult_SeqBAIJ_16;
+      B->ops->multadd = MatMultAdd_SeqBAIJ_16;
+      break;
     default:
       B->ops->mult    = MatMult_SeqBAIJ_N;
       B->ops->multadd = MatMultAdd_SeqBAIJ_N;
@@ -3516,6 +3646,9 @@ PetscErrorCode MatSeqBAIJRestoreArray(Mat A, PetscScalar *array[])
 
    Run with `-info` to see what version of the matrix-vector product is being used
 
+   For block sizes up to 16 the matrix-vector products and the triangular solves of factors in the natural ordering use
+   kernels specialized for the block size, `-mat_no_unroll` selects the generic matrix-vector products
+
 .seealso: [](ch_matrices), `Mat`, `MatCreateSeqBAIJ()`
 M*/
 
@@ -3557,6 +3690,7 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqBAIJ(Mat B)
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSeqBAIJSetPreallocation_C", MatSeqBAIJSetPreallocation_SeqBAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSeqBAIJSetPreallocationCSR_C", MatSeqBAIJSetPreallocationCSR_SeqBAIJ));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatIsTranspose_C", MatIsTranspose_SeqBAIJ));
+  PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSetConcurrentSetValues_C", MatSetConcurrentSetValues_SeqBAIJ));
 #if defined(PETSC_HAVE_HYPRE)
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatConvert_seqbaij_hypre_C", MatConvert_AIJ_HYPRE));
 #endif
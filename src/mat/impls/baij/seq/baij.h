@@ -122,7 +122,9 @@ PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_7(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_7_NaturalOrdering_inplace(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_7_NaturalOrdering(Mat, Vec, Vec);
 
+PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_8_NaturalOrdering(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_9_NaturalOrdering(Mat, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_10_NaturalOrdering(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_11_NaturalOrdering(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_12_NaturalOrdering(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_13_NaturalOrdering(Mat, Vec, Vec);
@@ -130,6 +132,7 @@ PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_14_NaturalOrdering(Mat, Vec, Vec);
 
 PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_15_NaturalOrdering_ver1(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_15_NaturalOrdering_ver2(Mat, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_16_NaturalOrdering(Mat, Vec, Vec);
 
 PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_N_inplace(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatSolve_SeqBAIJ_N(Mat, Vec, Vec);
@@ -221,7 +224,10 @@ PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_4(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_5(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_6(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_7(Mat, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_8(Mat, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_9(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_9_AVX2(Mat, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_10(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_11(Mat, Vec, Vec);
 
 PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_12_ver1(Mat, Vec, Vec);
@@ -230,11 +236,15 @@ PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_12_AVX2(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_12_ver1(Mat, Vec, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_12_ver2(Mat, Vec, Vec, Vec);
 
+PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_13(Mat, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_14(Mat, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_15(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_15_ver1(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_15_ver2(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_15_ver3(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_15_ver4(Mat, Vec, Vec);
 
+PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_16(Mat, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMult_SeqBAIJ_N(Mat, Vec, Vec);
 
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_1(Mat, Vec, Vec, Vec);
@@ -244,8 +254,15 @@ PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_4(Mat, Vec, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_5(Mat, Vec, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_6(Mat, Vec, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_7(Mat, Vec, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_8(Mat, Vec, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_9(Mat, Vec, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_9_AVX2(Mat, Vec, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_10(Mat, Vec, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_11(Mat, Vec, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_13(Mat, Vec, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_14(Mat, Vec, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_15(Mat, Vec, Vec, Vec);
+PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_16(Mat, Vec, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatMultAdd_SeqBAIJ_N(Mat, Vec, Vec, Vec);
 PETSC_INTERN PetscErrorCode MatSeqBAIJSetNumericFactorization_inplace(Mat, PetscBool);
 PETSC_INTERN PetscErrorCode MatSeqBAIJSetNumericFactorization(Mat, PetscBool);
@@ -713,9 +730,26 @@ static inline PetscErrorCode PetscKernel_A_gets_A_minus_B_times_C_7(PetscScalar
   return PETSC_SUCCESS;
 }
 
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES) && !defined(PETSC_SKIP_IMMINTRIN_H_CUDAWORKAROUND)
+/* the AVX2 kernels are compiled in any build on x86 and only installed in the ops tables if the processor supports them */
+static inline PetscErrorCode MatSeqBAIJUseAVX2_Private(PetscBool *flg)
+{
+  PetscFunctionBegin;
+  *flg = PETSC_FALSE;
+#if defined(PETSC_X86_AVX2_KERNELS_SUPPORTED) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+  {
+    PetscBool fma;
+
+    PetscCall(PetscCPUFeatureIsEnabled(PETSC_CPU_FEATURE_AVX2, flg));
+    PetscCall(PetscCPUFeatureIsEnabled(PETSC_CPU_FEATURE_FMA, &fma));
+    *flg = (PetscBool)(*flg && fma);
+  }
+#endif
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+#if defined(PETSC_X86_AVX2_KERNELS_SUPPORTED) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
   #include <immintrin.h>
-static inline PetscErrorCode PetscKernel_A_gets_A_times_B_9(PetscScalar *A, const PetscScalar *B, PetscScalar *W)
+PETSC_ATTRIBUTE_TARGET("avx2,fma") static inline PetscErrorCode PetscKernel_A_gets_A_times_B_9(PetscScalar *A, const PetscScalar *B, PetscScalar *W)
 {
   PetscInt i;
   __m256d  S0, S1, S2, S3, S4, S5, S6, S7, S8, B0, B1, B2, B6, B7, B8, A0, A1, A2, A3, A4, A5, A6, A7, A8;
@@ -987,8 +1021,8 @@ static inline PetscErrorCode PetscKernel_A_gets_A_times_B_9(PetscScalar *A, cons
 }
 #endif
 
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES) && !defined(PETSC_SKIP_IMMINTRIN_H_CUDAWORKAROUND)
-static inline PetscErrorCode PetscKernel_A_gets_A_minus_B_times_C_9(PetscScalar *A, const PetscScalar *B, const PetscScalar *C)
+#if defined(PETSC_X86_AVX2_KERNELS_SUPPORTED) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+PETSC_ATTRIBUTE_TARGET("avx2,fma") static inline PetscErrorCode PetscKernel_A_gets_A_minus_B_times_C_9(PetscScalar *A, const PetscScalar *B, const PetscScalar *C)
 {
   PetscInt i;
   __m256d  A0, A1, A2, A3, A4, A5, A6, A7, A8, B0, B1, B2, B3, B4, B5, B6, B7, B8, C0, C1, C2, C3, C4, C5, C6, C7, C8;
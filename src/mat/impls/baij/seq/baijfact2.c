@@ -209,12 +209,21 @@ PetscErrorCode MatLUFactorNumeric_SeqBAIJ_N(Mat B, Mat A, const MatFactorInfo *i
   both_identity = (PetscBool)(row_identity && col_identity);
   if (both_identity) {
     switch (bs) {
-    case 9:
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-      C->ops->solve = MatSolve_SeqBAIJ_9_NaturalOrdering;
+    case 8:
+      C->ops->solve = MatSolve_SeqBAIJ_8_NaturalOrdering;
+      break;
+    case 9: {
+      PetscBool avx2;
+
+      PetscCall(MatSeqBAIJUseAVX2_Private(&avx2));
+#if defined(PETSC_X86_AVX2_KERNELS_SUPPORTED) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+      C->ops->solve = avx2 ? MatSolve_SeqBAIJ_9_NaturalOrdering : MatSolve_SeqBAIJ_N_NaturalOrdering;
 #else
-      C->ops->solve = MatSolve_SeqBAIJ_N_NaturalOrdering;
+      C->ops->solve = MatSolve_SeqBAIJ_9_NaturalOrdering;
 #endif
+    } break;
+    case 10:
+      C->ops->solve = MatSolve_SeqBAIJ_10_NaturalOrdering;
       break;
     case 11:
       C->ops->solve = MatSolve_SeqBAIJ_11_NaturalOrdering;
@@ -228,6 +237,9 @@ PetscErrorCode MatLUFactorNumeric_SeqBAIJ_N(Mat B, Mat A, const MatFactorInfo *i
     case 14:
       C->ops->solve = MatSolve_SeqBAIJ_14_NaturalOrdering;
       break;
+    case 16:
+      C->ops->solve = MatSolve_SeqBAIJ_16_NaturalOrdering;
+      break;
     default:
       C->ops->solve = MatSolve_SeqBAIJ_N_NaturalOrdering;
       break;
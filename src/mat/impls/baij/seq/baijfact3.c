@@ -33,13 +33,15 @@ PetscErrorCode MatSeqBAIJSetNumericFactorization(Mat fact, PetscBool natural)
     case 7:
       fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_7_NaturalOrdering;
       break;
-    case 9:
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-      fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_9_NaturalOrdering;
-#else
+    case 9: {
+      PetscBool avx2;
+
+      PetscCall(MatSeqBAIJUseAVX2_Private(&avx2));
       fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_N;
+#if defined(PETSC_X86_AVX2_KERNELS_SUPPORTED) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+      if (avx2) fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_9_NaturalOrdering;
 #endif
-      break;
+    } break;
     case 15:
       fact->ops->lufactornumeric = MatLUFactorNumeric_SeqBAIJ_15_NaturalOrdering;
       break;
@@ -0,0 +1,42 @@
+#include <../src/mat/impls/baij/seq/baij.h>
+
+/* defines MatMult_SeqBAIJ_<BS>(), MatMultAdd_SeqBAIJ_<BS>() and, with BS_SOLVE, MatSolve_SeqBAIJ_<BS>_NaturalOrdering() */
+#define BS 8
+#define BS_SOLVE
+#include "../src/mat/impls/baij/seq/baijfixedbs.h"
+#undef BS
+#undef BS_SOLVE
+
+/* the AVX2 version of MatSolve_SeqBAIJ_9_NaturalOrdering() is in baijfact9.c */
+#define BS 9
+#if !(defined(PETSC_X86_AVX2_KERNELS_SUPPORTED) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES))
+  #define BS_SOLVE
+#endif
+#include "../src/mat/impls/baij/seq/baijfixedbs.h"
+#undef BS
+#undef BS_SOLVE
+
+#define BS 10
+#define BS_SOLVE
+#include "../src/mat/impls/baij/seq/baijfixedbs.h"
+#undef BS
+#undef BS_SOLVE
+
+/* the solves for block sizes 11 to 15 are hand-unrolled in baijsolvnat11.c, baijsolvnat14.c and baijsolvnat15.c */
+#define BS 13
+#include "../src/mat/impls/baij/seq/baijfixedbs.h"
+#undef BS
+
+#define BS 14
+#include "../src/mat/impls/baij/seq/baijfixedbs.h"
+#undef BS
+
+#define BS 15
+#include "../src/mat/impls/baij/seq/baijfixedbs.h"
+#undef BS
+
+#define BS 16
+#define BS_SOLVE
+#include "../src/mat/impls/baij/seq/baijfixedbs.h"
+#undef BS
+#undef BS_SOLVE
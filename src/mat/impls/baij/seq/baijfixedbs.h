@@ -0,0 +1,164 @@
+/*
+   Kernels of SEQBAIJ for a block size known at compile time, so that the compiler unrolls and vectorizes the loops over the
+   entries of the blocks, included by baijfixedbs.c once for each block size
+
+     define BS       to the block size
+            BS_SOLVE to also define the triangular solves of the factors in natural ordering
+*/
+PetscErrorCode PetscConcat(MatMult_SeqBAIJ_, BS)(Mat A, Vec xx, Vec zz)
+{
+  Mat_SeqBAIJ       *a = (Mat_SeqBAIJ *)A->data;
+  const PetscScalar *x;
+  PetscScalar       *zarray;
+  const PetscInt    *ii, *ridx = NULL;
+  PetscInt           mbs;
+  PetscBool          usecprow = a->compressedrow.use;
+
+  PetscFunctionBegin;
+  PetscCall(VecGetArrayRead(xx, &x));
+  PetscCall(VecGetArrayWrite(zz, &zarray));
+  if (usecprow) {
+    mbs  = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+    PetscCall(PetscArrayzero(zarray, BS * a->mbs));
+  } else {
+    mbs = a->mbs;
+    ii  = a->i;
+  }
+  for (PetscInt i = 0; i < mbs; i++) {
+    const PetscInt  *idx = a->j + ii[i], n = ii[i + 1] - ii[i];
+    const MatScalar *v   = a->a + (size_t)BS * BS * ii[i];
+    PetscScalar      sum[BS], *z = zarray + BS * (usecprow ? ridx[i] : i);
+
+    for (PetscInt r = 0; r < BS; r++) sum[r] = 0.0;
+    for (PetscInt k = 0; k < n; k++, v += BS * BS) {
+      const PetscScalar *xb = x + BS * idx[k];
+
+      for (PetscInt c = 0; c < BS; c++) {
+        const PetscScalar xc = xb[c];
+
+        PetscPragmaSIMD
+        for (PetscInt r = 0; r < BS; r++) sum[r] += v[c * BS + r] * xc;
+      }
+    }
+    for (PetscInt r = 0; r < BS; r++) z[r] = sum[r];
+  }
+  PetscCall(VecRestoreArrayRead(xx, &x));
+  PetscCall(VecRestoreArrayWrite(zz, &zarray));
+  PetscCall(PetscLogFlops(2.0 * a->nz * BS * BS - BS * a->nonzerorowcnt));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode PetscConcat(MatMultAdd_SeqBAIJ_, BS)(Mat A, Vec xx, Vec yy, Vec zz)
+{
+  Mat_SeqBAIJ       *a = (Mat_SeqBAIJ *)A->data;
+  const PetscScalar *x;
+  PetscScalar       *zarray;
+  const PetscInt    *ii, *ridx = NULL;
+  PetscInt           mbs;
+  PetscBool          usecprow = a->compressedrow.use;
+
+  PetscFunctionBegin;
+  PetscCall(VecCopy(yy, zz));
+  PetscCall(VecGetArrayRead(xx, &x));
+  PetscCall(VecGetArray(zz, &zarray));
+  if (usecprow) {
+    mbs  = a->compressedrow.nrows;
+    ii   = a->compressedrow.i;
+    ridx = a->compressedrow.rindex;
+  } else {
+    mbs = a->mbs;
+    ii  = a->i;
+  }
+  for (PetscInt i = 0; i < mbs; i++) {
+    const PetscInt  *idx = a->j + ii[i], n = ii[i + 1] - ii[i];
+    const MatScalar *v   = a->a + (size_t)BS * BS * ii[i];
+    PetscScalar      sum[BS], *z = zarray + BS * (usecprow ? ridx[i] : i);
+
+    for (PetscInt r = 0; r < BS; r++) sum[r] = z[r];
+    for (PetscInt k = 0; k < n; k++, v += BS * BS) {
+      const PetscScalar *xb = x + BS * idx[k];
+
+      for (PetscInt c = 0; c < BS; c++) {
+        const PetscScalar xc = xb[c];
+
+        PetscPragmaSIMD
+        for (PetscInt r = 0; r < BS; r++) sum[r] += v[c * BS + r] * xc;
+      }
+    }
+    for (PetscInt r = 0; r < BS; r++) z[r] = sum[r];
+  }
+  PetscCall(VecRestoreArrayRead(xx, &x));
+  PetscCall(VecRestoreArray(zz, &zarray));
+  PetscCall(PetscLogFlops(2.0 * a->nz * BS * BS));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+#if defined(BS_SOLVE)
+/* same as MatSolve_SeqBAIJ_N_NaturalOrdering(), the inverses of the diagonal blocks are stored in the factor */
+PetscErrorCode PetscConcat(PetscConcat(MatSolve_SeqBAIJ_, BS), _NaturalOrdering)(Mat A, Vec bb, Vec xx)
+{
+  Mat_SeqBAIJ       *a  = (Mat_SeqBAIJ *)A->data;
+  const PetscInt    *ai = a->i, *aj = a->j, *adiag = a->diag, n = a->mbs;
+  const MatScalar   *aa = a->a;
+  PetscScalar       *x, *t = a->solve_work;
+  const PetscScalar *b;
+
+  PetscFunctionBegin;
+  PetscCall(VecGetArrayRead(bb, &b));
+  PetscCall(VecGetArray(xx, &x));
+
+  /* forward solve the lower triangular */
+  for (PetscInt i = 0; i < n; i++) {
+    const PetscInt  *vi = aj + ai[i], nz = ai[i + 1] - ai[i];
+    const MatScalar *v  = aa + (size_t)BS * BS * ai[i];
+    PetscScalar      s[BS];
+
+    for (PetscInt r = 0; r < BS; r++) s[r] = b[BS * i + r];
+    for (PetscInt k = 0; k < nz; k++, v += BS * BS) {
+      const PetscScalar *w = t + BS * vi[k];
+
+      for (PetscInt c = 0; c < BS; c++) {
+        const PetscScalar wc = w[c];
+
+        PetscPragmaSIMD
+        for (PetscInt r = 0; r < BS; r++) s[r] -= v[c * BS + r] * wc;
+      }
+    }
+    for (PetscInt r = 0; r < BS; r++) t[BS * i + r] = s[r];
+  }
+
+  /* backward solve the upper triangular */
+  for (PetscInt i = n - 1; i >= 0; i--) {
+    const PetscInt  *vi = aj + adiag[i + 1] + 1, nz = adiag[i] - adiag[i + 1] - 1;
+    const MatScalar *v  = aa + (size_t)BS * BS * (adiag[i + 1] + 1), *d = aa + (size_t)BS * BS * adiag[i];
+    PetscScalar      s[BS], y[BS];
+
+    for (PetscInt r = 0; r < BS; r++) s[r] = t[BS * i + r];
+    for (PetscInt k = 0; k < nz; k++, v += BS * BS) {
+      const PetscScalar *w = t + BS * vi[k];
+
+      for (PetscInt c = 0; c < BS; c++) {
+        const PetscScalar wc = w[c];
+
+        PetscPragmaSIMD
+        for (PetscInt r = 0; r < BS; r++) s[r] -= v[c * BS + r] * wc;
+      }
+    }
+    for (PetscInt r = 0; r < BS; r++) y[r] = 0.0;
+    for (PetscInt c = 0; c < BS; c++) { /* multiply by the inverse of the diagonal block */
+      const PetscScalar sc = s[c];
+
+      PetscPragmaSIMD
+      for (PetscInt r = 0; r < BS; r++) y[r] += d[c * BS + r] * sc;
+    }
+    for (PetscInt r = 0; r < BS; r++) x[BS * i + r] = t[BS * i + r] = y[r];
+  }
+
+  PetscCall(VecRestoreArrayRead(bb, &b));
+  PetscCall(VecRestoreArray(xx, &x));
+  PetscCall(PetscLogFlops(2.0 * BS * BS * a->nz - BS * A->cmap->n));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+#endif
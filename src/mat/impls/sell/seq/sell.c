@@ -13,33 +13,99 @@ static const char citation[] = "@inproceedings{ZhangELLPACK2018,\n"
                                " year = 2018\n"
                                "}\n";
 
-#if defined(PETSC_HAVE_IMMINTRIN_H) && (defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__)) || defined(__AVX__)) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+/*
+  SpMV kernels for slices of height C, see MatSeqSELLMultKernel. Every slice column holds C valid column indices, including
+  the padding slots (MatAssemblyEnd_SeqSELL() sets them to a nearby column with a zero value), so no masking is needed.
 
+  The x86 kernels are compiled with PETSC_ATTRIBUTE_TARGET(), so they are available in any build and are only chosen on
+  processors that support them; the SVE kernel needs a compiler targeting SVE.
+*/
+static void MatMultKernel_SeqSELL_Generic(PetscInt C, PetscInt nslices, const PetscInt *sliidx, const PetscInt *colidx, const MatScalar *val, const PetscScalar *x, const PetscScalar *z, PetscScalar *y)
+{
+  for (PetscInt s = 0; s < nslices; s++) {
+    PetscScalar *ys = y + C * s;
+
+    for (PetscInt r = 0; r < C; r++) ys[r] = z ? z[C * s + r] : 0.0;
+    for (PetscInt k = sliidx[s]; k < sliidx[s + 1]; k += C) {
+      PetscPragmaSIMD
+      for (PetscInt r = 0; r < C; r++) ys[r] += val[k + r] * x[colidx[k + r]];
+    }
+  }
+}
+
+#if (defined(PETSC_X86_AVX2_KERNELS_SUPPORTED) || defined(PETSC_X86_AVX512_KERNELS_SUPPORTED)) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
   #include <immintrin.h>
+#endif
 
-  #if !defined(_MM_SCALE_8)
-    #define _MM_SCALE_8 8
-  #endif
+#if defined(PETSC_X86_AVX2_KERNELS_SUPPORTED) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+  #define MATSEQSELL_HAVE_AVX2_KERNEL
+
+/* a slice column is processed 4 rows at a time, with two accumulators to hide the latency of the gathers */
+PETSC_ATTRIBUTE_TARGET("avx2,fma") static void MatMultKernel_SeqSELL_AVX2(PetscInt C, PetscInt nslices, const PetscInt *sliidx, const PetscInt *colidx, const MatScalar *val, const PetscScalar *x, const PetscScalar *z, PetscScalar *y)
+{
+  for (PetscInt s = 0; s < nslices; s++) {
+    for (PetscInt r = 0; r < C; r += 4) {
+      __m256d  vec_y = z ? _mm256_loadu_pd(z + C * s + r) : _mm256_setzero_pd(), vec_y2 = _mm256_setzero_pd();
+      PetscInt k     = sliidx[s] + r;
+
+      for (; k + C < sliidx[s + 1]; k += 2 * C) {
+        vec_y  = _mm256_fmadd_pd(_mm256_i32gather_pd(x, _mm_loadu_si128((__m128i const *)(colidx + k)), 8), _mm256_loadu_pd(val + k), vec_y);
+        vec_y2 = _mm256_fmadd_pd(_mm256_i32gather_pd(x, _mm_loadu_si128((__m128i const *)(colidx + k + C)), 8), _mm256_loadu_pd(val + k + C), vec_y2);
+      }
+      if (k < sliidx[s + 1]) vec_y = _mm256_fmadd_pd(_mm256_i32gather_pd(x, _mm_loadu_si128((__m128i const *)(colidx + k)), 8), _mm256_loadu_pd(val + k), vec_y);
+      _mm256_storeu_pd(y + C * s + r, _mm256_add_pd(vec_y, vec_y2));
+    }
+  }
+}
+#endif
 
-  #if defined(__AVX512F__)
-    /* these do not work
-   vec_idx  = _mm512_loadunpackhi_epi32(vec_idx,acolidx);
-   vec_vals = _mm512_loadunpackhi_pd(vec_vals,aval);
-  */
-    #define AVX512_Mult_Private(vec_idx, vec_x, vec_vals, vec_y) \
-      /* if the mask bit is set, copy from acolidx, otherwise from vec_idx */ \
-      vec_idx  = _mm256_loadu_si256((__m256i const *)acolidx); \
-      vec_vals = _mm512_loadu_pd(aval); \
-      vec_x    = _mm512_i32gather_pd(vec_idx, x, _MM_SCALE_8); \
-      vec_y    = _mm512_fmadd_pd(vec_x, vec_vals, vec_y)
-  #elif defined(__AVX2__) && defined(__FMA__)
-    #define AVX2_Mult_Private(vec_idx, vec_x, vec_vals, vec_y) \
-      vec_vals = _mm256_loadu_pd(aval); \
-      vec_idx  = _mm_loadu_si128((__m128i const *)acolidx); /* SSE2 */ \
-      vec_x    = _mm256_i32gather_pd(x, vec_idx, _MM_SCALE_8); \
-      vec_y    = _mm256_fmadd_pd(vec_x, vec_vals, vec_y)
+#if defined(PETSC_X86_AVX512_KERNELS_SUPPORTED) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
+  #define MATSEQSELL_HAVE_AVX512_KERNEL
+
+/* a slice column is processed 8 rows at a time */
+PETSC_ATTRIBUTE_TARGET("avx512f") static void MatMultKernel_SeqSELL_AVX512(PetscInt C, PetscInt nslices, const PetscInt *sliidx, const PetscInt *colidx, const MatScalar *val, const PetscScalar *x, const PetscScalar *z, PetscScalar *y)
+{
+  for (PetscInt s = 0; s < nslices; s++) {
+    for (PetscInt r = 0; r < C; r += 8) {
+      __m512d  vec_y = z ? _mm512_loadu_pd(z + C * s + r) : _mm512_setzero_pd(), vec_y2 = _mm512_setzero_pd();
+      PetscInt k     = sliidx[s] + r;
+
+      for (; k + C < sliidx[s + 1]; k += 2 * C) {
+        vec_y  = _mm512_fmadd_pd(_mm512_i32gather_pd(_mm256_loadu_si256((__m256i const *)(colidx + k)), x, 8), _mm512_loadu_pd(val + k), vec_y);
+        vec_y2 = _mm512_fmadd_pd(_mm512_i32gather_pd(_mm256_loadu_si256((__m256i const *)(colidx + k + C)), x, 8), _mm512_loadu_pd(val + k + C), vec_y2);
+      }
+      if (k < sliidx[s + 1]) vec_y = _mm512_fmadd_pd(_mm512_i32gather_pd(_mm256_loadu_si256((__m256i const *)(colidx + k)), x, 8), _mm512_loadu_pd(val + k), vec_y);
+      _mm512_storeu_pd(y + C * s + r, _mm512_add_pd(vec_y, vec_y2));
+    }
+  }
+}
+#endif
+
+#if defined(__ARM_FEATURE_SVE) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX)
+  #define MATSEQSELL_HAVE_SVE_KERNEL
+  #include <arm_sve.h>
+
+/* vector length agnostic: a slice column is processed svcntd() rows at a time, the predicate covers slice heights that are not a multiple of it */
+static void MatMultKernel_SeqSELL_SVE(PetscInt C, PetscInt nslices, const PetscInt *sliidx, const PetscInt *colidx, const MatScalar *val, const PetscScalar *x, const PetscScalar *z, PetscScalar *y)
+{
+  for (PetscInt s = 0; s < nslices; s++) {
+    for (PetscInt r = 0; r < C; r += (PetscInt)svcntd()) {
+      svbool_t    pg    = svwhilelt_b64_s64((int64_t)r, (int64_t)C);
+      svfloat64_t vec_y = z ? svld1_f64(pg, z + C * s + r) : svdup_n_f64(0.0);
+
+      for (PetscInt k = sliidx[s] + r; k < sliidx[s + 1]; k += C) {
+  #if defined(PETSC_USE_64BIT_INDICES)
+        svint64_t vec_idx = svld1_s64(pg, (const int64_t *)(colidx + k));
+  #else
+        svint64_t vec_idx = svld1sw_s64(pg, (const int32_t *)(colidx + k));
   #endif
-#endif /* PETSC_HAVE_IMMINTRIN_H */
+        vec_y = svmla_f64_m(pg, vec_y, svld1_f64(pg, val + k), svld1_gather_s64index_f64(pg, x, vec_idx));
+      }
+      svst1_f64(pg, y + C * s + r, vec_y);
+    }
+  }
+}
+#endif
 
 /*@
   MatSeqSELLSetPreallocation - For good matrix assembly performance
@@ -317,249 +383,186 @@ PetscErrorCode MatConvert_SeqAIJ_SeqSELL(Mat A, MatType newtype, MatReuse reuse,
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
-PetscErrorCode MatMult_SeqSELL(Mat A, Vec xx, Vec yy)
+static const char *const MatSeqSELLKernelTypes[] = {"auto", "generic", "avx2", "avx512", "sve", "MatSeqSELLKernelType", "MAT_SEQSELL_KERNEL_", NULL};
+
+/* chooses the SpMV kernel for the slice height and the processor, honoring -mat_sell_kernel */
+static PetscErrorCode MatSeqSELLSelectKernel_Private(Mat A)
 {
-  Mat_SeqSELL       *a = (Mat_SeqSELL *)A->data;
-  PetscScalar       *y;
-  const PetscScalar *x;
-  const MatScalar   *aval        = a->val;
-  PetscInt           totalslices = a->totalslices;
-  const PetscInt    *acolidx     = a->colidx;
-  PetscInt           i, j;
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m512d  vec_x, vec_y, vec_vals;
-  __m256i  vec_idx;
-  __mmask8 mask;
-  __m512d  vec_x2, vec_y2, vec_vals2, vec_x3, vec_y3, vec_vals3, vec_x4, vec_y4, vec_vals4;
-  __m256i  vec_idx2, vec_idx3, vec_idx4;
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m128i   vec_idx;
-  __m256d   vec_x, vec_y, vec_y2, vec_vals;
-  MatScalar yval;
-  PetscInt  r, rows_left, row, nnz_in_row;
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m128d   vec_x_tmp;
-  __m256d   vec_x, vec_y, vec_y2, vec_vals;
-  MatScalar yval;
-  PetscInt  r, rows_left, row, nnz_in_row;
-#else
-  PetscInt     k, sliceheight = a->sliceheight;
-  PetscScalar *sum;
-#endif
+  Mat_SeqSELL         *a      = (Mat_SeqSELL *)A->data;
+  MatSeqSELLKernelType type   = a->kerneltype;
+  PetscBool            avx2   = PETSC_FALSE, avx512 = PETSC_FALSE, sve = PETSC_FALSE;
+  PetscInt             height = a->sliceheight;
 
-#if defined(PETSC_HAVE_PRAGMA_DISJOINT)
-  #pragma disjoint(*x, *y, *aval)
+  PetscFunctionBegin;
+#if defined(MATSEQSELL_HAVE_AVX2_KERNEL)
+  {
+    PetscBool fma;
+
+    PetscCall(PetscCPUFeatureIsEnabled(PETSC_CPU_FEATURE_AVX2, &avx2));
+    PetscCall(PetscCPUFeatureIsEnabled(PETSC_CPU_FEATURE_FMA, &fma));
+    avx2 = (PetscBool)(avx2 && fma && height % 4 == 0);
+  }
+#endif
+#if defined(MATSEQSELL_HAVE_AVX512_KERNEL)
+  PetscCall(PetscCPUFeatureIsEnabled(PETSC_CPU_FEATURE_AVX512F, &avx512));
+  avx512 = (PetscBool)(avx512 && height % 8 == 0);
+#endif
+#if defined(MATSEQSELL_HAVE_SVE_KERNEL)
+  PetscCall(PetscCPUFeatureIsEnabled(PETSC_CPU_FEATURE_SVE, &sve));
+#endif
+  if (type == MAT_SEQSELL_KERNEL_AUTO) type = avx512 ? MAT_SEQSELL_KERNEL_AVX512 : (avx2 ? MAT_SEQSELL_KERNEL_AVX2 : (sve ? MAT_SEQSELL_KERNEL_SVE : MAT_SEQSELL_KERNEL_GENERIC));
+  PetscCheck(type != MAT_SEQSELL_KERNEL_AVX2 || avx2, PETSC_COMM_SELF, PETSC_ERR_SUP, "The avx2 kernel requires a slice height that is a multiple of 4 (not %" PetscInt_FMT "), a processor with AVX2 and FMA that are not disabled, and a double precision real build with 32-bit indices", height);
+  PetscCheck(type != MAT_SEQSELL_KERNEL_AVX512 || avx512, PETSC_COMM_SELF, PETSC_ERR_SUP, "The avx512 kernel requires a slice height that is a multiple of 8 (not %" PetscInt_FMT "), a processor with AVX-512F that is not disabled, and a double precision real build with 32-bit indices", height);
+  PetscCheck(type != MAT_SEQSELL_KERNEL_SVE || sve, PETSC_COMM_SELF, PETSC_ERR_SUP, "The sve kernel requires a processor with SVE and a double precision real build with a compiler targeting SVE");
+  switch (type) {
+#if defined(MATSEQSELL_HAVE_AVX2_KERNEL)
+  case MAT_SEQSELL_KERNEL_AVX2:
+    a->kernel = MatMultKernel_SeqSELL_AVX2;
+    break;
 #endif
+#if defined(MATSEQSELL_HAVE_AVX512_KERNEL)
+  case MAT_SEQSELL_KERNEL_AVX512:
+    a->kernel = MatMultKernel_SeqSELL_AVX512;
+    break;
+#endif
+#if defined(MATSEQSELL_HAVE_SVE_KERNEL)
+  case MAT_SEQSELL_KERNEL_SVE:
+    a->kernel = MatMultKernel_SeqSELL_SVE;
+    break;
+#endif
+  default:
+    a->kernel = MatMultKernel_SeqSELL_Generic;
+  }
+  PetscCall(PetscInfo(A, "Using the %s SpMV kernel for slice height %" PetscInt_FMT "\n", MatSeqSELLKernelTypes[type], height));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  Builds (when the nonzero structure changed) and fills (when the matrix changed) the copy of the matrix used by the products
+  with SELL-C-sigma: within each window of sigma consecutive rows the rows are sorted by decreasing length, so rows of
+  similar length share a slice and less padding is stored and multiplied.
+*/
+static PetscErrorCode MatSeqSELLSetUpSorted_Private(Mat A)
+{
+  Mat_SeqSELL     *a = (Mat_SeqSELL *)A->data;
+  PetscInt         m = A->rmap->n, C = a->sliceheight, totalslices = a->totalslices, i, j, s;
+  PetscObjectState state;
 
   PetscFunctionBegin;
-  PetscCall(VecGetArrayRead(xx, &x));
-  PetscCall(VecGetArray(yy, &y));
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  PetscCheck(a->sliceheight == 8, PETSC_COMM_SELF, PETSC_ERR_SUP, "The kernel requires a slice height of 8, but the input matrix has a slice height of %" PetscInt_FMT, a->sliceheight);
-  for (i = 0; i < totalslices; i++) { /* loop over slices */
-    PetscPrefetchBlock(acolidx, a->sliidx[i + 1] - a->sliidx[i], 0, PETSC_PREFETCH_HINT_T0);
-    PetscPrefetchBlock(aval, a->sliidx[i + 1] - a->sliidx[i], 0, PETSC_PREFETCH_HINT_T0);
-
-    vec_y  = _mm512_setzero_pd();
-    vec_y2 = _mm512_setzero_pd();
-    vec_y3 = _mm512_setzero_pd();
-    vec_y4 = _mm512_setzero_pd();
-
-    j = a->sliidx[i] >> 3; /* 8 bytes are read at each time, corresponding to a slice column */
-    switch ((a->sliidx[i + 1] - a->sliidx[i]) / 8 & 3) {
-    case 3:
-      AVX512_Mult_Private(vec_idx, vec_x, vec_vals, vec_y);
-      acolidx += 8;
-      aval += 8;
-      AVX512_Mult_Private(vec_idx2, vec_x2, vec_vals2, vec_y2);
-      acolidx += 8;
-      aval += 8;
-      AVX512_Mult_Private(vec_idx3, vec_x3, vec_vals3, vec_y3);
-      acolidx += 8;
-      aval += 8;
-      j += 3;
-      break;
-    case 2:
-      AVX512_Mult_Private(vec_idx, vec_x, vec_vals, vec_y);
-      acolidx += 8;
-      aval += 8;
-      AVX512_Mult_Private(vec_idx2, vec_x2, vec_vals2, vec_y2);
-      acolidx += 8;
-      aval += 8;
-      j += 2;
-      break;
-    case 1:
-      AVX512_Mult_Private(vec_idx, vec_x, vec_vals, vec_y);
-      acolidx += 8;
-      aval += 8;
-      j += 1;
-      break;
-    }
-  #pragma novector
-    for (; j < (a->sliidx[i + 1] >> 3); j += 4) {
-      AVX512_Mult_Private(vec_idx, vec_x, vec_vals, vec_y);
-      acolidx += 8;
-      aval += 8;
-      AVX512_Mult_Private(vec_idx2, vec_x2, vec_vals2, vec_y2);
-      acolidx += 8;
-      aval += 8;
-      AVX512_Mult_Private(vec_idx3, vec_x3, vec_vals3, vec_y3);
-      acolidx += 8;
-      aval += 8;
-      AVX512_Mult_Private(vec_idx4, vec_x4, vec_vals4, vec_y4);
-      acolidx += 8;
-      aval += 8;
+  if (!a->sperm || a->snonzerostate != A->nonzerostate) {
+    PetscInt *len;
+
+    PetscCall(PetscFree(a->sperm));
+    PetscCall(PetscFree(a->ssliidx));
+    PetscCall(PetscFree2(a->sval, a->scolidx));
+    PetscCall(PetscMalloc1(m, &a->sperm));
+    PetscCall(PetscMalloc1(totalslices + 1, &a->ssliidx));
+    PetscCall(PetscMalloc1(m, &len));
+    for (i = 0; i < m; i++) {
+      a->sperm[i] = i;
+      len[i]      = -a->rlen[i];
     }
+    for (i = 0; i < m; i += a->sigma) PetscCall(PetscSortIntWithArray(PetscMin(a->sigma, m - i), len + i, a->sperm + i));
+    a->ssliidx[0] = 0;
+    for (s = 0; s < totalslices; s++) {
+      PetscInt width = 0;
 
-    vec_y = _mm512_add_pd(vec_y, vec_y2);
-    vec_y = _mm512_add_pd(vec_y, vec_y3);
-    vec_y = _mm512_add_pd(vec_y, vec_y4);
-    if (i == totalslices - 1 && A->rmap->n & 0x07) { /* if last slice has padding rows */
-      mask = (__mmask8)(0xff >> (8 - (A->rmap->n & 0x07)));
-      _mm512_mask_storeu_pd(&y[8 * i], mask, vec_y);
-    } else {
-      _mm512_storeu_pd(&y[8 * i], vec_y);
-    }
-  }
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX2__) && defined(__FMA__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  PetscCheck(a->sliceheight == 8, PETSC_COMM_SELF, PETSC_ERR_SUP, "The kernel requires a slice height of 8, but the input matrix has a slice height of %" PetscInt_FMT, a->sliceheight);
-  for (i = 0; i < totalslices; i++) { /* loop over full slices */
-    PetscPrefetchBlock(acolidx, a->sliidx[i + 1] - a->sliidx[i], 0, PETSC_PREFETCH_HINT_T0);
-    PetscPrefetchBlock(aval, a->sliidx[i + 1] - a->sliidx[i], 0, PETSC_PREFETCH_HINT_T0);
-
-    /* last slice may have padding rows. Don't use vectorization. */
-    if (i == totalslices - 1 && (A->rmap->n & 0x07)) {
-      rows_left = A->rmap->n - 8 * i;
-      for (r = 0; r < rows_left; ++r) {
-        yval       = (MatScalar)0;
-        row        = 8 * i + r;
-        nnz_in_row = a->rlen[row];
-        for (j = 0; j < nnz_in_row; ++j) yval += aval[8 * j + r] * x[acolidx[8 * j + r]];
-        y[row] = yval;
-      }
-      break;
+      for (i = C * s; i < PetscMin(C * (s + 1), m); i++) width = PetscMax(width, -len[i]);
+      PetscCall(PetscIntSumError(a->ssliidx[s], C * width, &a->ssliidx[s + 1]));
     }
+    PetscCall(PetscFree(len));
+    PetscCall(PetscInfo(A, "Sorting the rows within windows of %" PetscInt_FMT " rows reduces the stored entries from %" PetscInt_FMT " to %" PetscInt_FMT "\n", a->sigma, a->sliidx[totalslices], a->ssliidx[totalslices]));
 
-    vec_y  = _mm256_setzero_pd();
-    vec_y2 = _mm256_setzero_pd();
-
-  /* Process slice of height 8 (512 bits) via two subslices of height 4 (256 bits) via AVX */
-  #pragma novector
-  #pragma unroll(2)
-    for (j = a->sliidx[i]; j < a->sliidx[i + 1]; j += 8) {
-      AVX2_Mult_Private(vec_idx, vec_x, vec_vals, vec_y);
-      aval += 4;
-      acolidx += 4;
-      AVX2_Mult_Private(vec_idx, vec_x, vec_vals, vec_y2);
-      aval += 4;
-      acolidx += 4;
-    }
+    /* column indices, padding slots get the last column of the row, or of the previous row in the slice, and a zero value */
+    PetscCall(PetscMalloc2(a->ssliidx[totalslices], &a->sval, a->ssliidx[totalslices], &a->scolidx));
+    for (s = 0; s < totalslices; s++) {
+      PetscInt lastcol = 0, width = (a->ssliidx[s + 1] - a->ssliidx[s]) / C;
 
-    _mm256_storeu_pd(y + i * 8, vec_y);
-    _mm256_storeu_pd(y + i * 8 + 4, vec_y2);
-  }
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  PetscCheck(a->sliceheight == 8, PETSC_COMM_SELF, PETSC_ERR_SUP, "The kernel requires a slice height of 8, but the input matrix has a slice height of %" PetscInt_FMT, a->sliceheight);
-  for (i = 0; i < totalslices; i++) { /* loop over full slices */
-    PetscPrefetchBlock(acolidx, a->sliidx[i + 1] - a->sliidx[i], 0, PETSC_PREFETCH_HINT_T0);
-    PetscPrefetchBlock(aval, a->sliidx[i + 1] - a->sliidx[i], 0, PETSC_PREFETCH_HINT_T0);
-
-    vec_y  = _mm256_setzero_pd();
-    vec_y2 = _mm256_setzero_pd();
-
-    /* last slice may have padding rows. Don't use vectorization. */
-    if (i == totalslices - 1 && (A->rmap->n & 0x07)) {
-      rows_left = A->rmap->n - 8 * i;
-      for (r = 0; r < rows_left; ++r) {
-        yval       = (MatScalar)0;
-        row        = 8 * i + r;
-        nnz_in_row = a->rlen[row];
-        for (j = 0; j < nnz_in_row; ++j) yval += aval[8 * j + r] * x[acolidx[8 * j + r]];
-        y[row] = yval;
+      for (i = C * s; i < C * (s + 1); i++) {
+        PetscInt *cp = a->scolidx + a->ssliidx[s] + i % C, nrow = 0;
+
+        if (i < m) {
+          PetscInt row = a->sperm[i];
+
+          nrow = a->rlen[row];
+          for (j = 0; j < nrow; j++) cp[C * j] = a->colidx[a->sliidx[row / C] + row % C + C * j];
+          if (nrow) lastcol = cp[C * (nrow - 1)];
+        }
+        for (j = nrow; j < width; j++) {
+          cp[C * j]                              = lastcol;
+          a->sval[a->ssliidx[s] + i % C + C * j] = 0.0;
+        }
       }
-      break;
     }
+    a->snonzerostate = A->nonzerostate;
+    a->sstate        = -1;
+  }
+  PetscCall(PetscObjectStateGet((PetscObject)A, &state));
+  if (a->sstate != state) {
+    for (i = 0; i < m; i++) {
+      const PetscInt   row = a->sperm[i];
+      const MatScalar *vp  = a->val + a->sliidx[row / C] + row % C;
+      MatScalar       *svp = a->sval + a->ssliidx[i / C] + i % C;
 
-  /* Process slice of height 8 (512 bits) via two subslices of height 4 (256 bits) via AVX */
-  #pragma novector
-  #pragma unroll(2)
-    for (j = a->sliidx[i]; j < a->sliidx[i + 1]; j += 8) {
-      vec_vals  = _mm256_loadu_pd(aval);
-      vec_x_tmp = _mm_setzero_pd();
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x, vec_x_tmp, 0);
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x, vec_x_tmp, 1);
-      vec_y     = _mm256_add_pd(_mm256_mul_pd(vec_x, vec_vals), vec_y);
-      aval += 4;
-
-      vec_vals  = _mm256_loadu_pd(aval);
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x, vec_x_tmp, 0);
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x, vec_x_tmp, 1);
-      vec_y2    = _mm256_add_pd(_mm256_mul_pd(vec_x, vec_vals), vec_y2);
-      aval += 4;
+      for (j = 0; j < a->rlen[row]; j++) svp[C * j] = vp[C * j];
     }
-
-    _mm256_storeu_pd(y + i * 8, vec_y);
-    _mm256_storeu_pd(y + i * 8 + 4, vec_y2);
+    a->sstate = state;
   }
-#else
-  PetscCall(PetscMalloc1(sliceheight, &sum));
-  for (i = 0; i < totalslices; i++) { /* loop over slices */
-    for (j = 0; j < sliceheight; j++) {
-      sum[j] = 0.0;
-      for (k = a->sliidx[i] + j; k < a->sliidx[i + 1]; k += sliceheight) sum[j] += aval[k] * x[acolidx[k]];
-    }
-    if (i == totalslices - 1 && (A->rmap->n % sliceheight)) { /* if last slice has padding rows */
-      for (j = 0; j < (A->rmap->n % sliceheight); j++) y[sliceheight * i + j] = sum[j];
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* y = z + A x, where z may be NULL or equal to y */
+static PetscErrorCode MatMult_SeqSELL_Private(Mat A, const PetscScalar *x, const PetscScalar *z, PetscScalar *y)
+{
+  Mat_SeqSELL *a = (Mat_SeqSELL *)A->data;
+  PetscInt     m = A->rmap->n, C = a->sliceheight, totalslices = a->totalslices, nfull = m / C, i;
+
+  PetscFunctionBegin;
+  if (!a->kernel) PetscCall(MatSeqSELLSelectKernel_Private(A));
+  if (!a->multwork) PetscCall(PetscMalloc1(a->sigma > 1 ? C * totalslices : C, &a->multwork));
+  if (a->sigma > 1) {
+    PetscCall(MatSeqSELLSetUpSorted_Private(A));
+    a->kernel(C, totalslices, a->ssliidx, a->scolidx, a->sval, x, NULL, a->multwork);
+    if (z) {
+      for (i = 0; i < m; i++) y[a->sperm[i]] = z[a->sperm[i]] + a->multwork[i];
     } else {
-      for (j = 0; j < sliceheight; j++) y[sliceheight * i + j] = sum[j];
+      for (i = 0; i < m; i++) y[a->sperm[i]] = a->multwork[i];
+    }
+  } else {
+    a->kernel(C, nfull, a->sliidx, a->colidx, a->val, x, z, y);
+    if (nfull < totalslices) { /* the last slice has padding rows, compute it into the work array */
+      if (z) {
+        PetscCall(PetscArraycpy(a->multwork, z + C * nfull, m - C * nfull));
+        PetscCall(PetscArrayzero(a->multwork + m - C * nfull, C * totalslices - m));
+      }
+      a->kernel(C, 1, a->sliidx + nfull, a->colidx, a->val, x, z ? a->multwork : NULL, a->multwork);
+      PetscCall(PetscArraycpy(y + C * nfull, a->multwork, m - C * nfull));
     }
   }
-  PetscCall(PetscFree(sum));
-#endif
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode MatMult_SeqSELL(Mat A, Vec xx, Vec yy)
+{
+  Mat_SeqSELL       *a = (Mat_SeqSELL *)A->data;
+  PetscScalar       *y;
+  const PetscScalar *x;
 
+  PetscFunctionBegin;
+  PetscCall(VecGetArrayRead(xx, &x));
+  PetscCall(VecGetArrayWrite(yy, &y));
+  PetscCall(MatMult_SeqSELL_Private(A, x, NULL, y));
   PetscCall(PetscLogFlops(2.0 * a->nz - a->nonzerorowcnt)); /* theoretical minimal FLOPs */
   PetscCall(VecRestoreArrayRead(xx, &x));
-  PetscCall(VecRestoreArray(yy, &y));
+  PetscCall(VecRestoreArrayWrite(yy, &y));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
-#include <../src/mat/impls/aij/seq/ftn-kernels/fmultadd.h>
 PetscErrorCode MatMultAdd_SeqSELL(Mat A, Vec xx, Vec yy, Vec zz)
 {
   Mat_SeqSELL       *a = (Mat_SeqSELL *)A->data;
   PetscScalar       *y, *z;
   const PetscScalar *x;
-  const MatScalar   *aval        = a->val;
-  PetscInt           totalslices = a->totalslices;
-  const PetscInt    *acolidx     = a->colidx;
-  PetscInt           i, j;
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m512d  vec_x, vec_y, vec_vals;
-  __m256i  vec_idx;
-  __mmask8 mask = 0;
-  __m512d  vec_x2, vec_y2, vec_vals2, vec_x3, vec_y3, vec_vals3, vec_x4, vec_y4, vec_vals4;
-  __m256i  vec_idx2, vec_idx3, vec_idx4;
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  __m128d   vec_x_tmp;
-  __m256d   vec_x, vec_y, vec_y2, vec_vals;
-  MatScalar yval;
-  PetscInt  r, row, nnz_in_row;
-#else
-  PetscInt     k, sliceheight = a->sliceheight;
-  PetscScalar *sum;
-#endif
-
-#if defined(PETSC_HAVE_PRAGMA_DISJOINT)
-  #pragma disjoint(*x, *y, *aval)
-#endif
 
   PetscFunctionBegin;
   if (!a->nz) {
@@ -568,142 +571,7 @@ PetscErrorCode MatMultAdd_SeqSELL(Mat A, Vec xx, Vec yy, Vec zz)
   }
   PetscCall(VecGetArrayRead(xx, &x));
   PetscCall(VecGetArrayPair(yy, zz, &y, &z));
-#if defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX512F__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  PetscCheck(a->sliceheight == 8, PETSC_COMM_SELF, PETSC_ERR_SUP, "The kernel requires a slice height of 8, but the input matrix has a slice height of %" PetscInt_FMT, a->sliceheight);
-  for (i = 0; i < totalslices; i++) { /* loop over slices */
-    PetscPrefetchBlock(acolidx, a->sliidx[i + 1] - a->sliidx[i], 0, PETSC_PREFETCH_HINT_T0);
-    PetscPrefetchBlock(aval, a->sliidx[i + 1] - a->sliidx[i], 0, PETSC_PREFETCH_HINT_T0);
-
-    if (i == totalslices - 1 && A->rmap->n & 0x07) { /* if last slice has padding rows */
-      mask  = (__mmask8)(0xff >> (8 - (A->rmap->n & 0x07)));
-      vec_y = _mm512_mask_loadu_pd(vec_y, mask, &y[8 * i]);
-    } else {
-      vec_y = _mm512_loadu_pd(&y[8 * i]);
-    }
-    vec_y2 = _mm512_setzero_pd();
-    vec_y3 = _mm512_setzero_pd();
-    vec_y4 = _mm512_setzero_pd();
-
-    j = a->sliidx[i] >> 3; /* 8 bytes are read at each time, corresponding to a slice column */
-    switch ((a->sliidx[i + 1] - a->sliidx[i]) / 8 & 3) {
-    case 3:
-      AVX512_Mult_Private(vec_idx, vec_x, vec_vals, vec_y);
-      acolidx += 8;
-      aval += 8;
-      AVX512_Mult_Private(vec_idx2, vec_x2, vec_vals2, vec_y2);
-      acolidx += 8;
-      aval += 8;
-      AVX512_Mult_Private(vec_idx3, vec_x3, vec_vals3, vec_y3);
-      acolidx += 8;
-      aval += 8;
-      j += 3;
-      break;
-    case 2:
-      AVX512_Mult_Private(vec_idx, vec_x, vec_vals, vec_y);
-      acolidx += 8;
-      aval += 8;
-      AVX512_Mult_Private(vec_idx2, vec_x2, vec_vals2, vec_y2);
-      acolidx += 8;
-      aval += 8;
-      j += 2;
-      break;
-    case 1:
-      AVX512_Mult_Private(vec_idx, vec_x, vec_vals, vec_y);
-      acolidx += 8;
-      aval += 8;
-      j += 1;
-      break;
-    }
-  #pragma novector
-    for (; j < (a->sliidx[i + 1] >> 3); j += 4) {
-      AVX512_Mult_Private(vec_idx, vec_x, vec_vals, vec_y);
-      acolidx += 8;
-      aval += 8;
-      AVX512_Mult_Private(vec_idx2, vec_x2, vec_vals2, vec_y2);
-      acolidx += 8;
-      aval += 8;
-      AVX512_Mult_Private(vec_idx3, vec_x3, vec_vals3, vec_y3);
-      acolidx += 8;
-      aval += 8;
-      AVX512_Mult_Private(vec_idx4, vec_x4, vec_vals4, vec_y4);
-      acolidx += 8;
-      aval += 8;
-    }
-
-    vec_y = _mm512_add_pd(vec_y, vec_y2);
-    vec_y = _mm512_add_pd(vec_y, vec_y3);
-    vec_y = _mm512_add_pd(vec_y, vec_y4);
-    if (i == totalslices - 1 && A->rmap->n & 0x07) { /* if last slice has padding rows */
-      _mm512_mask_storeu_pd(&z[8 * i], mask, vec_y);
-    } else {
-      _mm512_storeu_pd(&z[8 * i], vec_y);
-    }
-  }
-#elif defined(PETSC_HAVE_IMMINTRIN_H) && defined(__AVX__) && defined(PETSC_USE_REAL_DOUBLE) && !defined(PETSC_USE_COMPLEX) && !defined(PETSC_USE_64BIT_INDICES)
-  PetscCheck(a->sliceheight == 8, PETSC_COMM_SELF, PETSC_ERR_SUP, "The kernel requires a slice height of 8, but the input matrix has a slice height of %" PetscInt_FMT, a->sliceheight);
-  for (i = 0; i < totalslices; i++) { /* loop over full slices */
-    PetscPrefetchBlock(acolidx, a->sliidx[i + 1] - a->sliidx[i], 0, PETSC_PREFETCH_HINT_T0);
-    PetscPrefetchBlock(aval, a->sliidx[i + 1] - a->sliidx[i], 0, PETSC_PREFETCH_HINT_T0);
-
-    /* last slice may have padding rows. Don't use vectorization. */
-    if (i == totalslices - 1 && (A->rmap->n & 0x07)) {
-      for (r = 0; r < (A->rmap->n & 0x07); ++r) {
-        row        = 8 * i + r;
-        yval       = (MatScalar)0.0;
-        nnz_in_row = a->rlen[row];
-        for (j = 0; j < nnz_in_row; ++j) yval += aval[8 * j + r] * x[acolidx[8 * j + r]];
-        z[row] = y[row] + yval;
-      }
-      break;
-    }
-
-    vec_y  = _mm256_loadu_pd(y + 8 * i);
-    vec_y2 = _mm256_loadu_pd(y + 8 * i + 4);
-
-    /* Process slice of height 8 (512 bits) via two subslices of height 4 (256 bits) via AVX */
-    for (j = a->sliidx[i]; j < a->sliidx[i + 1]; j += 8) {
-      vec_vals  = _mm256_loadu_pd(aval);
-      vec_x_tmp = _mm_setzero_pd();
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_setzero_pd();
-      vec_x     = _mm256_insertf128_pd(vec_x, vec_x_tmp, 0);
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x, vec_x_tmp, 1);
-      vec_y     = _mm256_add_pd(_mm256_mul_pd(vec_x, vec_vals), vec_y);
-      aval += 4;
-
-      vec_vals  = _mm256_loadu_pd(aval);
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x, vec_x_tmp, 0);
-      vec_x_tmp = _mm_loadl_pd(vec_x_tmp, x + *acolidx++);
-      vec_x_tmp = _mm_loadh_pd(vec_x_tmp, x + *acolidx++);
-      vec_x     = _mm256_insertf128_pd(vec_x, vec_x_tmp, 1);
-      vec_y2    = _mm256_add_pd(_mm256_mul_pd(vec_x, vec_vals), vec_y2);
-      aval += 4;
-    }
-
-    _mm256_storeu_pd(z + i * 8, vec_y);
-    _mm256_storeu_pd(z + i * 8 + 4, vec_y2);
-  }
-#else
-  PetscCall(PetscMalloc1(sliceheight, &sum));
-  for (i = 0; i < totalslices; i++) { /* loop over slices */
-    for (j = 0; j < sliceheight; j++) {
-      sum[j] = 0.0;
-      for (k = a->sliidx[i] + j; k < a->sliidx[i + 1]; k += sliceheight) sum[j] += aval[k] * x[acolidx[k]];
-    }
-    if (i == totalslices - 1 && (A->rmap->n % sliceheight)) {
-      for (j = 0; j < (A->rmap->n % sliceheight); j++) z[sliceheight * i + j] = y[sliceheight * i + j] + sum[j];
-    } else {
-      for (j = 0; j < sliceheight; j++) z[sliceheight * i + j] = y[sliceheight * i + j] + sum[j];
-    }
-  }
-  PetscCall(PetscFree(sum));
-#endif
-
+  PetscCall(MatMult_SeqSELL_Private(A, x, y, z));
   PetscCall(PetscLogFlops(2.0 * a->nz));
   PetscCall(VecRestoreArrayRead(xx, &x));
   PetscCall(VecRestoreArrayPair(yy, zz, &y, &z));
@@ -887,6 +755,10 @@ PetscErrorCode MatDestroy_SeqSELL(Mat A)
   PetscCall(ISDestroy(&a->icol));
   PetscCall(PetscFree(a->saved_values));
   PetscCall(PetscFree2(a->getrowcols, a->getrowvals));
+  PetscCall(PetscFree(a->multwork));
+  PetscCall(PetscFree(a->sperm));
+  PetscCall(PetscFree(a->ssliidx));
+  PetscCall(PetscFree2(a->sval, a->scolidx));
   PetscCall(PetscFree(A->data));
 #if defined(PETSC_HAVE_CUPM)
   PetscCall(PetscFree(a->chunk_slice_map));
@@ -1019,6 +891,8 @@ PetscErrorCode MatDiagonalScale_SeqSELL(Mat A, Vec ll, Vec rr)
     PetscCall(PetscLogFlops(a->nz));
   }
   PetscCall(MatSeqSELLInvalidateDiagonal(A));
+  /* MATMPISELL scales its blocks through their ops table; the sorted copy is refreshed based on the state */
+  PetscCall(PetscObjectStateIncrease((PetscObject)A));
 #if defined(PETSC_HAVE_CUPM)
   if (A->offloadmask != PETSC_OFFLOAD_UNALLOCATED) A->offloadmask = PETSC_OFFLOAD_CPU;
 #endif
@@ -2180,6 +2054,8 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqSELL(Mat B)
   b->idiagvalid         = PETSC_FALSE;
   b->keepnonzeropattern = PETSC_FALSE;
   b->sliceheight        = 0;
+  b->sigma              = 1;
+  b->kerneltype         = MAT_SEQSELL_KERNEL_AUTO;
 
   PetscCall(PetscObjectChangeTypeName((PetscObject)B, MATSEQSELL));
   PetscCall(PetscObjectComposeFunction((PetscObject)B, "MatSeqSELLGetArray_C", MatSeqSELLGetArray_SeqSELL));
@@ -2210,6 +2086,9 @@ PETSC_EXTERN PetscErrorCode MatCreate_SeqSELL(Mat B)
 
     PetscCall(PetscOptionsInt("-mat_sell_slice_height", "Set the slice height used to store SELL matrix", "MatSELLSetSliceHeight", newsh, &newsh, &flg));
     if (flg) { PetscCall(MatSeqSELLSetSliceHeight(B, newsh)); }
+    PetscCall(PetscOptionsInt("-mat_sell_sigma", "Sort the rows by length within windows of this many rows for the products (SELL-C-sigma)", "MATSEQSELL", b->sigma, &b->sigma, NULL));
+    PetscCheck(b->sigma >= 1, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "The sorting window must be positive: value %" PetscInt_FMT, b->sigma);
+    PetscCall(PetscOptionsEnum("-mat_sell_kernel", "SpMV kernel, auto chooses the fastest one supported by the processor", "MATSEQSELL", MatSeqSELLKernelTypes, (PetscEnum)b->kerneltype, (PetscEnum *)&b->kerneltype, NULL));
 #if defined(PETSC_HAVE_CUPM)
     PetscCall(PetscOptionsInt("-mat_sell_chunk_size", "Set the chunksize for load-balanced CUDA/HIP kernels. Choices include 64,128,256,512,1024", NULL, chunksize, &chunksize, &flg));
     if (flg) {
@@ -2243,6 +2122,8 @@ static PetscErrorCode MatDuplicateNoCreate_SeqSELL(Mat C, Mat A, MatDuplicateOpt
   PetscCall(PetscLayoutReference(A->cmap, &C->cmap));
 
   c->sliceheight = a->sliceheight;
+  c->sigma       = a->sigma;
+  c->kerneltype  = a->kerneltype;
   PetscCall(PetscMalloc1(c->sliceheight * totalslices, &c->rlen));
   PetscCall(PetscMalloc1(totalslices + 1, &c->sliidx));
 
@@ -2309,11 +2190,22 @@ PetscErrorCode MatDuplicate_SeqSELL(Mat A, MatDuplicateOption cpvalues, Mat *B)
    MATSEQSELL - MATSEQSELL = "seqsell" - A matrix type to be used for sequential sparse matrices,
    based on the sliced Ellpack format, {cite}`zhangellpack2018`
 
-   Options Database Key:
-. -mat_type seqsell - sets the matrix type to "`MATSEQELL` during a call to `MatSetFromOptions()`
+   Options Database Keys:
++ -mat_type seqsell                             - sets the matrix type to "`MATSEQELL` during a call to `MatSetFromOptions()`
+. -mat_sell_slice_height <C>                    - the number of rows in each slice, see `MatSeqSELLSetSliceHeight()`
+. -mat_sell_sigma <sigma>                       - sort the rows by length within windows of sigma rows for `MatMult()` and `MatMultAdd()` (SELL-C-sigma)
+- -mat_sell_kernel <auto,generic,avx2,avx512,sve> - the SpMV kernel, by default the fastest one supported by the processor
 
    Level: beginner
 
+   Notes:
+   The SpMV kernel is chosen at run time from the processor features, so a single build uses AVX-512 or AVX2 where they are available
+   and a portable kernel elsewhere; run with `-info` to see which kernel is used. The AVX-512 kernel requires a slice height that is a
+   multiple of 8 and the AVX2 kernel one that is a multiple of 4.
+
+   With a sorting window sigma larger than one, a copy of the matrix with the rows of each window sorted by decreasing length is kept
+   for the products. This reduces the padding of matrices with irregular row lengths at the cost of storing the matrix twice.
+
 .seealso: `Mat`, `MatCreateSeqSELL()`, `MATSELL`, `MATMPISELL`, `MATSEQAIJ`, `MATAIJ`, `MATMPIAIJ`
 M*/
 
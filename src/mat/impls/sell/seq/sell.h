@@ -58,6 +58,20 @@ means that this shares some data structures with the parent including diag, ilen
   PetscInt    *getrowcols;      /* workarray for MatGetRow_SeqSELL */ \
   PetscScalar *getrowvals       /* workarray for MatGetRow_SeqSELL */
 
+/*
+ SpMV kernel applied to nslices consecutive slices of height C: y[C*s+r] = z[C*s+r] + sum of row r of slice s times x,
+ where z may be NULL (then it is taken as zero) or equal to y; sliidx[] holds absolute offsets into colidx[] and val[]
+*/
+typedef void (*MatSeqSELLMultKernel)(PetscInt, PetscInt, const PetscInt *, const PetscInt *, const MatScalar *, const PetscScalar *, const PetscScalar *, PetscScalar *);
+
+typedef enum {
+  MAT_SEQSELL_KERNEL_AUTO,
+  MAT_SEQSELL_KERNEL_GENERIC,
+  MAT_SEQSELL_KERNEL_AVX2,
+  MAT_SEQSELL_KERNEL_AVX512,
+  MAT_SEQSELL_KERNEL_SVE
+} MatSeqSELLKernelType;
+
 typedef struct {
   SEQSELLHEADER(MatScalar);
   MatScalar   *saved_values;              /* location for stashing nonzero values of matrix */
@@ -65,6 +79,15 @@ typedef struct {
   PetscBool    idiagvalid;                /* current idiag[] and mdiag[] are valid */
   PetscScalar  fshift, omega;             /* last used omega and fshift */
   ISColoring   coloring;                  /* set with MatADSetColoring() used by MatADSetValues() */
+
+  MatSeqSELLKernelType kerneltype;            /* SpMV kernel requested with -mat_sell_kernel */
+  MatSeqSELLMultKernel kernel;                /* SpMV kernel chosen for the slice height and the CPU, NULL until the first product */
+  PetscScalar         *multwork;              /* output of the sorted copy, or of the last slice when it has padding rows */
+  PetscInt             sigma;                 /* rows are sorted by length within windows of sigma rows for the products (SELL-C-sigma) */
+  PetscInt            *sperm;                 /* row stored in each row slot of the sorted copy */
+  PetscInt            *ssliidx, *scolidx;     /* slice index and column indices of the sorted copy */
+  MatScalar           *sval;                  /* values of the sorted copy */
+  PetscObjectState     snonzerostate, sstate; /* nonzero state and state of the matrix when the sorted copy was last built and filled */
 } Mat_SeqSELL;
 
 /*
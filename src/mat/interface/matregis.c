@@ -40,6 +40,12 @@ PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJPERM(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSELL(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJSELL(Mat);
 
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJVBR(Mat);
+PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJVBR(Mat);
+#if !defined(PETSC_USE_COMPLEX)
+PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJSingle(Mat);
+#endif
+
 #if defined(PETSC_HAVE_MKL_SPARSE)
 PETSC_EXTERN PetscErrorCode MatCreate_SeqAIJMKL(Mat);
 PETSC_EXTERN PetscErrorCode MatCreate_MPIAIJMKL(Mat);
@@ -154,6 +160,13 @@ PetscErrorCode MatRegisterAll(void)
   PetscCall(MatRegister(MATMPIAIJSELL, MatCreate_MPIAIJSELL));
   PetscCall(MatRegister(MATSEQAIJSELL, MatCreate_SeqAIJSELL));
 
+  PetscCall(MatRegisterRootName(MATAIJVBR, MATSEQAIJVBR, MATMPIAIJVBR));
+  PetscCall(MatRegister(MATMPIAIJVBR, MatCreate_MPIAIJVBR));
+  PetscCall(MatRegister(MATSEQAIJVBR, MatCreate_SeqAIJVBR));
+#if !defined(PETSC_USE_COMPLEX)
+  PetscCall(MatRegister(MATSEQAIJSINGLE, MatCreate_SeqAIJSingle));
+#endif
+
 #if defined(PETSC_HAVE_MKL_SPARSE)
   PetscCall(MatRegisterRootName(MATAIJMKL, MATSEQAIJMKL, MATMPIAIJMKL));
   PetscCall(MatRegister(MATMPIAIJMKL, MatCreate_MPIAIJMKL));
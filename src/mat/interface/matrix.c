@@ -14,7 +14,7 @@ PetscClassId MAT_COLORING_CLASSID;
 PetscClassId MAT_FDCOLORING_CLASSID;
 PetscClassId MAT_TRANSPOSECOLORING_CLASSID;
 
-PetscLogEvent MAT_Mult, MAT_MultAdd, MAT_MultTranspose;
+PetscLogEvent MAT_Mult, MAT_MultAdd, MAT_MultPowers, MAT_MultTranspose;
 PetscLogEvent MAT_MultTransposeAdd, MAT_Solve, MAT_Solves, MAT_SolveAdd, MAT_SolveTranspose, MAT_MatSolve, MAT_MatTrSolve;
 PetscLogEvent MAT_SolveTransposeAdd, MAT_SOR, MAT_ForwardSolve, MAT_BackwardSolve, MAT_LUFactor, MAT_LUFactorSymbolic;
 PetscLogEvent MAT_LUFactorNumeric, MAT_CholeskyFactor, MAT_CholeskyFactorSymbolic, MAT_CholeskyFactorNumeric, MAT_ILUFactor;
@@ -37,7 +37,7 @@ PetscLogEvent MAT_CUSPARSECopyToGPU, MAT_CUSPARSECopyFromGPU, MAT_CUSPARSEGenera
 PetscLogEvent MAT_HIPSPARSECopyToGPU, MAT_HIPSPARSECopyFromGPU, MAT_HIPSPARSEGenerateTranspose, MAT_HIPSPARSESolveAnalysis;
 PetscLogEvent MAT_PreallCOO, MAT_SetVCOO;
 PetscLogEvent MAT_CreateGraph;
-PetscLogEvent MAT_SetValuesBatch;
+PetscLogEvent MAT_SetValuesBatch, MAT_StashFlush;
 PetscLogEvent MAT_ViennaCLCopyToGPU;
 PetscLogEvent MAT_CUDACopyToGPU, MAT_HIPCopyToGPU;
 PetscLogEvent MAT_DenseCopyToGPU, MAT_DenseCopyFromGPU;
@@ -1558,7 +1558,9 @@ PetscErrorCode MatSetValues(Mat mat, PetscInt m, const PetscInt idxm[], PetscInt
   PetscAssertPointer(idxn, 5);
   MatCheckPreallocated(mat, 1);
 
-  if (mat->insertmode == NOT_SET_VALUES) mat->insertmode = addv;
+  /* with MAT_CONCURRENT_SET_VALUES the threads only read the state of the matrix, MatAssemblyBegin() marks it unassembled */
+  if (mat->concurrent_setvalues) PetscCheck(mat->insertmode == NOT_SET_VALUES || mat->insertmode == addv, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Cannot mix add values and insert values");
+  else if (mat->insertmode == NOT_SET_VALUES) mat->insertmode = addv;
   else PetscCheck(mat->insertmode == addv, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Cannot mix add values and insert values");
 
   if (PetscDefined(USE_DEBUG)) {
@@ -1581,13 +1583,14 @@ PetscErrorCode MatSetValues(Mat mat, PetscInt m, const PetscInt idxm[], PetscInt
     for (i = 0; i < n; i++) PetscCheck(idxn[i] < mat->cmap->N, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Cannot insert in column %" PetscInt_FMT ", maximum is %" PetscInt_FMT, idxn[i], mat->cmap->N - 1);
   }
 
-  if (mat->assembled) {
+  if (mat->assembled && !mat->concurrent_setvalues) {
     mat->was_assembled = PETSC_TRUE;
     mat->assembled     = PETSC_FALSE;
   }
   PetscCall(PetscLogEventBegin(MAT_SetValues, mat, 0, 0, 0));
   PetscUseTypeMethod(mat, setvalues, m, idxm, n, idxn, v, addv);
   PetscCall(PetscLogEventEnd(MAT_SetValues, mat, 0, 0, 0));
+  if (PetscUnlikely(mat->stash.flushsize)) PetscCall(MatStashFlush_Private(mat));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -2084,7 +2087,8 @@ PetscErrorCode MatSetValuesBlocked(Mat mat, PetscInt m, const PetscInt idxm[], P
   PetscAssertPointer(idxm, 3);
   PetscAssertPointer(idxn, 5);
   MatCheckPreallocated(mat, 1);
-  if (mat->insertmode == NOT_SET_VALUES) mat->insertmode = addv;
+  if (mat->concurrent_setvalues) PetscCheck(mat->insertmode == NOT_SET_VALUES || mat->insertmode == addv, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Cannot mix add values and insert values");
+  else if (mat->insertmode == NOT_SET_VALUES) mat->insertmode = addv;
   else PetscCheck(mat->insertmode == addv, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Cannot mix add values and insert values");
   if (PetscDefined(USE_DEBUG)) {
     PetscCheck(!mat->factortype, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Not for factored matrix");
@@ -2098,7 +2102,7 @@ PetscErrorCode MatSetValuesBlocked(Mat mat, PetscInt m, const PetscInt idxm[], P
     for (i = 0; i < n; i++)
       PetscCheck(idxn[i] * cbs < N, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Column block %" PetscInt_FMT " contains an index %" PetscInt_FMT "*%" PetscInt_FMT " greater than column length %" PetscInt_FMT, i, idxn[i], cbs, N);
   }
-  if (mat->assembled) {
+  if (mat->assembled && !mat->concurrent_setvalues) {
     mat->was_assembled = PETSC_TRUE;
     mat->assembled     = PETSC_FALSE;
   }
@@ -2130,6 +2134,7 @@ PetscErrorCode MatSetValuesBlocked(Mat mat, PetscInt m, const PetscInt idxm[], P
     PetscCall(PetscFree2(bufr, bufc));
   }
   PetscCall(PetscLogEventEnd(MAT_SetValues, mat, 0, 0, 0));
+  if (PetscUnlikely(mat->stash.flushsize)) PetscCall(MatStashFlush_Private(mat));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -2509,6 +2514,7 @@ PetscErrorCode MatSetValuesLocal(Mat mat, PetscInt nrow, const PetscInt irow[],
     if (bufr != buf) PetscCall(PetscFree2(bufr, bufc));
   }
   PetscCall(PetscLogEventEnd(MAT_SetValues, mat, 0, 0, 0));
+  if (PetscUnlikely(mat->stash.flushsize)) PetscCall(MatStashFlush_Private(mat));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -2610,6 +2616,7 @@ PetscErrorCode MatSetValuesBlockedLocal(Mat mat, PetscInt nrow, const PetscInt i
     if (bufr != buf) PetscCall(PetscFree2(bufr, bufc));
   }
   PetscCall(PetscLogEventEnd(MAT_SetValues, mat, 0, 0, 0));
+  if (PetscUnlikely(mat->stash.flushsize)) PetscCall(MatStashFlush_Private(mat));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -2871,6 +2878,83 @@ PetscErrorCode MatMultAdd(Mat mat, Vec v1, Vec v2, Vec v3)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  MatMultPowers - Computes the vectors $y_k = p_k(A) x$, $k = 1, \ldots, s$, of a polynomial basis of the Krylov space of `mat`
+  and `x` given by a three-term recurrence, such as the monomial basis $A x, A^2 x, \ldots, A^s x$
+
+  Neighbor-wise Collective
+
+  Input Parameters:
++ mat   - the matrix
+. x     - the vector
+. s     - the number of vectors to compute
+. alpha - the shifts $\alpha_0, \ldots, \alpha_{s-1}$ of the recurrence, or `NULL` for zero shifts
+. beta  - the coefficients $\beta_1, \ldots, \beta_{s-1}$ of the recurrence, stored from `beta[1]`, or `NULL` for zero coefficients
+- gamma - the scalings $\gamma_0, \ldots, \gamma_{s-1}$ of the recurrence, or `NULL` for no scaling
+
+  Output Parameter:
+. y - the `s` vectors, which must be different from `x`
+
+  Level: advanced
+
+  Notes:
+  With $y_0 = x$ and $y_{-1} = 0$ the vectors are computed with $y_{k+1} = (A y_k - \alpha_k y_k - \beta_k y_{k-1}) / \gamma_k$. The monomial
+  basis uses no coefficients, the Newton basis the shifts $\alpha_k$, often Leja ordered Ritz values, and the Chebyshev basis
+  of an interval of center $c$ and half-width $h$ the coefficients $\alpha_k = c$, $\beta_k = h / 2$, $\gamma_0 = h$ and $\gamma_k = h / 2$ for $k > 0$.
+
+  For `MATMPIAIJ` the rows of `mat` at distance less than `s`, in the graph of `mat`, from the rows of each process are gathered
+  once per nonzero structure, and their values again when the matrix changes, so that all the vectors are computed with a single
+  exchange of the ghost values of `x`, at distance at most `s`, instead of one per product. The rows near the process boundaries are
+  computed redundantly by the neighboring processes, so this pays off when the latency of the exchanges dominates, with small local
+  problems or many processes, and for small `s`. The matrix must have the same row and column layouts.
+
+  Other matrix types compute the vectors with `MatMult()`, unless they provide their own implementation by composing a function
+  `MatMultPowers_C` with the calling sequence of `MatMultPowers()`, for instance for a `MATSHELL` that applies a stencil.
+
+.seealso: [](ch_matrices), `Mat`, `MatMult()`, `MatMultAdd()`, `KSPCG`, `KSPGMRES`
+@*/
+PetscErrorCode MatMultPowers(Mat mat, Vec x, PetscInt s, const PetscScalar alpha[], const PetscScalar beta[], const PetscScalar gamma[], Vec y[])
+{
+  PetscErrorCode (*f)(Mat, Vec, PetscInt, const PetscScalar[], const PetscScalar[], const PetscScalar[], Vec[]);
+
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(mat, MAT_CLASSID, 1);
+  PetscValidType(mat, 1);
+  PetscValidHeaderSpecific(x, VEC_CLASSID, 2);
+  PetscValidLogicalCollectiveInt(mat, s, 3);
+  PetscCheck(s >= 0, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_OUTOFRANGE, "Number of vectors %" PetscInt_FMT " cannot be negative", s);
+  if (s) PetscAssertPointer(y, 7);
+  for (PetscInt k = 0; k < s; k++) {
+    PetscValidHeaderSpecific(y[k], VEC_CLASSID, 7);
+    PetscCheck(y[k] != x, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_IDN, "x and y[%" PetscInt_FMT "] must be different vectors", k);
+  }
+  PetscCheck(mat->assembled, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_WRONGSTATE, "Not for unassembled matrix");
+  PetscCheck(!mat->factortype, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_WRONGSTATE, "Not for factored matrix");
+  PetscCheck(mat->rmap->N == mat->cmap->N, PetscObjectComm((PetscObject)mat), PETSC_ERR_ARG_SIZ, "Only for square matrices, not %" PetscInt_FMT " by %" PetscInt_FMT, mat->rmap->N, mat->cmap->N);
+  PetscCheck(mat->cmap->n == x->map->n, PETSC_COMM_SELF, PETSC_ERR_ARG_SIZ, "Mat mat,Vec x: local dim %" PetscInt_FMT " %" PetscInt_FMT, mat->cmap->n, x->map->n);
+  MatCheckPreallocated(mat, 1);
+  if (!s) PetscFunctionReturn(PETSC_SUCCESS);
+
+  PetscCall(PetscLogEventBegin(MAT_MultPowers, mat, x, 0, 0));
+  PetscCall(VecLockReadPush(x));
+  PetscCall(PetscObjectQueryFunction((PetscObject)mat, "MatMultPowers_C", &f));
+  if (f) PetscCall((*f)(mat, x, s, alpha, beta, gamma, y));
+  else {
+    for (PetscInt k = 0; k < s; k++) {
+      Vec yk = k ? y[k - 1] : x;
+
+      PetscCall(MatMult(mat, yk, y[k]));
+      if (alpha && alpha[k] != (PetscScalar)0.0) PetscCall(VecAXPY(y[k], -alpha[k], yk));
+      if (k && beta && beta[k] != (PetscScalar)0.0) PetscCall(VecAXPY(y[k], -beta[k], k > 1 ? y[k - 2] : x));
+      if (gamma) PetscCall(VecScale(y[k], 1.0 / gamma[k]));
+    }
+  }
+  PetscCall(VecLockReadPop(x));
+  for (PetscInt k = 0; k < s; k++) PetscCall(PetscObjectStateIncrease((PetscObject)y[k]));
+  PetscCall(PetscLogEventEnd(MAT_MultPowers, mat, x, 0, 0));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   MatMultTransposeAdd - Computes $v3 = v2 + A^T * v1$.
 
@@ -5784,12 +5868,20 @@ static PetscInt MatAssemblyEnd_InUse = 0;
 + mat  - the matrix
 - type - type of assembly, either `MAT_FLUSH_ASSEMBLY` or `MAT_FINAL_ASSEMBLY`
 
+  Options Database Key:
+. -matstash_flush_size <n> - send the cached values to their owners each time the cache holds `n` values, instead of only in `MatAssemblyBegin()`
+
   Level: beginner
 
   Notes:
   `MatSetValues()` generally caches the values that belong to other MPI processes.  The matrix is ready to
   use only after `MatAssemblyBegin()` and `MatAssemblyEnd()` have been called.
 
+  With `-matstash_flush_size` the cached values are sorted, duplicate entries are combined, and the result is sent to the owning
+  processes with nonblocking messages while `MatSetValues()` continues, so the communication overlaps with the rest of the assembly.
+  The option must have the same value on all processes; it is ignored with `-matstash_legacy` and with `MAT_SUBSET_OFF_PROC_ENTRIES`.
+  The flushes are logged as the `MatStashFlush` event of `-log_view`.
+
   Use `MAT_FLUSH_ASSEMBLY` when switching between `ADD_VALUES` and `INSERT_VALUES`
   in `MatSetValues()`; use `MAT_FINAL_ASSEMBLY` for the final assembly before
   using the matrix.
@@ -5973,9 +6065,11 @@ PetscErrorCode MatAssemblyEnd(Mat mat, MatAssemblyType type)
 . `MAT_NO_OFF_PROC_ENTRIES`         - you know each process will only set values for its own rows, will generate an error if
         any process sets values for another process. This avoids all reductions in the MatAssembly routines and thus improves
         performance for very large process counts.
-- `MAT_SUBSET_OFF_PROC_ENTRIES`     - you know that the first assembly after setting this flag will set a superset
+. `MAT_SUBSET_OFF_PROC_ENTRIES`     - you know that the first assembly after setting this flag will set a superset
         of the off-process entries required for all subsequent assemblies. This avoids a rendezvous step in the MatAssembly
         functions, instead sending only neighbor messages.
+- `MAT_CONCURRENT_SET_VALUES`       - several threads may call `MatSetValues()` at the same time to set values in an already
+        assembled nonzero structure
 
   Level: intermediate
 
@@ -6039,6 +6133,16 @@ PetscErrorCode MatAssemblyEnd(Mat mat, MatAssemblyType type)
   single call to `MatSetValues()`, preallocation is perfect, row-oriented, `INSERT_VALUES` is used. Common
   with finite difference schemes with non-periodic boundary conditions.
 
+  `MAT_CONCURRENT_SET_VALUES` - the threads of an OpenMP parallel region, for example one per set of finite elements, may call
+  `MatSetValues()` (and `MatSetValuesBlocked()` for `MATSEQBAIJ`) on the matrix at the same time. The nonzero structure must have
+  been assembled before, it is never changed: entries outside of it generate an error, or are ignored if `MAT_NEW_NONZERO_LOCATIONS`
+  is `PETSC_FALSE`. `ADD_VALUES` to the same entry from different threads are atomic, of concurrent `INSERT_VALUES` to the same entry
+  one value is kept. For `MATMPIAIJ` each thread may only set values in the locally owned rows. While the option is set, `MatSetValues()`
+  does not change the assembled state or the `InsertMode` of the matrix, so the threads do not write to the `Mat` object; `MatAssemblyBegin()`
+  and `MatAssemblyEnd()` are still called, by a single thread, once all the threads are done. Currently supported by `MATSEQAIJ`, `MATSEQBAIJ`
+  and `MATMPIAIJ` and only if PETSc was configured with OpenMP, other types generate an error. With debugging or logging, PETSc must also be
+  configured with `--with-threadsafety`.
+
   Developer Note:
   `MAT_SYMMETRY_ETERNAL`, `MAT_STRUCTURAL_SYMMETRY_ETERNAL`, and `MAT_SPD_ETERNAL` are used by `MatAssemblyEnd()` and in other
   places where otherwise the value of `MAT_SYMMETRIC`, `MAT_STRUCTURALLY_SYMMETRIC` or `MAT_SPD` would need to be changed back
@@ -6126,6 +6230,15 @@ PetscErrorCode MatSetOption(Mat mat, MatOption op, PetscBool flg)
   case MAT_SORTED_FULL:
     mat->sortedfull = flg;
     break;
+  case MAT_CONCURRENT_SET_VALUES: {
+    PetscErrorCode (*f)(Mat, PetscBool);
+
+    PetscCall(PetscObjectQueryFunction((PetscObject)mat, "MatSetConcurrentSetValues_C", &f));
+    PetscCheck(f || !flg, PetscObjectComm((PetscObject)mat), PETSC_ERR_SUP, "MAT_CONCURRENT_SET_VALUES is not supported for matrix type %s", ((PetscObject)mat)->type_name);
+    if (f) PetscCall((*f)(mat, flg));
+    mat->concurrent_setvalues = flg;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
   default:
     break;
   }
@@ -147,6 +147,10 @@ int main(int argc, char **args)
       suffix: aij
       args: -mat_type aij
 
+    test:
+      suffix: aij_threads
+      args: -mat_type aij -mat_seqaij_threads 3
+
     test:
       suffix: hypre
       requires: hypre
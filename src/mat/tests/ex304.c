@@ -0,0 +1,108 @@
+static char help[] = "Tests the thread-parallel kernels of MATSEQAIJ against MATSEQDENSE.\n\n";
+
+#include <petscmat.h>
+
+/*
+   Assembles a 1d periodic stencil over n nodes with bs unknowns per node, so that the matrix has inodes of size bs,
+   leaving the rows of every empty-th node empty to exercise the compressed row format
+*/
+static PetscErrorCode AssembleMatrix(PetscInt n, PetscInt bs, PetscInt empty, Mat A)
+{
+  PetscScalar *v;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscMalloc1(3 * bs * bs, &v));
+  for (PetscInt i = 0; i < n; i++) {
+    PetscInt cols[3];
+
+    if (empty > 0 && i % empty == 0) continue;
+    cols[0] = (i + n - 1) % n;
+    cols[1] = i;
+    cols[2] = (i + 1) % n;
+    for (PetscInt k = 0; k < 3 * bs * bs; k++) v[k] = (PetscScalar)(1.0 + (i * 7 + k * 3) % 11) / (PetscScalar)(1.0 + k % 5);
+    PetscCall(MatSetValuesBlocked(A, 1, &i, 3, cols, v, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(PetscFree(v));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat       A, D;
+  PetscInt  n = 50, bs = 3, empty = 0;
+  PetscBool flg;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-bs", &bs, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-empty", &empty, NULL));
+
+  PetscCall(MatCreate(PETSC_COMM_SELF, &A));
+  PetscCall(MatSetSizes(A, n * bs, n * bs, n * bs, n * bs));
+  PetscCall(MatSetBlockSize(A, bs));
+  PetscCall(MatSetType(A, MATSEQAIJ));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatSeqAIJSetPreallocation(A, 3 * bs, NULL));
+  PetscCall(AssembleMatrix(n, bs, empty, A));
+  PetscCall(MatConvert(A, MATSEQDENSE, MAT_INITIAL_MATRIX, &D));
+
+  PetscCall(MatMultEqual(A, D, 3, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatMult() differs from MATSEQDENSE");
+  PetscCall(MatMultAddEqual(A, D, 3, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatMultAdd() differs from MATSEQDENSE");
+  PetscCall(MatMultTransposeEqual(A, D, 3, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatMultTranspose() differs from MATSEQDENSE");
+  PetscCall(MatMultTransposeAddEqual(A, D, 3, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatMultTransposeAdd() differs from MATSEQDENSE");
+
+  /* a second assembly with the same nonzero structure reuses the partition and the colors but computes the transpose again */
+  PetscCall(MatScale(A, 2.0));
+  PetscCall(MatScale(D, 2.0));
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatMultEqual(A, D, 3, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatMult() differs from MATSEQDENSE after reassembly");
+  PetscCall(MatMultTransposeAddEqual(A, D, 3, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatMultTransposeAdd() differs from MATSEQDENSE after reassembly");
+
+  PetscCall(MatDestroy(&D));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+     output_file: output/empty.out
+     args: -mat_seqaij_threads {{1 2 3}} -empty {{0 2}}
+
+     test:
+       suffix: inode
+       args: -bs {{1 3 5}}
+
+     test:
+       suffix: no_inode
+       args: -mat_no_inode
+
+   testset:
+     output_file: output/empty.out
+     args: -mat_seqaij_threads 3 -mat_seqaij_multtranspose {{auto sequential private colors transpose}} -empty {{0 2}}
+
+     test:
+       suffix: multtranspose
+
+     test:
+       suffix: multtranspose_no_inode
+       args: -bs 1 -mat_no_inode
+
+   test:
+     suffix: first_touch
+     requires: openmp
+     output_file: output/empty.out
+     args: -mat_seqaij_threads 3 -omp_num_threads 3 -omp_first_touch
+
+TEST*/
@@ -0,0 +1,93 @@
+static char help[] = "Tests the SpMV kernels and the sorting window of MATSEQSELL against MATSEQAIJ.\n\n";
+
+#include <petscmat.h>
+
+/* Assembles an m x n matrix whose row lengths vary between 0 and 12, so that slices have padding */
+static PetscErrorCode AssembleMatrix(PetscInt m, PetscInt n, Mat A)
+{
+  PetscFunctionBeginUser;
+  for (PetscInt i = 0; i < m; i++) {
+    PetscInt    cols[12], ncols = PetscMin((i * 7) % 13, n);
+    PetscScalar v[12];
+
+    for (PetscInt k = 0; k < ncols; k++) {
+      cols[k] = (i + k * k * 5) % n;
+      v[k]    = (PetscScalar)(1.0 + (i + 3 * k) % 7) / (PetscScalar)(1.0 + k);
+    }
+    PetscCall(MatSetValues(A, 1, &i, ncols, cols, v, ADD_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CheckProducts(Mat A, Mat B, const char *stage)
+{
+  PetscBool flg;
+
+  PetscFunctionBeginUser;
+  PetscCall(MatMultEqual(A, B, 3, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatMult() differs from MATSEQAIJ %s", stage);
+  PetscCall(MatMultAddEqual(A, B, 3, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatMultAdd() differs from MATSEQAIJ %s", stage);
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat      A, B;
+  Vec      l, r;
+  PetscInt m = 203, n = 157;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+
+  PetscCall(MatCreateSeqAIJ(PETSC_COMM_SELF, m, n, 12, NULL, &A));
+  PetscCall(AssembleMatrix(m, n, A));
+  PetscCall(MatConvert(A, MATSEQSELL, MAT_INITIAL_MATRIX, &B));
+  PetscCall(CheckProducts(A, B, "after conversion"));
+
+  /* the sorted copy of the values must follow changes that do not go through an assembly */
+  PetscCall(MatCreateVecs(A, &r, &l));
+  PetscCall(VecSetRandom(l, NULL));
+  PetscCall(VecSetRandom(r, NULL));
+  PetscCall(MatDiagonalScale(A, l, r));
+  PetscCall(MatDiagonalScale(B, l, r));
+  PetscCall(MatScale(A, -2.0));
+  PetscCall(MatScale(B, -2.0));
+  PetscCall(CheckProducts(A, B, "after scaling"));
+
+  /* new values with the same nonzero structure */
+  PetscCall(AssembleMatrix(m, n, A));
+  PetscCall(AssembleMatrix(m, n, B));
+  PetscCall(CheckProducts(A, B, "after reassembly"));
+
+  PetscCall(VecDestroy(&l));
+  PetscCall(VecDestroy(&r));
+  PetscCall(MatDestroy(&B));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+     output_file: output/empty.out
+     args: -mat_sell_slice_height {{3 8 16}} -mat_sell_sigma {{1 16 64}}
+
+     test:
+       suffix: auto
+
+     test:
+       suffix: generic
+       args: -mat_sell_kernel generic
+
+   test:
+     suffix: disable_cpu_features
+     args: -mat_sell_slice_height 8 -disable_cpu_features avx2,avx512f -info :mat
+     filter: grep "SpMV kernel"
+
+TEST*/
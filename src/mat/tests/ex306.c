@@ -0,0 +1,109 @@
+static char help[] = "Tests MATSEQAIJSINGLE against MATSEQAIJ.\n\n";
+
+#include <petscmat.h>
+
+/* Assembles the 5-point Laplacian on an n x n grid, scaled by 1/3 so that its values are not exactly representable in single precision */
+static PetscErrorCode AssembleMatrix(PetscInt n, Mat A)
+{
+  PetscFunctionBeginUser;
+  for (PetscInt i = 0; i < n * n; i++) {
+    PetscInt    cols[5], nc = 0;
+    PetscScalar v[5];
+
+    if (i >= n) cols[nc++] = i - n;
+    if (i % n) cols[nc++] = i - 1;
+    cols[nc++] = i;
+    if ((i + 1) % n) cols[nc++] = i + 1;
+    if (i + n < n * n) cols[nc++] = i + n;
+    for (PetscInt k = 0; k < nc; k++) v[k] = (cols[k] == i ? 4.0 : -1.0) / 3.0;
+    PetscCall(MatSetValues(A, 1, &i, nc, cols, v, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Checks that y and w agree to single precision relative to the norm of w */
+static PetscErrorCode CheckClose(Vec y, Vec w, const char *op)
+{
+  PetscReal nrm, err;
+
+  PetscFunctionBeginUser;
+  PetscCall(VecNorm(w, NORM_INFINITY, &nrm));
+  PetscCall(VecAXPY(y, -1.0, w));
+  PetscCall(VecNorm(y, NORM_INFINITY, &err));
+  PetscCheck(err <= 1.e-6 * nrm, PETSC_COMM_SELF, PETSC_ERR_PLIB, "%s differs from MATSEQAIJ by %g", op, (double)(err / nrm));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat         A, B;
+  Vec         x, y, w;
+  PetscInt    n = 20;
+  PetscBool   flg;
+  MatSORType  types[] = {SOR_FORWARD_SWEEP, SOR_BACKWARD_SWEEP, SOR_SYMMETRIC_SWEEP};
+  PetscRandom rctx;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+
+  PetscCall(MatCreateSeqAIJ(PETSC_COMM_SELF, n * n, n * n, 5, NULL, &A));
+  PetscCall(AssembleMatrix(n, A));
+  PetscCall(MatConvert(A, MATSEQAIJSINGLE, MAT_INITIAL_MATRIX, &B));
+  PetscCall(PetscObjectTypeCompare((PetscObject)B, MATSEQAIJSINGLE, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatConvert() did not produce a MATSEQAIJSINGLE matrix");
+
+  PetscCall(PetscRandomCreate(PETSC_COMM_SELF, &rctx));
+  PetscCall(MatCreateVecs(A, &x, &y));
+  PetscCall(VecDuplicate(y, &w));
+  PetscCall(VecSetRandom(x, rctx));
+
+  for (PetscInt pass = 0; pass < 2; pass++) {
+    PetscCall(MatMult(A, x, w));
+    PetscCall(MatMult(B, x, y));
+    PetscCall(CheckClose(y, w, "MatMult()"));
+
+    PetscCall(VecSetRandom(w, rctx));
+    PetscCall(VecCopy(w, y));
+    PetscCall(MatMultAdd(A, x, w, w));
+    PetscCall(MatMultAdd(B, x, y, y));
+    PetscCall(CheckClose(y, w, "MatMultAdd()"));
+
+    for (PetscInt k = 0; k < (PetscInt)PETSC_STATIC_ARRAY_LENGTH(types); k++) {
+      PetscCall(VecSet(w, 1.0));
+      PetscCall(VecSet(y, 1.0));
+      PetscCall(MatSOR(A, x, 1.2, types[k], 0.0, 2, 1, w));
+      PetscCall(MatSOR(B, x, 1.2, types[k], 0.0, 2, 1, y));
+      PetscCall(CheckClose(y, w, "MatSOR()"));
+      PetscCall(MatSOR(A, x, 1.0, (MatSORType)(types[k] | SOR_ZERO_INITIAL_GUESS), 0.0, 1, 1, w));
+      PetscCall(MatSOR(B, x, 1.0, (MatSORType)(types[k] | SOR_ZERO_INITIAL_GUESS), 0.0, 1, 1, y));
+      PetscCall(CheckClose(y, w, "MatSOR() with a zero initial guess"));
+    }
+
+    /* the single precision values must follow changes of the matrix */
+    PetscCall(MatScale(A, -2.0));
+    PetscCall(MatScale(B, -2.0));
+  }
+
+  PetscCall(VecDestroy(&w));
+  PetscCall(VecDestroy(&y));
+  PetscCall(VecDestroy(&x));
+  PetscCall(PetscRandomDestroy(&rctx));
+  PetscCall(MatDestroy(&B));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   build:
+     requires: !complex
+
+   test:
+     output_file: output/empty.out
+     args: -mat_seqaij_threads {{1 3}}
+
+TEST*/
@@ -0,0 +1,88 @@
+static char help[] = "Tests the 16-bit column offsets of MATSEQAIJ against the full column indices.\n\n";
+
+#include <petscmat.h>
+
+/*
+   Assembles a periodic tridiagonal matrix with n rows plus a few far entries, so that when n > 65536 the first and last rows
+   and every far-th row span too many columns for 16-bit offsets; the rows of every empty-th node are left empty
+*/
+static PetscErrorCode AssembleMatrix(PetscInt n, PetscInt far, PetscInt empty, Mat A)
+{
+  PetscFunctionBeginUser;
+  for (PetscInt i = 0; i < n; i++) {
+    PetscInt    cols[4], nc = 0;
+    PetscScalar v[4];
+
+    if (empty > 0 && i % empty == 0) continue;
+    cols[nc++] = (i + n - 1) % n;
+    cols[nc++] = i;
+    cols[nc++] = (i + 1) % n;
+    if (far > 0 && i % far == 1) cols[nc++] = (i + n / 2) % n;
+    for (PetscInt k = 0; k < nc; k++) v[k] = (PetscScalar)(1.0 + (i * 7 + k * 3) % 11) / (PetscScalar)(1.0 + k);
+    PetscCall(MatSetValues(A, 1, &i, nc, cols, v, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CreateMatrix(PetscInt n, const char prefix[], Mat *A)
+{
+  PetscFunctionBeginUser;
+  PetscCall(MatCreate(PETSC_COMM_SELF, A));
+  PetscCall(MatSetOptionsPrefix(*A, prefix));
+  PetscCall(MatSetSizes(*A, n, n, n, n));
+  PetscCall(MatSetType(*A, MATSEQAIJ));
+  PetscCall(MatSetFromOptions(*A));
+  PetscCall(MatSeqAIJSetPreallocation(*A, 4, NULL));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat       A, B;
+  PetscInt  n = 70000, far = 1000, empty = 0;
+  PetscBool flg;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-far", &far, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-empty", &empty, NULL));
+
+  /* only B is given -b_mat_seqaij_compressed_indices */
+  PetscCall(CreateMatrix(n, NULL, &A));
+  PetscCall(CreateMatrix(n, "b_", &B));
+  PetscCall(AssembleMatrix(n, far, empty, A));
+  PetscCall(AssembleMatrix(n, far, empty, B));
+
+  PetscCall(MatMultEqual(A, B, 3, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatMult() with 16-bit column offsets differs");
+  PetscCall(MatMultAddEqual(A, B, 3, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatMultAdd() with 16-bit column offsets differs");
+
+  /* a new nonzero structure rebuilds the offsets */
+  PetscCall(MatSetOption(A, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE));
+  PetscCall(MatSetOption(B, MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE));
+  PetscCall(MatSetValue(A, 2, n - 1, 1.0, INSERT_VALUES));
+  PetscCall(MatSetValue(B, 2, n - 1, 1.0, INSERT_VALUES));
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyBegin(B, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(B, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatMultEqual(A, B, 3, &flg));
+  PetscCheck(flg, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatMult() with 16-bit column offsets differs after a new nonzero structure");
+
+  PetscCall(MatDestroy(&B));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   test:
+     output_file: output/empty.out
+     args: -b_mat_seqaij_compressed_indices -empty {{0 2}} -b_mat_seqaij_threads {{1 3}}
+
+TEST*/
@@ -0,0 +1,119 @@
+static char help[] = "Tests the level and color schedules of MatSOR() for MATSEQAIJ.\n\n";
+
+#include <petscmat.h>
+
+/* Assembles the 5-point Laplacian on an n x n grid plus a few entries that make the nonzero structure nonsymmetric */
+static PetscErrorCode AssembleMatrix(PetscInt n, Mat A)
+{
+  PetscFunctionBeginUser;
+  for (PetscInt i = 0; i < n * n; i++) {
+    PetscInt    cols[6], nc = 0;
+    PetscScalar v[6];
+
+    if (i >= n) cols[nc++] = i - n;
+    if (i % n) cols[nc++] = i - 1;
+    cols[nc++] = i;
+    if ((i + 1) % n) cols[nc++] = i + 1;
+    if (i + n < n * n) cols[nc++] = i + n;
+    if (i % 7 == 3 && i + n + 1 < n * n) cols[nc++] = i + n + 1;
+    for (PetscInt k = 0; k < nc; k++) v[k] = cols[k] == i ? 4.5 : -1.0 / (1.0 + k % 2);
+    PetscCall(MatSetValues(A, 1, &i, nc, cols, v, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode CreateMatrix(PetscInt n, const char prefix[], Mat *A)
+{
+  PetscFunctionBeginUser;
+  PetscCall(MatCreate(PETSC_COMM_SELF, A));
+  PetscCall(MatSetOptionsPrefix(*A, prefix));
+  PetscCall(MatSetSizes(*A, n * n, n * n, n * n, n * n));
+  PetscCall(MatSetType(*A, MATSEQAIJ));
+  PetscCall(MatSetFromOptions(*A));
+  PetscCall(MatSeqAIJSetPreallocation(*A, 6, NULL));
+  PetscCall(AssembleMatrix(n, *A));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat         A, L, C1, C3;
+  Vec         b, x, y, z, r;
+  PetscInt    n = 30;
+  PetscReal   omega[] = {1.0, 1.3}, err, nrm;
+  MatSORType  types[] = {SOR_LOCAL_FORWARD_SWEEP, SOR_LOCAL_BACKWARD_SWEEP, SOR_LOCAL_SYMMETRIC_SWEEP};
+  PetscRandom rctx;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+
+  /* A uses the sequential sweeps, L the dependency levels and C1, C3 the colors with 1 and 3 threads */
+  PetscCall(CreateMatrix(n, NULL, &A));
+  PetscCall(CreateMatrix(n, "l_", &L));
+  PetscCall(CreateMatrix(n, "c1_", &C1));
+  PetscCall(CreateMatrix(n, "c3_", &C3));
+
+  PetscCall(PetscRandomCreate(PETSC_COMM_SELF, &rctx));
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecDuplicate(x, &y));
+  PetscCall(VecDuplicate(x, &z));
+  PetscCall(VecDuplicate(x, &r));
+  PetscCall(VecSetRandom(b, rctx));
+  for (PetscInt o = 0; o < (PetscInt)PETSC_STATIC_ARRAY_LENGTH(omega); o++) {
+    for (PetscInt k = 0; k < (PetscInt)PETSC_STATIC_ARRAY_LENGTH(types); k++) {
+      for (PetscInt zero = 0; zero < 2; zero++) {
+        const MatSORType type = zero ? (MatSORType)(types[k] | SOR_ZERO_INITIAL_GUESS) : types[k];
+
+        /* the levels reproduce the sequential sweeps exactly */
+        PetscCall(VecSet(x, 1.0));
+        PetscCall(VecSet(y, 1.0));
+        PetscCall(MatSOR(A, b, omega[o], type, 0.0, 2, 1, x));
+        PetscCall(MatSOR(L, b, omega[o], type, 0.0, 2, 1, y));
+        PetscCall(VecAXPY(y, -1.0, x));
+        PetscCall(VecNorm(y, NORM_INFINITY, &err));
+        PetscCheck(err == 0.0, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Level scheduled MatSOR() differs from the sequential one by %g", (double)err);
+
+        /* the colors do not depend on the number of threads */
+        PetscCall(VecSet(y, 1.0));
+        PetscCall(VecSet(z, 1.0));
+        PetscCall(MatSOR(C1, b, omega[o], type, 0.0, 2, 1, y));
+        PetscCall(MatSOR(C3, b, omega[o], type, 0.0, 2, 1, z));
+        PetscCall(VecAXPY(z, -1.0, y));
+        PetscCall(VecNorm(z, NORM_INFINITY, &err));
+        PetscCheck(err == 0.0, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Color scheduled MatSOR() depends on the number of threads, difference %g", (double)err);
+      }
+    }
+  }
+
+  /* the colored symmetric sweeps converge */
+  PetscCall(MatSOR(C3, b, 1.0, (MatSORType)(SOR_LOCAL_SYMMETRIC_SWEEP | SOR_ZERO_INITIAL_GUESS), 0.0, 200, 1, y));
+  PetscCall(MatResidual(C3, b, y, r));
+  PetscCall(VecNorm(r, NORM_2, &err));
+  PetscCall(VecNorm(b, NORM_2, &nrm));
+  PetscCheck(err < 1.e-8 * nrm, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Color scheduled MatSOR() does not converge, relative residual %g", (double)(err / nrm));
+
+  PetscCall(VecDestroy(&r));
+  PetscCall(VecDestroy(&z));
+  PetscCall(VecDestroy(&y));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(PetscRandomDestroy(&rctx));
+  PetscCall(MatDestroy(&C3));
+  PetscCall(MatDestroy(&C1));
+  PetscCall(MatDestroy(&L));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   test:
+     requires: double
+     output_file: output/empty.out
+     args: -l_mat_seqaij_sor_schedule levels -l_mat_seqaij_threads {{1 3}} -c1_mat_seqaij_sor_schedule colors -c3_mat_seqaij_sor_schedule colors -c3_mat_seqaij_threads 3
+
+TEST*/
@@ -0,0 +1,123 @@
+static char help[] = "Tests the level-scheduled MatSolve() of the MATSEQAIJ LU and ILU factors against the sequential one.\n\n";
+
+#include <petscmat.h>
+
+/* Assembles a convection-diffusion operator on an n x n grid, with a nonsymmetric upwind convection term */
+static PetscErrorCode AssembleMatrix(PetscInt n, PetscReal scale, Mat A)
+{
+  PetscFunctionBeginUser;
+  for (PetscInt i = 0; i < n * n; i++) {
+    PetscInt    cols[5], nc = 0;
+    PetscScalar v[5];
+
+    if (i >= n) {
+      cols[nc] = i - n;
+      v[nc++]  = -1.5;
+    }
+    if (i % n) {
+      cols[nc] = i - 1;
+      v[nc++]  = -1.25;
+    }
+    cols[nc] = i;
+    v[nc++]  = 4.0 + 1.0 / (1.0 + i % 7);
+    if ((i + 1) % n) {
+      cols[nc] = i + 1;
+      v[nc++]  = -0.75;
+    }
+    if (i + n < n * n) {
+      cols[nc] = i + n;
+      v[nc++]  = -0.5;
+    }
+    for (PetscInt k = 0; k < nc; k++) v[k] *= scale;
+    PetscCall(MatSetValues(A, 1, &i, nc, cols, v, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat           A, F, G;
+  Vec           b, x, y;
+  IS            rperm, cperm;
+  MatFactorInfo info;
+  MatFactorType ftype = MAT_FACTOR_ILU;
+  PetscInt      n = 30, levels = 0;
+  PetscReal     nrm, err;
+  PetscBool     lu = PETSC_FALSE;
+  char          ordering[256] = MATORDERINGNATURAL;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-levels", &levels, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-lu", &lu, NULL));
+  PetscCall(PetscOptionsGetString(NULL, NULL, "-ordering", ordering, sizeof(ordering), NULL));
+  if (lu) ftype = MAT_FACTOR_LU;
+
+  PetscCall(MatCreateSeqAIJ(PETSC_COMM_SELF, n * n, n * n, 5, NULL, &A));
+  PetscCall(AssembleMatrix(n, 1.0, A));
+  PetscCall(MatGetOrdering(A, ordering, &rperm, &cperm));
+  PetscCall(MatFactorInfoInitialize(&info));
+  info.levels = levels;
+  info.fill   = 2.0;
+
+  /* only G is given -l_mat_seqaij_solve_threads */
+  PetscCall(MatGetFactor(A, MATSOLVERPETSC, ftype, &F));
+  PetscCall(MatGetFactor(A, MATSOLVERPETSC, ftype, &G));
+  PetscCall(MatSetOptionsPrefix(G, "l_"));
+  if (lu) {
+    PetscCall(MatLUFactorSymbolic(F, A, rperm, cperm, &info));
+    PetscCall(MatLUFactorSymbolic(G, A, rperm, cperm, &info));
+  } else {
+    PetscCall(MatILUFactorSymbolic(F, A, rperm, cperm, &info));
+    PetscCall(MatILUFactorSymbolic(G, A, rperm, cperm, &info));
+  }
+
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecDuplicate(x, &y));
+  for (PetscInt pass = 0; pass < 2; pass++) {
+    PetscCall(MatLUFactorNumeric(F, A, &info));
+    PetscCall(MatLUFactorNumeric(G, A, &info));
+    /* the levels are reused by the solves with the same factorization */
+    for (PetscInt k = 0; k < 2; k++) {
+      PetscCall(VecSetRandom(b, NULL));
+      PetscCall(MatSolve(F, b, x));
+      PetscCall(MatSolve(G, b, y));
+      PetscCall(VecNorm(x, NORM_INFINITY, &nrm));
+      PetscCall(VecAXPY(y, -1.0, x));
+      PetscCall(VecNorm(y, NORM_INFINITY, &err));
+      PetscCheck(err <= 100 * PETSC_MACHINE_EPSILON * nrm, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Level-scheduled MatSolve() differs by %g", (double)(err / nrm));
+    }
+    /* new values with the same nonzero structure */
+    PetscCall(AssembleMatrix(n, -2.0, A));
+  }
+
+  PetscCall(VecDestroy(&y));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(ISDestroy(&rperm));
+  PetscCall(ISDestroy(&cperm));
+  PetscCall(MatDestroy(&G));
+  PetscCall(MatDestroy(&F));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+     output_file: output/empty.out
+     args: -l_mat_seqaij_solve_threads {{1 3}}
+
+     test:
+       suffix: ilu
+       args: -levels {{0 2}} -ordering {{natural rcm}}
+
+     test:
+       suffix: lu
+       args: -lu -ordering nd
+
+TEST*/
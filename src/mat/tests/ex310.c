@@ -0,0 +1,134 @@
+static char help[] = "Tests the iterative ILU and the Jacobi triangular solves of the MATSEQAIJ ILU factors against the standard ILU.\n\n";
+
+#include <petscmat.h>
+
+/* Assembles a convection-diffusion operator on an n x n grid, with a nonsymmetric upwind convection term */
+static PetscErrorCode AssembleMatrix(PetscInt n, PetscReal scale, Mat A)
+{
+  PetscFunctionBeginUser;
+  for (PetscInt i = 0; i < n * n; i++) {
+    PetscInt    cols[5], nc = 0;
+    PetscScalar v[5];
+
+    if (i >= n) {
+      cols[nc] = i - n;
+      v[nc++]  = -1.5;
+    }
+    if (i % n) {
+      cols[nc] = i - 1;
+      v[nc++]  = -1.25;
+    }
+    cols[nc] = i;
+    v[nc++]  = 4.0 + 1.0 / (1.0 + i % 7);
+    if ((i + 1) % n) {
+      cols[nc] = i + 1;
+      v[nc++]  = -0.75;
+    }
+    if (i + n < n * n) {
+      cols[nc] = i + n;
+      v[nc++]  = -0.5;
+    }
+    for (PetscInt k = 0; k < nc; k++) v[k] *= scale;
+    PetscCall(MatSetValues(A, 1, &i, nc, cols, v, INSERT_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat             A, F, G;
+  Vec             b, x, y;
+  IS              rperm, cperm;
+  const PetscInt *r, *c;
+  MatFactorInfo   info;
+  MatFactorError  ferr, gerr;
+  PetscInt        n = 12, levels = 0;
+  PetscReal       nrm, err, tol = 1.e-10;
+  char            ordering[256] = MATORDERINGNATURAL;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-levels", &levels, NULL));
+  PetscCall(PetscOptionsGetReal(NULL, NULL, "-tol", &tol, NULL));
+  PetscCall(PetscOptionsGetString(NULL, NULL, "-ordering", ordering, sizeof(ordering), NULL));
+
+  PetscCall(MatCreateSeqAIJ(PETSC_COMM_SELF, n * n, n * n, 5, NULL, &A));
+  PetscCall(AssembleMatrix(n, 1.0, A));
+  PetscCall(MatGetOrdering(A, ordering, &rperm, &cperm));
+  PetscCall(MatFactorInfoInitialize(&info));
+  info.levels = levels;
+  info.fill   = 2.0;
+
+  /* only G is given the -i_ options */
+  PetscCall(MatGetFactor(A, MATSOLVERPETSC, MAT_FACTOR_ILU, &F));
+  PetscCall(MatGetFactor(A, MATSOLVERPETSC, MAT_FACTOR_ILU, &G));
+  PetscCall(MatSetOptionsPrefix(G, "i_"));
+  PetscCall(MatILUFactorSymbolic(F, A, rperm, cperm, &info));
+  PetscCall(MatILUFactorSymbolic(G, A, rperm, cperm, &info));
+
+  PetscCall(MatCreateVecs(A, &x, &b));
+  PetscCall(VecDuplicate(x, &y));
+  for (PetscInt pass = 0; pass < 2; pass++) {
+    PetscCall(MatLUFactorNumeric(F, A, &info));
+    PetscCall(MatLUFactorNumeric(G, A, &info));
+    for (PetscInt k = 0; k < 2; k++) {
+      PetscCall(VecSetRandom(b, NULL));
+      PetscCall(MatSolve(F, b, x));
+      PetscCall(MatSolve(G, b, y));
+      PetscCall(VecNorm(x, NORM_INFINITY, &nrm));
+      PetscCall(VecAXPY(y, -1.0, x));
+      PetscCall(VecNorm(y, NORM_INFINITY, &err));
+      PetscCheck(err <= tol * nrm, PETSC_COMM_SELF, PETSC_ERR_PLIB, "MatSolve() differs from the standard ILU by %g", (double)(err / nrm));
+    }
+    /* new values with the same nonzero structure */
+    PetscCall(AssembleMatrix(n, -2.0, A));
+  }
+
+  /* a zero first pivot is reported by both factorizations */
+  PetscCall(ISGetIndices(rperm, &r));
+  PetscCall(ISGetIndices(cperm, &c));
+  PetscCall(MatSetValue(A, r[0], c[0], 0.0, INSERT_VALUES));
+  PetscCall(ISRestoreIndices(cperm, &c));
+  PetscCall(ISRestoreIndices(rperm, &r));
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatLUFactorNumeric(F, A, &info));
+  PetscCall(MatLUFactorNumeric(G, A, &info));
+  PetscCall(MatFactorGetError(F, &ferr));
+  PetscCall(MatFactorGetError(G, &gerr));
+  PetscCheck(ferr == MAT_FACTOR_NUMERIC_ZEROPIVOT && gerr == MAT_FACTOR_NUMERIC_ZEROPIVOT, PETSC_COMM_SELF, PETSC_ERR_PLIB, "Zero pivot not detected");
+
+  PetscCall(VecDestroy(&y));
+  PetscCall(VecDestroy(&x));
+  PetscCall(VecDestroy(&b));
+  PetscCall(ISDestroy(&rperm));
+  PetscCall(ISDestroy(&cperm));
+  PetscCall(MatDestroy(&G));
+  PetscCall(MatDestroy(&F));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+     output_file: output/empty.out
+     args: -levels {{0 1}} -ordering {{natural rcm}} -i_mat_seqaij_solve_threads {{1 3}}
+
+     test:
+       suffix: sweeps
+       args: -i_mat_seqaij_ilu_sweeps 40
+
+     test:
+       suffix: jacobi
+       args: -i_mat_seqaij_ilu_jacobi_its 60
+
+     test:
+       suffix: both
+       args: -i_mat_seqaij_ilu_sweeps 40 -i_mat_seqaij_ilu_jacobi_its 60
+
+TEST*/
@@ -0,0 +1,127 @@
+static char help[] = "Tests MatSetValues() and MatSetValuesBlocked() with MAT_CONCURRENT_SET_VALUES from several threads against the serial assembly.\n\n";
+
+#include <petscmat.h>
+
+/*
+   Adds the bilinear element e = (ex, ey) of an n x n grid of elements with bs unknowns per node, only the rows in [rstart, rend)
+   owned by this process are set. Without PetscFunctionBeginUser and PetscCall() so that the threads of a parallel region can call it
+*/
+static PetscErrorCode AddElement(Mat A, PetscInt n, PetscInt bs, PetscBool blocked, PetscInt rstart, PetscInt rend, PetscInt ex, PetscInt ey)
+{
+  PetscInt    nodes[4], rows[4 * 16], cols[4 * 16];
+  PetscScalar v[16 * 16 * 16];
+
+  nodes[0] = ey * (n + 1) + ex;
+  nodes[1] = nodes[0] + 1;
+  nodes[2] = nodes[0] + n + 1;
+  nodes[3] = nodes[2] + 1;
+  for (PetscInt i = 0; i < 4 * bs; i++) {
+    cols[i] = nodes[i / bs] * bs + i % bs;
+    rows[i] = cols[i] >= rstart && cols[i] < rend ? cols[i] : -1;
+    for (PetscInt j = 0; j < 4 * bs; j++) v[i * 4 * bs + j] = (i == j ? 4.0 : -1.0) * (1.0 + 0.1 * ((ex + 3 * ey) % 5)) + 0.01 * (i - j);
+  }
+  if (!blocked) return MatSetValues(A, 4 * bs, rows, 4 * bs, cols, v, ADD_VALUES);
+  for (PetscInt i = 0; i < 4; i++) {
+    cols[i] = nodes[i];
+    rows[i] = rows[i * bs] < 0 ? -1 : nodes[i];
+  }
+  return MatSetValuesBlocked(A, 4, rows, 4, cols, v, ADD_VALUES);
+}
+
+int main(int argc, char **argv)
+{
+  Mat       A, B;
+  PetscInt  n = 16, bs = 1, nthreads = 1, rstart, rend;
+  PetscBool blocked = PETSC_FALSE;
+  PetscReal nrm, err;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-bs", &bs, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nthreads", &nthreads, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-blocked", &blocked, NULL));
+  PetscCheck(bs >= 1 && bs <= 16, PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE, "Block size must be between 1 and 16");
+
+  PetscCall(MatCreate(PETSC_COMM_WORLD, &A));
+  PetscCall(MatSetSizes(A, PETSC_DECIDE, PETSC_DECIDE, (n + 1) * (n + 1) * bs, (n + 1) * (n + 1) * bs));
+  PetscCall(MatSetBlockSize(A, bs));
+  PetscCall(MatSetFromOptions(A));
+  PetscCall(MatSeqAIJSetPreallocation(A, 9 * bs, NULL));
+  PetscCall(MatMPIAIJSetPreallocation(A, 9 * bs, NULL, 9 * bs, NULL));
+  PetscCall(MatSeqBAIJSetPreallocation(A, bs, 9, NULL));
+  PetscCall(MatGetOwnershipRange(A, &rstart, &rend));
+  for (PetscInt e = 0; e < n * n; e++) PetscCall(AddElement(A, n, bs, blocked, rstart, rend, e % n, e / n));
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatNorm(A, NORM_FROBENIUS, &nrm));
+
+  PetscCall(MatDuplicate(A, MAT_DO_NOT_COPY_VALUES, &B));
+  PetscCall(MatSetOption(B, MAT_CONCURRENT_SET_VALUES, PETSC_TRUE));
+  for (PetscInt pass = 0; pass < 2; pass++) {
+    int nerr = 0;
+
+    /* the elements of each thread share nodes with the elements of the other threads */
+    PetscPragmaOMP(parallel for num_threads((int)nthreads) schedule(static, 1) reduction(+ : nerr))
+    for (PetscInt e = 0; e < n * n; e++) nerr += AddElement(B, n, bs, blocked, rstart, rend, e % n, e / n) ? 1 : 0;
+    PetscCheck(!nerr, PETSC_COMM_SELF, PETSC_ERR_LIB, "Setting the values of %d elements failed", nerr);
+    PetscCall(MatAssemblyBegin(B, MAT_FINAL_ASSEMBLY));
+    PetscCall(MatAssemblyEnd(B, MAT_FINAL_ASSEMBLY));
+    PetscCall(MatAXPY(B, -1.0, A, SAME_NONZERO_PATTERN));
+    PetscCall(MatNorm(B, NORM_FROBENIUS, &err));
+    PetscCheck(err <= 100 * PETSC_MACHINE_EPSILON * nrm, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "Concurrent assembly differs from the serial assembly by %g", (double)(err / nrm));
+    PetscCall(MatZeroEntries(B));
+  }
+
+  PetscCall(MatDestroy(&B));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   build:
+     requires: openmp
+
+   testset:
+     output_file: output/empty.out
+     args: -blocked {{0 1}}
+
+     test:
+       suffix: aij
+       args: -bs {{1 3}}
+
+     test:
+       suffix: baij
+       args: -mat_type baij -bs {{1 3}}
+
+     test:
+       suffix: mpiaij
+       nsize: 2
+       args: -mat_type aij -bs 2
+
+   test:
+     suffix: dense_unsupported
+     args: -mat_type dense -petsc_ci_portable_error_output -error_output_stdout
+     filter: grep -F MAT_CONCURRENT_SET_VALUES
+
+   testset:
+     requires: threadsafety
+     output_file: output/empty.out
+     args: -blocked {{0 1}} -nthreads 3
+
+     test:
+       suffix: aij_threads
+       args: -bs {{1 3}}
+
+     test:
+       suffix: baij_threads
+       args: -mat_type baij -bs 3
+
+     test:
+       suffix: mpiaij_threads
+       nsize: 2
+       args: -mat_type aij -bs 2
+
+TEST*/
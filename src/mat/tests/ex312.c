@@ -0,0 +1,112 @@
+static char help[] = "Tests flushing the stash to the owners during assembly with -matstash_flush_size against the assembly without flushing.\n\n";
+
+#include <petscmat.h>
+
+/*
+   Sets the bilinear element e = (ex, ey) of an n x n grid of elements with bs unknowns per node, most of its rows may belong to other processes
+*/
+static PetscErrorCode SetElement(Mat A, PetscInt n, PetscInt bs, PetscBool blocked, PetscInt ex, PetscInt ey, InsertMode mode)
+{
+  PetscInt    nodes[4], idx[4 * 4];
+  PetscScalar v[16 * 4 * 4];
+
+  PetscFunctionBeginUser;
+  nodes[0] = ey * (n + 1) + ex;
+  nodes[1] = nodes[0] + 1;
+  nodes[2] = nodes[0] + n + 1;
+  nodes[3] = nodes[2] + 1;
+  for (PetscInt i = 0; i < 4 * bs; i++) {
+    idx[i] = nodes[i / bs] * bs + i % bs;
+    /* inserted values only depend on the location, so that all processes insert the same value */
+    for (PetscInt j = 0; j < 4 * bs; j++) v[i * 4 * bs + j] = mode == ADD_VALUES ? (i == j ? 4.0 : -1.0) * (1.0 + 0.1 * ((ex + 3 * ey) % 5)) + 0.01 * (i - j) : 1.0 + 0.001 * (nodes[i / bs] * bs + i % bs) - 0.002 * (nodes[j / bs] * bs + j % bs);
+  }
+  if (blocked) PetscCall(MatSetValuesBlocked(A, 4, nodes, 4, nodes, v, mode));
+  else PetscCall(MatSetValues(A, 4 * bs, idx, 4 * bs, idx, v, mode));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+   Each process sets the elements of a contiguous range that is shifted by a third of the range, so that many rows go to the other processes
+*/
+static PetscErrorCode Assemble(Mat A, PetscInt n, PetscInt bs, PetscBool blocked, InsertMode mode)
+{
+  PetscMPIInt rank, size;
+  PetscInt    ne = n * n, estart, eend;
+
+  PetscFunctionBeginUser;
+  PetscCallMPI(MPI_Comm_rank(PetscObjectComm((PetscObject)A), &rank));
+  PetscCallMPI(MPI_Comm_size(PetscObjectComm((PetscObject)A), &size));
+  estart = (rank * ne) / size + ne / (3 * size);
+  eend   = ((rank + 1) * ne) / size + ne / (3 * size);
+  for (PetscInt e = estart; e < eend; e++) PetscCall(SetElement(A, n, bs, blocked, (e % ne) % n, (e % ne) / n, mode));
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat        A[2], D;
+  PetscInt   n = 12, bs = 1, flushsize = 10;
+  PetscBool  blocked = PETSC_FALSE;
+  PetscReal  nrm, err;
+  char       flush[32];
+  InsertMode modes[3] = {ADD_VALUES, ADD_VALUES, INSERT_VALUES};
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-bs", &bs, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-flush_size", &flushsize, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-blocked", &blocked, NULL));
+  PetscCheck(bs >= 1 && bs <= 4, PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE, "Block size must be between 1 and 4");
+
+  for (PetscInt k = 0; k < 2; k++) {
+    if (k) { /* the option is read when the stash is created */
+      PetscCall(PetscSNPrintf(flush, sizeof(flush), "%" PetscInt_FMT, flushsize));
+      PetscCall(PetscOptionsSetValue(NULL, "-matstash_flush_size", flush));
+    }
+    PetscCall(MatCreate(PETSC_COMM_WORLD, &A[k]));
+    PetscCall(MatSetSizes(A[k], PETSC_DECIDE, PETSC_DECIDE, (n + 1) * (n + 1) * bs, (n + 1) * (n + 1) * bs));
+    PetscCall(MatSetBlockSize(A[k], bs));
+    PetscCall(MatSetFromOptions(A[k]));
+    PetscCall(MatSetUp(A[k]));
+    PetscCall(MatSetOption(A[k], MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE));
+  }
+  /* two assemblies with ADD_VALUES, so that the stash is reused after a flush, then one with INSERT_VALUES */
+  for (PetscInt pass = 0; pass < 3; pass++) {
+    for (PetscInt k = 0; k < 2; k++) PetscCall(Assemble(A[k], n, bs, blocked, modes[pass]));
+    PetscCall(MatNorm(A[0], NORM_FROBENIUS, &nrm));
+    PetscCall(MatDuplicate(A[1], MAT_COPY_VALUES, &D));
+    PetscCall(MatAXPY(D, -1.0, A[0], UNKNOWN_NONZERO_PATTERN));
+    PetscCall(MatNorm(D, NORM_FROBENIUS, &err));
+    PetscCheck(err <= 100 * PETSC_MACHINE_EPSILON * nrm, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "Assembly %" PetscInt_FMT " with -matstash_flush_size differs from the assembly without it by %g", pass, (double)(err / nrm));
+    PetscCall(MatDestroy(&D));
+  }
+
+  PetscCall(MatDestroy(&A[1]));
+  PetscCall(MatDestroy(&A[0]));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+     nsize: 3
+     output_file: output/empty.out
+     args: -blocked {{0 1}}
+
+     test:
+       suffix: aij
+       args: -mat_type aij -bs {{1 2}}
+
+     test:
+       suffix: baij
+       args: -mat_type baij -bs 3 -flush_size 50
+
+     test:
+       suffix: sbaij
+       args: -mat_type sbaij -bs 2 -mat_ignore_lower_triangular
+
+TEST*/
@@ -0,0 +1,125 @@
+static char help[] = "Tests -mat_aij_detect_block_size, which converts an AIJ matrix with a uniform block structure to BAIJ at its first assembly.\n\n";
+
+#include <petscmat.h>
+
+/*
+   Adds the bilinear element e = (ex, ey) of an n x n grid of elements with bs unknowns per node, the entries of the
+   blocks are all set unless scalar is true, then only the entries coupling the same component are set
+*/
+static PetscErrorCode AddElement(Mat A, PetscInt n, PetscInt bs, PetscBool scalar, PetscInt ex, PetscInt ey)
+{
+  PetscInt    nodes[4], idx[4 * 16];
+  PetscScalar v[16 * 16 * 16];
+
+  PetscFunctionBeginUser;
+  nodes[0] = ey * (n + 1) + ex;
+  nodes[1] = nodes[0] + 1;
+  nodes[2] = nodes[0] + n + 1;
+  nodes[3] = nodes[2] + 1;
+  for (PetscInt i = 0; i < 4 * bs; i++) {
+    idx[i] = nodes[i / bs] * bs + i % bs;
+    for (PetscInt j = 0; j < 4 * bs; j++) v[i * 4 * bs + j] = scalar && i % bs != j % bs ? 0.0 : (i == j ? 4.0 : -1.0) * (1.0 + 0.1 * ((ex + 3 * ey) % 5)) + 0.01 * (i - j);
+  }
+  if (scalar) {
+    for (PetscInt i = 0; i < 4 * bs; i++) {
+      for (PetscInt j = 0; j < 4 * bs; j++) {
+        if (i % bs == j % bs) PetscCall(MatSetValue(A, idx[i], idx[j], v[i * 4 * bs + j], ADD_VALUES));
+      }
+    }
+  } else PetscCall(MatSetValues(A, 4 * bs, idx, 4 * bs, idx, v, ADD_VALUES));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+static PetscErrorCode Assemble(Mat A, PetscInt n, PetscInt bs, PetscBool scalar)
+{
+  PetscMPIInt rank, size;
+
+  PetscFunctionBeginUser;
+  PetscCallMPI(MPI_Comm_rank(PetscObjectComm((PetscObject)A), &rank));
+  PetscCallMPI(MPI_Comm_size(PetscObjectComm((PetscObject)A), &size));
+  for (PetscInt e = (rank * n * n) / size; e < ((rank + 1) * n * n) / size; e++) PetscCall(AddElement(A, n, bs, scalar, e % n, e / n));
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat       A[2];
+  Vec       x, y[2];
+  PetscInt  n = 6, bs = 3, nnodes = PETSC_DECIDE, Nnodes, mbs, rbs;
+  PetscBool scalar = PETSC_FALSE;
+  PetscReal nrm, err;
+  MatType   type;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-bs", &bs, NULL));
+  PetscCall(PetscOptionsGetBool(NULL, NULL, "-scalar", &scalar, NULL));
+  PetscCheck(bs >= 1 && bs <= 16, PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE, "Block size must be between 1 and 16");
+
+  /* the ownership ranges follow the nodes, but no block size is set: A[0] has the prefix detect_ */
+  Nnodes = (n + 1) * (n + 1);
+  PetscCall(PetscSplitOwnership(PETSC_COMM_WORLD, &nnodes, &Nnodes));
+  for (PetscInt k = 0; k < 2; k++) {
+    PetscCall(MatCreate(PETSC_COMM_WORLD, &A[k]));
+    PetscCall(MatSetSizes(A[k], nnodes * bs, nnodes * bs, PETSC_DETERMINE, PETSC_DETERMINE));
+    if (!k) PetscCall(MatSetOptionsPrefix(A[k], "detect_"));
+    PetscCall(MatSetFromOptions(A[k]));
+    PetscCall(MatSetUp(A[k]));
+    PetscCall(MatSetOption(A[k], MAT_NEW_NONZERO_ALLOCATION_ERR, PETSC_FALSE));
+  }
+  PetscCall(MatCreateVecs(A[1], &x, &y[1]));
+  PetscCall(VecDuplicate(y[1], &y[0]));
+  PetscCall(VecSetRandom(x, NULL));
+
+  /* the second assembly sets values into the converted matrix */
+  for (PetscInt pass = 0; pass < 2; pass++) {
+    for (PetscInt k = 0; k < 2; k++) {
+      PetscCall(Assemble(A[k], n, bs, scalar));
+      PetscCall(MatMult(A[k], x, y[k]));
+    }
+    PetscCall(MatGetType(A[0], &type));
+    PetscCall(MatGetBlockSize(A[0], &mbs));
+    PetscCall(MatGetBlockSize(A[1], &rbs));
+    PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Assembly %" PetscInt_FMT ": type %s, block size %" PetscInt_FMT ", block size without detection %" PetscInt_FMT "\n", pass, type, mbs, rbs));
+    PetscCall(VecNorm(y[1], NORM_2, &nrm));
+    PetscCall(VecAXPY(y[0], -1.0, y[1]));
+    PetscCall(VecNorm(y[0], NORM_2, &err));
+    PetscCheck(err <= 100 * PETSC_MACHINE_EPSILON * nrm, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "MatMult() differs from the one without detection by %g", (double)(err / nrm));
+  }
+
+  PetscCall(VecDestroy(&y[1]));
+  PetscCall(VecDestroy(&y[0]));
+  PetscCall(VecDestroy(&x));
+  PetscCall(MatDestroy(&A[1]));
+  PetscCall(MatDestroy(&A[0]));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+     args: -detect_mat_aij_detect_block_size
+
+     test:
+       suffix: seq
+       args: -bs 3
+
+     test:
+       suffix: seq_scalar
+       args: -bs 3 -scalar
+
+     test:
+       suffix: mpi
+       nsize: 2
+       args: -bs 5
+
+     test:
+       suffix: mpi_scalar
+       nsize: 2
+       args: -bs 2 -scalar
+
+TEST*/
@@ -0,0 +1,155 @@
+static char help[] = "Tests MATAIJVBR, the AIJ matrix with a variable block row copy, on a chain of nodes with 3 and 4 unknowns.\n\n";
+
+#include <petscksp.h>
+
+/* the first unknown of node i, the nodes alternate between 3 and 4 unknowns */
+static PetscInt NodeStart(PetscInt i)
+{
+  return 3 * i + i / 2;
+}
+
+/*
+   dense blocks couple each node to itself, to its neighbors and to the nodes at distance 5, so that ILU(0) is not exact;
+   the diagonal blocks are nonsymmetric and dominant
+*/
+static PetscErrorCode Assemble(Mat A, PetscInt nstart, PetscInt nend, PetscInt N)
+{
+  const PetscInt offsets[] = {-5, -1, 0, 1, 5};
+  PetscInt       rows[4], cols[4];
+  PetscScalar    v[16];
+
+  PetscFunctionBeginUser;
+  for (PetscInt i = nstart; i < nend; i++) {
+    const PetscInt m = NodeStart(i + 1) - NodeStart(i);
+
+    for (PetscInt r = 0; r < m; r++) rows[r] = NodeStart(i) + r;
+    for (PetscInt o = 0; o < 5; o++) {
+      const PetscInt j = i + offsets[o], n = NodeStart(j + 1) - NodeStart(j);
+
+      if (j < 0 || j >= N) continue;
+
+      for (PetscInt c = 0; c < n; c++) cols[c] = NodeStart(j) + c;
+      for (PetscInt r = 0; r < m; r++) {
+        for (PetscInt c = 0; c < n; c++) v[r * n + c] = i == j ? (r == c ? 6.0 + 0.1 * (i % 7) : 0.5 + 0.1 * (r - c)) : -0.25 - 0.05 * ((r + c + i) % 3);
+      }
+      PetscCall(MatSetValues(A, m, rows, n, cols, v, INSERT_VALUES));
+    }
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat                A[2];
+  Vec                x, b, y[2];
+  KSP                ksp;
+  PetscInt           N = 24, n = PETSC_DECIDE, nstart, *bsizes, its;
+  PetscReal          nrm, err;
+  KSPConvergedReason reason;
+  MatType            type;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &N, NULL));
+  PetscCall(PetscSplitOwnership(PETSC_COMM_WORLD, &n, &N));
+  PetscCallMPI(MPI_Scan(&n, &nstart, 1, MPIU_INT, MPI_SUM, PETSC_COMM_WORLD));
+  nstart -= n;
+  PetscCall(PetscMalloc1(n, &bsizes));
+  for (PetscInt i = 0; i < n; i++) bsizes[i] = NodeStart(nstart + i + 1) - NodeStart(nstart + i);
+
+  /* A[0] has the type given with -mat_type, A[1] is the MATAIJ reference */
+  for (PetscInt k = 0; k < 2; k++) {
+    PetscCall(MatCreate(PETSC_COMM_WORLD, &A[k]));
+    PetscCall(MatSetSizes(A[k], NodeStart(nstart + n) - NodeStart(nstart), NodeStart(nstart + n) - NodeStart(nstart), PETSC_DETERMINE, PETSC_DETERMINE));
+    if (k) PetscCall(MatSetType(A[k], MATAIJ));
+    else PetscCall(MatSetFromOptions(A[k]));
+    PetscCall(MatSeqAIJSetPreallocation(A[k], 20, NULL));
+    PetscCall(MatMPIAIJSetPreallocation(A[k], 20, NULL, 12, NULL));
+    PetscCall(MatSetVariableBlockSizes(A[k], n, bsizes));
+    PetscCall(Assemble(A[k], nstart, nstart + n, N));
+  }
+  PetscCall(PetscFree(bsizes));
+  PetscCall(MatGetType(A[0], &type));
+  PetscCall(PetscPrintf(PETSC_COMM_WORLD, "Matrix type %s\n", type));
+
+  /* the second pass checks that the values are updated after MatScale() */
+  PetscCall(MatCreateVecs(A[1], &x, &b));
+  PetscCall(VecDuplicate(b, &y[0]));
+  PetscCall(VecDuplicate(b, &y[1]));
+  PetscCall(VecSetRandom(x, NULL));
+  PetscCall(VecSetRandom(b, NULL));
+  for (PetscInt pass = 0; pass < 2; pass++) {
+    for (PetscInt k = 0; k < 2; k++) PetscCall(MatMult(A[k], x, y[k]));
+    PetscCall(VecNorm(y[1], NORM_2, &nrm));
+    PetscCall(VecAXPY(y[0], -1.0, y[1]));
+    PetscCall(VecNorm(y[0], NORM_2, &err));
+    PetscCheck(err <= 100 * PETSC_MACHINE_EPSILON * nrm, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "MatMult() differs from MATAIJ by %g", (double)(err / nrm));
+    for (PetscInt k = 0; k < 2; k++) PetscCall(MatMultAdd(A[k], x, b, y[k]));
+    PetscCall(VecNorm(y[1], NORM_2, &nrm));
+    PetscCall(VecAXPY(y[0], -1.0, y[1]));
+    PetscCall(VecNorm(y[0], NORM_2, &err));
+    PetscCheck(err <= 100 * PETSC_MACHINE_EPSILON * nrm, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "MatMultAdd() differs from MATAIJ by %g", (double)(err / nrm));
+    for (PetscInt k = 0; k < 2; k++) PetscCall(MatScale(A[k], 2.0));
+  }
+
+  /* the preconditioner is set with the options, the block relaxation and ILU(0) use the blocks */
+  PetscCall(KSPCreate(PETSC_COMM_WORLD, &ksp));
+  PetscCall(KSPSetOperators(ksp, A[0], A[0]));
+  PetscCall(KSPSetTolerances(ksp, 1.e-10, PETSC_CURRENT, PETSC_CURRENT, PETSC_CURRENT));
+  PetscCall(KSPSetFromOptions(ksp));
+  PetscCall(KSPSolve(ksp, b, x));
+  PetscCall(KSPGetConvergedReason(ksp, &reason));
+  PetscCall(KSPGetIterationNumber(ksp, &its));
+  PetscCall(MatMult(A[1], x, y[1]));
+  PetscCall(VecAXPY(y[1], -1.0, b));
+  PetscCall(VecNorm(y[1], NORM_2, &err));
+  PetscCall(VecNorm(b, NORM_2, &nrm));
+  PetscCheck(err <= 1.e-8 * nrm, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "The relative residual %g of the solution is too large", (double)(err / nrm));
+  PetscCall(PetscPrintf(PETSC_COMM_WORLD, "%s in %" PetscInt_FMT " iterations\n", KSPConvergedReasons[reason], its));
+
+  PetscCall(KSPDestroy(&ksp));
+  PetscCall(VecDestroy(&y[1]));
+  PetscCall(VecDestroy(&y[0]));
+  PetscCall(VecDestroy(&b));
+  PetscCall(VecDestroy(&x));
+  PetscCall(MatDestroy(&A[1]));
+  PetscCall(MatDestroy(&A[0]));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+     args: -mat_type aijvbr -info :mat
+     filter: grep -v "^\[1\]" | grep -e "Matrix type" -e CONVERGED -e "Using the ILU" -e "diagonal blocks"
+
+     test:
+       suffix: seq_sor
+       args: -pc_type sor
+
+     test:
+       suffix: seq_ssor
+       args: -pc_type sor -pc_sor_symmetric -pc_sor_its 2 -pc_sor_omega 0.9
+
+     test:
+       suffix: seq_ilu
+       args: -pc_type ilu
+
+     test:
+       suffix: seq_ilu_rcm
+       args: -pc_type ilu -pc_factor_mat_ordering_type rcm
+
+     test:
+       suffix: mpi_ilu
+       nsize: 2
+       args: -pc_type bjacobi -sub_pc_type ilu
+
+     test:
+       suffix: mpi_sor
+       nsize: 2
+       args: -pc_type sor -pc_sor_local_symmetric
+
+TEST*/
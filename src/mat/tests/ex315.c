@@ -0,0 +1,109 @@
+static char help[] = "Tests MatMultPowers() against repeated MatMult().\n\n";
+
+#include <petscmat.h>
+
+/* Computes the basis with MatMult() and compares it with y */
+static PetscErrorCode CheckPowers(Mat A, Vec x, PetscInt s, const PetscScalar alpha[], const PetscScalar beta[], const PetscScalar gamma[], Vec y[], const char name[])
+{
+  Vec *z;
+
+  PetscFunctionBeginUser;
+  PetscCall(VecDuplicateVecs(x, s + 1, &z));
+  PetscCall(VecCopy(x, z[0]));
+  for (PetscInt k = 0; k < s; k++) {
+    PetscReal nrm, err;
+
+    PetscCall(MatMult(A, z[k], z[k + 1]));
+    if (alpha) PetscCall(VecAXPY(z[k + 1], -alpha[k], z[k]));
+    if (beta && k > 0) PetscCall(VecAXPY(z[k + 1], -beta[k], z[k - 1]));
+    if (gamma) PetscCall(VecScale(z[k + 1], 1.0 / gamma[k]));
+    PetscCall(VecNorm(z[k + 1], NORM_INFINITY, &nrm));
+    PetscCall(VecAXPY(z[k + 1], -1.0, y[k]));
+    PetscCall(VecNorm(z[k + 1], NORM_INFINITY, &err));
+    PetscCheck(err <= 100 * PETSC_MACHINE_EPSILON * nrm, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "%s basis: vector %" PetscInt_FMT " differs by %g", name, k + 1, (double)err);
+    PetscCall(VecCopy(y[k], z[k + 1]));
+  }
+  PetscCall(VecDestroyVecs(s + 1, &z));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+int main(int argc, char **argv)
+{
+  Mat          A;
+  Vec          x, *y;
+  PetscInt     m = 8, s = 3, rstart, rend, N;
+  PetscScalar *alpha, *beta, *gamma;
+  PetscRandom  rand;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-m", &m, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-s", &s, NULL));
+  N = m * m;
+
+  /* a nonsymmetric 5-point stencil on an m by m grid with a long-range coupling */
+  PetscCall(MatCreateAIJ(PETSC_COMM_WORLD, PETSC_DECIDE, PETSC_DECIDE, N, N, 6, NULL, 6, NULL, &A));
+  PetscCall(MatGetOwnershipRange(A, &rstart, &rend));
+  for (PetscInt row = rstart; row < rend; row++) {
+    const PetscInt i = row / m, j = row % m;
+
+    if (i > 0) PetscCall(MatSetValue(A, row, row - m, -1.0, ADD_VALUES));
+    if (i < m - 1) PetscCall(MatSetValue(A, row, row + m, -1.5, ADD_VALUES));
+    if (j > 0) PetscCall(MatSetValue(A, row, row - 1, -0.5, ADD_VALUES));
+    if (j < m - 1) PetscCall(MatSetValue(A, row, row + 1, -1.25, ADD_VALUES));
+    PetscCall(MatSetValue(A, row, (row * 7 + 3) % N, 0.25, ADD_VALUES));
+    PetscCall(MatSetValue(A, row, row, 4.0 + (PetscReal)(row % 3), ADD_VALUES));
+  }
+  PetscCall(MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY));
+  PetscCall(MatAssemblyEnd(A, MAT_FINAL_ASSEMBLY));
+
+  PetscCall(MatCreateVecs(A, &x, NULL));
+  PetscCall(PetscRandomCreate(PETSC_COMM_WORLD, &rand));
+  PetscCall(PetscRandomSetFromOptions(rand));
+  PetscCall(VecSetRandom(x, rand));
+  PetscCall(PetscRandomDestroy(&rand));
+  PetscCall(VecDuplicateVecs(x, s, &y));
+  PetscCall(PetscMalloc3(s, &alpha, s, &beta, s, &gamma));
+  for (PetscInt k = 0; k < s; k++) {
+    alpha[k] = 5.0 + 2.0 * PetscCosReal(PETSC_PI * (k + 0.5) / s);
+    beta[k]  = 2.0;
+    gamma[k] = k ? 2.0 : 4.0;
+  }
+
+  PetscCall(MatMultPowers(A, x, s, NULL, NULL, NULL, y));
+  PetscCall(CheckPowers(A, x, s, NULL, NULL, NULL, y, "monomial"));
+  PetscCall(MatMultPowers(A, x, s, alpha, NULL, NULL, y));
+  PetscCall(CheckPowers(A, x, s, alpha, NULL, NULL, y, "Newton"));
+  PetscCall(MatMultPowers(A, x, s, alpha, beta, gamma, y));
+  PetscCall(CheckPowers(A, x, s, alpha, beta, gamma, y, "Chebyshev"));
+
+  /* new values with the same nonzero structure, then a smaller depth */
+  PetscCall(MatShift(A, 1.0));
+  PetscCall(MatMultPowers(A, x, s, alpha, NULL, NULL, y));
+  PetscCall(CheckPowers(A, x, s, alpha, NULL, NULL, y, "Newton after MatShift()"));
+  PetscCall(MatMultPowers(A, x, s - 1, NULL, NULL, NULL, y));
+  PetscCall(CheckPowers(A, x, s - 1, NULL, NULL, NULL, y, "monomial of lower degree"));
+
+  PetscCall(PetscFree3(alpha, beta, gamma));
+  PetscCall(VecDestroyVecs(s, &y));
+  PetscCall(VecDestroy(&x));
+  PetscCall(MatDestroy(&A));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   test:
+     suffix: aij
+     output_file: output/empty.out
+     nsize: {{1 2 3}}
+     args: -s {{1 2 4}}
+
+   test:
+     suffix: deep
+     output_file: output/empty.out
+     nsize: {{2 4}}
+     args: -m 5 -s 6
+
+TEST*/
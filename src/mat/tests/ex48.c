@@ -243,6 +243,11 @@ int main(int argc, char **args)
 /*TEST
 
    test:
-      args: -mat_block_size {{1 2 3 4 5 6 7 8}}
+      args: -mat_block_size {{1 2 3 4 5 6 7 8 9 10 13 14 15 16}}
+
+   test:
+      suffix: disable_cpu_features
+      args: -mat_block_size 12 -mat_baij_mult_version 3 -disable_cpu_features avx2,avx512f -info :mat
+      filter: grep -e "MatMult for BAIJ" -e Error -e "not equal"
 
 TEST*/
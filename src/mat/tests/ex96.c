@@ -271,6 +271,11 @@ int main(int argc, char **argv)
       args: -Mx 10 -My 5 -Mz 10
       output_file: output/ex96_1.out
 
+   test:
+      suffix: seq_threaded
+      args: -Mx 10 -My 5 -Mz 10 -matptap_via threaded -mat_seqaij_threads {{1 3}}
+      output_file: output/ex96_1.out
+
    test:
       suffix: nonscalable
       nsize: 3
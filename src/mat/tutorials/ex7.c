@@ -169,20 +169,20 @@ int main(int argc, char **argv)
       requires: defined(PETSC_USE_INFO) !defined(PETSC_HAVE_THREADSAFETY)
       suffix: 1
       args: -info
-      filter: grep -h -ve Running -ve communicator -ve MPI_Comm -ve OpenMP -ve PetscGetHostName -ve PetscSetFPTrap -ve PetscDetermineInitialFPTrap -ve libpetscbamg -ve PetscDeviceContext -ve PetscDeviceType -ve BLAS -ve PetscDeviceInitializeTypeFromOptions_Private
+      filter: grep -h -ve Running -ve communicator -ve MPI_Comm -ve OpenMP -ve PetscGetHostName -ve PetscSetFPTrap -ve PetscDetermineInitialFPTrap -ve libpetscbamg -ve PetscDeviceContext -ve PetscDeviceType -ve BLAS -ve PetscCPUFeaturesInitialize -ve PetscDeviceInitializeTypeFromOptions_Private
 
    test:
       requires: defined(PETSC_USE_INFO) !defined(PETSC_HAVE_THREADSAFETY)
       suffix: 2
       args: -info ex7info.2
-      filter: grep -h -ve Running -ve communicator -ve MPI_Comm -ve OpenMP -ve PetscGetHostName -ve PetscSetFPTrap -ve PetscDetermineInitialFPTrap -ve libpetscbamg -ve PetscDeviceContext -ve PetscDeviceType -ve BLAS -ve PetscDeviceInitializeTypeFromOptions_Private "ex7info.2.0"
+      filter: grep -h -ve Running -ve communicator -ve MPI_Comm -ve OpenMP -ve PetscGetHostName -ve PetscSetFPTrap -ve PetscDetermineInitialFPTrap -ve libpetscbamg -ve PetscDeviceContext -ve PetscDeviceType -ve BLAS -ve PetscCPUFeaturesInitialize -ve PetscDeviceInitializeTypeFromOptions_Private "ex7info.2.0"
 
    test:
       requires: defined(PETSC_USE_INFO) !defined(PETSC_HAVE_THREADSAFETY)
       suffix: 3
       nsize: 2
       args: -info ex7info.3
-      filter: grep -h -ve Running -ve communicator -ve MPI_Comm -ve OpenMP -ve PetscGetHostName -ve PetscSetFPTrap -ve PetscDetermineInitialFPTrap -ve libpetscbamg -ve PetscDeviceContext -ve PetscDeviceType -ve BLAS -ve PetscDeviceInitializeTypeFromOptions_Private "ex7info.3.0" | sort -b
+      filter: grep -h -ve Running -ve communicator -ve MPI_Comm -ve OpenMP -ve PetscGetHostName -ve PetscSetFPTrap -ve PetscDetermineInitialFPTrap -ve libpetscbamg -ve PetscDeviceContext -ve PetscDeviceType -ve BLAS -ve PetscCPUFeaturesInitialize -ve PetscDeviceInitializeTypeFromOptions_Private "ex7info.3.0" | sort -b
 
    test:
       requires: defined(PETSC_USE_INFO)
@@ -75,6 +75,7 @@ PetscErrorCode MatStashCreate_Private(MPI_Comm comm, PetscInt bs, MatStash *stas
   stash->nprocessed  = 0;
   stash->reproduce   = PETSC_FALSE;
   stash->blocktype   = MPI_DATATYPE_NULL;
+  stash->flushsize   = 0;
 
   PetscCall(PetscOptionsGetBool(NULL, NULL, "-matstash_reproduce", &stash->reproduce, NULL));
 #if !defined(PETSC_HAVE_MPIUNI)
@@ -85,6 +86,11 @@ PetscErrorCode MatStashCreate_Private(MPI_Comm comm, PetscInt bs, MatStash *stas
     stash->ScatterGetMesg = MatStashScatterGetMesg_BTS;
     stash->ScatterEnd     = MatStashScatterEnd_BTS;
     stash->ScatterDestroy = MatStashScatterDestroy_BTS;
+    PetscCall(PetscOptionsGetInt(NULL, NULL, "-matstash_flush_size", &stash->flushsize, NULL));
+    if (stash->flushsize > 0) {
+      PetscCall(PetscCommGetNewTag(stash->comm, &stash->flushtag));
+      PetscCall(PetscCalloc2(stash->size, &stash->flushsendcounts, stash->size, &stash->flushrecvcounts));
+    } else stash->flushsize = 0;
   } else {
 #endif
     stash->ScatterBegin   = MatStashScatterBegin_Ref;
@@ -107,6 +113,8 @@ PetscErrorCode MatStashDestroy_Private(MatStash *stash)
   if (stash->ScatterDestroy) PetscCall((*stash->ScatterDestroy)(stash));
   stash->space = NULL;
   PetscCall(PetscFree(stash->flg_v));
+  PetscCall(PetscFree(stash->flushowners));
+  PetscCall(PetscFree2(stash->flushsendcounts, stash->flushrecvcounts));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -125,27 +133,18 @@ PetscErrorCode MatStashScatterEnd_Private(MatStash *stash)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
-PETSC_INTERN PetscErrorCode MatStashScatterEnd_Ref(MatStash *stash)
+/*
+   MatStashReset_Private - Empties the stash, after its values have been sent to their owners
+*/
+static PetscErrorCode MatStashReset_Private(MatStash *stash)
 {
-  PetscMPIInt nsends = stash->nsends;
-  PetscInt    bs2, oldnmax;
-  MPI_Status *send_status;
-
   PetscFunctionBegin;
-  for (PetscMPIInt i = 0; i < 2 * stash->size; i++) stash->flg_v[i] = -1;
-  /* wait on sends */
-  if (nsends) {
-    PetscCall(PetscMalloc1(2 * nsends, &send_status));
-    PetscCallMPI(MPI_Waitall(2 * nsends, stash->send_waits, send_status));
-    PetscCall(PetscFree(send_status));
-  }
-
   /* Now update nmaxold to be app 10% more than max n used, this way the
      wastage of space is reduced the next time this stash is used.
      Also update the oldmax, only if it increases */
   if (stash->n) {
-    bs2     = stash->bs * stash->bs;
-    oldnmax = ((int)(stash->n * 1.1) + 5) * bs2;
+    PetscInt bs2     = stash->bs * stash->bs;
+    PetscInt oldnmax = ((int)(stash->n * 1.1) + 5) * bs2;
     if (oldnmax > stash->oldnmax) stash->oldnmax = oldnmax;
   }
 
@@ -157,7 +156,24 @@ PETSC_INTERN PetscErrorCode MatStashScatterEnd_Ref(MatStash *stash)
   PetscCall(PetscMatStashSpaceDestroy(&stash->space_head));
 
   stash->space = NULL;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PETSC_INTERN PetscErrorCode MatStashScatterEnd_Ref(MatStash *stash)
+{
+  PetscMPIInt nsends = stash->nsends;
+  MPI_Status *send_status;
 
+  PetscFunctionBegin;
+  for (PetscMPIInt i = 0; i < 2 * stash->size; i++) stash->flg_v[i] = -1;
+  /* wait on sends */
+  if (nsends) {
+    PetscCall(PetscMalloc1(2 * nsends, &send_status));
+    PetscCallMPI(MPI_Waitall(2 * nsends, stash->send_waits, send_status));
+    PetscCall(PetscFree(send_status));
+  }
+
+  PetscCall(MatStashReset_Private(stash));
   PetscCall(PetscFree(stash->send_waits));
   PetscCall(PetscFree(stash->recv_waits));
   PetscCall(PetscFree2(stash->svalues, stash->sindices));
@@ -765,6 +781,12 @@ static PetscErrorCode MatStashBlockTypeSetUp(MatStash *stash)
     PetscCall(PetscSegBufferCreate(stash->blocktype_size, 1, &stash->segsendblocks));
     PetscCall(PetscSegBufferCreate(stash->blocktype_size, 1, &stash->segrecvblocks));
     PetscCall(PetscSegBufferCreate(sizeof(MatStashFrame), 1, &stash->segrecvframe));
+    if (stash->flushsize) {
+      PetscCall(PetscSegBufferCreate(stash->blocktype_size, 1, &stash->segflushsendblocks));
+      PetscCall(PetscSegBufferCreate(sizeof(MPI_Request), 1, &stash->segflushreqs));
+      PetscCall(PetscSegBufferCreate(sizeof(MatStashFrame), 1, &stash->segflushframe));
+      PetscCall(PetscSegBufferCreate(stash->blocktype_size, 1, &stash->segflushrecvblocks));
+    }
     blocklens[0] = 2;
     blocklens[1] = (PetscMPIInt)bs2;
     displs[0]    = offsetof(struct DummyBlock, row);
@@ -815,6 +837,139 @@ static PetscErrorCode MatStashBTSRecv_Private(MPI_Comm comm, const PetscMPIInt t
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+  Finds the next rank, in increasing order, that gets a message from MatStashScatterBegin_BTS() or MatStashFlush_Private(): the owner of the
+  run of sorted blocks starting at *rowstart, or, if ranks < size and it comes first, a rank that was sent flushed messages. On return *rowstart
+  is advanced past the run and *count is its length; *rank is -1 when there are no more ranks.
+*/
+static PetscErrorCode MatStashBTSNextRank_Private(MatStash *stash, const PetscInt owners[], const char *sendblocks, PetscCount nblocks, PetscMPIInt ranks, PetscCount *rowstart, PetscMPIInt *r, PetscMPIInt *rank, PetscCount *count)
+{
+  PetscMPIInt owner = stash->size;
+  PetscCount  i;
+
+  PetscFunctionBegin;
+  if (*rowstart < nblocks) {
+    const MatStashBlock *sendblock_rowstart = (const MatStashBlock *)&sendblocks[*rowstart * stash->blocktype_size];
+    PetscInt             iowner;
+
+    PetscCall(PetscFindInt(sendblock_rowstart->row, stash->size + 1, owners, &iowner));
+    if (iowner < 0) iowner = -(iowner + 2);
+    PetscCall(PetscMPIIntCast(iowner, &owner));
+  }
+  for (; *r < PetscMin(owner, ranks); (*r)++) {
+    if (stash->flushsendcounts[*r]) { /* Only flushed messages go to this rank */
+      *rank  = (*r)++;
+      *count = 0;
+      PetscFunctionReturn(PETSC_SUCCESS);
+    }
+  }
+  if (owner == stash->size) {
+    *rank  = -1;
+    *count = 0;
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  for (i = *rowstart + 1; i < nblocks; i++) { /* Move forward through a run of blocks with the same owner */
+    const MatStashBlock *sendblock_i = (const MatStashBlock *)&sendblocks[i * stash->blocktype_size];
+
+    if (sendblock_i->row >= owners[owner + 1]) break;
+  }
+  *rank     = owner;
+  *count    = i - *rowstart;
+  *rowstart = i;
+  *r        = owner + 1;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/* Receives a message flushed to us, whose arrival has been established by status */
+static PetscErrorCode MatStashFlushRecv_Private(MatStash *stash, MPI_Status *status)
+{
+  MatStashFrame *frame;
+  PetscMPIInt    count;
+
+  PetscFunctionBegin;
+  PetscCallMPI(MPI_Get_count(status, stash->blocktype, &count));
+  PetscCall(PetscSegBufferGet(stash->segflushframe, 1, &frame));
+  PetscCall(PetscSegBufferGet(stash->segflushrecvblocks, count, &frame->buffer));
+  PetscCallMPI(MPIU_Recv(frame->buffer, count, stash->blocktype, status->MPI_SOURCE, stash->flushtag, stash->comm, MPI_STATUS_IGNORE));
+  frame->count   = count;
+  frame->rank    = status->MPI_SOURCE;
+  frame->pending = 0;
+  stash->flushrecvcounts[status->MPI_SOURCE]++;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  Sorts and compresses the stash and sends the blocks of each owner in a nonblocking message tagged flushtag. The send buffers are kept, and the
+  number of messages sent to each rank is recorded, until MatStashScatterBegin_BTS() tells the owners how many flushed messages to expect.
+  Messages flushed to this rank by the others are received along the way.
+*/
+static PetscErrorCode MatStashFlush_BTS(Mat mat, MatStash *stash)
+{
+  PetscCount  nblocks, rowstart, count;
+  PetscMPIInt r = 0, rank, nsends = 0, flag;
+  char       *sendblocks, *flushblocks;
+  MPI_Status  status;
+
+  PetscFunctionBegin;
+  PetscCall(PetscLogEventBegin(MAT_StashFlush, mat, 0, 0, 0));
+  PetscCall(MatStashBlockTypeSetUp(stash));
+  if (!stash->flushowners) {
+    PetscCall(PetscMalloc1(stash->size + 1, &stash->flushowners));
+    for (PetscMPIInt i = 0; i <= stash->size; i++) stash->flushowners[i] = mat->rmap->range[i] / stash->bs;
+  }
+  PetscCall(MatStashSortCompress_Private(stash, mat->insertmode));
+  PetscCall(PetscSegBufferGetSize(stash->segsendblocks, &nblocks));
+  PetscCall(PetscSegBufferExtractInPlace(stash->segsendblocks, &sendblocks));
+  PetscCall(PetscSegBufferGet(stash->segflushsendblocks, nblocks, &flushblocks));
+  PetscCall(PetscMemcpy(flushblocks, sendblocks, nblocks * stash->blocktype_size));
+  if (mat->insertmode == INSERT_VALUES) { /* Encode insertmode as in MatStashScatterBegin_BTS() */
+    for (PetscCount i = 0; i < nblocks; i++) {
+      MatStashBlock *block = (MatStashBlock *)&flushblocks[i * stash->blocktype_size];
+      block->row           = -(block->row + 1);
+    }
+  }
+  for (rowstart = 0;;) {
+    PetscCount   start = rowstart;
+    MPI_Request *req;
+
+    /* The runs are found in the unencoded copy left in segsendblocks */
+    PetscCall(MatStashBTSNextRank_Private(stash, stash->flushowners, sendblocks, nblocks, 0, &rowstart, &r, &rank, &count));
+    if (rank < 0) break;
+    PetscCall(PetscSegBufferGet(stash->segflushreqs, 1, &req));
+    PetscCallMPI(MPIU_Isend(&flushblocks[start * stash->blocktype_size], count, stash->blocktype, rank, stash->flushtag, stash->comm, req));
+    stash->flushsendcounts[rank]++;
+    nsends++;
+  }
+  PetscCall(PetscInfo(mat, "Flushed %" PetscCount_FMT " stashed blocks in %d messages of %zu bytes in total\n", nblocks, nsends, (size_t)nblocks * stash->blocktype_size));
+  PetscCall(MatStashReset_Private(stash));
+
+  /* Receive what the other ranks have flushed to us so far */
+  do {
+    PetscCallMPI(MPI_Iprobe(MPI_ANY_SOURCE, stash->flushtag, stash->comm, &flag, &status));
+    if (flag) PetscCall(MatStashFlushRecv_Private(stash, &status));
+  } while (flag);
+  PetscCall(PetscLogEventEnd(MAT_StashFlush, mat, 0, 0, 0));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*
+  MatStashFlush_Private - Sends the values in the stashes of the matrix to their owners once a stash holds -matstash_flush_size values,
+  so that the communication overlaps with the rest of the calls to MatSetValues(). Called by the MatSetValues() family.
+*/
+PetscErrorCode MatStashFlush_Private(Mat mat)
+{
+  MatStash *stashes[2] = {&mat->stash, &mat->bstash};
+
+  PetscFunctionBegin;
+  if (mat->assembly_subset) PetscFunctionReturn(PETSC_SUCCESS); /* The messages are set up once with MAT_SUBSET_OFF_PROC_ENTRIES */
+  for (PetscInt i = 0; i < 2; i++) {
+    MatStash *stash = stashes[i];
+
+    if (stash->flushsize && stash->ScatterBegin == MatStashScatterBegin_BTS && stash->n * stash->bs * stash->bs >= stash->flushsize) PetscCall(MatStashFlush_BTS(mat, stash));
+  }
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*
  * owners[] contains the ownership ranges; may be indexed by either blocks or scalars
  */
@@ -849,50 +1004,33 @@ static PetscErrorCode MatStashScatterBegin_BTS(Mat mat, MatStash *stash, PetscIn
       }
     }
   } else { /* Dynamically count and pack (first time) */
-    PetscInt   sendno;
-    PetscCount i, rowstart;
+    PetscMPIInt sendno, r, rank, ranks = stash->flushsendcounts ? stash->size : 0;
+    PetscCount  rowstart, count;
 
-    /* Count number of send ranks and allocate for sends */
+    /* Count number of send ranks and allocate for sends, including the ranks that only got flushed messages */
     stash->nsendranks = 0;
-    for (rowstart = 0; rowstart < nblocks;) {
-      PetscInt       owner;
-      MatStashBlock *sendblock_rowstart = (MatStashBlock *)&sendblocks[rowstart * stash->blocktype_size];
-
-      PetscCall(PetscFindInt(sendblock_rowstart->row, stash->size + 1, owners, &owner));
-      if (owner < 0) owner = -(owner + 2);
-      for (i = rowstart + 1; i < nblocks; i++) { /* Move forward through a run of blocks with the same owner */
-        MatStashBlock *sendblock_i = (MatStashBlock *)&sendblocks[i * stash->blocktype_size];
-
-        if (sendblock_i->row >= owners[owner + 1]) break;
-      }
+    for (rowstart = 0, r = 0;;) {
+      PetscCall(MatStashBTSNextRank_Private(stash, owners, sendblocks, nblocks, ranks, &rowstart, &r, &rank, &count));
+      if (rank < 0) break;
       stash->nsendranks++;
-      rowstart = i;
     }
     PetscCall(PetscMalloc3(stash->nsendranks, &stash->sendranks, stash->nsendranks, &stash->sendhdr, stash->nsendranks, &stash->sendframes));
 
     /* Set up sendhdrs and sendframes */
     sendno = 0;
-    for (rowstart = 0; rowstart < nblocks;) {
-      PetscInt       iowner;
-      PetscMPIInt    owner;
-      MatStashBlock *sendblock_rowstart = (MatStashBlock *)&sendblocks[rowstart * stash->blocktype_size];
-
-      PetscCall(PetscFindInt(sendblock_rowstart->row, stash->size + 1, owners, &iowner));
-      PetscCall(PetscMPIIntCast(iowner, &owner));
-      if (owner < 0) owner = -(owner + 2);
-      stash->sendranks[sendno] = owner;
-      for (i = rowstart + 1; i < nblocks; i++) { /* Move forward through a run of blocks with the same owner */
-        MatStashBlock *sendblock_i = (MatStashBlock *)&sendblocks[i * stash->blocktype_size];
-
-        if (sendblock_i->row >= owners[owner + 1]) break;
-      }
-      stash->sendframes[sendno].buffer  = sendblock_rowstart;
+    for (rowstart = 0, r = 0;;) {
+      PetscCount start = rowstart;
+
+      PetscCall(MatStashBTSNextRank_Private(stash, owners, sendblocks, nblocks, ranks, &rowstart, &r, &rank, &count));
+      if (rank < 0) break;
+      stash->sendranks[sendno]          = rank;
+      stash->sendframes[sendno].buffer  = &sendblocks[start * stash->blocktype_size];
       stash->sendframes[sendno].pending = 0;
-      PetscCall(PetscIntCast(i - rowstart, &stash->sendhdr[sendno].count));
+      PetscCall(PetscIntCast(count, &stash->sendhdr[sendno].count));
+      stash->sendhdr[sendno].nflushed = ranks ? stash->flushsendcounts[rank] : 0;
       sendno++;
-      rowstart = i;
     }
-    PetscCheck(sendno == stash->nsendranks, stash->comm, PETSC_ERR_PLIB, "BTS counted %d sendranks, but %" PetscInt_FMT " sends", stash->nsendranks, sendno);
+    PetscCheck(sendno == stash->nsendranks, stash->comm, PETSC_ERR_PLIB, "BTS counted %d sendranks, but %d sends", stash->nsendranks, sendno);
   }
 
   /* Encode insertmode on the outgoing messages. If we want to support more than two options, we would need a new
@@ -912,11 +1050,29 @@ static PetscErrorCode MatStashScatterBegin_BTS(Mat mat, MatStash *stash, PetscIn
     for (i = 0; i < stash->nsendranks; i++) PetscCall(MatStashBTSSend_Private(stash->comm, &tag, i, stash->sendranks[i], &stash->sendhdr[i], &stash->sendreqs[i], stash));
     stash->use_status = PETSC_TRUE; /* Use count from message status. */
   } else {
-    PetscCall(PetscCommBuildTwoSidedFReq(stash->comm, 1, MPIU_INT, stash->nsendranks, stash->sendranks, (PetscInt *)stash->sendhdr, &stash->nrecvranks, &stash->recvranks, (PetscInt *)&stash->recvhdr, 1, &stash->sendreqs, &stash->recvreqs, MatStashBTSSend_Private, MatStashBTSRecv_Private, stash));
+    PetscCall(PetscCommBuildTwoSidedFReq(stash->comm, 2, MPIU_INT, stash->nsendranks, stash->sendranks, (PetscInt *)stash->sendhdr, &stash->nrecvranks, &stash->recvranks, (PetscInt *)&stash->recvhdr, 1, &stash->sendreqs, &stash->recvreqs, MatStashBTSSend_Private, MatStashBTSRecv_Private, stash));
     PetscCall(PetscMalloc2(stash->nrecvranks, &stash->some_indices, stash->nrecvranks, &stash->some_statuses));
     stash->use_status = PETSC_FALSE; /* Use count from header instead of from message. */
   }
 
+  stash->nflushframes = 0;
+  stash->flushframe_i = 0;
+  if (stash->flushsendcounts && !stash->first_assembly_done) { /* Receive the flushed messages that have not arrived yet */
+    for (PetscMPIInt i = 0; i < stash->nrecvranks; i++) {
+      PetscMPIInt rank = stash->recvranks[i];
+
+      while (stash->flushrecvcounts[rank] < stash->recvhdr[i].nflushed) {
+        MPI_Status status;
+
+        PetscCallMPI(MPI_Probe(rank, stash->flushtag, stash->comm, &status));
+        PetscCall(MatStashFlushRecv_Private(stash, &status));
+      }
+      stash->flushrecvcounts[rank] = 0;
+    }
+    PetscCall(PetscSegBufferGetSize(stash->segflushframe, &stash->nflushframes));
+    PetscCall(PetscSegBufferExtractInPlace(stash->segflushframe, &stash->flushframes));
+  }
+
   PetscCall(PetscSegBufferExtractInPlace(stash->segrecvframe, &stash->recvframes));
   stash->recvframe_active    = NULL;
   stash->recvframe_i         = 0;
@@ -935,27 +1091,36 @@ static PetscErrorCode MatStashScatterGetMesg_BTS(MatStash *stash, PetscMPIInt *n
   PetscFunctionBegin;
   *flg = 0;
   while (!stash->recvframe_active || stash->recvframe_i == stash->recvframe_count) {
-    if (stash->some_i == stash->some_count) {
-      if (stash->recvcount == stash->nrecvranks) PetscFunctionReturn(PETSC_SUCCESS); /* Done */
-      PetscCallMPI(MPI_Waitsome(stash->nrecvranks, stash->recvreqs, &stash->some_count, stash->some_indices, stash->use_status ? stash->some_statuses : MPI_STATUSES_IGNORE));
-      stash->some_i = 0;
-    }
-    stash->recvframe_active = &stash->recvframes[stash->some_indices[stash->some_i]];
-    stash->recvframe_count  = stash->recvframe_active->count; /* From header; maximum count */
-    if (stash->use_status) {                                  /* Count what was actually sent */
-      PetscMPIInt ic;
+    PetscMPIInt rank;
 
-      PetscCallMPI(MPI_Get_count(&stash->some_statuses[stash->some_i], stash->blocktype, &ic));
-      stash->recvframe_count = ic;
+    if (stash->flushframe_i < stash->nflushframes) { /* The messages flushed to us have all arrived, process them first */
+      stash->recvframe_active = &stash->flushframes[stash->flushframe_i++];
+      stash->recvframe_count  = stash->recvframe_active->count;
+      rank                    = stash->recvframe_active->rank;
+    } else {
+      if (stash->some_i == stash->some_count) {
+        if (stash->recvcount == stash->nrecvranks) PetscFunctionReturn(PETSC_SUCCESS); /* Done */
+        PetscCallMPI(MPI_Waitsome(stash->nrecvranks, stash->recvreqs, &stash->some_count, stash->some_indices, stash->use_status ? stash->some_statuses : MPI_STATUSES_IGNORE));
+        stash->some_i = 0;
+      }
+      stash->recvframe_active = &stash->recvframes[stash->some_indices[stash->some_i]];
+      stash->recvframe_count  = stash->recvframe_active->count; /* From header; maximum count */
+      if (stash->use_status) {                                  /* Count what was actually sent */
+        PetscMPIInt ic;
+
+        PetscCallMPI(MPI_Get_count(&stash->some_statuses[stash->some_i], stash->blocktype, &ic));
+        stash->recvframe_count = ic;
+      }
+      rank = stash->recvranks[stash->some_indices[stash->some_i]];
+      stash->some_i++;
+      stash->recvcount++;
     }
     if (stash->recvframe_count > 0) { /* Check for InsertMode consistency */
       block = (MatStashBlock *)&((char *)stash->recvframe_active->buffer)[0];
       if (PetscUnlikely(*stash->insertmode == NOT_SET_VALUES)) *stash->insertmode = block->row < 0 ? INSERT_VALUES : ADD_VALUES;
-      PetscCheck(*stash->insertmode != INSERT_VALUES || block->row < 0, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Assembling INSERT_VALUES, but rank %d requested ADD_VALUES", stash->recvranks[stash->some_indices[stash->some_i]]);
-      PetscCheck(*stash->insertmode != ADD_VALUES || block->row >= 0, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Assembling ADD_VALUES, but rank %d requested INSERT_VALUES", stash->recvranks[stash->some_indices[stash->some_i]]);
+      PetscCheck(*stash->insertmode != INSERT_VALUES || block->row < 0, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Assembling INSERT_VALUES, but rank %d requested ADD_VALUES", rank);
+      PetscCheck(*stash->insertmode != ADD_VALUES || block->row >= 0, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONGSTATE, "Assembling ADD_VALUES, but rank %d requested INSERT_VALUES", rank);
     }
-    stash->some_i++;
-    stash->recvcount++;
     stash->recvframe_i = 0;
   }
   *n    = 1;
@@ -973,29 +1138,26 @@ static PetscErrorCode MatStashScatterEnd_BTS(MatStash *stash)
 {
   PetscFunctionBegin;
   PetscCallMPI(MPI_Waitall(stash->nsendranks, stash->sendreqs, MPI_STATUSES_IGNORE));
+  if (stash->flushsendcounts && stash->segflushreqs) { /* Complete the flushed messages and release their buffers */
+    PetscCount   nreqs;
+    PetscMPIInt  n;
+    MPI_Request *reqs;
+
+    PetscCall(PetscSegBufferGetSize(stash->segflushreqs, &nreqs));
+    PetscCall(PetscMPIIntCast(nreqs, &n));
+    PetscCall(PetscSegBufferExtractInPlace(stash->segflushreqs, &reqs));
+    PetscCallMPI(MPI_Waitall(n, reqs, MPI_STATUSES_IGNORE));
+    PetscCall(PetscSegBufferExtractInPlace(stash->segflushsendblocks, NULL));
+    PetscCall(PetscSegBufferExtractInPlace(stash->segflushrecvblocks, NULL));
+    PetscCall(PetscArrayzero(stash->flushsendcounts, stash->size));
+  }
   if (stash->first_assembly_done) { /* Reuse the communication contexts, so consolidate and reset segrecvblocks  */
     PetscCall(PetscSegBufferExtractInPlace(stash->segrecvblocks, NULL));
   } else { /* No reuse, so collect everything. */
     PetscCall(MatStashScatterDestroy_BTS(stash));
   }
 
-  /* Now update nmaxold to be app 10% more than max n used, this way the
-     wastage of space is reduced the next time this stash is used.
-     Also update the oldmax, only if it increases */
-  if (stash->n) {
-    PetscInt bs2     = stash->bs * stash->bs;
-    PetscInt oldnmax = ((int)(stash->n * 1.1) + 5) * bs2;
-    if (oldnmax > stash->oldnmax) stash->oldnmax = oldnmax;
-  }
-
-  stash->nmax       = 0;
-  stash->n          = 0;
-  stash->reallocs   = -1;
-  stash->nprocessed = 0;
-
-  PetscCall(PetscMatStashSpaceDestroy(&stash->space_head));
-
-  stash->space = NULL;
+  PetscCall(MatStashReset_Private(stash));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
@@ -1006,6 +1168,11 @@ PetscErrorCode MatStashScatterDestroy_BTS(MatStash *stash)
   PetscCall(PetscSegBufferDestroy(&stash->segrecvframe));
   stash->recvframes = NULL;
   PetscCall(PetscSegBufferDestroy(&stash->segrecvblocks));
+  PetscCall(PetscSegBufferDestroy(&stash->segflushsendblocks));
+  PetscCall(PetscSegBufferDestroy(&stash->segflushreqs));
+  PetscCall(PetscSegBufferDestroy(&stash->segflushframe));
+  stash->flushframes = NULL;
+  PetscCall(PetscSegBufferDestroy(&stash->segflushrecvblocks));
   if (stash->blocktype != MPI_DATATYPE_NULL) PetscCallMPI(MPI_Type_free(&stash->blocktype));
   stash->nsendranks = 0;
   stash->nrecvranks = 0;
@@ -1017,4 +1184,10 @@ PetscErrorCode MatStashScatterDestroy_BTS(MatStash *stash)
   PetscCall(PetscFree2(stash->some_indices, stash->some_statuses));
   PetscFunctionReturn(PETSC_SUCCESS);
 }
+#else
+PetscErrorCode MatStashFlush_Private(Mat mat)
+{
+  PetscFunctionBegin;
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
 #endif
@@ -1319,6 +1319,24 @@ static PetscErrorCode PetscLogHandlerView_Default_Info(PetscLogHandler handler,
 
 #if defined(PETSC_HAVE_OPENMP)
   PetscCall(PetscViewerASCIIPrintf(viewer, "Using %" PetscInt_FMT " OpenMP threads\n", PetscNumOMPThreads));
+  if (PetscOMPFirstTouch) {
+    PetscInt        nnodes, n;
+    PetscLogDouble *pages;
+    PetscMPIInt     mnnodes;
+
+    PetscCall(PetscMemoryGetNUMAPages(0, &nnodes, NULL));
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, &nnodes, 1, MPIU_INT, MPI_MAX, comm));
+    PetscCall(PetscMPIIntCast(nnodes, &mnnodes));
+    PetscCall(PetscMalloc1(nnodes, &pages));
+    PetscCall(PetscMemoryGetNUMAPages(nnodes, &n, pages));
+    PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, pages, mnnodes, MPIU_PETSCLOGDOUBLE, MPI_SUM, comm));
+    if (nnodes) {
+      PetscCall(PetscViewerASCIIPrintf(viewer, "Using first touch placement, resident pages per NUMA node:"));
+      for (PetscInt k = 0; k < nnodes; k++) PetscCall(PetscViewerASCIIPrintf(viewer, " %.0f", pages[k]));
+      PetscCall(PetscViewerASCIIPrintf(viewer, "\n"));
+    } else PetscCall(PetscViewerASCIIPrintf(viewer, "Using first touch placement, resident pages per NUMA node: not available\n"));
+    PetscCall(PetscFree(pages));
+  }
 #endif
   PetscCall(PetscViewerASCIIPrintf(viewer, "Using %s\n", version));
 
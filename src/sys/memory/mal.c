@@ -3,6 +3,7 @@
 */
 #define PETSC_DESIRE_FEATURE_TEST_MACROS /* for posix_memalign() */
 #include <petscsys.h>                    /*I   "petscsys.h"   I*/
+#include <petsc/private/petscimpl.h>
 #include <stdarg.h>
 #if defined(PETSC_HAVE_MALLOC_H)
   #include <malloc.h>
@@ -473,3 +474,35 @@ PetscErrorCode PetscFreeA(int n, int lineno, const char *function, const char *f
   }
   PetscFunctionReturn(PETSC_SUCCESS);
 }
+
+/*
+  PetscMemzeroFirstTouch_Private - Zeros a freshly allocated array of n entries of size unit
+
+  With -omp_first_touch the array is zeroed by nt OpenMP threads (PETSC_DECIDE for the number given by -omp_num_threads),
+  thread t touching the entries [start[t], start[t+1]), or an equal share of the entries when start is NULL which is how
+  the static OpenMP schedule of the vector kernels splits their loops. Since the operating system places a page on the
+  NUMA node of the thread that first touches it this spreads the pages over the NUMA nodes the same way as the
+  kernels that later use the array. This has no effect when PetscMalloc() already touched the array, which it does
+  with -malloc_debug (the default in debug builds) to fill it with NaN and with -log_view_memory to zero it.
+*/
+PetscErrorCode PetscMemzeroFirstTouch_Private(void *a, size_t unit, PetscInt n, PetscInt nt, const PetscInt start[])
+{
+  PetscFunctionBegin;
+#if defined(PETSC_HAVE_OPENMP)
+  if (nt == PETSC_DECIDE) nt = PetscNumOMPThreads;
+  if (PetscOMPFirstTouch && nt > 1 && n > 0) {
+    char *c = (char *)a;
+
+    PetscPragmaOMP(parallel for num_threads((int)nt) schedule(static, 1))
+    for (PetscInt t = 0; t < nt; t++) {
+      const PetscInt s = start ? start[t] : (PetscInt)(((PetscCount)n * t) / nt);
+      const PetscInt e = start ? start[t + 1] : (PetscInt)(((PetscCount)n * (t + 1)) / nt);
+
+      if (e > s) memset(c + (size_t)s * unit, 0, (size_t)(e - s) * unit);
+    }
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+#endif
+  PetscCall(PetscMemzero(a, (size_t)n * unit));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
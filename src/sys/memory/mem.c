@@ -1,5 +1,6 @@
 #define PETSC_DESIRE_FEATURE_TEST_MACROS /* for getpagesize() with c89 */
 #include <petscsys.h>                    /*I "petscsys.h" I*/
+#include <petsc/private/petscimpl.h>
 #if defined(PETSC_HAVE_PWD_H)
   #include <pwd.h>
 #endif
@@ -110,6 +111,63 @@ PetscErrorCode PetscMemoryGetCurrentUsage(PetscLogDouble *mem)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  PetscMemoryGetNUMAPages - Returns the number of memory pages of the program resident on each NUMA node
+
+  Not Collective, No Fortran Support
+
+  Input Parameter:
+. maxnodes - the length of `pages`
+
+  Output Parameters:
++ nnodes - the number of NUMA nodes with pages of the program, 0 if the information is not available
+- pages  - the number of pages on each of the first `maxnodes` NUMA nodes
+
+  Options Database Key:
+. -omp_first_touch - Zero the arrays of `Vec` and `MATSEQAIJ` with the OpenMP threads that will later use them
+
+  Level: intermediate
+
+  Notes:
+  The information is read from /proc/self/numa_maps and is thus only available on Linux systems built with NUMA support
+
+  `nnodes` may be larger than `maxnodes`, call this routine with `maxnodes` of 0 to get the length `pages` needs.
+
+  With `-malloc_debug`, the default for debug builds, or `-log_view_memory`, `PetscMalloc()` fills new memory from the calling
+  thread, so the pages are placed before `-omp_first_touch` can spread them over the NUMA nodes. Use an optimized build or
+  `-malloc_debug 0` to measure the placement.
+
+.seealso: `PetscMemoryGetCurrentUsage()`, `PetscMemoryView()`
+@*/
+PetscErrorCode PetscMemoryGetNUMAPages(PetscInt maxnodes, PetscInt *nnodes, PetscLogDouble pages[])
+{
+#if defined(PETSC_USE_PROC_FOR_SIZE)
+  FILE *file;
+  char  line[4096];
+#endif
+
+  PetscFunctionBegin;
+  PetscAssertPointer(nnodes, 2);
+  if (maxnodes) PetscAssertPointer(pages, 3);
+  *nnodes = 0;
+  for (PetscInt k = 0; k < maxnodes; k++) pages[k] = 0.0;
+#if defined(PETSC_USE_PROC_FOR_SIZE)
+  if (!(file = fopen("/proc/self/numa_maps", "r"))) PetscFunctionReturn(PETSC_SUCCESS);
+  while (fgets(line, sizeof(line), file)) {
+    /* each mapping lists its resident pages as N<node>=<count> */
+    for (char *s = strstr(line, " N"); s; s = strstr(s + 2, " N")) {
+      long node, count;
+
+      if (sscanf(s, " N%ld=%ld", &node, &count) != 2 || node < 0) continue;
+      if (node < maxnodes) pages[node] += (PetscLogDouble)count;
+      *nnodes = PetscMax(*nnodes, (PetscInt)node + 1);
+    }
+  }
+  PetscCheck(!fclose(file), PETSC_COMM_SELF, PETSC_ERR_SYS, "fclose() failed on file");
+#endif
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PETSC_INTERN PetscBool      PetscMemoryCollectMaximumUsage;
 PETSC_INTERN PetscLogDouble PetscMemoryMaximumUsage;
 
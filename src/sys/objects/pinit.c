@@ -743,7 +743,8 @@ int64_t Petsc_adios_group;
 #endif
 #if PetscDefined(HAVE_OPENMP)
   #include <omp.h>
-PetscInt PetscNumOMPThreads;
+PetscInt  PetscNumOMPThreads;
+PetscBool PetscOMPFirstTouch = PETSC_FALSE;
 #endif
 
 #include <petsc/private/deviceimpl.h>
@@ -1091,6 +1092,7 @@ PETSC_INTERN PetscErrorCode PetscInitialize_Common(const char *prog, const char
   PetscCall(PetscInfo(NULL, "PETSc successfully started: number of processors = %d\n", size));
   PetscCall(PetscGetHostName(hostname, sizeof(hostname)));
   PetscCall(PetscInfo(NULL, "Running on machine: %s\n", hostname));
+  PetscCall(PetscCPUFeaturesInitialize());
 #if defined(PETSC_HAVE_OPENMP)
   {
     PetscBool omp_view_flag;
@@ -1106,6 +1108,7 @@ PETSC_INTERN PetscErrorCode PetscInitialize_Common(const char *prog, const char
     PetscOptionsBegin(PETSC_COMM_WORLD, NULL, "OpenMP options", "Sys");
     PetscCall(PetscOptionsInt("-omp_num_threads", "Number of OpenMP threads to use (can also use environmental variable OMP_NUM_THREADS", "None", PetscNumOMPThreads, &PetscNumOMPThreads, &flg));
     PetscCall(PetscOptionsName("-omp_view", "Display OpenMP number of threads", NULL, &omp_view_flag));
+    PetscCall(PetscOptionsBool("-omp_first_touch", "Initialize vector and matrix arrays with the OpenMP threads that use them so their pages are placed on the threads' NUMA nodes", "None", PetscOMPFirstTouch, &PetscOMPFirstTouch, NULL));
     PetscOptionsEnd();
     if (flg) {
       PetscCall(PetscInfo(NULL, "Number of OpenMP threads %" PetscInt_FMT " (given by -omp_num_threads)\n", PetscNumOMPThreads));
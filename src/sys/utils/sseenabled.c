@@ -1,4 +1,4 @@
-#include <petscsys.h> /*I "petscsys.h" I*/
+#include <petsc/private/petscimpl.h> /*I "petscsys.h" I*/
 
 #if defined(PETSC_HAVE_SSE)
 
@@ -158,3 +158,82 @@ PetscErrorCode PetscSSEIsEnabled(MPI_Comm comm, PetscBool *lflag, PetscBool *gfl
   if (gflag) *gflag = petsc_sse_enabled_global;
   PetscFunctionReturn(PETSC_SUCCESS);
 }
+
+#if defined(__aarch64__) && defined(PETSC_HAVE_SYS_AUXV_H)
+  #include <sys/auxv.h>
+#endif
+
+const char *const PetscCPUFeatures[] = {"avx", "avx2", "fma", "avx512f", "avx512vl", "sve", "PetscCPUFeature", "PETSC_CPU_FEATURE_", NULL};
+
+static PetscBool petsc_cpu_features_untested = PETSC_TRUE;
+static PetscBool petsc_cpu_features[PETSC_CPU_FEATURE_SVE + 1];
+
+/*
+  Probes the processor (and, through the compiler runtime, the operating system support for the wider registers),
+  then masks the extensions listed with -disable_cpu_features
+*/
+PetscErrorCode PetscCPUFeaturesInitialize(void)
+{
+  PetscEnum disabled[PETSC_CPU_FEATURE_SVE + 1];
+  PetscInt  ndisabled = PETSC_STATIC_ARRAY_LENGTH(disabled);
+  char      list[128] = "";
+
+  PetscFunctionBegin;
+#if (defined(__x86_64__) || defined(__i386__)) && (PetscHasBuiltin(__builtin_cpu_supports) || (defined(__GNUC__) && !defined(__NVCOMPILER)))
+  __builtin_cpu_init();
+  petsc_cpu_features[PETSC_CPU_FEATURE_AVX]      = (PetscBool)!!__builtin_cpu_supports("avx");
+  petsc_cpu_features[PETSC_CPU_FEATURE_AVX2]     = (PetscBool)!!__builtin_cpu_supports("avx2");
+  petsc_cpu_features[PETSC_CPU_FEATURE_FMA]      = (PetscBool)!!__builtin_cpu_supports("fma");
+  petsc_cpu_features[PETSC_CPU_FEATURE_AVX512F]  = (PetscBool)!!__builtin_cpu_supports("avx512f");
+  petsc_cpu_features[PETSC_CPU_FEATURE_AVX512VL] = (PetscBool)!!__builtin_cpu_supports("avx512vl");
+#elif defined(__aarch64__) && defined(PETSC_HAVE_SYS_AUXV_H) && defined(HWCAP_SVE)
+  petsc_cpu_features[PETSC_CPU_FEATURE_SVE] = (PetscBool)!!(getauxval(AT_HWCAP) & HWCAP_SVE);
+#elif defined(__ARM_FEATURE_SVE)
+  petsc_cpu_features[PETSC_CPU_FEATURE_SVE] = PETSC_TRUE;
+#endif
+  PetscCall(PetscOptionsGetEnumArray(NULL, NULL, "-disable_cpu_features", PetscCPUFeatures, disabled, &ndisabled, NULL));
+  for (PetscInt i = 0; i < ndisabled; i++) petsc_cpu_features[disabled[i]] = PETSC_FALSE;
+  petsc_cpu_features_untested = PETSC_FALSE;
+
+  for (PetscInt i = 0; i < (PetscInt)PETSC_STATIC_ARRAY_LENGTH(petsc_cpu_features); i++) {
+    if (!petsc_cpu_features[i]) continue;
+    PetscCall(PetscStrlcat(list, " ", sizeof(list)));
+    PetscCall(PetscStrlcat(list, PetscCPUFeatures[i], sizeof(list)));
+  }
+  PetscCall(PetscInfo(NULL, "CPU features available to the hand-vectorized kernels:%s\n", list[0] ? list : " none"));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+/*@
+  PetscCPUFeatureIsEnabled - Determines if the processor this process runs on supports an instruction set
+  extension, so that kernels vectorized for it can be installed at run time
+
+  Not Collective
+
+  Input Parameter:
+. feature - the extension, see `PetscCPUFeature`
+
+  Output Parameter:
+. flg - `PETSC_TRUE` if the extension can be used
+
+  Options Database Key:
+. -disable_cpu_features <avx,avx2,fma,avx512f,avx512vl,sve> - treat these extensions as unavailable, for example to reproduce the kernels chosen on older processors
+
+  Level: developer
+
+  Notes:
+  The processor is probed in `PetscInitialize()`; run with `-info` to see the extensions found and which kernels are installed.
+
+  Processes of a parallel run may get different answers on heterogeneous machines.
+
+.seealso: `PetscCPUFeature`, `PETSC_ATTRIBUTE_TARGET`, `PetscSSEIsEnabled()`
+@*/
+PetscErrorCode PetscCPUFeatureIsEnabled(PetscCPUFeature feature, PetscBool *flg)
+{
+  PetscFunctionBegin;
+  PetscAssertPointer(flg, 2);
+  PetscCheck(feature >= PETSC_CPU_FEATURE_AVX && feature <= PETSC_CPU_FEATURE_SVE, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Unknown CPU feature %d", (int)feature);
+  if (petsc_cpu_features_untested) PetscCall(PetscCPUFeaturesInitialize());
+  *flg = petsc_cpu_features[feature];
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
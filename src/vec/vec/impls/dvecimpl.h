@@ -10,6 +10,13 @@
 
 #include <petsc/private/vecimpl.h>
 
+/* workspace of VecMAXPYMDot() kept between calls, room for nv arrays and the nv + 1 partial sums of nt threads */
+typedef struct {
+  const PetscScalar **x;
+  PetscScalar        *work;
+  PetscInt            nv, nt;
+} VecMAXPYMDotWork;
+
 typedef struct {
   VECHEADER
   /* VecSetValuesCOO() related fields on host. m is the vector's local size */
@@ -17,6 +24,8 @@ typedef struct {
   PetscCount  tot1;  /* Total number of valid (i.e., w/ non-negative indices) entries in the COO array */
   PetscCount *jmap1; /* [m+1]: perm1[jmap1[i]..jmap1[i+1]) give indices of entries in v[] associated with i-th nonzero of the vector */
   PetscCount *perm1; /* [tot1]: The permutation array in sorting coo_i[] */
+
+  VecMAXPYMDotWork maxpymdot;
 } Vec_Seq;
 
 PETSC_INTERN PetscErrorCode VecMaxPointwiseDivide_Seq(Vec, Vec, PetscReal *);
@@ -40,6 +49,8 @@ PETSC_SINGLE_LIBRARY_INTERN PetscErrorCode VecMDot_Seq(Vec, PetscInt, const Vec[
 PETSC_SINGLE_LIBRARY_INTERN PetscErrorCode VecMTDot_Seq(Vec, PetscInt, const Vec[], PetscScalar *);
 PETSC_SINGLE_LIBRARY_INTERN PetscErrorCode VecSet_Seq(Vec, PetscScalar);
 PETSC_SINGLE_LIBRARY_INTERN PetscErrorCode VecMAXPY_Seq(Vec, PetscInt, const PetscScalar *, Vec *);
+PETSC_SINGLE_LIBRARY_INTERN PetscErrorCode VecMAXPYMDot_Seq(Vec, PetscInt, const PetscScalar *, Vec *, PetscScalar *, PetscReal *);
+PETSC_SINGLE_LIBRARY_INTERN PetscErrorCode VecMAXPYMDotLocal_Seq(Vec, PetscInt, const PetscScalar *, Vec *, VecMAXPYMDotWork *, PetscScalar **);
 PETSC_SINGLE_LIBRARY_INTERN PetscErrorCode VecAYPX_Seq(Vec, PetscScalar, Vec);
 PETSC_SINGLE_LIBRARY_INTERN PetscErrorCode VecWAXPY_Seq(Vec, PetscScalar, Vec, Vec);
 PETSC_SINGLE_LIBRARY_INTERN PetscErrorCode VecAXPBYPCZ_Seq(Vec, PetscScalar, PetscScalar, PetscScalar, Vec, Vec);
@@ -589,7 +589,8 @@ PetscErrorCode VecCreate_MPI_Private(Vec v, PetscBool alloc, PetscInt nghost, co
   s->array_allocated = NULL;
   if (alloc && !array) {
     PetscInt n = v->map->n + nghost;
-    PetscCall(PetscCalloc1(n, &s->array));
+    PetscCall(PetscMalloc1(n, &s->array));
+    PetscCall(PetscMemzeroFirstTouch_Private(s->array, sizeof(PetscScalar), n, PETSC_DECIDE, NULL));
     s->array_allocated = s->array;
     PetscCall(PetscObjectComposedDataSetReal((PetscObject)v, NormIds[NORM_2], 0));
     PetscCall(PetscObjectComposedDataSetReal((PetscObject)v, NormIds[NORM_1], 0));
@@ -652,6 +653,8 @@ PetscErrorCode VecCreate_MPI(Vec vv)
 {
   PetscFunctionBegin;
   PetscCall(VecCreate_MPI_Private(vv, PETSC_TRUE, 0, NULL));
+  /* not in DvOps since the device vector types build on that table and must not get a host kernel */
+  vv->ops->maxpymdot = VecMAXPYMDot_MPI;
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
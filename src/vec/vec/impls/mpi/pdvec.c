@@ -31,6 +31,7 @@ PetscErrorCode VecDestroy_MPI(Vec v)
   PetscCall(PetscLogObjectState((PetscObject)v, "Length=%" PetscInt_FMT, v->map->N));
   if (!x) PetscFunctionReturn(PETSC_SUCCESS);
   PetscCall(PetscFree(x->array_allocated));
+  PetscCall(PetscFree2(x->maxpymdot.x, x->maxpymdot.work));
 
   /* Destroy local representation of vector if it exists */
   if (x->localrep) {
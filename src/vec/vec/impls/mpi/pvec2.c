@@ -25,6 +25,21 @@ PetscErrorCode VecMDot_MPI(Vec xin, PetscInt nv, const Vec y[], PetscScalar *z)
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+PetscErrorCode VecMAXPYMDot_MPI(Vec yin, PetscInt nv, const PetscScalar *alpha, Vec *x, PetscScalar *z, PetscReal *nrm)
+{
+  PetscScalar *w;
+  PetscMPIInt  cnt;
+
+  PetscFunctionBegin;
+  /* reduce the dot products and, if requested, the norm together */
+  PetscCall(VecMAXPYMDotLocal_Seq(yin, nv, alpha, x, &((Vec_MPI *)yin->data)->maxpymdot, &w));
+  PetscCall(PetscMPIIntCast(nrm ? nv + 1 : nv, &cnt));
+  PetscCallMPI(MPIU_Allreduce(MPI_IN_PLACE, w, cnt, MPIU_SCALAR, MPIU_SUM, PetscObjectComm((PetscObject)yin)));
+  PetscCall(PetscArraycpy(z, w, nv));
+  if (nrm) *nrm = PetscSqrtReal(PetscRealPart(w[nv]));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 PetscErrorCode VecMDot_MPI_GEMV(Vec xin, PetscInt nv, const Vec y[], PetscScalar *z)
 {
   PetscFunctionBegin;
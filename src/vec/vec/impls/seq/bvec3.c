@@ -31,7 +31,7 @@ PetscErrorCode VecCreate_Seq(Vec V)
   PetscCheck(size <= 1, PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Cannot create VECSEQ on more than one process");
 #if !defined(PETSC_USE_MIXED_PRECISION)
   PetscCall(PetscShmgetAllocateArray(n, sizeof(PetscScalar), (void **)&array));
-  PetscCall(PetscMemzero(array, n * sizeof(PetscScalar)));
+  PetscCall(PetscMemzeroFirstTouch_Private(array, sizeof(PetscScalar), n, PETSC_DECIDE, NULL));
   PetscCall(VecCreate_Seq_Private(V, array));
 
   s                  = (Vec_Seq *)V->data;
@@ -64,5 +64,7 @@ PetscErrorCode VecCreate_Seq(Vec V)
     SETERRQ(PetscObjectComm((PetscObject)V), PETSC_ERR_SUP, "No support for mixed precision %d", (int)(((PetscObject)V)->precision));
   }
 #endif
+  /* not in DvOps since the device vector types build on that table and must not get a host kernel */
+  V->ops->maxpymdot = VecMAXPYMDot_Seq;
   PetscFunctionReturn(PETSC_SUCCESS);
 }
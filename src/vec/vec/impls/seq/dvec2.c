@@ -755,6 +755,88 @@ PetscErrorCode VecMAXPY_Seq_GEMV(Vec yin, PetscInt nv, const PetscScalar alpha[]
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*
+   Rows are processed in blocks small enough that the block of y and of all the x[j] stay in cache between the update and
+   the dot products, so the x[j] are streamed from memory only once
+*/
+#define VEC_MAXPYMDOT_BLOCK 256
+
+static inline void VecMAXPYMDot_Kernel(PetscInt nv, const PetscScalar alpha[], const PetscScalar *const xx[], PetscScalar *PETSC_RESTRICT yy, PetscInt start, PetscInt end, PetscScalar w[])
+{
+  for (PetscInt i0 = start; i0 < end; i0 += VEC_MAXPYMDOT_BLOCK) {
+    const PetscInt i1 = PetscMin(i0 + VEC_MAXPYMDOT_BLOCK, end);
+    PetscReal      nrm2 = 0.0;
+
+    for (PetscInt j = 0; j < nv; j++) {
+      const PetscScalar                a  = alpha[j];
+      const PetscScalar *PETSC_RESTRICT xj = xx[j];
+
+      PetscPragmaSIMD
+      for (PetscInt i = i0; i < i1; i++) yy[i] += a * xj[i];
+    }
+    for (PetscInt j = 0; j < nv; j++) {
+      const PetscScalar *PETSC_RESTRICT xj  = xx[j];
+      PetscScalar                       sum = 0.0;
+
+      PetscPragmaSIMD
+      for (PetscInt i = i0; i < i1; i++) sum += PetscConj(xj[i]) * yy[i];
+      w[j] += sum;
+    }
+    PetscPragmaSIMD
+    for (PetscInt i = i0; i < i1; i++) nrm2 += PetscRealPart(PetscConj(yy[i]) * yy[i]);
+    w[nv] += nrm2;
+  }
+}
+
+/*
+   y = y + sum alpha[j] x[j], then w[j] = x[j]^H y on the local part for j < nv and w[nv] the local part of ||y||^2.
+   With --with-openmp-kernels the rows are split among the OpenMP threads. The nv + 1 sums are returned in the workspace
+   ws kept in the implementation data of the vector, which is valid until the next call, so GMRES does not allocate.
+*/
+PetscErrorCode VecMAXPYMDotLocal_Seq(Vec yin, PetscInt nv, const PetscScalar *alpha, Vec *x, VecMAXPYMDotWork *ws, PetscScalar **w)
+{
+  const PetscInt n  = yin->map->n;
+  PetscInt       nt = 1;
+  PetscScalar   *yy, *work;
+
+  PetscFunctionBegin;
+#if defined(PETSC_USE_OPENMP_KERNELS)
+  nt = PetscMax(1, PetscMin(PetscNumOMPThreads, n / (4 * VEC_MAXPYMDOT_BLOCK)));
+#endif
+  if (nv > ws->nv || nt > ws->nt || !ws->work) {
+    PetscCall(PetscFree2(ws->x, ws->work));
+    ws->nv = PetscMax(nv, ws->nv);
+    ws->nt = PetscMax(nt, ws->nt);
+    PetscCall(PetscMalloc2(ws->nv, &ws->x, ws->nt * (ws->nv + 1), &ws->work));
+  }
+  work = ws->work;
+  PetscCall(PetscArrayzero(work, nt * (nv + 1)));
+  for (PetscInt j = 0; j < nv; j++) PetscCall(VecGetArrayRead(x[j], &ws->x[j]));
+  PetscCall(VecGetArray(yin, &yy));
+  if (nt > 1) {
+    PetscPragmaUseOMPKernels(parallel for num_threads((int)nt) schedule(static, 1))
+    for (PetscInt t = 0; t < nt; t++) VecMAXPYMDot_Kernel(nv, alpha, ws->x, yy, (PetscInt)(((PetscCount)n * t) / nt), (PetscInt)(((PetscCount)n * (t + 1)) / nt), work + t * (nv + 1));
+  } else VecMAXPYMDot_Kernel(nv, alpha, ws->x, yy, 0, n, work);
+  for (PetscInt t = 1; t < nt; t++)
+    for (PetscInt j = 0; j <= nv; j++) work[j] += work[t * (nv + 1) + j];
+  PetscCall(VecRestoreArray(yin, &yy));
+  for (PetscInt j = 0; j < nv; j++) PetscCall(VecRestoreArrayRead(x[j], &ws->x[j]));
+  *w = work;
+  PetscCall(PetscLogFlops(nv * 4.0 * n + 2.0 * n));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
+PetscErrorCode VecMAXPYMDot_Seq(Vec yin, PetscInt nv, const PetscScalar *alpha, Vec *x, PetscScalar *z, PetscReal *nrm)
+{
+  PetscScalar *w;
+
+  PetscFunctionBegin;
+  PetscCall(VecMAXPYMDotLocal_Seq(yin, nv, alpha, x, &((Vec_Seq *)yin->data)->maxpymdot, &w));
+  PetscCall(PetscArraycpy(z, w, nv));
+  if (nrm) *nrm = PetscSqrtReal(PetscRealPart(w[nv]));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 #include <../src/vec/vec/impls/seq/ftn-kernels/faypx.h>
 
 PetscErrorCode VecAYPX_Seq(Vec yin, PetscScalar alpha, Vec xin)
@@ -1318,6 +1318,71 @@ PetscErrorCode VecMAXPY(Vec y, PetscInt nv, const PetscScalar alpha[], Vec x[])
   PetscFunctionReturn(PETSC_SUCCESS);
 }
 
+/*@
+  VecMAXPYMDot - Computes `y = y + sum alpha[i] x[i]` followed by the multiple dot products `val[i] = (y, x[i])` and optionally the 2-norm of the updated `y`
+
+  Collective
+
+  Input Parameters:
++ y     - one vector
+. nv    - number of scalars and x-vectors
+. alpha - array of scalars
+- x     - array of vectors
+
+  Output Parameters:
++ val - array of the dot products of the updated `y` with the `x[i]`, as computed by `VecMDot()`
+- nrm - the 2-norm of the updated `y`, pass `NULL` if not needed
+
+  Level: advanced
+
+  Notes:
+  `y` cannot be any of the `x` vectors
+
+  This is the update of a classical Gram-Schmidt step fused with the inner products of the next one, as used by the
+  reorthogonalization in `KSPGMRESClassicalGramSchmidtOrthogonalization()`. Implementations can then read each `x[i]` only once.
+  `VECSEQ` and `VECMPI` provide a fused implementation, threaded when PETSc is configured with `--with-openmp-kernels`;
+  other vector types fall back to `VecMAXPY()`, `VecMDot()` and `VecNorm()`.
+
+.seealso: [](ch_vectors), `Vec`, `VecMAXPY()`, `VecMDot()`, `VecNorm()`, `VecDotNorm2()`
+@*/
+PetscErrorCode VecMAXPYMDot(Vec y, PetscInt nv, const PetscScalar alpha[], Vec x[], PetscScalar val[], PetscReal *nrm)
+{
+  PetscFunctionBegin;
+  PetscValidHeaderSpecific(y, VEC_CLASSID, 1);
+  VecCheckAssembled(y);
+  PetscValidLogicalCollectiveInt(y, nv, 2);
+  PetscCall(VecSetErrorIfLocked(y, 1));
+  PetscCheck(nv >= 0, PETSC_COMM_SELF, PETSC_ERR_ARG_OUTOFRANGE, "Number of vectors (given %" PetscInt_FMT ") cannot be negative", nv);
+  if (!y->ops->maxpymdot) {
+    PetscCall(VecMAXPY(y, nv, alpha, x));
+    PetscCall(VecMDot(y, nv, x, val));
+    if (nrm) PetscCall(VecNorm(y, NORM_2, nrm));
+    PetscFunctionReturn(PETSC_SUCCESS);
+  }
+  if (nv) {
+    PetscAssertPointer(alpha, 3);
+    PetscAssertPointer(x, 4);
+    PetscAssertPointer(val, 5);
+  }
+  for (PetscInt i = 0; i < nv; ++i) {
+    PetscValidLogicalCollectiveScalar(y, alpha[i], 3);
+    PetscValidHeaderSpecific(x[i], VEC_CLASSID, 4);
+    PetscValidType(x[i], 4);
+    PetscCheckSameTypeAndComm(y, 1, x[i], 4);
+    VecCheckSameSize(y, 1, x[i], 4);
+    PetscCheck(y != x[i], PETSC_COMM_SELF, PETSC_ERR_ARG_WRONG, "Array of vectors 'x' cannot contain y, found x[%" PetscInt_FMT "] == y", i);
+    VecCheckAssembled(x[i]);
+    PetscCall(VecLockReadPush(x[i]));
+  }
+  PetscCall(PetscLogEventBegin(VEC_MAXPYMDot, y, nv ? *x : NULL, 0, 0));
+  PetscUseTypeMethod(y, maxpymdot, nv, alpha, x, val, nrm);
+  PetscCall(PetscLogEventEnd(VEC_MAXPYMDot, y, nv ? *x : NULL, 0, 0));
+  PetscCall(PetscObjectStateIncrease((PetscObject)y));
+  if (nrm) PetscCall(PetscObjectComposedDataSetReal((PetscObject)y, NormIds[NORM_2], *nrm));
+  for (PetscInt i = 0; i < nv; ++i) PetscCall(VecLockReadPop(x[i]));
+  PetscFunctionReturn(PETSC_SUCCESS);
+}
+
 /*@
   VecMAXPBY - Computes `y = beta y + sum alpha[i] x[i]`
 
@@ -0,0 +1,67 @@
+static char help[] = "Tests VecMAXPYMDot() against VecMAXPY(), VecMDot() and VecNorm().\n\n";
+
+#include <petscvec.h>
+
+int main(int argc, char **argv)
+{
+  Vec         y, w, *x;
+  PetscInt    n = 3000, nv = 7;
+  PetscScalar alpha[16], val[16], ref[16];
+  PetscReal   nrm, refnrm, err = 0.0;
+  PetscRandom rctx;
+
+  PetscFunctionBeginUser;
+  PetscCall(PetscInitialize(&argc, &argv, NULL, help));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-n", &n, NULL));
+  PetscCall(PetscOptionsGetInt(NULL, NULL, "-nv", &nv, NULL));
+  PetscCheck(nv >= 0 && nv <= 16, PETSC_COMM_WORLD, PETSC_ERR_ARG_OUTOFRANGE, "-nv must be in [0, 16]");
+
+  PetscCall(PetscRandomCreate(PETSC_COMM_WORLD, &rctx));
+  PetscCall(PetscRandomSetFromOptions(rctx));
+  PetscCall(VecCreate(PETSC_COMM_WORLD, &y));
+  PetscCall(VecSetSizes(y, PETSC_DECIDE, n));
+  PetscCall(VecSetFromOptions(y));
+  PetscCall(VecDuplicate(y, &w));
+  PetscCall(VecDuplicateVecs(y, nv, &x));
+  PetscCall(VecSetRandom(y, rctx));
+  for (PetscInt i = 0; i < nv; i++) {
+    PetscCall(VecSetRandom(x[i], rctx));
+    alpha[i] = -1.0 / (i + 2);
+  }
+  PetscCall(VecCopy(y, w));
+
+  PetscCall(VecMAXPY(w, nv, alpha, x));
+  PetscCall(VecMDot(w, nv, x, ref));
+  PetscCall(VecNorm(w, NORM_2, &refnrm));
+  PetscCall(VecMAXPYMDot(y, nv, alpha, x, val, &nrm));
+
+  PetscCall(VecAXPY(w, -1.0, y));
+  PetscCall(VecNorm(w, NORM_INFINITY, &err));
+  PetscCheck(err < 100 * PETSC_MACHINE_EPSILON, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "Updated vector differs by %g", (double)err);
+  for (PetscInt i = 0; i < nv; i++) PetscCheck(PetscAbsScalar(val[i] - ref[i]) <= 100 * PETSC_MACHINE_EPSILON * n, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "Dot product %" PetscInt_FMT " differs by %g", i, (double)PetscAbsScalar(val[i] - ref[i]));
+  PetscCheck(PetscAbsReal(nrm - refnrm) <= 100 * PETSC_MACHINE_EPSILON * refnrm, PETSC_COMM_WORLD, PETSC_ERR_PLIB, "Norm differs by %g", (double)PetscAbsReal(nrm - refnrm));
+
+  PetscCall(VecDestroyVecs(nv, &x));
+  PetscCall(VecDestroy(&w));
+  PetscCall(VecDestroy(&y));
+  PetscCall(PetscRandomDestroy(&rctx));
+  PetscCall(PetscFinalize());
+  return 0;
+}
+
+/*TEST
+
+   testset:
+     output_file: output/empty.out
+     args: -nv {{1 7 16}}
+
+     test:
+       suffix: 1
+       nsize: {{1 3}}
+
+     test:
+       suffix: omp
+       requires: openmp
+       args: -omp_num_threads 3 -vec_mdot_use_gemv 0
+
+TEST*/